@@ -78,6 +78,7 @@ MCU_COMMON_SRC = \
             drivers/mcu/at32/usb_msc_at32f43x.c \
             drivers/accgyro/accgyro_mpu.c \
             drivers/dshot_bitbang_decode.c \
+            drivers/dshot_bitbang_encode.c \
             drivers/inverter.c \
             drivers/pwm_output_dshot_shared.c \
             $(MIDDLEWARES_DIR)/i2c_application_library/i2c_application.c \
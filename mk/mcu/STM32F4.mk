@@ -159,6 +159,7 @@ DEVICE_FLAGS    += -DHSE_VALUE=$(HSE_VALUE) -DSTM32
 MCU_COMMON_SRC = \
             drivers/accgyro/accgyro_mpu.c \
             drivers/dshot_bitbang_decode.c \
+            drivers/dshot_bitbang_encode.c \
             drivers/inverter.c \
             drivers/pwm_output_dshot_shared.c \
             drivers/mcu/stm32/pwm_output_dshot.c \
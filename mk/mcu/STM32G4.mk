@@ -118,6 +118,7 @@ MCU_COMMON_SRC = \
             drivers/accgyro/accgyro_mpu.c \
             drivers/bus_i2c_timing.c \
             drivers/dshot_bitbang_decode.c \
+            drivers/dshot_bitbang_encode.c \
             drivers/pwm_output_dshot_shared.c \
             drivers/mcu/stm32/adc_stm32g4xx.c \
             drivers/mcu/stm32/bus_i2c_hal_init.c \
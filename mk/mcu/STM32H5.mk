@@ -152,6 +152,7 @@ MCU_COMMON_SRC = \
             drivers/bus_i2c_timing.c \
             drivers/bus_quadspi.c \
             drivers/dshot_bitbang_decode.c \
+            drivers/dshot_bitbang_encode.c \
             drivers/pwm_output_dshot_shared.c \
             drivers/mcu/stm32/bus_i2c_hal_init.c \
             drivers/mcu/stm32/bus_i2c_hal.c \
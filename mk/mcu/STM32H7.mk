@@ -266,6 +266,7 @@ MCU_COMMON_SRC = \
             drivers/bus_i2c_timing.c \
             drivers/bus_quadspi.c \
             drivers/dshot_bitbang_decode.c \
+            drivers/dshot_bitbang_encode.c \
             drivers/pwm_output_dshot_shared.c \
             drivers/mcu/stm32/adc_stm32h7xx.c \
             drivers/mcu/stm32/audio_stm32h7xx.c \
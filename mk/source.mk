@@ -7,6 +7,8 @@ PG_SRC = \
             pg/bus_quadspi.c \
             pg/bus_spi.c \
             pg/dashboard.c \
+            pg/debug_capture.c \
+            pg/detected_hardware.c \
             pg/displayport_profiles.c \
             pg/dyn_notch.c \
             pg/flash.c \
@@ -44,6 +46,7 @@ PG_SRC = \
 COMMON_SRC = \
             build/build_config.c \
             build/debug.c \
+            build/debug_capture.c \
             build/debug_pin.c \
             build/version.c \
             $(TARGET_DIR_SRC) \
@@ -58,6 +61,7 @@ COMMON_SRC = \
             common/gps_conversion.c \
             common/huffman.c \
             common/huffman_table.c \
+            common/lz.c \
             common/maths.c \
             common/printf.c \
             common/printf_serial.c \
@@ -94,6 +98,7 @@ COMMON_SRC = \
             drivers/bus_spi.c \
             drivers/bus_spi_config.c \
             drivers/bus_spi_pinconfig.c \
+            drivers/bus_spi_queue.c \
             drivers/buttons.c \
             drivers/display.c \
             drivers/display_canvas.c \
@@ -134,7 +139,11 @@ COMMON_SRC = \
             msp/msp.c \
             msp/msp_box.c \
             msp/msp_build_info.c \
+            msp/msp_dataflash_read.c \
+            msp/msp_dataflash_stream.c \
+            msp/msp_multi.c \
             msp/msp_serial.c \
+            msp/msp_settings.c \
             scheduler/scheduler.c \
             sensors/adcinternal.c \
             sensors/battery.c \
@@ -149,10 +158,12 @@ COMMON_SRC = \
             drivers/rx/rx_pwm.c \
             drivers/serial_softserial.c \
             fc/core.c \
+            fc/latency.c \
             fc/rc.c \
             fc/rc_adjustments.c \
             fc/rc_controls.c \
             fc/rc_modes.c \
+            flight/alt_estimator.c \
             flight/position.c \
             flight/failsafe.c \
             flight/gps_rescue.c \
@@ -198,6 +209,7 @@ COMMON_SRC = \
             sensors/boardalignment.c \
             sensors/compass.c \
             sensors/gyro.c \
+            sensors/gyro_fusion.c \
             sensors/gyro_init.c \
             sensors/initialisation.c \
             blackbox/blackbox.c \
@@ -399,6 +411,7 @@ SPEED_OPTIMISED_SRC := ""
 SIZE_OPTIMISED_SRC  := ""
 
 SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
+            build/debug_capture.c \
             common/encoding.c \
             common/filter.c \
             common/maths.c \
@@ -422,6 +435,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             drivers/bus.c \
             drivers/bus_quadspi.c \
             drivers/bus_spi.c \
+            drivers/bus_spi_queue.c \
             drivers/exti.c \
             drivers/io.c \
             drivers/pwm_output.c \
@@ -431,6 +445,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             drivers/system.c \
             drivers/timer.c \
             fc/core.c \
+            fc/latency.c \
             fc/tasks.c \
             fc/rc.c \
             fc/rc_controls.c \
@@ -457,6 +472,7 @@ SPEED_OPTIMISED_SRC := $(SPEED_OPTIMISED_SRC) \
             sensors/acceleration.c \
             sensors/boardalignment.c \
             sensors/gyro.c \
+            sensors/gyro_fusion.c \
             $(CMSIS_SRC) \
             $(DEVICE_STDPERIPH_SRC) \
 
@@ -510,7 +526,9 @@ SIZE_OPTIMISED_SRC := $(SIZE_OPTIMISED_SRC) \
             io/serial_4way_stk500v2.c \
             io/transponder_ir.c \
             io/usb_cdc_hid.c \
+            msp/msp_multi.c \
             msp/msp_serial.c \
+            msp/msp_settings.c \
             cms/cms.c \
             cms/cms_menu_blackbox.c \
             cms/cms_menu_failsafe.c \
@@ -34,6 +34,7 @@
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/debug_capture.h"
 #include "build/version.h"
 
 #include "common/axis.h"
@@ -56,6 +57,7 @@
 
 #include "fc/board_info.h"
 #include "fc/controlrate_profile.h"
+#include "fc/latency.h"
 #include "fc/parameter_names.h"
 #include "fc/rc.h"
 #include "fc/rc_controls.h"
@@ -582,6 +584,9 @@ static void blackboxSetState(BlackboxState newState)
         break;
     case BLACKBOX_STATE_RUNNING:
         blackboxSlowFrameIterationTimer = blackboxSInterval; //Force a slow frame to be written on the first iteration
+#ifdef USE_DEBUG_CAPTURE
+        debugCaptureReset(); // records from before the log started or while it was paused aren't wanted
+#endif
         break;
     case BLACKBOX_STATE_SHUTTING_DOWN:
         xmitState.u.startTime = millis();
@@ -1568,7 +1573,6 @@ static bool blackboxWriteSysinfo(void)
 #endif
         BLACKBOX_PRINT_HEADER_LINE(PARAM_NAME_POSITION_ALTITUDE_SOURCE, "%d",      positionConfig()->altitude_source);
         BLACKBOX_PRINT_HEADER_LINE(PARAM_NAME_POSITION_ALTITUDE_PREFER_BARO, "%d", positionConfig()->altitude_prefer_baro);
-        BLACKBOX_PRINT_HEADER_LINE(PARAM_NAME_POSITION_ALTITUDE_LPF, "%d",         positionConfig()->altitude_lpf);
         BLACKBOX_PRINT_HEADER_LINE(PARAM_NAME_POSITION_ALTITUDE_D_LPF, "%d",       positionConfig()->altitude_d_lpf);
 
 #ifdef USE_MAG
@@ -1692,6 +1696,28 @@ static bool blackboxWriteSysinfo(void)
         BLACKBOX_PRINT_HEADER_LINE(PARAM_NAME_TPA_GRAVITY_THR100, "%d", currentPidProfile->tpa_gravity_thr100);
 #endif
 
+#ifdef USE_LATENCY_STATS
+        // mean, median, 99th percentile and maximum in us, since boot or the last reset over MSP
+#define LATENCY_HEADER_VALUES(path) \
+            (unsigned)latencyMeanUs(latencyGetStats(path)), \
+            (unsigned)latencyPercentileUs(latencyGetStats(path), 50), \
+            (unsigned)latencyPercentileUs(latencyGetStats(path), 99), \
+            (unsigned)latencyGetStats(path)->maxUs
+        BLACKBOX_PRINT_HEADER_LINE("latency_gyro_filter", "%u,%u,%u,%u", LATENCY_HEADER_VALUES(LATENCY_GYRO_FILTER));
+        BLACKBOX_PRINT_HEADER_LINE("latency_gyro_pid", "%u,%u,%u,%u",    LATENCY_HEADER_VALUES(LATENCY_GYRO_PID));
+        BLACKBOX_PRINT_HEADER_LINE("latency_gyro_motor", "%u,%u,%u,%u",  LATENCY_HEADER_VALUES(LATENCY_GYRO_MOTOR));
+        BLACKBOX_PRINT_HEADER_LINE("latency_rx_motor", "%u,%u,%u,%u",    LATENCY_HEADER_VALUES(LATENCY_RX_MOTOR));
+#undef LATENCY_HEADER_VALUES
+#endif
+
+#ifdef USE_DEBUG_CAPTURE
+        // debug mode and divider of each capture slot, the records themselves follow as 'X' frames
+        BLACKBOX_PRINT_HEADER_LINE("debug_capture_mode", "%d,%d,%d,%d",  debugCaptureConfig()->mode[0], debugCaptureConfig()->mode[1],
+                                                                        debugCaptureConfig()->mode[2], debugCaptureConfig()->mode[3]);
+        BLACKBOX_PRINT_HEADER_LINE("debug_capture_divider", "%d,%d,%d,%d", debugCaptureConfig()->divider[0], debugCaptureConfig()->divider[1],
+                                                                        debugCaptureConfig()->divider[2], debugCaptureConfig()->divider[3]);
+#endif
+
         default:
             return true;
     }
@@ -1749,6 +1775,32 @@ void blackboxLogEvent(FlightLogEvent event, flightLogEventData_t *data)
     }
 }
 
+#ifdef USE_DEBUG_CAPTURE
+STATIC_ASSERT(DEBUG_CAPTURE_SLOT_COUNT == 4, debug_capture_header_lists_four_slots);
+
+/*
+ * Write the captured debug records as 'X' frames, as many as fit in the buffer. Each frame holds the length of
+ * its record so readers that don't decode them can skip over them.
+ */
+static void writeDebugCaptureFrames(void)
+{
+    uint8_t record[DEBUG_CAPTURE_RECORD_MAX_BYTES];
+
+    while (blackboxDeviceReserveBufferSpace(DEBUG_CAPTURE_RECORD_MAX_BYTES + 2) == BLACKBOX_RESERVE_SUCCESS) {
+        const unsigned length = debugCaptureEncodeNext(record);
+        if (!length) {
+            break;
+        }
+
+        blackboxWrite('X');
+        blackboxWriteUnsignedVB(length);
+        for (unsigned i = 0; i < length; i++) {
+            blackboxWrite(record[i]);
+        }
+    }
+}
+#endif
+
 /* If an arming beep has played since it was last logged, write the time of the arming beep to the log as a synchronization point */
 static void blackboxCheckAndLogArmingBeep(void)
 {
@@ -1861,6 +1913,10 @@ STATIC_UNIT_TESTED void blackboxLogIteration(timeUs_t currentTimeUs)
 #endif
     }
 
+#ifdef USE_DEBUG_CAPTURE
+    writeDebugCaptureFrames();
+#endif
+
     //Flush every iteration so that our runtime variance is minimized
     blackboxDeviceFlush();
 }
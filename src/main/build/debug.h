@@ -26,7 +26,47 @@
 extern int16_t debug[DEBUG16_VALUE_COUNT];
 extern uint8_t debugMode;
 
-#define DEBUG_SET(mode, index, value) do { if (debugMode == (mode)) { debug[(index)] = (value); } } while (0)
+#ifdef USE_DEBUG_CAPTURE
+// Slot capturing each debug mode, counting from 1, 0 when the mode isn't captured
+extern uint8_t debugCaptureSlot[];
+
+void debugCaptureSetInt(unsigned slot, unsigned index, int32_t value);
+void debugCaptureSetFloat(unsigned slot, unsigned index, float value);
+
+// Captured values keep their full range
+#define DEBUG_MODE_ACTIVE(mode) (debugMode == (mode) || debugCaptureSlot[(mode)])
+#define DEBUG_CAPTURE_SET(mode, index, value) do { if (debugCaptureSlot[(mode)]) { debugCaptureSetInt(debugCaptureSlot[(mode)], (index), (value)); } } while (0)
+#define DEBUG_CAPTURE_SET_FLOAT(mode, index, value) do { if (debugCaptureSlot[(mode)]) { debugCaptureSetFloat(debugCaptureSlot[(mode)], (index), (value)); } } while (0)
+#else
+#define DEBUG_MODE_ACTIVE(mode) (debugMode == (mode))
+#define DEBUG_CAPTURE_SET(mode, index, value) do { } while (0)
+#define DEBUG_CAPTURE_SET_FLOAT(mode, index, value) do { } while (0)
+#endif
+
+// index and value are evaluated once, and only when the mode is shown or captured
+#define DEBUG_SET(mode, index, value) \
+    do { \
+        if (DEBUG_MODE_ACTIVE(mode)) { \
+            const unsigned _debugIndex = (index); \
+            const int32_t _debugValue = (value); \
+            if (debugMode == (mode)) { \
+                debug[_debugIndex] = _debugValue; \
+            } \
+            DEBUG_CAPTURE_SET(mode, _debugIndex, _debugValue); \
+        } \
+    } while (0)
+// Floats are rounded into debug[] and captured as they are
+#define DEBUG_SET_FLOAT(mode, index, value) \
+    do { \
+        if (DEBUG_MODE_ACTIVE(mode)) { \
+            const unsigned _debugIndex = (index); \
+            const float _debugValue = (value); \
+            if (debugMode == (mode)) { \
+                debug[_debugIndex] = lrintf(_debugValue); \
+            } \
+            DEBUG_CAPTURE_SET_FLOAT(mode, _debugIndex, _debugValue); \
+        } \
+    } while (0)
 
 typedef enum {
     DEBUG_NONE,
@@ -123,6 +163,7 @@ typedef enum {
     DEBUG_S_TERM,
     DEBUG_SPA,
     DEBUG_TASK,
+    DEBUG_LATENCY,
     DEBUG_COUNT
 } debugType_e;
 
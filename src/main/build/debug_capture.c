@@ -0,0 +1,199 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_DEBUG_CAPTURE
+
+#include "build/debug.h"
+
+#include "common/encoding.h"
+#include "common/maths.h"
+#include "common/streambuf.h"
+
+#include "pg/debug_capture.h"
+
+#include "debug_capture.h"
+
+// Latest values of the channels of each slot, recorded every divider PID loops
+typedef struct debugCaptureChannels_s {
+    uint8_t mode;
+    uint8_t divider;
+    uint8_t counter;
+    uint8_t writtenMask;
+    uint8_t floatMask;
+    debugCaptureValue_t value[DEBUG16_VALUE_COUNT];
+} debugCaptureChannels_t;
+
+uint8_t debugCaptureSlot[DEBUG_COUNT];
+
+static debugCaptureChannels_t captureChannels[DEBUG_CAPTURE_SLOT_COUNT];
+
+static debugCaptureRecord_t captureRing[DEBUG_CAPTURE_RING_SIZE];
+static unsigned captureRingHead;
+static unsigned captureRingTail;
+// Records lost to a full ring since the last one taken out
+static uint32_t captureDropped;
+
+void debugCaptureInit(void)
+{
+    memset(debugCaptureSlot, 0, sizeof(debugCaptureSlot));
+    memset(captureChannels, 0, sizeof(captureChannels));
+
+    for (unsigned slot = 0; slot < DEBUG_CAPTURE_SLOT_COUNT; slot++) {
+        const uint8_t mode = debugCaptureConfig()->mode[slot];
+
+        // a mode is captured by the first slot asking for it
+        if (mode == DEBUG_NONE || mode >= DEBUG_COUNT || debugCaptureSlot[mode]) {
+            continue;
+        }
+
+        captureChannels[slot].mode = mode;
+        captureChannels[slot].divider = MAX(debugCaptureConfig()->divider[slot], 1);
+        debugCaptureSlot[mode] = slot + 1;
+    }
+
+    debugCaptureReset();
+}
+
+void debugCaptureReset(void)
+{
+    captureRingHead = 0;
+    captureRingTail = 0;
+    captureDropped = 0;
+}
+
+FAST_CODE void debugCaptureSetInt(unsigned slot, unsigned index, int32_t value)
+{
+    debugCaptureChannels_t *channels = &captureChannels[slot - 1];
+
+    channels->value[index].i = value;
+    channels->writtenMask |= 1 << index;
+    channels->floatMask &= ~(1 << index);
+}
+
+FAST_CODE void debugCaptureSetFloat(unsigned slot, unsigned index, float value)
+{
+    debugCaptureChannels_t *channels = &captureChannels[slot - 1];
+
+    channels->value[index].f = value;
+    channels->writtenMask |= 1 << index;
+    channels->floatMask |= 1 << index;
+}
+
+// Called at the end of each PID loop
+FAST_CODE void debugCaptureUpdate(timeUs_t currentTimeUs)
+{
+    for (unsigned slot = 0; slot < DEBUG_CAPTURE_SLOT_COUNT; slot++) {
+        debugCaptureChannels_t *channels = &captureChannels[slot];
+
+        if (channels->mode == DEBUG_NONE || ++channels->counter < channels->divider) {
+            continue;
+        }
+        channels->counter = 0;
+
+        if (!channels->writtenMask) {
+            continue;
+        }
+
+        if (captureRingTail - captureRingHead == DEBUG_CAPTURE_RING_SIZE) {
+            captureDropped++;
+            continue;
+        }
+
+        debugCaptureRecord_t *record = &captureRing[captureRingTail % DEBUG_CAPTURE_RING_SIZE];
+        record->timeUs = currentTimeUs;
+        record->mode = channels->mode;
+        record->writtenMask = channels->writtenMask;
+        record->floatMask = channels->floatMask;
+        memcpy(record->value, channels->value, sizeof(record->value));
+        captureRingTail++;
+    }
+}
+
+const debugCaptureRecord_t *debugCapturePeek(void)
+{
+    if (captureRingHead == captureRingTail) {
+        return NULL;
+    }
+
+    return &captureRing[captureRingHead % DEBUG_CAPTURE_RING_SIZE];
+}
+
+static void sbufWriteUnsignedVB(sbuf_t *dst, uint32_t value)
+{
+    while (value > 127) {
+        sbufWriteU8(dst, (uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    sbufWriteU8(dst, value);
+}
+
+/*
+ * Takes the oldest record out of the ring and encodes it into buf, which must hold DEBUG_CAPTURE_RECORD_MAX_BYTES.
+ * Returns the length of the encoding, 0 when there is no record.
+ *
+ * The record describes itself as:
+ *   U8  debug mode, the channels being named after it and their index
+ *   UVB time of the PID loop it was recorded in, us
+ *   UVB records dropped before it
+ *   U8  mask of the channels present
+ *   U8  mask of the channels present holding a float
+ *   for each channel present in index order, the float as U32 or the integer as SVB
+ */
+unsigned debugCaptureEncodeNext(uint8_t *buf)
+{
+    const debugCaptureRecord_t *record = debugCapturePeek();
+    if (!record) {
+        return 0;
+    }
+
+    sbuf_t sbuf;
+    sbufInit(&sbuf, buf, buf + DEBUG_CAPTURE_RECORD_MAX_BYTES);
+
+    sbufWriteU8(&sbuf, record->mode);
+    sbufWriteUnsignedVB(&sbuf, record->timeUs);
+    sbufWriteUnsignedVB(&sbuf, captureDropped);
+    sbufWriteU8(&sbuf, record->writtenMask);
+    sbufWriteU8(&sbuf, record->floatMask);
+
+    for (unsigned index = 0; index < DEBUG16_VALUE_COUNT; index++) {
+        if (!(record->writtenMask & (1 << index))) {
+            continue;
+        }
+        if (record->floatMask & (1 << index)) {
+            sbufWriteU32(&sbuf, castFloatBytesToInt(record->value[index].f));
+        } else {
+            sbufWriteUnsignedVB(&sbuf, zigzagEncode(record->value[index].i));
+        }
+    }
+
+    captureRingHead++;
+    captureDropped = 0;
+
+    return sbufPtr(&sbuf) - buf;
+}
+
+#endif // USE_DEBUG_CAPTURE
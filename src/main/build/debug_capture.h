@@ -0,0 +1,56 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdint.h>
+
+#include "build/debug.h"
+
+#include "common/time.h"
+
+#include "pg/debug_capture.h"
+
+// Records waiting to be logged, a power of two
+#define DEBUG_CAPTURE_RING_SIZE 32
+
+// Longest encoded record: mode, time, dropped count, masks and a variable byte value per channel
+#define DEBUG_CAPTURE_RECORD_MAX_BYTES (1 + 5 + 5 + 2 + DEBUG16_VALUE_COUNT * 5)
+
+typedef union debugCaptureValue_u {
+    int32_t i;
+    float f;
+} debugCaptureValue_t;
+
+typedef struct debugCaptureRecord_s {
+    timeUs_t timeUs;
+    uint8_t mode;
+    uint8_t writtenMask;    // channels written since the capture started
+    uint8_t floatMask;      // channels holding a float
+    debugCaptureValue_t value[DEBUG16_VALUE_COUNT];
+} debugCaptureRecord_t;
+
+void debugCaptureInit(void);
+void debugCaptureReset(void);
+void debugCaptureUpdate(timeUs_t currentTimeUs);
+
+const debugCaptureRecord_t *debugCapturePeek(void);
+unsigned debugCaptureEncodeNext(uint8_t *buf);
@@ -188,7 +188,7 @@ static uint8_t cliWriteBuffer[CLI_OUT_BUFFER_SIZE];
 static char cliBuffer[CLI_IN_BUFFER_SIZE];
 static uint32_t bufferIndex = 0;
 
-static bool configIsInCopy = false;
+static bool configIsDumping = false;
 
 #define CURRENT_PROFILE_INDEX -1
 static int8_t pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
@@ -683,63 +683,13 @@ static const char *cliPrintSectionHeading(dumpFlags_t dumpMask, bool outputFlag,
     }
 }
 
-static void backupPgConfig(const pgRegistry_t *pg)
-{
-    memcpy(pg->copy, pg->address, pg->size);
-}
-
-static void restorePgConfig(const pgRegistry_t *pg, uint16_t notToRestoreGroupId)
-{
-    if (!notToRestoreGroupId || pgN(pg) != notToRestoreGroupId) {
-        memcpy(pg->address, pg->copy, pg->size);
-    }
-}
-
-static void backupConfigs(void)
-{
-    if (configIsInCopy) {
-        return;
-    }
-
-    PG_FOREACH(pg) {
-        backupPgConfig(pg);
-    }
-
-    configIsInCopy = true;
-}
-
-static void restoreConfigs(uint16_t notToRestoreGroupId)
-{
-    if (!configIsInCopy) {
-        return;
-    }
-
-    PG_FOREACH(pg) {
-        restorePgConfig(pg, notToRestoreGroupId);
-    }
-
-    configIsInCopy = false;
-}
-
 #if defined(USE_RESOURCE_MGMT) || defined(USE_TIMER_MGMT)
-static bool isReadingConfigFromCopy(void)
+static bool isComparingWithDefaults(void)
 {
-    return configIsInCopy;
+    return configIsDumping;
 }
 #endif
 
-static bool isWritingConfigToCopy(void)
-{
-    return configIsInCopy;
-}
-
-static void backupAndResetConfigs(void)
-{
-    backupConfigs();
-    // reset all configs to defaults to do differencing
-    resetConfig();
-}
-
 static uint8_t getPidProfileIndexToUse(void)
 {
     return pidProfileIndexToUse == CURRENT_PROFILE_INDEX ? getCurrentPidProfileIndex() : pidProfileIndexToUse;
@@ -765,19 +715,77 @@ static uint16_t getValueOffset(const clivalue_t *value)
     return 0;
 }
 
-STATIC_UNIT_TESTED void *cliGetValuePointer(const clivalue_t *value)
+// registry indices ordered by pgn, built on first use so settings find their parameter group with a binary search
+#define CLI_PG_INDEX_SIZE 128
+
+static uint8_t cliPgIndex[CLI_PG_INDEX_SIZE];
+static uint8_t cliPgIndexCount;
+
+static void cliBuildPgIndex(void)
 {
-    const pgRegistry_t* rec = pgFind(value->pgn);
-    if (isWritingConfigToCopy()) {
-        return CONST_CAST(void *, rec->copy + getValueOffset(value));
-    } else {
-        return CONST_CAST(void *, rec->address + getValueOffset(value));
+    if (PG_REGISTRY_SIZE > CLI_PG_INDEX_SIZE) {
+        return;
+    }
+
+    // insertion sort, the registry is small and does not change at run time
+    for (unsigned i = 0; i < PG_REGISTRY_SIZE; i++) {
+        const pgn_t pgn = pgN(&__pg_registry_start[i]);
+        unsigned j = i;
+        while (j > 0 && pgN(&__pg_registry_start[cliPgIndex[j - 1]]) > pgn) {
+            cliPgIndex[j] = cliPgIndex[j - 1];
+            j--;
+        }
+        cliPgIndex[j] = i;
     }
+    cliPgIndexCount = PG_REGISTRY_SIZE;
+}
+
+static const pgRegistry_t *cliFindPg(pgn_t pgn)
+{
+    if (!cliPgIndexCount) {
+        cliBuildPgIndex();
+        if (!cliPgIndexCount) {
+            return pgFind(pgn);
+        }
+    }
+
+    unsigned low = 0;
+    unsigned high = cliPgIndexCount;
+    while (low < high) {
+        const unsigned mid = (low + high) / 2;
+        const pgRegistry_t *reg = &__pg_registry_start[cliPgIndex[mid]];
+        if (pgN(reg) == pgn) {
+            return reg;
+        }
+        if (pgN(reg) < pgn) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+// defaults are generated on demand, there is no shadow copy of the config to compare against
+static const void *getDefaultPgConfig(const pgRegistry_t *pg)
+{
+    return pgDefaults(pg);
+}
+
+static const void *getDefaultConfig(pgn_t pgn)
+{
+    return getDefaultPgConfig(cliFindPg(pgn));
+}
+
+STATIC_UNIT_TESTED void *cliGetValuePointer(const clivalue_t *value)
+{
+    const pgRegistry_t* rec = cliFindPg(value->pgn);
+    return CONST_CAST(void *, rec->address + getValueOffset(value));
 }
 
 static const char *dumpPgValue(const char *cmdName, const clivalue_t *value, dumpFlags_t dumpMask, const char *headingStr)
 {
-    const pgRegistry_t *pg = pgFind(value->pgn);
+    const pgRegistry_t *pg = cliFindPg(value->pgn);
 #ifdef DEBUG
     if (!pg) {
         cliPrintLinef("VALUE %s ERROR", value->name);
@@ -788,17 +796,18 @@ static const char *dumpPgValue(const char *cmdName, const clivalue_t *value, dum
     const char *format = "set %s = ";
     const char *defaultFormat = "#set %s = ";
     const int valueOffset = getValueOffset(value);
-    const bool equalsDefault = valuePtrEqualsDefault(value, pg->copy + valueOffset, pg->address + valueOffset);
+    const uint8_t *defaults = getDefaultPgConfig(pg);
+    const bool equalsDefault = valuePtrEqualsDefault(value, pg->address + valueOffset, defaults + valueOffset);
 
     headingStr = cliPrintSectionHeading(dumpMask, !equalsDefault, headingStr);
     if (((dumpMask & DO_DIFF) == 0) || !equalsDefault) {
         if (dumpMask & SHOW_DEFAULTS && !equalsDefault) {
             cliPrintf(defaultFormat, value->name);
-            printValuePointer(cmdName, value, (uint8_t*)pg->address + valueOffset, false);
+            printValuePointer(cmdName, value, defaults + valueOffset, false);
             cliPrintLinefeed();
         }
         cliPrintf(format, value->name);
-        printValuePointer(cmdName, value, pg->copy + valueOffset, false);
+        printValuePointer(cmdName, value, pg->address + valueOffset, false);
         cliPrintLinefeed();
     }
     return headingStr;
@@ -867,6 +876,9 @@ static void cliPrintVarRange(const clivalue_t *var)
     break;
     case (MODE_ARRAY): {
         cliPrintLinef("Array length: %d", var->config.array.length);
+        if (var->config.array.max) {
+            cliPrintLinef("Allowed range: 0 - %d", var->config.array.max);
+        }
     }
     break;
     case (MODE_STRING): {
@@ -1557,6 +1569,7 @@ static void cliSerialPassthrough(const char *cmdName, char *cmdline)
             if ((*port)->rxCallback) {
                 (*port)->rxCallback = NULL;
             }
+            (*port)->rxFrameCallback = NULL;
         }
     }
 
@@ -3143,7 +3156,7 @@ static void cliBoardName(const char *cmdName, char *cmdline)
     if (len > 0 && strlen(boardName) != 0 && boardInformationIsSet() && (len != strlen(boardName) || strncmp(boardName, cmdline, len))) {
         cliPrintErrorLinef(cmdName, ERROR_MESSAGE, "BOARD_NAME", boardName);
     } else {
-        if (len > 0 && !configIsInCopy && setBoardName(cmdline)) {
+        if (len > 0 && setBoardName(cmdline)) {
             boardInformationUpdated = true;
 
             cliPrintHashLine("Set board_name.");
@@ -3166,7 +3179,7 @@ static void cliManufacturerId(const char *cmdName, char *cmdline)
     if (len > 0 && boardInformationIsSet() && strlen(manufacturerId) != 0 && (len != strlen(manufacturerId) || strncmp(manufacturerId, cmdline, len))) {
         cliPrintErrorLinef(cmdName, ERROR_MESSAGE, "MANUFACTURER_ID", manufacturerId);
     } else {
-        if (len > 0 && !configIsInCopy && setManufacturerId(cmdline)) {
+        if (len > 0 && setManufacturerId(cmdline)) {
             boardInformationUpdated = true;
 
             cliPrintHashLine("Set manufacturer_id.");
@@ -3218,7 +3231,7 @@ static void cliSignature(const char *cmdName, char *cmdline)
         writeSignature(signatureStr, getSignature());
         cliPrintErrorLinef(cmdName, ERROR_MESSAGE, "SIGNATURE", signatureStr);
     } else {
-        if (len > 0 && !configIsInCopy && setSignature(signature)) {
+        if (len > 0 && setSignature(signature)) {
             signatureUpdated = true;
 
             writeSignature(signatureStr, getSignature());
@@ -3590,6 +3603,7 @@ static void cliExit(const char *cmdName, char *cmdline)
     *cliBuffer = '\0';
     bufferIndex = 0;
     cliMode = false;
+    pgDefaultsRelease();
     // incase a motor was left running during motortest, clear it here
     mixerResetDisarmedMotors();
     cliReboot();
@@ -4250,7 +4264,7 @@ static void cliSave(const char *cmdName, char *cmdline)
     }
 }
 
-static void cliDefaults(const char *cmdName, char *cmdline)
+STATIC_UNIT_TESTED void cliDefaults(const char *cmdName, char *cmdline)
 {
     bool saveConfigs = true;
     uint16_t parameterGroupId = 0;
@@ -4288,12 +4302,17 @@ static void cliDefaults(const char *cmdName, char *cmdline)
 
     if (parameterGroupId) {
         cliPrintLinef("\r\n# resetting group %d to defaults", parameterGroupId);
-        backupConfigs();
+
+        const pgRegistry_t *pg = pgFind(parameterGroupId);
+        if (pg) {
+            // the defaults include the target configuration
+            memcpy(pg->address, getDefaultPgConfig(pg), pgSize(pg));
+        }
     } else {
         cliPrintHashLine("resetting to defaults");
-    }
 
-    resetConfig();
+        resetConfig();
+    }
 
 #ifdef USE_CLI_BATCH
     // Reset only the error state and allow the batch active state to remain.
@@ -4304,12 +4323,22 @@ static void cliDefaults(const char *cmdName, char *cmdline)
 #endif
 
 #if defined(USE_SIMPLIFIED_TUNING)
-    applySimplifiedTuningAllProfiles();
-#endif
-
-    if (parameterGroupId) {
-        restoreConfigs(parameterGroupId);
+    // a single group only gets the part of simplified tuning that is stored in it
+    switch (parameterGroupId) {
+    case 0:
+        applySimplifiedTuningAllProfiles();
+        break;
+    case PG_PID_PROFILE:
+        for (unsigned pidProfileIndex = 0; pidProfileIndex < PID_PROFILE_COUNT; pidProfileIndex++) {
+            applySimplifiedTuningPids(pidProfilesMutable(pidProfileIndex));
+            applySimplifiedTuningDtermFilters(pidProfilesMutable(pidProfileIndex));
+        }
+        break;
+    case PG_GYRO_CONFIG:
+        applySimplifiedTuningGyroFilters(gyroConfigMutable());
+        break;
     }
+#endif
 
     if (saveConfigs && tryPrepareSave(cmdName)) {
         writeUnmodifiedConfigToEEPROM();
@@ -4320,14 +4349,15 @@ static void cliDefaults(const char *cmdName, char *cmdline)
 
 static void cliPrintVarDefault(const char *cmdName, const clivalue_t *value)
 {
-    const pgRegistry_t *pg = pgFind(value->pgn);
+    const pgRegistry_t *pg = cliFindPg(value->pgn);
     if (pg) {
         const char *defaultFormat = "Default value: ";
         const int valueOffset = getValueOffset(value);
-        const bool equalsDefault = valuePtrEqualsDefault(value, pg->copy + valueOffset, pg->address + valueOffset);
+        const uint8_t *defaults = getDefaultPgConfig(pg);
+        const bool equalsDefault = valuePtrEqualsDefault(value, pg->address + valueOffset, defaults + valueOffset);
         if (!equalsDefault) {
             cliPrintf(defaultFormat, value->name);
-            printValuePointer(cmdName, value, (uint8_t*)pg->address + valueOffset, false);
+            printValuePointer(cmdName, value, defaults + valueOffset, false);
             cliPrintLinefeed();
         }
     }
@@ -4341,8 +4371,6 @@ STATIC_UNIT_TESTED void cliGet(const char *cmdName, char *cmdline)
     pidProfileIndexToUse = getCurrentPidProfileIndex();
     rateProfileIndexToUse = getCurrentControlRateProfileIndex();
 
-    backupAndResetConfigs();
-
     for (uint32_t i = 0; i < valueTableEntryCount; i++) {
         if (strcasestr(valueTable[i].name, cmdline)) {
             val = &valueTable[i];
@@ -4372,8 +4400,6 @@ STATIC_UNIT_TESTED void cliGet(const char *cmdName, char *cmdline)
         }
     }
 
-    restoreConfigs(0);
-
     pidProfileIndexToUse = CURRENT_PROFILE_INDEX;
     rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
 
@@ -4391,19 +4417,54 @@ static uint8_t getWordLength(const char *bufBegin, const char *bufEnd)
     return bufEnd - bufBegin;
 }
 
+// binary search of the name ordered index, valueTable itself is grouped by parameter group
 uint16_t cliGetSettingIndex(const char *name, size_t length)
 {
-    for (uint32_t i = 0; i < valueTableEntryCount; i++) {
-        const char *settingName = valueTable[i].name;
+    int low = 0;
+    int high = valueTableEntryCount - 1;
+    while (low <= high) {
+        const int mid = (low + high) / 2;
+        const char *settingName = valueTable[valueTableNameIndex[mid]].name;
 
+        int cmp = strncasecmp(name, settingName, length);
         // ensure exact match when setting to prevent setting variables with longer names
-        if (strncasecmp(name, settingName, length) == 0 && length == strlen(settingName)) {
-            return i;
+        if (cmp == 0 && settingName[length] != '\0') {
+            cmp = -1;
+        }
+
+        if (cmp == 0) {
+            return valueTableNameIndex[mid];
+        } else if (cmp < 0) {
+            high = mid - 1;
+        } else {
+            low = mid + 1;
         }
     }
     return valueTableEntryCount;
 }
 
+// check the elements of an array setting against its limit before any of them are changed
+static bool cliArrayElementsInRange(const clivalue_t *var, const char *valPtr)
+{
+    if (!var->config.array.max) {
+        return true;
+    }
+
+    for (int i = 0; i < var->config.array.length && valPtr; i++) {
+        const int value = atoi(valPtr);
+        if (value < 0 || value > var->config.array.max) {
+            return false;
+        }
+
+        valPtr = strchr(valPtr, ',');
+        if (valPtr) {
+            valPtr++;
+        }
+    }
+
+    return true;
+}
+
 STATIC_UNIT_TESTED void cliSet(const char *cmdName, char *cmdline)
 {
     const uint32_t len = strlen(cmdline);
@@ -4496,6 +4557,10 @@ STATIC_UNIT_TESTED void cliSet(const char *cmdName, char *cmdline)
                 const uint8_t arrayLength = val->config.array.length;
                 char *valPtr = eqptr;
 
+                if (!cliArrayElementsInRange(val, valPtr)) {
+                    break;
+                }
+
                 int i = 0;
                 while (i < arrayLength && valPtr != NULL) {
                     // skip spaces
@@ -5162,11 +5227,10 @@ static void printResource(dumpFlags_t dumpMask, const char *headingStr)
         const pgRegistry_t* pg = pgFind(resourceTable[i].pgn);
         const void *currentConfig;
         const void *defaultConfig;
-        if (isReadingConfigFromCopy()) {
-            currentConfig = pg->copy;
-            defaultConfig = pg->address;
+        currentConfig = pg->address;
+        if (isComparingWithDefaults()) {
+            defaultConfig = getDefaultPgConfig(pg);
         } else {
-            currentConfig = pg->address;
             defaultConfig = NULL;
         }
 
@@ -5402,11 +5466,10 @@ static const char *printPeripheralDmaopt(dmaoptEntry_t *entry, int index, dumpFl
     const void *currentConfig;
     const void *defaultConfig;
 
-    if (isReadingConfigFromCopy()) {
-        currentConfig = pg->copy;
-        defaultConfig = pg->address;
+    currentConfig = pg->address;
+    if (isComparingWithDefaults()) {
+        defaultConfig = getDefaultPgConfig(pg);
     } else {
-        currentConfig = pg->address;
         defaultConfig = NULL;
     }
 
@@ -5514,11 +5577,10 @@ static void printDmaopt(dumpFlags_t dumpMask, const char *headingStr)
     const timerIOConfig_t *currentConfig;
     const timerIOConfig_t *defaultConfig;
 
-    if (isReadingConfigFromCopy()) {
-        currentConfig = (timerIOConfig_t *)pg->copy;
-        defaultConfig = (timerIOConfig_t *)pg->address;
+    currentConfig = (timerIOConfig_t *)pg->address;
+    if (isComparingWithDefaults()) {
+        defaultConfig = getDefaultPgConfig(pg);
     } else {
-        currentConfig = (timerIOConfig_t *)pg->address;
         defaultConfig = NULL;
     }
 
@@ -5590,12 +5652,7 @@ static void cliDmaopt(const char *cmdName, char *cmdline)
         }
 
         const pgRegistry_t* pg = pgFind(entry->pgn);
-        const void *currentConfig;
-        if (isWritingConfigToCopy()) {
-            currentConfig = pg->copy;
-        } else {
-            currentConfig = pg->address;
-        }
+        const void *currentConfig = pg->address;
         optaddr = (dmaoptValue_t *)((uint8_t *)currentConfig + entry->stride * index + entry->offset);
         orgval = *optaddr;
     } else {
@@ -5748,11 +5805,10 @@ static void printTimer(dumpFlags_t dumpMask, const char *headingStr)
     const timerIOConfig_t *defaultConfig;
 
     headingStr = cliPrintSectionHeading(dumpMask, false, headingStr);
-    if (isReadingConfigFromCopy()) {
-        currentConfig = (timerIOConfig_t *)pg->copy;
-        defaultConfig = (timerIOConfig_t *)pg->address;
+    currentConfig = (timerIOConfig_t *)pg->address;
+    if (isComparingWithDefaults()) {
+        defaultConfig = getDefaultPgConfig(pg);
     } else {
-        currentConfig = (timerIOConfig_t *)pg->address;
         defaultConfig = NULL;
     }
 
@@ -6210,7 +6266,7 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
         dumpMask = dumpMask | BARE;   // show the diff / dump without extra commands and board specific data
     }
 
-    backupAndResetConfigs();
+    configIsDumping = true;
 
 #ifdef USE_CLI_BATCH
     bool batchModeEnabled = false;
@@ -6246,7 +6302,7 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
         }
 
         if (!(dumpMask & HARDWARE_ONLY)) {
-            printCraftName(dumpMask, &pilotConfig_Copy);
+            printCraftName(dumpMask, pilotConfig());
         }
 
 #ifdef USE_RESOURCE_MGMT
@@ -6259,69 +6315,75 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
 #endif
 #endif
 
-        printFeature(dumpMask, featureConfig_Copy.enabledFeatures, featureConfig()->enabledFeatures, "feature");
+        const featureConfig_t *defaultFeatureConfig = getDefaultConfig(PG_FEATURE_CONFIG);
+        printFeature(dumpMask, featureConfig()->enabledFeatures, defaultFeatureConfig->enabledFeatures, "feature");
 
-        printSerial(dumpMask, &serialConfig_Copy, serialConfig(), "serial");
+        printSerial(dumpMask, serialConfig(), getDefaultConfig(PG_SERIAL_CONFIG), "serial");
 
         if (!(dumpMask & HARDWARE_ONLY)) {
 #ifndef USE_QUAD_MIXER_ONLY
             const char *mixerHeadingStr = "mixer";
-            const bool equalsDefault = mixerConfig_Copy.mixerMode == mixerConfig()->mixerMode;
+            const mixerConfig_t *defaultMixerConfig = getDefaultConfig(PG_MIXER_CONFIG);
+            const bool equalsDefault = mixerConfig()->mixerMode == defaultMixerConfig->mixerMode;
             mixerHeadingStr = cliPrintSectionHeading(dumpMask, !equalsDefault, mixerHeadingStr);
             const char *formatMixer = "mixer %s";
-            cliDefaultPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig()->mixerMode - 1]);
-            cliDumpPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig_Copy.mixerMode - 1]);
+            cliDefaultPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[defaultMixerConfig->mixerMode - 1]);
+            cliDumpPrintLinef(dumpMask, equalsDefault, formatMixer, mixerNames[mixerConfig()->mixerMode - 1]);
 
-            cliDumpPrintLinef(dumpMask, customMotorMixer(0)->throttle == 0.0f, "\r\nmmix reset\r\n");
+            const motorMixer_t *defaultCustomMotorMixer = getDefaultConfig(PG_MOTOR_MIXER);
+            cliDumpPrintLinef(dumpMask, defaultCustomMotorMixer[0].throttle == 0.0f, "\r\nmmix reset\r\n");
 
-            printMotorMix(dumpMask, customMotorMixer_CopyArray, customMotorMixer(0), mixerHeadingStr);
+            printMotorMix(dumpMask, customMotorMixer(0), defaultCustomMotorMixer, mixerHeadingStr);
 
 #ifdef USE_SERVOS
-            printServo(dumpMask, servoParams_CopyArray, servoParams(0), "servo");
+            printServo(dumpMask, servoParams(0), getDefaultConfig(PG_SERVO_PARAMS), "servo");
 
             const char *servoMixHeadingStr = "servo mixer";
-            if (!(dumpMask & DO_DIFF) || customServoMixers(0)->rate != 0) {
+            const servoMixer_t *defaultCustomServoMixers = getDefaultConfig(PG_SERVO_MIXER);
+            if (!(dumpMask & DO_DIFF) || defaultCustomServoMixers[0].rate != 0) {
                 cliPrintHashLine(servoMixHeadingStr);
                 cliPrintLine("smix reset\r\n");
                 servoMixHeadingStr = NULL;
             }
-            printServoMix(dumpMask, customServoMixers_CopyArray, customServoMixers(0), servoMixHeadingStr);
+            printServoMix(dumpMask, customServoMixers(0), defaultCustomServoMixers, servoMixHeadingStr);
 #endif
 #endif
 
 #if defined(USE_BEEPER)
-            printBeeper(dumpMask, beeperConfig_Copy.beeper_off_flags, beeperConfig()->beeper_off_flags, "beeper", BEEPER_ALLOWED_MODES, "beeper");
+            const beeperConfig_t *defaultBeeperConfig = getDefaultConfig(PG_BEEPER_CONFIG);
+            printBeeper(dumpMask, beeperConfig()->beeper_off_flags, defaultBeeperConfig->beeper_off_flags, "beeper", BEEPER_ALLOWED_MODES, "beeper");
 
 #if defined(USE_DSHOT)
-            printBeeper(dumpMask, beeperConfig_Copy.dshotBeaconOffFlags, beeperConfig()->dshotBeaconOffFlags, "beacon", DSHOT_BEACON_ALLOWED_MODES, "beacon");
+            printBeeper(dumpMask, beeperConfig()->dshotBeaconOffFlags, defaultBeeperConfig->dshotBeaconOffFlags, "beacon", DSHOT_BEACON_ALLOWED_MODES, "beacon");
 #endif
 #endif // USE_BEEPER
 
-            printMap(dumpMask, &rxConfig_Copy, rxConfig(), "map");
+            printMap(dumpMask, rxConfig(), getDefaultConfig(PG_RX_CONFIG), "map");
 
 #ifdef USE_LED_STRIP_STATUS_MODE
-            printLed(dumpMask, ledStripStatusModeConfig_Copy.ledConfigs, ledStripStatusModeConfig()->ledConfigs, "led");
+            const ledStripStatusModeConfig_t *defaultLedStripStatusModeConfig = getDefaultConfig(PG_LED_STRIP_STATUS_MODE_CONFIG);
+            printLed(dumpMask, ledStripStatusModeConfig()->ledConfigs, defaultLedStripStatusModeConfig->ledConfigs, "led");
 
-            printColor(dumpMask, ledStripStatusModeConfig_Copy.colors, ledStripStatusModeConfig()->colors, "color");
+            printColor(dumpMask, ledStripStatusModeConfig()->colors, defaultLedStripStatusModeConfig->colors, "color");
 
-            printModeColor(dumpMask, &ledStripStatusModeConfig_Copy, ledStripStatusModeConfig(), "mode_color");
+            printModeColor(dumpMask, ledStripStatusModeConfig(), defaultLedStripStatusModeConfig, "mode_color");
 #endif
 
-            printAux(dumpMask, modeActivationConditions_CopyArray, modeActivationConditions(0), "aux");
+            printAux(dumpMask, modeActivationConditions(0), getDefaultConfig(PG_MODE_ACTIVATION_PROFILE), "aux");
 
-            printAdjustmentRange(dumpMask, adjustmentRanges_CopyArray, adjustmentRanges(0), "adjrange");
+            printAdjustmentRange(dumpMask, adjustmentRanges(0), getDefaultConfig(PG_ADJUSTMENT_RANGE_CONFIG), "adjrange");
 
-            printRxRange(dumpMask, rxChannelRangeConfigs_CopyArray, rxChannelRangeConfigs(0), "rxrange");
+            printRxRange(dumpMask, rxChannelRangeConfigs(0), getDefaultConfig(PG_RX_CHANNEL_RANGE_CONFIG), "rxrange");
 
 #ifdef USE_VTX_TABLE
-            printVtxTable(dumpMask, &vtxTableConfig_Copy, vtxTableConfig(), "vtxtable");
+            printVtxTable(dumpMask, vtxTableConfig(), getDefaultConfig(PG_VTX_TABLE_CONFIG), "vtxtable");
 #endif
 
 #ifdef USE_VTX_CONTROL
-            printVtx(dumpMask, &vtxConfig_Copy, vtxConfig(), "vtx");
+            printVtx(dumpMask, vtxConfig(), getDefaultConfig(PG_VTX_CONFIG), "vtx");
 #endif
 
-            printRxFailsafe(dumpMask, rxFailsafeChannelConfigs_CopyArray, rxFailsafeChannelConfigs(0), "rxfail");
+            printRxFailsafe(dumpMask, rxFailsafeChannelConfigs(0), getDefaultConfig(PG_RX_FAILSAFE_CHANNEL_CONFIG), "rxfail");
         }
 
         if (dumpMask & HARDWARE_ONLY) {
@@ -6334,7 +6396,7 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
                     cliDumpPidProfile(cmdName, pidProfileIndex, dumpMask);
                 }
 
-                pidProfileIndexToUse = systemConfig_Copy.pidProfileIndex;
+                pidProfileIndexToUse = systemConfig()->pidProfileIndex;
 
                 if (!(dumpMask & BARE)) {
                     cliPrintHashLine("restore original profile selection");
@@ -6348,7 +6410,7 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
                     cliDumpRateProfile(cmdName, rateIndex, dumpMask);
                 }
 
-                rateProfileIndexToUse = systemConfig_Copy.activeRateProfile;
+                rateProfileIndexToUse = systemConfig()->activeRateProfile;
 
                 if (!(dumpMask & BARE)) {
                     cliPrintHashLine("restore original rateprofile selection");
@@ -6364,15 +6426,15 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
 
                 rateProfileIndexToUse = CURRENT_PROFILE_INDEX;
             } else {
-                cliDumpPidProfile(cmdName, systemConfig_Copy.pidProfileIndex, dumpMask);
+                cliDumpPidProfile(cmdName, systemConfig()->pidProfileIndex, dumpMask);
 
-                cliDumpRateProfile(cmdName, systemConfig_Copy.activeRateProfile, dumpMask);
+                cliDumpRateProfile(cmdName, systemConfig()->activeRateProfile, dumpMask);
             }
         }
     } else if (dumpMask & DUMP_PROFILE) {
-        cliDumpPidProfile(cmdName, systemConfig_Copy.pidProfileIndex, dumpMask);
+        cliDumpPidProfile(cmdName, systemConfig()->pidProfileIndex, dumpMask);
     } else if (dumpMask & DUMP_RATES) {
-        cliDumpRateProfile(cmdName, systemConfig_Copy.activeRateProfile, dumpMask);
+        cliDumpRateProfile(cmdName, systemConfig()->activeRateProfile, dumpMask);
     }
 
 #ifdef USE_CLI_BATCH
@@ -6382,8 +6444,7 @@ static void printConfig(const char *cmdName, char *cmdline, bool doDiff)
     }
 #endif
 
-    // restore configs from copies
-    restoreConfigs(0);
+    configIsDumping = false;
 }
 
 static void cliDump(const char *cmdName, char *cmdline)
@@ -201,7 +201,8 @@ typedef struct cliLookupTableConfig_s {
 } cliLookupTableConfig_t;
 
 typedef struct cliArrayLengthConfig_s {
-    const uint8_t length;
+    const uint8_t max;                        // largest element accepted, 0 for the full range of the type
+    const uint8_t length;                     // last, so .config.array.length can be followed by the pgn in valueTable
 } cliArrayLengthConfig_t;
 
 typedef struct cliStringLengthConfig_s {
@@ -244,6 +245,8 @@ extern const lookupTableEntry_t lookupTables[];
 extern const uint16_t valueTableEntryCount;
 
 extern const clivalue_t valueTable[];
+// valueTable indices ordered by name, generated at build time by src/utils/make_settings_index.sh
+extern const uint16_t valueTableNameIndex[];
 //extern const uint8_t lookupTablesEntryCount;
 
 extern const char * const lookupTableGyroHardware[];
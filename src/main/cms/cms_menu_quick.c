@@ -39,6 +39,7 @@
 
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/rc.h"
 #include "fc/runtime_config.h"
 #include "flight/pid.h"
 #include "flight/pid_init.h"
@@ -83,6 +84,7 @@ static const void *cmsx_RateProfileWriteback(displayPort_t *pDisp, const OSD_Ent
     pidProfile->motor_output_limit = cmsx_motorOutputLimit;
 
     pidInitConfig(currentPidProfile);
+    initRcProcessing();
 
     return NULL;
 }
@@ -58,3 +58,28 @@ void bitArrayCopy(void *array, unsigned from, unsigned to)
         bitArrayClr(array, to);
     }
 }
+
+// Return the index of the first set bit at or after start, or -1 if there is none.
+// size is in bytes and must be a multiple of 4.
+int bitArrayFindFirstSet(const void *array, unsigned start, size_t size)
+{
+    const uint32_t *words = array;
+    const unsigned wordCount = size / sizeof(uint32_t);
+    unsigned wordIndex = start / 32;
+
+    if (wordIndex >= wordCount) {
+        return -1;
+    }
+
+    // Ignore the bits below start in the first word
+    uint32_t word = words[wordIndex] & (0xffffffffU << (start % 32));
+
+    while (!word) {
+        if (++wordIndex >= wordCount) {
+            return -1;
+        }
+        word = words[wordIndex];
+    }
+
+    return wordIndex * 32 + __builtin_ctz(word);
+}
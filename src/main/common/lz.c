@@ -0,0 +1,164 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LZ
+
+#include "common/maths.h"
+
+#include "lz.h"
+
+#define LZ_MIN_MATCH        4
+#define LZ_LAST_LITERALS    5   // the last 5 bytes of a block are always literals
+#define LZ_MF_LIMIT         12  // the last match must start at least 12 bytes before the end of the block
+#define LZ_RUN_MASK         0x0F
+
+static uint32_t lzRead32(const uint8_t *p)
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static unsigned lzHash(uint32_t sequence)
+{
+    return (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+// write an LZ4 length continuation (a run of 255s followed by the remainder)
+static uint8_t *lzWriteLength(uint8_t *op, unsigned length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = length;
+    return op;
+}
+
+static int lzLengthBytes(unsigned length)
+{
+    return (length >= LZ_RUN_MASK) ? (length - LZ_RUN_MASK) / 255 + 1 : 0;
+}
+
+/*
+ * Append one sequence: literals followed by an optional match.
+ * Returns the new output position or NULL if the output buffer would overflow.
+ */
+static uint8_t *lzWriteSequence(uint8_t *op, const uint8_t *opEnd, const uint8_t *literals, unsigned literalLen, unsigned offset, unsigned matchLen)
+{
+    const int needed = 1 + lzLengthBytes(literalLen) + literalLen
+        + (matchLen ? sizeof(uint16_t) + lzLengthBytes(matchLen - LZ_MIN_MATCH) : 0);
+    if (op + needed > opEnd) {
+        return NULL;
+    }
+
+    uint8_t *token = op++;
+    *token = MIN(literalLen, (unsigned)LZ_RUN_MASK) << 4;
+    if (literalLen >= LZ_RUN_MASK) {
+        op = lzWriteLength(op, literalLen - LZ_RUN_MASK);
+    }
+    memcpy(op, literals, literalLen);
+    op += literalLen;
+
+    if (matchLen) {
+        *op++ = offset & 0xff;
+        *op++ = offset >> 8;
+        matchLen -= LZ_MIN_MATCH;
+        *token |= MIN(matchLen, (unsigned)LZ_RUN_MASK);
+        if (matchLen >= LZ_RUN_MASK) {
+            op = lzWriteLength(op, matchLen - LZ_RUN_MASK);
+        }
+    }
+
+    return op;
+}
+
+/*
+ * Compress inBuf into a single LZ4 block.
+ * Returns the number of bytes written to outBuf, or -1 if outBuf is too small.
+ */
+int lzCompressBlock(lzState_t *state, uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen)
+{
+    if (inLen > LZ_BLOCK_SIZE_MAX) {
+        return -1;
+    }
+
+    uint8_t *op = outBuf;
+    const uint8_t * const opEnd = outBuf + outBufLen;
+
+    // positions of stale entries are harmless, every candidate is verified before use
+    memset(state->hashTable, 0, sizeof(state->hashTable));
+
+    int anchor = 0;
+    if (inLen > LZ_MF_LIMIT) {
+        const int matchLimit = inLen - LZ_LAST_LITERALS;
+        const int mfLimit = inLen - LZ_MF_LIMIT;
+
+        int ip = 0;
+        while (ip < mfLimit) {
+            const uint32_t sequence = lzRead32(inBuf + ip);
+            const unsigned hash = lzHash(sequence);
+            int candidate = state->hashTable[hash];
+            state->hashTable[hash] = ip;
+
+            if (candidate >= ip || lzRead32(inBuf + candidate) != sequence) {
+                ip++;
+                continue;
+            }
+
+            // extend the match backwards into the pending literals
+            while (ip > anchor && candidate > 0 && inBuf[ip - 1] == inBuf[candidate - 1]) {
+                ip--;
+                candidate--;
+            }
+
+            int matchLen = LZ_MIN_MATCH;
+            while (ip + matchLen < matchLimit && inBuf[candidate + matchLen] == inBuf[ip + matchLen]) {
+                matchLen++;
+            }
+
+            op = lzWriteSequence(op, opEnd, inBuf + anchor, ip - anchor, ip - candidate, matchLen);
+            if (!op) {
+                return -1;
+            }
+
+            ip += matchLen;
+            anchor = ip;
+
+            // keep the table populated for the position just before the next search starts
+            if (ip - 2 < mfLimit) {
+                state->hashTable[lzHash(lzRead32(inBuf + ip - 2))] = ip - 2;
+            }
+        }
+    }
+
+    op = lzWriteSequence(op, opEnd, inBuf + anchor, inLen - anchor, 0, 0);
+    if (!op) {
+        return -1;
+    }
+
+    return op - outBuf;
+}
+
+#endif
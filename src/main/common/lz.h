@@ -0,0 +1,40 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Small LZ77 compressor producing raw LZ4 blocks, so any LZ4 block decoder can unpack the output.
+ *
+ * Matches are only searched for within the block being compressed, the working RAM is the
+ * hash table of previous positions in lzState_t.
+ */
+
+#define LZ_HASH_BITS        8
+#define LZ_HASH_SIZE        (1 << LZ_HASH_BITS)
+#define LZ_BLOCK_SIZE_MAX   UINT16_MAX
+
+typedef struct lzState_s {
+    uint16_t    hashTable[LZ_HASH_SIZE];
+} lzState_t;
+
+int lzCompressBlock(lzState_t *state, uint8_t *outBuf, int outBufLen, const uint8_t *inBuf, int inLen);
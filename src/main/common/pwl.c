@@ -30,6 +30,7 @@ void pwlInitialize(pwl_t *pwl, float *yValues, int numPoints, float xMin, float
     pwl->xMin = xMin;
     pwl->xMax = xMax;
     pwl->dx = (xMax - xMin) / (numPoints - 1);
+    pwl->invDx = (numPoints - 1) / (xMax - xMin);
 }
 
 void pwlFill(pwl_t *pwl, float (*function)(float, void*), void *args)
@@ -40,7 +41,7 @@ void pwlFill(pwl_t *pwl, float (*function)(float, void*), void *args)
     }
 }
 
-float pwlInterpolate(const pwl_t *pwl, float x)
+FAST_CODE_NOINLINE float pwlInterpolate(const pwl_t *pwl, float x)
 {
     if (x <= pwl->xMin) {
         return pwl->yValues[0];
@@ -50,14 +51,14 @@ float pwlInterpolate(const pwl_t *pwl, float x)
         return pwl->yValues[pwl->numPoints - 1];
     }
     
-    const int index = (int)((x - pwl->xMin) / pwl->dx);
+    const float position = (x - pwl->xMin) * pwl->invDx;
+    const int index = (int)position;
     if (index >= pwl->numPoints - 1) {
         return pwl->yValues[pwl->numPoints - 1];
     }
 
-    const float x0 = pwl->xMin + index * pwl->dx;
     const float y0 = pwl->yValues[index];
     const float y1 = pwl->yValues[index + 1];
 
-    return y0 + (x - x0) * (y1 - y0) / pwl->dx;
+    return y0 + (position - index) * (y1 - y0);
 }
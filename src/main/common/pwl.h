@@ -23,18 +23,20 @@
 
 #include "utils.h"
 
+#define PWL_MAX_POINTS 129
 
 #define PWL_DECLARE(name, size, xMinV, xMaxV)                           \
     STATIC_ASSERT((xMinV) < (xMaxV), "xMinV must be less than xMaxV");  \
     STATIC_ASSERT((size) > 1, "size must be more than 1");              \
-    STATIC_ASSERT((size) < 33, "size must be less than 33");            \
+    STATIC_ASSERT((size) <= PWL_MAX_POINTS, "size too large");          \
     float name##_yValues[(size)];                                       \
     pwl_t name = {                                                      \
         .yValues = name##_yValues,                                      \
         .numPoints = (size),                                            \
         .xMin = (xMinV),                                                \
         .xMax = (xMaxV),                                                \
-        .dx = ((xMaxV) - (xMinV)) / ((size) - 1)                        \
+        .dx = ((xMaxV) - (xMinV)) / ((size) - 1),                       \
+        .invDx = ((size) - 1) / ((xMaxV) - (xMinV))                     \
     }
 
 typedef struct pwl_s {
@@ -43,6 +45,7 @@ typedef struct pwl_s {
     float xMin;
     float xMax;
     float dx;
+    float invDx;
 } pwl_t;
 
 void pwlInitialize(pwl_t *pwl, float *yValues, int numPoints, float xMin, float xMax);
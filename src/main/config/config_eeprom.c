@@ -43,6 +43,24 @@
 
 static uint16_t eepromConfigSize;
 
+// Changed PGs are appended after the saved copy as a log of records. Each record carries the generation
+// of the saved copy, which is incremented by every rewrite, and is followed by a CRC seeded with the CRC
+// of the saved copy, so records left over from an older copy are never replayed.
+// The whole config area is only rewritten (compacted) when the log no longer fits.
+// External flash needs page programming to start on a page boundary, so it always rewrites.
+#if !defined(CONFIG_IN_EXTERNAL_FLASH)
+#define USE_CONFIG_LOG
+#endif
+
+#define CONFIG_LOG_ALIGN(size) (((size) + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE)
+// space taken in the log by a record of recordSize, including the generation and the CRC
+#define CONFIG_LOG_ENTRY_SIZE(recordSize) CONFIG_LOG_ALIGN(sizeof(uint16_t) + (recordSize) + sizeof(uint16_t))
+
+static const uint8_t *configLogStart;
+static const uint8_t *configLogEnd;
+static uint16_t configLogCrcSeed;
+static uint16_t configLogGeneration;
+
 typedef enum {
     CR_CLASSICATION_SYSTEM   = 0,
     CR_CLASSICATION_PROFILE_LAST = CR_CLASSICATION_SYSTEM,
@@ -56,6 +74,7 @@ typedef enum {
 typedef struct {
     uint8_t eepromConfigVersion;
     uint8_t magic_be;           // magic number, should be 0xBE
+    uint16_t generation;        // incremented every time the saved copy is rewritten
 } PG_PACKED configHeader_t;
 
 // Header for each stored PG.
@@ -71,6 +90,12 @@ typedef struct {
     uint8_t pg[];
 } PG_PACKED configRecord_t;
 
+// Header for each PG appended to the log, the record is followed by a CRC.
+typedef struct {
+    uint16_t generation;        // generation of the saved copy the record belongs to
+    configRecord_t record;
+} PG_PACKED configLogRecord_t;
+
 // Footer for the saved copy.
 typedef struct {
     uint16_t terminator;
@@ -300,6 +325,7 @@ void initEEPROM(void)
 
     STATIC_ASSERT(sizeof(configFooter_t) == 2, footer_size_failed);
     STATIC_ASSERT(sizeof(configRecord_t) == 6, record_size_failed);
+    STATIC_ASSERT(sizeof(configLogRecord_t) == 8, log_record_size_failed);
 
 #if defined(CONFIG_IN_FILE)
     loadEEPROMFromFile();
@@ -318,6 +344,31 @@ void initEEPROM(void)
 #endif
 }
 
+#ifdef USE_CONFIG_LOG
+// Returns the record of the log entry at p, or NULL if p is past the end of the log.
+static const configRecord_t *findConfigLogRecord(const uint8_t *p)
+{
+    const configLogRecord_t *logRecord = (const configLogRecord_t *)p;
+    const size_t remaining = &__config_end - p;
+
+    if (remaining < sizeof(*logRecord) + sizeof(uint16_t)
+        || logRecord->generation != configLogGeneration
+        || logRecord->record.size < sizeof(logRecord->record)
+        || logRecord->record.size > remaining - sizeof(logRecord->generation) - sizeof(uint16_t)) {
+        return NULL;
+    }
+
+    const size_t length = sizeof(logRecord->generation) + logRecord->record.size;
+    uint16_t storedCrc;
+    memcpy(&storedCrc, p + length, sizeof(storedCrc));
+    if (crc16_ccitt_update(configLogCrcSeed, p, length) != storedCrc) {
+        return NULL;
+    }
+
+    return &logRecord->record;
+}
+#endif
+
 bool isEEPROMVersionValid(void)
 {
     const uint8_t *p = &__config_start;
@@ -369,12 +420,27 @@ bool isEEPROMStructureValid(void)
     // include stored CRC in the CRC calculation
     const uint16_t *storedCrc = (const uint16_t *)p;
     crc = crc16_ccitt_update(crc, storedCrc, sizeof(*storedCrc));
-    p += sizeof(storedCrc);
-
-    eepromConfigSize = p - &__config_start;
+    p += sizeof(*storedCrc);
 
     // CRC has the property that if the CRC itself is included in the calculation the resulting CRC will have constant value
-    return crc == CRC_CHECK_VALUE;
+    if (crc != CRC_CHECK_VALUE) {
+        return false;
+    }
+
+    // the log starts at the next write boundary after the saved copy
+    configLogStart = &__config_start + CONFIG_LOG_ALIGN(p - &__config_start);
+    configLogCrcSeed = *storedCrc;
+    configLogGeneration = header->generation;
+    configLogEnd = configLogStart;
+#ifdef USE_CONFIG_LOG
+    for (const configRecord_t *record; (record = findConfigLogRecord(configLogEnd)); ) {
+        configLogEnd += CONFIG_LOG_ENTRY_SIZE(record->size);
+    }
+#endif
+
+    eepromConfigSize = configLogEnd - &__config_start;
+
+    return true;
 }
 
 uint16_t getEEPROMConfigSize(void)
@@ -396,11 +462,12 @@ size_t getEEPROMStorageSize(void)
 #endif
 }
 
-// find config record for reg + classification (profile info) in EEPROM
+// find config record for reg + classification (profile info) in EEPROM, the saved copy is overridden by the log
 // return NULL when record is not found
 // this function assumes that EEPROM content is valid
 static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFlags_e classification)
 {
+    const configRecord_t *found = NULL;
     const uint8_t *p = &__config_start;
     p += sizeof(configHeader_t);             // skip header
     while (true) {
@@ -410,12 +477,26 @@ static const configRecord_t *findEEPROM(const pgRegistry_t *reg, configRecordFla
             || record->size < sizeof(*record))
             break;
         if (pgN(reg) == record->pgn
-            && (record->flags & CR_CLASSIFICATION_MASK) == classification)
-            return record;
+            && (record->flags & CR_CLASSIFICATION_MASK) == classification) {
+            found = record;
+            break;
+        }
         p += record->size;
     }
-    // record not found
-    return NULL;
+
+#ifdef USE_CONFIG_LOG
+    // later records in the log replace earlier ones
+    for (p = configLogStart; p < configLogEnd; ) {
+        const configRecord_t *record = &((const configLogRecord_t *)p)->record;
+        p += CONFIG_LOG_ENTRY_SIZE(record->size);
+        if (pgN(reg) == record->pgn
+            && (record->flags & CR_CLASSIFICATION_MASK) == classification) {
+            found = record;
+        }
+    }
+#endif
+
+    return found;
 }
 
 // Initialize all PG records from EEPROM.
@@ -443,21 +524,108 @@ bool loadEEPROM(void)
     return success;
 }
 
+static bool isPgDirty(const pgRegistry_t *reg)
+{
+    return *reg->fnv_hash != fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg));
+}
+
+#ifdef USE_CONFIG_LOG
+// Appending is only possible into erased memory. Embedded flash is erased a page at a time
+// by the streamer when it reaches the start of a page, anything else has to be erased already.
+static bool isConfigLogSpaceErased(const uint8_t *p, size_t length)
+{
+#if defined(CONFIG_IN_FLASH)
+    for (; length > 0; p++, length--) {
+        if ((uintptr_t)p % FLASH_PAGE_SIZE == 0) {
+            break;
+        }
+        if (*p != 0xFF) {
+            return false;
+        }
+    }
+#else
+    UNUSED(p);
+    UNUSED(length);
+#endif
+    return true;
+}
+
+// Append the changed PGs to the log, returns false if they do not fit and the config has to be rewritten.
+static bool appendSettingsToEEPROM(bool *success)
+{
+    size_t length = 0;
+    PG_FOREACH(reg) {
+        if (isPgDirty(reg)) {
+            length += CONFIG_LOG_ENTRY_SIZE(sizeof(configRecord_t) + pgSize(reg));
+        }
+    }
+
+    if (length > (size_t)(&__config_end - configLogEnd) || !isConfigLogSpaceErased(configLogEnd, length)) {
+        return false;
+    }
+
+    config_streamer_t streamer;
+    config_streamer_init(&streamer);
+
+    config_streamer_start(&streamer, (uintptr_t)configLogEnd, &__config_end - configLogEnd);
+
+    PG_FOREACH(reg) {
+        if (!isPgDirty(reg)) {
+            continue;
+        }
+
+        const uint16_t regSize = pgSize(reg);
+        const configLogRecord_t logRecord = {
+            .generation = configLogGeneration,
+            .record = {
+                .size = sizeof(configRecord_t) + regSize,
+                .pgn = pgN(reg),
+                .version = pgVersion(reg),
+                .flags = CR_CLASSICATION_SYSTEM,
+            },
+        };
+
+        config_streamer_write(&streamer, (uint8_t *)&logRecord, sizeof(logRecord));
+        uint16_t crc = crc16_ccitt_update(configLogCrcSeed, (uint8_t *)&logRecord, sizeof(logRecord));
+        config_streamer_write(&streamer, reg->address, regSize);
+        crc = crc16_ccitt_update(crc, reg->address, regSize);
+        config_streamer_write(&streamer, (uint8_t *)&crc, sizeof(crc));
+
+        // each record starts on a write boundary
+        config_streamer_flush(&streamer);
+    }
+
+    *success = (config_streamer_finish(&streamer) == 0);
+
+    return true;
+}
+#endif
+
 static bool writeSettingsToEEPROM(void)
 {
-    bool dirtyConfig = !isEEPROMVersionValid() || !isEEPROMStructureValid();
+    const bool validConfig = isEEPROMVersionValid() && isEEPROMStructureValid();
+    bool dirtyConfig = !validConfig;
 
     configHeader_t header = {
         .eepromConfigVersion =  EEPROM_CONF_VERSION,
         .magic_be =             0xBE,
+        // records appended to the copy being replaced must not match the new one
+        .generation =           ((const configHeader_t *)&__config_start)->generation + 1,
     };
 
     PG_FOREACH(reg) {
-        if (*reg->fnv_hash != fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg))) {
+        if (isPgDirty(reg)) {
             dirtyConfig = true;
         }
     }
 
+#ifdef USE_CONFIG_LOG
+    bool success;
+    if (dirtyConfig && validConfig && appendSettingsToEEPROM(&success)) {
+        return success;
+    }
+#endif
+
     // Only write the config if it has changed
     if (dirtyConfig) {
         config_streamer_t streamer;
@@ -525,6 +693,10 @@ void writeConfigToEEPROM(void)
 
 
     if (success && isEEPROMVersionValid() && isEEPROMStructureValid()) {
+        // the stored config now matches memory, only later changes need to be appended
+        PG_FOREACH(reg) {
+            *reg->fnv_hash = fnv_update(FNV_OFFSET_BASIS, reg->address, pgSize(reg));
+        }
         return;
     }
 
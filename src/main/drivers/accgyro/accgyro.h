@@ -103,7 +103,7 @@ typedef struct gyroDev_s {
     extDevice_t dev;
     float scale;                                             // scalefactor
     float gyroZero[XYZ_AXIS_COUNT];
-    float gyroADC[XYZ_AXIS_COUNT];                           // gyro data after calibration and alignment
+    float gyroADC[XYZ_AXIS_COUNT];                           // gyro data after calibration, alignment and scaling, in deg/s
     int32_t gyroADCRawPrevious[XYZ_AXIS_COUNT];
     int16_t gyroADCRaw[XYZ_AXIS_COUNT];                      // raw data from sensor
     int16_t temperature;
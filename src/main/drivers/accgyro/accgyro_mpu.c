@@ -376,7 +376,7 @@ static gyroSpiDetectFn_t gyroSpiDetectFnTable[] = {
     NULL // Avoid an empty array
 };
 
-static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro, const gyroDeviceConfig_t *config)
+static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro, const gyroDeviceConfig_t *config, const mpuDetectionResult_t *previousResult)
 {
     if (!config->csnTag || !spiSetBusInstance(&gyro->dev, config->spiBus)) {
         return false;
@@ -397,17 +397,38 @@ static bool detectSPISensorsAndUpdateDetectionResult(gyroDev_t *gyro, const gyro
 
     // It is hard to use hardware to optimize the detection loop here,
     // as hardware type and detection function name doesn't match.
-    // May need a bitmap of hardware to detection function to do it right?
+    // Instead the detection function which found the sensor on a previous boot is tried on its own first,
+    // and only if it no longer finds the same sensor are all of them tried in turn.
 
-    for (size_t index = 0 ; gyroSpiDetectFnTable[index] ; index++) {
-        uint8_t sensor = (gyroSpiDetectFnTable[index])(&gyro->dev);
-        if (sensor != MPU_NONE) {
-            gyro->mpuDetectionResult.sensor = sensor;
-            busDeviceRegister(&gyro->dev);
-            return true;
+    size_t index = 0;
+    uint8_t sensor = MPU_NONE;
+
+    if (previousResult && previousResult->sensor != MPU_NONE && previousResult->spiDetectIndex < ARRAYLEN(gyroSpiDetectFnTable) - 1) {
+        index = previousResult->spiDetectIndex;
+        sensor = (gyroSpiDetectFnTable[index])(&gyro->dev);
+        if (sensor != previousResult->sensor) {
+            sensor = MPU_NONE;
         }
     }
 
+    if (sensor == MPU_NONE) {
+        for (index = 0 ; gyroSpiDetectFnTable[index] ; index++) {
+            sensor = (gyroSpiDetectFnTable[index])(&gyro->dev);
+            if (sensor != MPU_NONE) {
+                break;
+            }
+        }
+    }
+
+    if (sensor != MPU_NONE) {
+        gyro->mpuDetectionResult.sensor = sensor;
+        gyro->mpuDetectionResult.spiDetectIndex = index;
+        busDeviceRegister(&gyro->dev);
+        // Gyro reads preempt flash and OSD transfers sharing the bus
+        spiSetPriority(&gyro->dev, BUS_PRIORITY_HIGH);
+        return true;
+    }
+
     // Detection failed, disable CS pin again
 
     spiPreinitByTag(config->csnTag);
@@ -425,7 +446,7 @@ void mpuPreInit(const struct gyroDeviceConfig_s *config)
 #endif
 }
 
-bool mpuDetect(gyroDev_t *gyro, const gyroDeviceConfig_t *config)
+bool mpuDetect(gyroDev_t *gyro, const gyroDeviceConfig_t *config, const mpuDetectionResult_t *previousResult)
 {
     static busDevice_t bus;
     gyro->dev.bus = &bus;
@@ -477,8 +498,10 @@ bool mpuDetect(gyroDev_t *gyro, const gyroDeviceConfig_t *config)
 #ifdef USE_SPI_GYRO
     gyro->dev.bus->busType = BUS_TYPE_SPI;
 
-    return detectSPISensorsAndUpdateDetectionResult(gyro, config);
+    return detectSPISensorsAndUpdateDetectionResult(gyro, config, previousResult);
 #else
+    UNUSED(previousResult);
+
     return false;
 #endif
 }
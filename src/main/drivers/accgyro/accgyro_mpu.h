@@ -216,6 +216,7 @@ typedef enum {
 typedef struct mpuDetectionResult_s {
     mpuSensor_e sensor;
     mpu6050Resolution_e resolution;
+    uint8_t spiDetectIndex; // entry of the SPI detection table which found the sensor
 } mpuDetectionResult_t;
 
 struct gyroDev_s;
@@ -224,7 +225,7 @@ void mpuGyroInit(struct gyroDev_s *gyro);
 bool mpuGyroRead(struct gyroDev_s *gyro);
 bool mpuGyroReadSPI(struct gyroDev_s *gyro);
 void mpuPreInit(const struct gyroDeviceConfig_s *config);
-bool mpuDetect(struct gyroDev_s *gyro, const struct gyroDeviceConfig_s *config);
+bool mpuDetect(struct gyroDev_s *gyro, const struct gyroDeviceConfig_s *config, const mpuDetectionResult_t *previousResult);
 uint8_t mpuGyroDLPF(struct gyroDev_s *gyro);
 uint8_t mpuGyroReadRegister(const extDevice_t *dev, uint8_t reg);
 
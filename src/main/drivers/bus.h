@@ -42,7 +42,15 @@ typedef enum {
     BUS_ABORT
 } busStatus_e;
 
+// Order in which the transfers of devices sharing a bus are made
+typedef enum {
+    BUS_PRIORITY_LOW = -1,  // Bulk transfers, kept short when sharing the bus with a higher priority device
+    BUS_PRIORITY_NORMAL = 0,
+    BUS_PRIORITY_HIGH = 1,  // Takes over the bus as soon as chip select of the current transfer is negated
+} busPriority_e;
+
 struct extDevice_s;
+struct busSegment_s;
 
 // Bus interface, independent of connected device
 typedef struct busDevice_s {
@@ -76,6 +84,11 @@ typedef struct busDevice_s {
 #endif // UNIT_TEST
     volatile struct busSegment_s* volatile curSegment;
     bool initSegment;
+    // Highest priority of the devices registered on the bus, low until one is
+    busPriority_e maxPriority;
+    // High priority transfer waiting for the current one to negate chip select
+    const struct extDevice_s *preemptDev;
+    struct busSegment_s *preemptSegments;
 } busDevice_t;
 
 // External device has an associated bus and bus dependent address
@@ -106,6 +119,7 @@ typedef struct extDevice_s {
 #endif // UNIT_TEST
     // Support disabling DMA on a per device basis
     bool useDMA;
+    busPriority_e priority;
     // Per device buffer reference if needed
     uint8_t *txBuf, *rxBuf;
     // Connected devices on the same bus may support different speeds
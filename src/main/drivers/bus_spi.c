@@ -26,11 +26,14 @@
 
 #include "build/atomic.h"
 
+#include "common/maths.h"
+
 #ifdef USE_SPI
 
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
 #include "drivers/bus_spi_impl.h"
+#include "drivers/bus_spi_queue.h"
 #include "drivers/dma_reqmap.h"
 #include "drivers/exti.h"
 #include "drivers/io.h"
@@ -406,6 +409,9 @@ FAST_IRQ_HANDLER static void spiIrqHandler(const extDevice_t *dev)
 {
     busDevice_t *bus = dev->bus;
     busSegment_t *nextSegment;
+    const extDevice_t *nextDev;
+    // Another transfer may take over the bus only once chip select is negated
+    const bool preemptible = bus->curSegment->negateCS;
 
     if (bus->curSegment->callback) {
         switch(bus->curSegment->callback(dev->callbackArg)) {
@@ -437,19 +443,14 @@ FAST_IRQ_HANDLER static void spiIrqHandler(const extDevice_t *dev)
     nextSegment = (busSegment_t *)bus->curSegment + 1;
 
     if (nextSegment->len == 0) {
-        // If a following transaction has been linked, start it
-        if (nextSegment->u.link.dev) {
-            const extDevice_t *nextDev = nextSegment->u.link.dev;
-            busSegment_t *nextSegments = (busSegment_t *)nextSegment->u.link.segments;
-            // The end of the segment list has been reached
-            bus->curSegment = nextSegments;
-            nextSegment->u.link.dev = NULL;
-            nextSegment->u.link.segments = NULL;
+        // The end of the segment list has been reached, start the next transaction if there is one
+        nextDev = spiQueueNext(bus, nextSegment);
+        if (nextDev) {
             spiSequenceStart(nextDev);
-        } else {
-            // The end of the segment list has been reached, so mark transactions as complete
-            bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
         }
+    } else if (preemptible && (nextDev = spiQueuePreempt(bus, dev, nextSegment))) {
+        // A higher priority transaction takes over, the rest of this one follows it
+        spiSequenceStart(nextDev);
     } else {
         // Do as much processing as possible before asserting CS to avoid violating minimum high time
         bool negateCS = bus->curSegment->negateCS;
@@ -563,6 +564,7 @@ bool spiSetBusInstance(extDevice_t *dev, uint32_t device)
     bus->busType = BUS_TYPE_SPI;
     bus->useDMA = false;
     bus->deviceCount = 1;
+    spiQueueInit(bus);
     bus->initTx = &dev->initTx;
     bus->initRx = &dev->initRx;
 
@@ -715,6 +717,20 @@ void spiSetClkPhasePolarity(const extDevice_t *dev, bool leadingEdge)
     ((extDevice_t *)dev)->busType_u.spi.leadingEdge = leadingEdge;
 }
 
+// Set the priority of the device's transfers over others on the same bus. Normal by default.
+void spiSetPriority(const extDevice_t *dev, busPriority_e priority)
+{
+    ((extDevice_t *)dev)->priority = priority;
+    spiQueueRegisterPriority(dev->bus, priority);
+}
+
+// Longest transfer a device should make holding chip select, so that a higher priority device on the same bus
+// waits no more than SPI_LOW_PRIORITY_TRANSFER_US
+uint32_t spiTransferLimit(const extDevice_t *dev, uint32_t length)
+{
+    return spiQueueTransferLimit(dev, spiCalculateClock(dev->busType_u.spi.speed), length);
+}
+
 // Enable/disable DMA on a specific device. Enabled by default.
 void spiDmaEnable(const extDevice_t *dev, bool enable)
 {
@@ -734,7 +750,8 @@ bool spiUseSDO_DMA(const extDevice_t *dev)
 
 void spiBusDeviceRegister(const extDevice_t *dev)
 {
-    UNUSED(dev);
+    // Low priority devices sharing the bus now have something to give way to
+    spiQueueRegisterPriority(dev->bus, dev->priority);
 
     spiRegisteredDeviceCount++;
 }
@@ -769,42 +786,9 @@ void spiSequence(const extDevice_t *dev, busSegment_t *segments)
 
     ATOMIC_BLOCK(NVIC_PRIO_MAX) {
         if (spiIsBusy(dev)) {
-            busSegment_t *endSegment;
-
-            // Defer this transfer to be triggered upon completion of the current transfer
-
-            // Find the last segment of the new transfer
-            for (endSegment = segments; endSegment->len; endSegment++);
-
-            // Safe to discard the volatile qualifier as we're in an atomic block
-            busSegment_t *endCmpSegment = (busSegment_t *)bus->curSegment;
-
-            if (endCmpSegment) {
-                while (true) {
-                    // Find the last segment of the current transfer
-                    for (; endCmpSegment->len; endCmpSegment++);
-
-                    if (endCmpSegment == endSegment) {
-                        /* Attempt to use the new segment list twice in the same queue. Abort.
-                         * Note that this can only happen with non-blocking transfers so drivers must take
-                         * care to avoid this.
-                         * */
-                        return;
-                    }
-
-                    if (endCmpSegment->u.link.dev == NULL) {
-                        // End of the segment list queue reached
-                        break;
-                    } else {
-                        // Follow the link to the next queued segment list
-                        endCmpSegment = (busSegment_t *)endCmpSegment->u.link.segments;
-                    }
-                }
-
-                // Record the dev and segments parameters in the terminating segment entry
-                endCmpSegment->u.link.dev = dev;
-                endCmpSegment->u.link.segments = segments;
-            }
+            // Defer this transfer to be triggered upon completion of the current transfer, or at the
+            // next chip select negation if of high priority
+            spiQueueSegments(bus, dev, segments);
 
             return;
         } else {
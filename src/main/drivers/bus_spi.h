@@ -123,6 +123,10 @@ void spiSetClkDivisor(const extDevice_t *dev, uint16_t divider);
 void spiSetClkPhasePolarity(const extDevice_t *dev, bool leadingEdge);
 // Enable/disable DMA on a specific device. Enabled by default.
 void spiDmaEnable(const extDevice_t *dev, bool enable);
+// Set the priority of the device's transfers over others on the same bus. Normal by default.
+void spiSetPriority(const extDevice_t *dev, busPriority_e priority);
+// Limit a transfer holding chip select to what a higher priority device on the same bus can wait for
+uint32_t spiTransferLimit(const extDevice_t *dev, uint32_t length);
 
 // DMA transfer setup and start
 void spiSequence(const extDevice_t *dev, busSegment_t *segments);
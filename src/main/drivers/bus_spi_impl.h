@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "drivers/bus_spi_queue.h"
+
 #define SPI_TIMEOUT_US  10000
 
 #if defined(STM32F4) || defined(STM32G4)
@@ -32,8 +34,6 @@
 #error Unknown MCU family
 #endif
 
-#define BUS_SPI_FREE   0x0
-
 typedef struct spiPinDef_s {
     ioTag_t pin;
 #if defined(STM32F7) || defined(STM32H7) || defined(STM32G4) || defined(AT32F4)
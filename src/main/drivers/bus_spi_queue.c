@@ -0,0 +1,186 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_SPI
+
+#include "common/maths.h"
+
+#include "drivers/bus.h"
+#include "drivers/bus_spi_queue.h"
+
+/*
+ * Transfers are lists of segments, each list ending in a zero length segment which links to the next transfer
+ * on the bus. A transfer is queued behind those of the same or higher priority, and the first high priority
+ * transfer to arrive while the bus is busy is held aside to take over at the next chip select negation. The rest
+ * of the transfer it interrupts is linked to run after it.
+ */
+
+static busSegment_t *spiQueueEndSegment(busSegment_t *segments)
+{
+    for (; segments->len; segments++);
+
+    return segments;
+}
+
+// Find the terminating segment of the last of a chain of linked transfers
+static busSegment_t *spiQueueChainEnd(busSegment_t *segments)
+{
+    busSegment_t *endSegment = spiQueueEndSegment(segments);
+
+    while (endSegment->u.link.dev) {
+        endSegment = spiQueueEndSegment((busSegment_t *)endSegment->u.link.segments);
+    }
+
+    return endSegment;
+}
+
+static bool spiQueueContains(busSegment_t *segments, const busSegment_t *endSegment)
+{
+    while (segments) {
+        busSegment_t *checkSegment = spiQueueEndSegment(segments);
+
+        if (checkSegment == endSegment) {
+            return true;
+        }
+
+        segments = checkSegment->u.link.dev ? (busSegment_t *)checkSegment->u.link.segments : NULL;
+    }
+
+    return false;
+}
+
+void spiQueueSegments(busDevice_t *bus, const extDevice_t *dev, busSegment_t *segments)
+{
+    busSegment_t *endSegment = spiQueueEndSegment(segments);
+
+    /* Attempt to use the new segment list twice in the same queue. Abort.
+     * Note that this can only happen with non-blocking transfers so drivers must take
+     * care to avoid this.
+     */
+    if (spiQueueContains((busSegment_t *)bus->curSegment, endSegment) || spiQueueContains(bus->preemptSegments, endSegment)) {
+        return;
+    }
+
+    if (dev->priority >= BUS_PRIORITY_HIGH && !bus->preemptDev) {
+        bus->preemptDev = dev;
+        bus->preemptSegments = segments;
+        return;
+    }
+
+    // Pass queued transfers of lower priority, but never split transfers which keep chip select asserted
+    busSegment_t *insertSegment = spiQueueEndSegment((busSegment_t *)bus->curSegment);
+
+    while (insertSegment->u.link.dev) {
+        if (insertSegment->u.link.dev->priority < dev->priority && insertSegment[-1].negateCS) {
+            break;
+        }
+        insertSegment = spiQueueEndSegment((busSegment_t *)insertSegment->u.link.segments);
+    }
+
+    busSegment_t *chainEnd = spiQueueChainEnd(segments);
+
+    chainEnd->u.link.dev = insertSegment->u.link.dev;
+    chainEnd->u.link.segments = insertSegment->u.link.segments;
+    insertSegment->u.link.dev = dev;
+    insertSegment->u.link.segments = segments;
+}
+
+const extDevice_t *spiQueuePreempt(busDevice_t *bus, const extDevice_t *dev, busSegment_t *nextSegment)
+{
+    const extDevice_t *preemptDev = bus->preemptDev;
+
+    if (!preemptDev || preemptDev->priority <= dev->priority) {
+        return NULL;
+    }
+
+    // Resume the interrupted transfer once the preempting one completes
+    busSegment_t *chainEnd = spiQueueChainEnd(bus->preemptSegments);
+
+    chainEnd->u.link.dev = dev;
+    chainEnd->u.link.segments = nextSegment;
+
+    bus->curSegment = bus->preemptSegments;
+    bus->preemptDev = NULL;
+    bus->preemptSegments = NULL;
+
+    return preemptDev;
+}
+
+const extDevice_t *spiQueueNext(busDevice_t *bus, busSegment_t *endSegment)
+{
+    const extDevice_t *nextDev = endSegment->u.link.dev;
+    busSegment_t *nextSegments = (busSegment_t *)endSegment->u.link.segments;
+
+    endSegment->u.link.dev = NULL;
+    endSegment->u.link.segments = NULL;
+
+    /* A high priority transfer held aside goes ahead of those queued, unless chip select is still asserted for
+     * the transfer linked after this one. With nothing linked the bus would be free, so it starts regardless.
+     */
+    if (bus->preemptDev && (endSegment[-1].negateCS || !nextDev)) {
+        busSegment_t *chainEnd = spiQueueChainEnd(bus->preemptSegments);
+
+        chainEnd->u.link.dev = nextDev;
+        chainEnd->u.link.segments = nextSegments;
+
+        nextDev = bus->preemptDev;
+        nextSegments = bus->preemptSegments;
+        bus->preemptDev = NULL;
+        bus->preemptSegments = NULL;
+    }
+
+    bus->curSegment = nextDev ? nextSegments : (busSegment_t *)BUS_SPI_FREE;
+
+    return nextDev;
+}
+
+void spiQueueInit(busDevice_t *bus)
+{
+    bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
+    // Nothing to give way to until a device of higher priority than the lowest is registered
+    bus->maxPriority = BUS_PRIORITY_LOW;
+    bus->preemptDev = NULL;
+    bus->preemptSegments = NULL;
+}
+
+void spiQueueRegisterPriority(busDevice_t *bus, busPriority_e priority)
+{
+    bus->maxPriority = MAX(bus->maxPriority, priority);
+}
+
+uint32_t spiQueueTransferLimit(const extDevice_t *dev, uint32_t clockHz, uint32_t length)
+{
+    if (dev->priority >= dev->bus->maxPriority) {
+        return length;
+    }
+
+    // Bytes clocked out in SPI_LOW_PRIORITY_TRANSFER_US
+    const uint32_t limit = clockHz / 8 / (1000000 / SPI_LOW_PRIORITY_TRANSFER_US);
+
+    return MIN(length, limit);
+}
+
+#endif
@@ -0,0 +1,48 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "drivers/bus.h"
+
+#define BUS_SPI_FREE   0x0
+
+// Longest a transfer of a lower priority device should hold chip select on a bus shared with a higher priority one
+#define SPI_LOW_PRIORITY_TRANSFER_US 100
+
+/*
+ * Ordering of the segment lists of devices sharing an SPI bus. All are called with the bus's interrupts masked,
+ * or from its DMA completion interrupt.
+ */
+
+// Queue a transfer on a busy bus
+void spiQueueSegments(busDevice_t *bus, const extDevice_t *dev, busSegment_t *segments);
+// With chip select negated after a segment of dev, return the device to take over the bus or NULL to continue
+const extDevice_t *spiQueuePreempt(busDevice_t *bus, const extDevice_t *dev, busSegment_t *nextSegment);
+// At the end of a segment list, return the device whose transfer is next or NULL if the bus is now free
+const extDevice_t *spiQueueNext(busDevice_t *bus, busSegment_t *endSegment);
+
+// Reset the bus to having no devices registered
+void spiQueueInit(busDevice_t *bus);
+// Note that a device of the given priority is in use on the bus
+void spiQueueRegisterPriority(busDevice_t *bus, busPriority_e priority);
+// Longest transfer dev should make holding chip select at clockHz, length if no higher priority device is registered
+uint32_t spiQueueTransferLimit(const extDevice_t *dev, uint32_t clockHz, uint32_t length);
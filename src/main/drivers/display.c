@@ -31,6 +31,10 @@
 
 #include "display.h"
 
+#if defined(USE_MAX7456) || defined(USE_MSP_DISPLAYPORT)
+uint32_t osdDeviceBuffer[OSD_DEVICE_BUFFER_SIZE / sizeof(uint32_t)];
+#endif
+
 void displayClearScreen(displayPort_t *instance, displayClearOption_e options)
 {
     instance->vTable->clearScreen(instance, options);
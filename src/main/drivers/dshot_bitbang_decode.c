@@ -71,6 +71,51 @@ uint32_t sequence[MAX_GCR_EDGES];
 int sequenceIndex = 0;
 #endif
 
+// Access to the samples of a single pin in the port input buffer
+#ifdef USE_DSHOT_BITBAND
+typedef bitBandWord_t bbSample_t;
+
+#define BB_SAMPLE(p, bit) ((p)->value)
+
+static const bbSample_t *bbPinSamples(const uint16_t *buffer, uint32_t bit)
+{
+    return (const bbSample_t *)BITBAND_SRAM((uint32_t)buffer, bit);
+}
+#else
+typedef uint16_t bbSample_t;
+
+#define BB_SAMPLE(p, bit) ((*(p) >> (bit)) & 1)
+
+static const bbSample_t *bbPinSamples(const uint16_t *buffer, uint32_t bit)
+{
+    UNUSED(bit);
+    return buffer;
+}
+#endif
+
+// Bits of GCR in a level held for n samples, MAX((n + 1) / 3, 1), up to the longest valid level
+static const uint8_t runBits[] = { 1, 1, 1, 1, 1, 2, 2, 2, 3, 3, 3 };
+
+// Packs count (1 to 32) samples of the pin into a word, the first sample in the msb
+static uint32_t bbPackSamples(const bbSample_t *p, int count, uint32_t bit)
+{
+    uint32_t word = 0;
+    int i = 0;
+
+    // Manual loop unrolling, four samples at a time without a dependency between them
+    for (; i + 4 <= count; i += 4) {
+        word = (word << 4) |
+            (BB_SAMPLE(p + i + 0, bit) << 3) |
+            (BB_SAMPLE(p + i + 1, bit) << 2) |
+            (BB_SAMPLE(p + i + 2, bit) << 1) |
+            BB_SAMPLE(p + i + 3, bit);
+    }
+    for (; i < count; i++) {
+        word = (word << 1) | BB_SAMPLE(p + i, bit);
+    }
+
+    return word << (32 - count);
+}
 
 static uint32_t decode_bb_value(uint32_t value, uint16_t buffer[], uint32_t count, uint32_t bit)
 {
@@ -111,7 +156,10 @@ static uint32_t decode_bb_value(uint32_t value, uint16_t buffer[], uint32_t coun
 }
 
 #ifdef USE_DSHOT_BITBAND
-uint32_t decode_bb_bitband( uint16_t buffer[], uint32_t count, uint32_t bit)
+uint32_t decode_bb_bitband(uint16_t buffer[], uint32_t count, uint32_t bit)
+#else
+FAST_CODE uint32_t decode_bb(uint16_t buffer[], uint32_t count, uint32_t bit)
+#endif
 {
     timeUs_t now = micros();
 #ifdef DEBUG_BBDECODE
@@ -120,9 +168,9 @@ uint32_t decode_bb_bitband( uint16_t buffer[], uint32_t count, uint32_t bit)
 #endif
     uint32_t value = 0;
 
-    bitBandWord_t* p = (bitBandWord_t*)BITBAND_SRAM((uint32_t)buffer, bit);
-    bitBandWord_t* b = p;
-    bitBandWord_t* endP = p + (count - MIN_VALID_BBSAMPLES);
+    const bbSample_t *b = bbPinSamples(buffer, bit);
+    const bbSample_t *p = b;
+    const bbSample_t *endP = p + (count - MIN_VALID_BBSAMPLES);
 
     // Jump forward in the buffer to just before where we anticipate the first zero
     p += preambleSkip;
@@ -132,10 +180,10 @@ uint32_t decode_bb_bitband( uint16_t buffer[], uint32_t count, uint32_t bit)
     // Eliminate leading high signal level by looking for first zero bit in data stream.
     // Manual loop unrolling and branch hinting to produce faster code.
     while (p < endP) {
-        if (__builtin_expect((!(p++)->value), 0) ||
-            __builtin_expect((!(p++)->value), 0) ||
-            __builtin_expect((!(p++)->value), 0) ||
-            __builtin_expect((!(p++)->value), 0)) {
+        if (__builtin_expect(!BB_SAMPLE(p++, bit), 0) ||
+            __builtin_expect(!BB_SAMPLE(p++, bit), 0) ||
+            __builtin_expect(!BB_SAMPLE(p++, bit), 0) ||
+            __builtin_expect(!BB_SAMPLE(p++, bit), 0)) {
             break;
         }
     }
@@ -155,194 +203,54 @@ uint32_t decode_bb_bitband( uint16_t buffer[], uint32_t count, uint32_t bit)
 
     const int remaining = MIN(count - startMargin, (unsigned int)MAX_VALID_BBSAMPLES);
 
-    bitBandWord_t* oldP = p;
-    uint32_t bits = 0;
-    endP = p + remaining;
-
 #ifdef DEBUG_BBDECODE
-    sequence[sequenceIndex++] = p - b;
+    sequence[sequenceIndex++] = startMargin;
 #endif
 
-    while (endP > p) {
-        do {
-            // Look for next positive edge. Manual loop unrolling and branch hinting to produce faster code.
-            if(__builtin_expect((p++)->value, 0) ||
-               __builtin_expect((p++)->value, 0) ||
-               __builtin_expect((p++)->value, 0) ||
-               __builtin_expect((p++)->value, 0)) {
-                break;
-            }
-        } while (endP > p);
+    // Rather than testing sample by sample, the samples of the frame are packed 32 to a word and the
+    // edges found by XORing each word with itself shifted by one sample, counting leading zeros to
+    // step from one edge to the next. The level before the first sample is the low start bit.
+    // Only edges up to the last but one sample count, the last sample only tells the level.
+    uint32_t lastLevel = 0;
+    int lastEdge = -1;
+    uint32_t bits = 0;
+
+    for (int wordStart = 0; wordStart < remaining - 1; wordStart += 32) {
+        const int samples = MIN(remaining - wordStart, 32);
+        const uint32_t word = bbPackSamples(p + wordStart, samples, bit);
+        uint32_t edges = word ^ ((word >> 1) | (lastLevel << 31));
+        lastLevel = (word >> (32 - samples)) & 1;
+
+        // Mask off the last sample of the frame
+        if (wordStart + 32 >= remaining) {
+            edges &= ~(0xffffffff >> (remaining - 1 - wordStart));
+        }
 
-        if (endP > p) {
+        while (edges) {
+            const int offset = __builtin_clz(edges);
+            const int edge = wordStart + offset;
+            edges &= ~(0x80000000 >> offset);
 
 #ifdef DEBUG_BBDECODE
-            sequence[sequenceIndex++] = p - b;
+            sequence[sequenceIndex++] = startMargin + edge + 1;
 #endif
             // A level of length n gets decoded to a sequence of bits of
             // the form 1000 with a length of (n+1) / 3 to account for 3x
             // oversampling.
-            const int len = MAX((p - oldP + 1) / 3, 1);
-            bits += len;
-            value <<= len;
-            value |= 1 << (len - 1);
-            oldP = p;
-
-            // Look for next zero edge. Manual loop unrolling and branch hinting to produce faster code.
-            do {
-                if (__builtin_expect(!(p++)->value, 0) ||
-                    __builtin_expect(!(p++)->value, 0) ||
-                    __builtin_expect(!(p++)->value, 0) ||
-                    __builtin_expect(!(p++)->value, 0)) {
-                    break;
-                }
-            } while (endP > p);
+            const unsigned run = edge - lastEdge;
+            lastEdge = edge;
 
-            if (endP > p) {
-
-#ifdef DEBUG_BBDECODE
-                sequence[sequenceIndex++] = p - b;
-#endif
-                // A level of length n gets decoded to a sequence of bits of
-                // the form 1000 with a length of (n+1) / 3 to account for 3x
-                // oversampling.
-                const int len = MAX((p - oldP + 1) / 3, 1);
-                bits += len;
-                value <<= len;
-                value |= 1 << (len - 1);
-                oldP = p;
+            // GCR never holds a level for more than three bits, and a frame has 21
+            if (run >= ARRAYLEN(runBits)) {
+                return DSHOT_TELEMETRY_INVALID;
             }
-        }
-    }
-
-    // length of last sequence has to be inferred since the last bit with inverted dshot is high
-    if (bits < 18) {
-        return DSHOT_TELEMETRY_NOEDGE;
-    }
-
-    // length of last sequence has to be inferred since the last bit with inverted dshot is high
-    const int nlen = 21 - bits;
-    if (nlen < 0) {
-        return DSHOT_TELEMETRY_NOEDGE;
-    }
-
-    // Data appears valid
-    if (startMargin < minMargin) {
-        minMargin = startMargin;
-    }
-
-    if (cmpTimeUs(now, nextMarginCheckUs) >= 0) {
-        nextMarginCheckUs += MARGIN_CHECK_INTERVAL_US;
-
-        // Handle a skipped check
-        if (nextMarginCheckUs < now) {
-            nextMarginCheckUs = now + DSHOT_TELEMETRY_START_MARGIN;
-        }
-
-        if (minMargin > DSHOT_TELEMETRY_START_MARGIN) {
-            preambleSkip = minMargin - DSHOT_TELEMETRY_START_MARGIN;
-        } else {
-            preambleSkip = 0;
-        }
-
-        minMargin = UINT32_MAX;
-    }
-
-#ifdef DEBUG_BBDECODE
-    sequence[sequenceIndex] = sequence[sequenceIndex] + (nlen) * 3;
-    sequenceIndex++;
-#endif
-
-    // The anticipated edges were observed
-    if (nlen > 0) {
-        value <<= nlen;
-        value |= 1 << (nlen - 1);
-    }
-
-    return decode_bb_value(value, buffer, count, bit);
-}
-
-#else // USE_DSHOT_BITBAND
-
-FAST_CODE uint32_t decode_bb( uint16_t buffer[], uint32_t count, uint32_t bit)
-{
-    timeUs_t now = micros();
-#ifdef DEBUG_BBDECODE
-    memset(sequence, 0, sizeof(sequence));
-    sequenceIndex = 0;
-#endif
-    uint32_t mask = 1 << bit;
-
-#ifdef DEBUG_BBDECODE
-    uint32_t sequence[MAX_GCR_EDGES];
-    memset(sequence, 0, sizeof(sequence));
-    int sequenceIndex = 0;
-#endif
-    uint16_t lastValue = 0;
-    uint32_t value = 0;
-
-    uint16_t* p = buffer;
-    uint16_t* endP = p + count - MIN_VALID_BBSAMPLES;
-
-    // Jump forward in the buffer to just before where we anticipate the first zero
-    p += preambleSkip;
-
-    DEBUG_SET(DEBUG_DSHOT_TELEMETRY_COUNTS, 3, preambleSkip);
-
-    // Eliminate leading high signal level by looking for first zero bit in data stream.
-    // Manual loop unrolling and branch hinting to produce faster code.
-    while (p < endP) {
-        if (__builtin_expect(!(*p++ & mask), 0) ||
-            __builtin_expect(!(*p++ & mask), 0) ||
-            __builtin_expect(!(*p++ & mask), 0) ||
-            __builtin_expect(!(*p++ & mask), 0)) {
-            break;
-        }
-    }
-
-    const uint32_t startMargin = p - buffer;
-
-    if (p >= endP) {
-        // not returning telemetry is ok if the esc cpu is
-        // overburdened.  in that case no edge will be found and
-        // BB_NOEDGE indicates the condition to caller
-        // Increase the start margin
-        if (preambleSkip > 0) {
-            // Increase the start margin
-            preambleSkip--;
-        }
-        return DSHOT_TELEMETRY_NOEDGE;
-    }
-
-    const int remaining = MIN(count - startMargin, (unsigned int)MAX_VALID_BBSAMPLES);
-    uint16_t* oldP = p;
-    uint32_t bits = 0;
-    endP = p + remaining;
-
-#ifdef DEBUG_BBDECODE
-    sequence[sequenceIndex++] = p - buffer;
-#endif
-
-    while (endP > p ) {
-        // Look for next edge. Manual loop unrolling and branch hinting to produce faster code.
-        if (__builtin_expect((*p++ & mask) != lastValue, 0) ||
-            __builtin_expect((*p++ & mask) != lastValue, 0) ||
-            __builtin_expect((*p++ & mask) != lastValue, 0) ||
-            __builtin_expect((*p++ & mask) != lastValue, 0)) {
-            if (endP > p) {
-#ifdef DEBUG_BBDECODE
-                sequence[sequenceIndex++] = p - buffer;
-#endif
-                // A level of length n gets decoded to a sequence of bits of
-                // the form 1000 with a length of (n+1) / 3 to account for 3x
-                // oversampling.
-                const int len = MAX((p - oldP + 1) / 3, 1);
-                bits += len;
-                value <<= len;
-                value |= 1 << (len - 1);
-                oldP = p;
-                lastValue = *(p-1) & mask;
+            const int len = runBits[run];
+            bits += len;
+            if (bits > 21) {
+                return DSHOT_TELEMETRY_NOEDGE;
             }
+            value <<= len;
+            value |= 1 << (len - 1);
         }
     }
 
@@ -353,9 +261,6 @@ FAST_CODE uint32_t decode_bb( uint16_t buffer[], uint32_t count, uint32_t bit)
 
     // length of last sequence has to be inferred since the last bit with inverted dshot is high
     const int nlen = 21 - bits;
-    if (nlen < 0) {
-        return DSHOT_TELEMETRY_NOEDGE;
-    }
 
     // Data appears valid
     if (startMargin < minMargin) {
@@ -392,6 +297,5 @@ FAST_CODE uint32_t decode_bb( uint16_t buffer[], uint32_t count, uint32_t bit)
 
     return decode_bb_value(value, buffer, count, bit);
 }
-#endif // USE_DSHOT_BITBAND
 
 #endif
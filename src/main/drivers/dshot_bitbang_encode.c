@@ -0,0 +1,120 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_DSHOT_BITBANG
+
+#include "drivers/dshot_bitbang_encode.h"
+
+// DMA GPIO output buffer formatting
+//
+// Each DShot bit is sent as three BSRR writes: set the line, reset it if the bit is a 0, reset it.
+// Only the middle write depends on the data, and it holds the bits of every motor on the port.
+
+// Middle words for a nibble, most significant bit first, as a mask to AND with the motor's pin mask;
+// a 0 bit resets the line early.
+static const uint32_t bbNibbleMask[16][4] = {
+#define BB_NIBBLE_WORD(nibble, bit) (((nibble) & (1 << (bit))) ? 0 : 0xffffffff)
+#define BB_NIBBLE(nibble) { BB_NIBBLE_WORD(nibble, 3), BB_NIBBLE_WORD(nibble, 2), BB_NIBBLE_WORD(nibble, 1), BB_NIBBLE_WORD(nibble, 0) }
+    BB_NIBBLE(0x0), BB_NIBBLE(0x1), BB_NIBBLE(0x2), BB_NIBBLE(0x3),
+    BB_NIBBLE(0x4), BB_NIBBLE(0x5), BB_NIBBLE(0x6), BB_NIBBLE(0x7),
+    BB_NIBBLE(0x8), BB_NIBBLE(0x9), BB_NIBBLE(0xa), BB_NIBBLE(0xb),
+    BB_NIBBLE(0xc), BB_NIBBLE(0xd), BB_NIBBLE(0xe), BB_NIBBLE(0xf),
+#undef BB_NIBBLE
+#undef BB_NIBBLE_WORD
+};
+
+// BSRR bit that ends a 0 bit early for the pin
+uint32_t bbOutputPinMask(int pinIndex, bool inverted)
+{
+    if (inverted) {
+        return (1 << (pinIndex + 0));
+    } else {
+        return (1 << (pinIndex + 16));
+    }
+}
+
+void bbOutputDataInit(uint32_t *buffer, uint16_t portMask, bool inverted)
+{
+    uint32_t resetMask;
+    uint32_t setMask;
+
+    if (inverted) {
+        resetMask = portMask;
+        setMask = (portMask << 16);
+    } else {
+        resetMask = (portMask << 16);
+        setMask = portMask;
+    }
+
+    int symbol_index;
+
+    for (symbol_index = 0; symbol_index < MOTOR_DSHOT_FRAME_BITS; symbol_index++) {
+        buffer[symbol_index * MOTOR_DSHOT_STATE_PER_SYMBOL + 0] |= setMask ; // Always set all ports
+        buffer[symbol_index * MOTOR_DSHOT_STATE_PER_SYMBOL + 1] = 0;          // Reset bits are port dependent
+        buffer[symbol_index * MOTOR_DSHOT_STATE_PER_SYMBOL + 2] |= resetMask; // Always reset all ports
+    }
+
+    //
+    // output one more 'bit' that keeps the line level at idle to allow the ESC to sample the last bit
+    //
+    // Avoid CRC errors in the case of bi-directional d-shot.  CRC errors can occur if the output is
+    // transitioned to an input before the signal has been sampled by the ESC as the sampled voltage
+    // may be somewhere between logic-high and logic-low depending on how the motor output line is
+    // driven or floating.  On some MCUs it's observed that the voltage momentarily drops low on transition
+    // to input.
+
+    int hold_bit_index = MOTOR_DSHOT_FRAME_BITS * MOTOR_DSHOT_STATE_PER_SYMBOL;
+    buffer[hold_bit_index + 0] |= resetMask; // Always reset all ports
+    buffer[hold_bit_index + 1] = 0;          // Never any change
+    buffer[hold_bit_index + 2] = 0;          // Never any change
+}
+
+// Writes the data words of a port's frame from the packets of all its motors, a nibble of each at a time
+FAST_CODE void bbOutputDataEncode(uint32_t *buffer, const uint16_t *packets, const uint32_t *pinMasks, int motorCount)
+{
+    for (int shift = MOTOR_DSHOT_FRAME_BITS - 4; shift >= 0; shift -= 4) {
+        uint32_t word0 = 0;
+        uint32_t word1 = 0;
+        uint32_t word2 = 0;
+        uint32_t word3 = 0;
+
+        for (int i = 0; i < motorCount; i++) {
+            const uint32_t *nibbleMask = bbNibbleMask[(packets[i] >> shift) & 0xf];
+            const uint32_t pinMask = pinMasks[i];
+            word0 |= nibbleMask[0] & pinMask;
+            word1 |= nibbleMask[1] & pinMask;
+            word2 |= nibbleMask[2] & pinMask;
+            word3 |= nibbleMask[3] & pinMask;
+        }
+
+        buffer[1] = word0;
+        buffer[1 + MOTOR_DSHOT_STATE_PER_SYMBOL] = word1;
+        buffer[1 + MOTOR_DSHOT_STATE_PER_SYMBOL * 2] = word2;
+        buffer[1 + MOTOR_DSHOT_STATE_PER_SYMBOL * 3] = word3;
+        buffer += MOTOR_DSHOT_STATE_PER_SYMBOL * 4;
+    }
+}
+
+#endif // USE_DSHOT_BITBANG
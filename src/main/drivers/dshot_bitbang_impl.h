@@ -21,6 +21,7 @@
 #pragma once
 
 #include "common/time.h"
+#include "drivers/dshot_bitbang_encode.h"
 #include "drivers/motor.h"
 
 #define USE_DMA_REGISTER_CACHE
@@ -50,11 +51,8 @@
 
 #define MOTOR_DSHOT_BIT_PER_SYMBOL         1
 
-#define MOTOR_DSHOT_STATE_PER_SYMBOL       3  // Initial high, 0/1, low
 #define MOTOR_DSHOT_BIT_HOLD_STATES        3  // 3 extra states at the end of transmission required to allow ESC to sample the last bit correctly.
 
-#define MOTOR_DSHOT_FRAME_BITS             16
-
 #define MOTOR_DSHOT_FRAME_TIME_NS(rate)    ((MOTOR_DSHOT_FRAME_BITS / MOTOR_DSHOT_BIT_PER_SYMBOL) * MOTOR_DSHOT_SYMBOL_TIME_NS(rate))
 
 #define MOTOR_DSHOT_TELEMETRY_WINDOW_US    (30000 + MOTOR_DSHOT_FRAME_TIME_NS(rate) * (1.1)) / 1000
@@ -185,6 +183,11 @@ typedef struct bbPort_s {
     bool inputActive;
     volatile bool telemetryPending;
 
+    // Motors on the port, encoded into the output buffer together
+    uint16_t motorPacket[MAX_SUPPORTED_MOTORS];
+    uint32_t motorPinMask[MAX_SUPPORTED_MOTORS];
+    uint8_t motorCount;
+
     // Misc
 #ifdef DEBUG_COUNT_INTERRUPT
     uint32_t outputIrq;
@@ -198,6 +201,7 @@ typedef struct bbPort_s {
 typedef struct bbMotor_s {
     dshotProtocolControl_t protocolControl;
     int pinIndex;            // pinIndex of this motor output within a group that bbPort points to
+    uint8_t portMotorIndex;  // index of this motor within the motors of bbPort
     int portIndex;
     IO_t io;                 // IO_t for this output
     uint8_t output;
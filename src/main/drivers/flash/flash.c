@@ -290,6 +290,9 @@ static bool flashSpiInit(const flashConfig_t *flashConfig)
         return false;
     }
 
+    // Give way to the gyro if it shares the bus
+    spiSetPriority(dev, BUS_PRIORITY_LOW);
+
     // Set the callback argument when calling back to this driver for DMA completion
     dev->callbackArg = (uint32_t)&flashDevice;
 
@@ -39,6 +39,7 @@
 
 #include "common/color.h"
 #include "common/colorconversion.h"
+#include "common/utils.h"
 
 #include "drivers/dma.h"
 #include "drivers/io.h"
@@ -77,6 +78,16 @@ uint16_t BIT_COMPARE_1 = 0;
 uint16_t BIT_COMPARE_0 = 0;
 
 static hsvColor_t ledColorBuffer[WS2811_DATA_BUFFER_SIZE];
+// Colour each LED was last encoded with, only changed LEDs are encoded again
+static hsvColor_t ledColorEncoded[WS2811_DATA_BUFFER_SIZE];
+static ledStripFormatRGB_e encodedLedFormat;
+static uint8_t encodedBrightness;
+
+// Timer compare values for each nibble of a colour, most significant bit first
+static uint32_t nibbleToCompare[16][4];
+static uint16_t nibbleToCompareBit1;
+static uint16_t nibbleToCompareBit0;
+static bool nibbleToCompareValid = false;
 
 #if !defined(USE_WS2811_SINGLE_COLOUR)
 void setLedHsv(uint16_t index, const hsvColor_t *color)
@@ -153,6 +164,19 @@ bool isWS2811LedStripReady(void)
     return ws2811Initialised && !ws2811LedDataTransferInProgress;
 }
 
+static void updateNibbleToCompare(void)
+{
+    for (unsigned nibble = 0; nibble < ARRAYLEN(nibbleToCompare); nibble++) {
+        for (unsigned bit = 0; bit < 4; bit++) {
+            nibbleToCompare[nibble][bit] = (nibble & (0x8 >> bit)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+        }
+    }
+
+    nibbleToCompareBit1 = BIT_COMPARE_1;
+    nibbleToCompareBit0 = BIT_COMPARE_0;
+    nibbleToCompareValid = true;
+}
+
 STATIC_UNIT_TESTED void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex)
 {
     uint32_t bits_per_led;
@@ -180,9 +204,15 @@ STATIC_UNIT_TESTED void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbCol
         break;
     }
 
-    unsigned dmaBufferOffset = 0;
-    for (int index = bits_per_led - 1; index >= 0; index--) {
-        ledStripDMABuffer[ledIndex * bits_per_led + dmaBufferOffset++] = (packed_colour & (1U << index)) ? BIT_COMPARE_1 : BIT_COMPARE_0;
+    // The compare values are set by the timer initialisation
+    if (!nibbleToCompareValid || nibbleToCompareBit1 != BIT_COMPARE_1 || nibbleToCompareBit0 != BIT_COMPARE_0) {
+        updateNibbleToCompare();
+    }
+
+    uint32_t *dmaBuffer = &ledStripDMABuffer[ledIndex * bits_per_led];
+    for (int shift = bits_per_led - 4; shift >= 0; shift -= 4) {
+        memcpy(dmaBuffer, nibbleToCompare[(packed_colour >> shift) & 0xf], sizeof(nibbleToCompare[0]));
+        dmaBuffer += 4;
     }
 }
 
@@ -201,12 +231,30 @@ bool ws2811UpdateStrip(ledStripFormatRGB_e ledFormat, uint8_t brightness)
     }
 
 
+    // A different encoding invalidates everything already in the transmit buffer
+    if (ledIndex == 0 && (ledFormat != encodedLedFormat || brightness != encodedBrightness)) {
+        encodedLedFormat = ledFormat;
+        encodedBrightness = brightness;
+        needsFullRefresh = true;
+    }
+
     // fill transmit buffer with correct compare values to achieve
     // correct pulse widths according to color values
     const unsigned ledUpdateCount = needsFullRefresh ? WS2811_DATA_BUFFER_SIZE : usedLedCount;
     const hsvColor_t hsvBlack = { 0, 0, 0 };
     while (ledIndex < ledUpdateCount) {
-        hsvColor_t scaledLed = ledIndex < usedLedCount ? ledColorBuffer[ledIndex] : hsvBlack;
+        const hsvColor_t *led = ledIndex < usedLedCount ? &ledColorBuffer[ledIndex] : &hsvBlack;
+        hsvColor_t *encodedLed = &ledColorEncoded[ledIndex];
+
+        if (!needsFullRefresh && led->h == encodedLed->h && led->s == encodedLed->s && led->v == encodedLed->v) {
+            // Unchanged, so the transmit buffer already holds this LED
+            ledIndex++;
+            continue;
+        }
+
+        *encodedLed = *led;
+
+        hsvColor_t scaledLed = *led;
         // Scale the LED brightness
         scaledLed.v = scaledLed.v * brightness / 100;
 
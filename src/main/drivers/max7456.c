@@ -28,6 +28,8 @@
 
 #include "build/debug.h"
 
+#include "common/maths.h"
+
 #include "pg/max7456.h"
 #include "pg/vcd.h"
 
@@ -186,7 +188,18 @@ typedef struct max7456Layer_s {
     uint8_t buffer[VIDEO_BUFFER_CHARS_PAL];
 } max7456Layer_t;
 
-static max7456Layer_t displayLayers[MAX7456_SUPPORTED_LAYER_COUNT];
+typedef struct max7456Buffers_s {
+    max7456Layer_t layers[MAX7456_SUPPORTED_LAYER_COUNT];
+    // We write everything to the active layer and then compare
+    // it with shadow to update only changed chars.
+    // This solution is faster then redrawing entire screen.
+    uint8_t shadow[VIDEO_BUFFER_CHARS_PAL];
+} max7456Buffers_t;
+
+STATIC_ASSERT(sizeof(max7456Buffers_t) <= sizeof(osdDeviceBuffer), max7456_buffers_too_large);
+
+// kept in the memory shared by the OSD device drivers
+static max7456Buffers_t *const buffers = (max7456Buffers_t *)osdDeviceBuffer;
 static displayPortLayer_e activeLayer = DISPLAYPORT_LAYER_FOREGROUND;
 
 extDevice_t max7456Device;
@@ -198,19 +211,21 @@ static volatile bool max7456ActiveDma = false;
 
 uint16_t maxScreenSize = VIDEO_BUFFER_CHARS_PAL;
 
-// We write everything to the active layer and then compare
-// it with shadowBuffer to update only changed chars.
-// This solution is faster then redrawing entire screen.
+// With DMA the changed characters of a whole frame are encoded into spiBuf and sent
+// as a single transfer. A full screen fits when sent as one auto-increment run.
+// Without DMA the transfer blocks, so only a few bytes are sent per call.
 
-static uint8_t shadowBuffer[VIDEO_BUFFER_CHARS_PAL];
-
-//Max bytes to update in one call to max7456DrawScreen()
-
-#define MAX_BYTES2SEND          250
+#define MAX_BYTES2SEND          (VIDEO_BUFFER_CHARS_PAL * 2 + 64)
 #define MAX_BYTES2SEND_POLLED   12
 #define MAX_ENCODE_US           20
 #define MAX_ENCODE_US_POLLED    10
 
+// Bytes to set DMM and the start address of a run, and to terminate it
+#define RUN_START_BYTES         6
+#define RUN_END_BYTES           2
+// Unchanged characters between two changes are resent rather than starting a new run
+#define RUN_MAX_GAP             3
+
 static DMA_DATA uint8_t spiBuf[MAX_BYTES2SEND];
 
 static uint8_t  videoSignalCfg;
@@ -233,7 +248,7 @@ static uint8_t previousInvertRegister = INVALID_PREVIOUS_REGISTER_STATE;
 
 static uint8_t *getLayerBuffer(displayPortLayer_e layer)
 {
-    return displayLayers[layer].buffer;
+    return buffers->layers[layer].buffer;
 }
 
 static uint8_t *getActiveLayerBuffer(void)
@@ -273,7 +288,7 @@ uint8_t max7456GetRowsCount(void)
 // be flagged as changed when compared to the 0x20 used in the layer buffers.
 static void max7456ClearShadowBuffer(void)
 {
-    memset(shadowBuffer, 0, maxScreenSize);
+    memset(buffers->shadow, 0, maxScreenSize);
 }
 
 // Buffer is filled with the whitespace character (0x20)
@@ -355,6 +370,9 @@ max7456InitStatus_e max7456Init(const max7456Config_t *max7456Config, const vcdP
         return MAX7456_INIT_NOT_CONFIGURED;
     }
 
+    // Give way to the gyro if it shares the bus
+    spiSetPriority(dev, BUS_PRIORITY_LOW);
+
     dev->busType_u.spi.csnPin = IOGetByTag(max7456Config->csTag);
 
     if (!IOIsFreeOrPreinit(dev->busType_u.spi.csnPin)) {
@@ -547,7 +565,7 @@ bool max7456DmaInProgress(void)
 bool max7456BuffersSynced(void)
 {
     for (int i = 0; i < maxScreenSize; i++) {
-        if (displayLayers[DISPLAYPORT_LAYER_FOREGROUND].buffer[i] != shadowBuffer[i]) {
+        if (buffers->layers[DISPLAYPORT_LAYER_FOREGROUND].buffer[i] != buffers->shadow[i]) {
             return false;
         }
     }
@@ -622,110 +640,135 @@ busStatus_e max7456_callbackReady(uint32_t arg)
     return BUS_READY;
 }
 
+// Return the number of characters from pos to send as one run, including bridged gaps
+static int max7456GetRunLength(const uint8_t *buffer, int pos)
+{
+    int length = 1;
+    int gap = 0;
+
+    for (int i = pos + 1; i < maxScreenSize && gap <= RUN_MAX_GAP; i++) {
+        if (buffer[i] != buffers->shadow[i]) {
+            length = i - pos + 1;
+            gap = 0;
+        } else {
+            gap++;
+        }
+    }
+
+    return length;
+}
+
 // Return true if screen still being transferred
 bool max7456DrawScreen(void)
 {
     static uint16_t pos = 0;
+    static int spiBufIndex = 0;
+    static bool autoInc = false;
     // This routine doesn't block so need to use static data
     static busSegment_t segments[] = {
             {.u.link = {NULL, NULL}, 0, true, max7456_callbackReady},
             {.u.link = {NULL, NULL}, 0, true, NULL},
     };
 
-    if (!fontIsLoading) {
-        uint8_t *buffer = getActiveLayerBuffer();
-        int spiBufIndex = 0;
-        int maxSpiBufStartIndex;
-        timeDelta_t maxEncodeTime;
-        bool setAddress = true;
-        bool autoInc = false;
-        int posLimit = pos + (maxScreenSize / 2);
-
-        maxSpiBufStartIndex = spiUseSDO_DMA(dev) ? MAX_BYTES2SEND : MAX_BYTES2SEND_POLLED;
-        maxEncodeTime = spiUseSDO_DMA(dev) ? MAX_ENCODE_US : MAX_ENCODE_US_POLLED;
-
-        // Abort for now if the bus is still busy
-        if (spiIsBusy(dev)) {
-            // Not finished yet
-            return true;
-        }
+    if (fontIsLoading) {
+        return false;
+    }
+
+    // Abort for now if the bus is still busy
+    if (spiIsBusy(dev)) {
+        // Not finished yet
+        return true;
+    }
 
-        timeUs_t startTime = micros();
+    uint8_t *buffer = getActiveLayerBuffer();
+    const bool useDma = spiUseSDO_DMA(dev);
+    // Keep a DMA transfer short enough not to delay the gyro if it shares the bus
+    const int maxSpiBufIndex = (useDma ? MAX((int)spiTransferLimit(dev, MAX_BYTES2SEND), MAX_BYTES2SEND_POLLED) : MAX_BYTES2SEND_POLLED) - RUN_END_BYTES;
+    const timeDelta_t maxEncodeTime = useDma ? MAX_ENCODE_US : MAX_ENCODE_US_POLLED;
+    const timeUs_t startTime = micros();
+    bool bufferFull = false;
+
+    // Encode the runs of changed characters, leaving room to restore DMM at the end
+    while (pos < maxScreenSize) {
+        if (buffer[pos] == buffers->shadow[pos]) {
+            pos++;
+            continue;
+        }
 
-        // Allow for an ESCAPE, a reset of DMM and a two byte MAX7456ADD_DMM command at end of buffer
-        maxSpiBufStartIndex -= 4;
+        if (cmpTimeUs(micros(), startTime) >= maxEncodeTime) {
+            // Continue encoding this frame on the next call
+            return true;
+        }
 
-        // Initialise the transfer buffer
-        while ((spiBufIndex < maxSpiBufStartIndex) && (pos < posLimit) && (cmpTimeUs(micros(), startTime) < maxEncodeTime)) {
-            if (buffer[pos] != shadowBuffer[pos]) {
-                if (buffer[pos] == 0xff) {
-                    buffer[pos] = ' ';
-                }
+        int length = max7456GetRunLength(buffer, pos);
+        const int space = maxSpiBufIndex - spiBufIndex - RUN_START_BYTES;
 
-                if (setAddress || !autoInc) {
-                    if (buffer[pos + 1] != shadowBuffer[pos + 1]) {
-                        // It's worth auto incrementing
-                        spiBuf[spiBufIndex++] = MAX7456ADD_DMM;
-                        spiBuf[spiBufIndex++] = displayMemoryModeReg | DMM_AUTO_INC;
-                        autoInc = true;
-                    } else {
-                        // It's not worth auto incrementing
-                        spiBuf[spiBufIndex++] = MAX7456ADD_DMM;
-                        spiBuf[spiBufIndex++] = displayMemoryModeReg;
-                        autoInc = false;
-                    }
+        // Split the run if it doesn't fit in what is left of the buffer
+        if (length > 1 && length * 2 + RUN_END_BYTES > space) {
+            length = (space - RUN_END_BYTES) / 2;
+        }
 
-                    spiBuf[spiBufIndex++] = MAX7456ADD_DMAH;
-                    spiBuf[spiBufIndex++] = pos >> 8;
-                    spiBuf[spiBufIndex++] = MAX7456ADD_DMAL;
-                    spiBuf[spiBufIndex++] = pos & 0xff;
+        if (length < 1 || length * 2 > space) {
+            bufferFull = true;
+            break;
+        }
 
-                    setAddress = false;
-                }
+        const bool runAutoInc = length > 1;
 
-                spiBuf[spiBufIndex++] = MAX7456ADD_DMDI;
-                spiBuf[spiBufIndex++] = buffer[pos];
+        spiBuf[spiBufIndex++] = MAX7456ADD_DMM;
+        spiBuf[spiBufIndex++] = displayMemoryModeReg | (runAutoInc ? DMM_AUTO_INC : 0);
+        spiBuf[spiBufIndex++] = MAX7456ADD_DMAH;
+        spiBuf[spiBufIndex++] = pos >> 8;
+        spiBuf[spiBufIndex++] = MAX7456ADD_DMAL;
+        spiBuf[spiBufIndex++] = pos & 0xff;
 
-                shadowBuffer[pos] = buffer[pos];
-            } else {
-                if (!setAddress) {
-                    setAddress = true;
-                    if (autoInc) {
-                        spiBuf[spiBufIndex++] = MAX7456ADD_DMDI;
-                        spiBuf[spiBufIndex++] = END_STRING;
-                    }
-                }
+        for (const int runEnd = pos + length; pos < runEnd; pos++) {
+            if (buffer[pos] == END_STRING) {
+                buffer[pos] = ' ';
             }
+            spiBuf[spiBufIndex++] = MAX7456ADD_DMDI;
+            spiBuf[spiBufIndex++] = buffer[pos];
+            buffers->shadow[pos] = buffer[pos];
+        }
 
-            if (++pos >= maxScreenSize) {
-                pos = 0;
-                break;
-            }
+        if (runAutoInc) {
+            spiBuf[spiBufIndex++] = MAX7456ADD_DMDI;
+            spiBuf[spiBufIndex++] = END_STRING;
+            autoInc = true;
         }
 
-        if (autoInc) {
-            if (!setAddress) {
-                spiBuf[spiBufIndex++] = MAX7456ADD_DMDI;
-                spiBuf[spiBufIndex++] = END_STRING;
-            }
+        if (!useDma) {
+            // Send each run as soon as it is encoded
+            bufferFull = true;
+            break;
+        }
+    }
 
+    if (spiBufIndex) {
+        if (autoInc) {
             spiBuf[spiBufIndex++] = MAX7456ADD_DMM;
             spiBuf[spiBufIndex++] = displayMemoryModeReg;
+            autoInc = false;
         }
 
-        if (spiBufIndex) {
-            segments[0].u.buffers.txData = spiBuf;
-            segments[0].len = spiBufIndex;
+        segments[0].u.buffers.txData = spiBuf;
+        segments[0].len = spiBufIndex;
+        spiBufIndex = 0;
 
-            max7456ActiveDma = true;
+        max7456ActiveDma = true;
 
-            spiSequence(dev, &segments[0]);
+        spiSequence(dev, &segments[0]);
 
-            // Non-blocking, so transfer still in progress if using DMA
-        }
+        // Non-blocking, so transfer still in progress if using DMA
+    }
+
+    if (bufferFull) {
+        return true;
     }
 
-    return (pos != 0);
+    pos = 0;
+
+    return false;
 }
 
 // should not be used when armed
@@ -28,6 +28,7 @@
 
 #define IS_CCM(p) (((uint32_t)p & 0xffff0000) == 0x10000000)
 
+#include "build/atomic.h"
 #include "common/maths.h"
 #include "drivers/bus.h"
 #include "drivers/bus_spi.h"
@@ -35,6 +36,7 @@
 #include "drivers/exti.h"
 #include "drivers/io.h"
 #include "drivers/rcc.h"
+#include "nvic.h"
 
 // Use DMA if possible if this many bytes are to be transferred
 #define SPI_DMA_THRESHOLD 8
@@ -395,18 +397,13 @@ void spiSequenceStart(const extDevice_t *dev)
             }
         }
 
-        // If a following transaction has been linked, start it
-        if (bus->curSegment->u.link.dev) {
-            const extDevice_t *nextDev = bus->curSegment->u.link.dev;
-            busSegment_t *nextSegments = (busSegment_t *)bus->curSegment->u.link.segments;
-            busSegment_t *endSegment = (busSegment_t *)bus->curSegment;
-            bus->curSegment = nextSegments;
-            endSegment->u.link.dev = NULL;
-            endSegment->u.link.segments = NULL;
+        // The end of the segment list has been reached, start the next transaction if there is one
+        const extDevice_t *nextDev = NULL;
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            nextDev = spiQueueNext(bus, (busSegment_t *)bus->curSegment);
+        }
+        if (nextDev) {
             spiSequenceStart(nextDev);
-        } else {
-            // The end of the segment list has been reached, so mark transactions as complete
-            bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
         }
     }
 }
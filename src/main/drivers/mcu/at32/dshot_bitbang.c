@@ -95,70 +95,6 @@ static FAST_DATA_ZERO_INIT timeUs_t lastSendUs;
 
 static motorPwmProtocolTypes_e motorPwmProtocol;
 
-// DMA GPIO output buffer formatting
-
-static void bbOutputDataInit(uint32_t *buffer, uint16_t portMask, bool inverted)
-{
-    uint32_t resetMask;
-    uint32_t setMask;
-
-    if (inverted) {
-        resetMask = portMask;
-        setMask = (portMask << 16);
-    } else {
-        resetMask = (portMask << 16);
-        setMask = portMask;
-    }
-
-    int symbol_index;
-
-    for (symbol_index = 0; symbol_index < MOTOR_DSHOT_FRAME_BITS; symbol_index++) {
-        buffer[symbol_index * MOTOR_DSHOT_STATE_PER_SYMBOL + 0] |= setMask ; // Always set all ports
-        buffer[symbol_index * MOTOR_DSHOT_STATE_PER_SYMBOL + 1] = 0;          // Reset bits are port dependent
-        buffer[symbol_index * MOTOR_DSHOT_STATE_PER_SYMBOL + 2] |= resetMask; // Always reset all ports
-    }
-
-    //
-    // output one more 'bit' that keeps the line level at idle to allow the ESC to sample the last bit
-    //
-    // Avoid CRC errors in the case of bi-directional d-shot.  CRC errors can occur if the output is
-    // transitioned to an input before the signal has been sampled by the ESC as the sampled voltage
-    // may be somewhere between logic-high and logic-low depending on how the motor output line is
-    // driven or floating.  On some MCUs it's observed that the voltage momentarily drops low on transition
-    // to input.
-
-    int hold_bit_index = MOTOR_DSHOT_FRAME_BITS * MOTOR_DSHOT_STATE_PER_SYMBOL;
-    buffer[hold_bit_index + 0] |= resetMask; // Always reset all ports
-    buffer[hold_bit_index + 1] = 0;          // Never any change
-    buffer[hold_bit_index + 2] = 0;          // Never any change
-}
-
-static void bbOutputDataSet(uint32_t *buffer, int pinNumber, uint16_t value, bool inverted)
-{
-    uint32_t middleBit;
-
-    if (inverted) {
-        middleBit = (1 << (pinNumber + 0));
-    } else {
-        middleBit = (1 << (pinNumber + 16));
-    }
-
-    for (int pos = 0; pos < 16; pos++) {
-        if (!(value & 0x8000)) {
-            buffer[pos * 3 + 1] |= middleBit;
-        }
-        value <<= 1;
-    }
-}
-
-static void bbOutputDataClear(uint32_t *buffer)
-{
-    // Middle position to no change
-    for (int bitpos = 0; bitpos < 16; bitpos++) {
-        buffer[bitpos * 3 + 1] = 0;
-    }
-}
-
 // bbPacer management
 
 static bbPacer_t *bbFindMotorPacer(TIM_TypeDef *tim)
@@ -449,11 +385,14 @@ static bool bbMotorConfig(IO_t io, uint8_t motorIndex, motorPwmProtocolTypes_e p
 #ifdef USE_DSHOT_TELEMETRY
     if (useDshotTelemetry) {
         bbOutputDataInit(bbPort->portOutputBuffer, (1 << pinIndex), DSHOT_BITBANG_INVERTED);
+        bbPort->motorPinMask[bbPort->motorCount] = bbOutputPinMask(pinIndex, DSHOT_BITBANG_INVERTED);
     } else
 #endif
     {
         bbOutputDataInit(bbPort->portOutputBuffer, (1 << pinIndex), DSHOT_BITBANG_NONINVERTED);
+        bbPort->motorPinMask[bbPort->motorCount] = bbOutputPinMask(pinIndex, DSHOT_BITBANG_NONINVERTED);
     }
+    bbMotors[motorIndex].portMotorIndex = bbPort->motorCount++;
 
     bbSwitchToOutput(bbPort);
 
@@ -491,8 +430,12 @@ static bool bbTelemetryWait(void)
 
 static void bbUpdateInit(void)
 {
+    // a packet of all ones leaves the line untouched in the middle of every bit, as for an unwritten motor
     for (int i = 0; i < usedMotorPorts; i++) {
-        bbOutputDataClear(bbPorts[i].portOutputBuffer);
+        bbPort_t *bbPort = &bbPorts[i];
+        for (int j = 0; j < bbPort->motorCount; j++) {
+            bbPort->motorPacket[j] = 0xffff;
+        }
     }
 }
 
@@ -571,16 +514,8 @@ static void bbWriteInt(uint8_t motorIndex, uint16_t value)
 
     uint16_t packet = prepareDshotPacket(&bbmotor->protocolControl);
 
-    bbPort_t *bbPort = bbmotor->bbPort;
-
-#ifdef USE_DSHOT_TELEMETRY
-    if (useDshotTelemetry) {
-        bbOutputDataSet(bbPort->portOutputBuffer, bbmotor->pinIndex, packet, DSHOT_BITBANG_INVERTED);
-    } else
-#endif
-    {
-        bbOutputDataSet(bbPort->portOutputBuffer, bbmotor->pinIndex, packet, DSHOT_BITBANG_NONINVERTED);
-    }
+    // encoded with the rest of the port in bbUpdateComplete()
+    bbmotor->bbPort->motorPacket[bbmotor->portMotorIndex] = packet;
 }
 
 static void bbWrite(uint8_t motorIndex, float value)
@@ -598,6 +533,11 @@ static void bbUpdateComplete(void)
         }
     }
 
+    for (int i = 0; i < usedMotorPorts; i++) {
+        bbPort_t *bbPort = &bbPorts[i];
+        bbOutputDataEncode(bbPort->portOutputBuffer, bbPort->motorPacket, bbPort->motorPinMask, bbPort->motorCount);
+    }
+
 #ifdef USE_DSHOT_CACHE_MGMT
     for (int motorIndex = 0; motorIndex < MAX_SUPPORTED_MOTORS && motorIndex < motorCount; motorIndex++) {
         // Only clean each buffer once. If all motors are on a common port they'll share a buffer.
@@ -148,6 +148,9 @@ void uartReconfigure(uartPort_t *uartPort)
             xDMA_Cmd(uartPort->rxDMAResource, TRUE);
             usart_dma_receiver_enable(uartPort->USARTx,TRUE);
             uartPort->rxDMAPos = xDMA_GetCurrDataCounter(uartPort->rxDMAResource);
+            if (uartPort->port.rxCallback) {
+                usart_interrupt_enable(uartPort->USARTx, USART_IDLE_INT, TRUE);
+            }
         } else {
             usart_flag_clear(uartPort->USARTx, USART_RDBF_FLAG);
             usart_interrupt_enable(uartPort->USARTx, USART_RDBF_INT, TRUE);
@@ -330,6 +333,11 @@ void uartIrqHandler(uartPort_t *s)
     }
     
     if (usart_flag_get(s->USARTx, USART_IDLEF_FLAG) == SET) {
+#ifdef USE_DMA
+        if (s->rxDMAResource) {
+            uartRxDmaIdle(s);
+        }
+#endif
         if (s->port.idleCallback) {
             s->port.idleCallback();
         }
@@ -414,12 +414,8 @@ uartPort_t *serialUART(UARTDevice_e device, uint32_t baudRate, portMode_e mode,
         }
     }
 
-#ifdef USE_DMA
-    if (!s->rxDMAResource)
-#endif
-    {
-        nvic_irq_enable(hardware->irqn,NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
-    }
+    // The IRQ is also needed with DMA-based RX, for idle line
+    nvic_irq_enable(hardware->irqn,NVIC_PRIORITY_BASE(hardware->rxPriority), NVIC_PRIORITY_SUB(hardware->rxPriority));
 
     return s;
 }
@@ -26,6 +26,8 @@
 
 #if defined(USE_SPI)
 
+#include "build/atomic.h"
+
 #include "common/utils.h"
 #include "common/maths.h"
 
@@ -35,6 +37,7 @@
 #include "drivers/dma.h"
 #include "drivers/io.h"
 #include "drivers/rcc.h"
+#include "nvic.h"
 
 // Use DMA if possible if this many bytes are to be transferred
 #define SPI_DMA_THRESHOLD 8
@@ -671,18 +674,13 @@ FAST_CODE void spiSequenceStart(const extDevice_t *dev)
             }
         }
 
-        // If a following transaction has been linked, start it
-        if (bus->curSegment->u.link.dev) {
-            busSegment_t *endSegment = (busSegment_t *)bus->curSegment;
-            const extDevice_t *nextDev = endSegment->u.link.dev;
-            busSegment_t *nextSegments = (busSegment_t *)endSegment->u.link.segments;
-            bus->curSegment = nextSegments;
-            endSegment->u.link.dev = NULL;
-            endSegment->u.link.segments = NULL;
+        // The end of the segment list has been reached, start the next transaction if there is one
+        const extDevice_t *nextDev = NULL;
+        ATOMIC_BLOCK(NVIC_PRIO_MAX) {
+            nextDev = spiQueueNext(bus, (busSegment_t *)bus->curSegment);
+        }
+        if (nextDev) {
             spiSequenceStart(nextDev);
-        } else {
-            // The end of the segment list has been reached, so mark transactions as complete
-            bus->curSegment = (busSegment_t *)BUS_SPI_FREE;
         }
     }
 }
@@ -59,3 +59,13 @@ typedef enum {
 typedef struct osdCharacter_s {
     uint8_t data[OSD_CHAR_BYTES];
 } osdCharacter_t;
+
+// Only one OSD device drives the display, so rather than each reserving their own the device drivers
+// keep their frame buffers in this memory, which belongs to whichever is in use.
+#ifdef USE_OSD_HD
+#define OSD_DEVICE_BUFFER_SIZE 2560     // the MSP displayport canvas of an HD display
+#else
+#define OSD_DEVICE_BUFFER_SIZE 1536     // the MAX7456 layers, or the MSP displayport canvas of an SD display
+#endif
+
+extern uint32_t osdDeviceBuffer[OSD_DEVICE_BUFFER_SIZE / sizeof(uint32_t)];
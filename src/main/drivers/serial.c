@@ -19,10 +19,13 @@
  */
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "platform.h"
 
+#include "common/maths.h"
+
 #include "serial.h"
 
 void serialPrint(serialPort_t *instance, const char *str)
@@ -74,6 +77,19 @@ uint8_t serialRead(serialPort_t *instance)
     return instance->vTable->serialRead(instance);
 }
 
+uint32_t serialReadBuf(serialPort_t *instance, uint8_t *data, uint32_t count)
+{
+    if (instance->vTable->readBuf) {
+        return instance->vTable->readBuf(instance, data, count);
+    }
+
+    count = MIN(count, serialRxBytesWaiting(instance));
+    for (uint32_t i = 0; i < count; i++) {
+        data[i] = serialRead(instance);
+    }
+    return count;
+}
+
 void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate)
 {
     instance->vTable->serialSetBaudRate(instance, baudRate);
@@ -129,3 +145,45 @@ void serialWriteBufShim(void *instance, const uint8_t *data, int count)
 {
     serialWriteBuf((serialPort_t *)instance, data, count);
 }
+
+bool serialSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr rxFrameCallback, size_t maxFrameLength)
+{
+    // With DMA-based RX the buffer is only flushed on idle line, and the next frame keeps arriving while a span is
+    // being handled, so the buffer has to hold two of the longest frames or a span is overwritten before it is parsed
+    if (instance->rxBufferSize < 2 * maxFrameLength) {
+        return false;
+    }
+
+    instance->rxFrameCallback = rxFrameCallback;
+    return true;
+}
+
+void serialRxFrame(serialPort_t *instance, const uint8_t *data, size_t len)
+{
+    if (instance->rxFrameCallback) {
+        instance->rxFrameCallback(data, len, instance->rxCallbackData);
+    } else if (instance->rxCallback) {
+        // Shim for parsers which only handle a byte at a time
+        for (size_t i = 0; i < len; i++) {
+            instance->rxCallback(data[i], instance->rxCallbackData);
+        }
+    }
+}
+
+// Pass everything between rxBufferTail and head in the receive ring buffer to the callbacks.
+// Data wrapping around the end of the buffer is passed as two spans.
+void serialRxFlushBuffer(serialPort_t *instance, uint32_t head)
+{
+    const uint8_t *rxBuffer = (const uint8_t *)instance->rxBuffer;
+    uint32_t tail = instance->rxBufferTail;
+
+    if (head < tail) {
+        serialRxFrame(instance, &rxBuffer[tail], instance->rxBufferSize - tail);
+        tail = 0;
+    }
+    if (head > tail) {
+        serialRxFrame(instance, &rxBuffer[tail], head - tail);
+    }
+
+    instance->rxBufferTail = head;
+}
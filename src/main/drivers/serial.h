@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include <stddef.h>
+
 #include "drivers/io.h"
 #include "drivers/io_types.h"
 #include "drivers/resource.h"
@@ -65,6 +67,7 @@ typedef enum {
 #define CTRL_LINE_STATE_RTS (1 << 1)
 
 typedef void (*serialReceiveCallbackPtr)(uint16_t data, void *rxCallbackData);   // used by serial drivers to return frames to app
+typedef void (*serialReceiveFrameCallbackPtr)(const uint8_t *data, size_t len, void *rxCallbackData);   // as above, a contiguous span of bytes per call
 typedef void (*serialIdleCallbackPtr)();
 
 typedef struct serialPort_s {
@@ -86,6 +89,7 @@ typedef struct serialPort_s {
     uint32_t txBufferTail;
 
     serialReceiveCallbackPtr rxCallback;
+    serialReceiveFrameCallbackPtr rxFrameCallback;
     void *rxCallbackData;
 
     serialIdleCallbackPtr idleCallback;
@@ -123,6 +127,8 @@ struct serialPortVTable {
     uint32_t (*serialTotalTxFree)(const serialPort_t *instance);
 
     uint8_t (*serialRead)(serialPort_t *instance);
+    // Optional, copies up to count received bytes and returns the number copied.
+    uint32_t (*readBuf)(serialPort_t *instance, uint8_t *data, uint32_t count);
 
     // Specified baud rate may not be allowed by an implementation, use serialGetBaudRate to determine actual baud rate in use.
     void (*serialSetBaudRate)(serialPort_t *instance, uint32_t baudRate);
@@ -145,6 +151,7 @@ uint32_t serialTxBytesFree(const serialPort_t *instance);
 void serialWriteBuf(serialPort_t *instance, const uint8_t *data, int count);
 void serialWriteBufNoFlush(serialPort_t *instance, const uint8_t *data, int count);
 uint8_t serialRead(serialPort_t *instance);
+uint32_t serialReadBuf(serialPort_t *instance, uint8_t *data, uint32_t count);
 void serialSetBaudRate(serialPort_t *instance, uint32_t baudRate);
 void serialSetMode(serialPort_t *instance, portMode_e mode);
 void serialSetCtrlLineStateCb(serialPort_t *instance, void (*cb)(void *context, uint16_t ctrlLineState), void *context);
@@ -153,6 +160,13 @@ bool isSerialTransmitBufferEmpty(const serialPort_t *instance);
 void serialPrint(serialPort_t *instance, const char *str);
 uint32_t serialGetBaudRate(serialPort_t *instance);
 
+// Bulk receive. The frame callback, if set, takes the place of the per byte callback passed when the port was opened.
+// Refused, leaving the per byte callback in place, if the receive buffer is too small for frames of maxFrameLength.
+bool serialSetRxFrameCallback(serialPort_t *instance, serialReceiveFrameCallbackPtr rxFrameCallback, size_t maxFrameLength);
+// Used by serial drivers to hand received data to the app, one byte at a time if the app has no frame callback.
+void serialRxFrame(serialPort_t *instance, const uint8_t *data, size_t len);
+void serialRxFlushBuffer(serialPort_t *instance, uint32_t head);
+
 // A shim that adapts the bufWriter API to the serialWriteBuf() API.
 void serialWriteBufShim(void *instance, const uint8_t *data, int count);
 void serialBeginWrite(serialPort_t *instance);
@@ -705,6 +705,7 @@ static serialPort_t *openEscSerial(const motorDevConfig_t *motorConfig, escSeria
     escSerial->port.mode = MODE_RXTX;
     escSerial->port.options = options;
     escSerial->port.rxCallback = callback;
+    escSerial->port.rxFrameCallback = NULL;
 
     resetBuffers(escSerial);
 
@@ -275,6 +275,7 @@ serialPort_t *openSoftSerial(softSerialPortIndex_e portIndex, serialReceiveCallb
     softSerial->port.mode = mode;
     softSerial->port.options = options;
     softSerial->port.rxCallback = rxCallback;
+    softSerial->port.rxFrameCallback = NULL;
     softSerial->port.rxCallbackData = rxCallbackData;
 
     resetBuffers(softSerial);
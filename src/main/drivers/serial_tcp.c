@@ -140,8 +140,9 @@ serialPort_t *serTcpOpen(int id, serialReceiveCallbackPtr rxCallback, void *rxCa
     s->port.rxBuffer = s->rxBuffer;
     s->port.txBuffer = s->txBuffer;
 
-    // callback works for IRQ-based RX ONLY
+    // callbacks are run as data arrives
     s->port.rxCallback = rxCallback;
+    s->port.rxFrameCallback = NULL;
     s->port.rxCallbackData = rxCallbackData;
     s->port.mode = mode;
     s->port.baudRate = baudRate;
@@ -249,13 +250,17 @@ void tcpDataIn(tcpPort_t *instance, uint8_t* ch, int size)
     tcpPort_t *s = (tcpPort_t *)instance;
     pthread_mutex_lock(&s->rxLock);
 
-    while (size--) {
-//        printf("%c", *ch);
-        s->port.rxBuffer[s->port.rxBufferHead] = *(ch++);
-        if (s->port.rxBufferHead + 1 >= s->port.rxBufferSize) {
-            s->port.rxBufferHead = 0;
-        } else {
-            s->port.rxBufferHead++;
+    if (s->port.rxCallback || s->port.rxFrameCallback) {
+        serialRxFrame(&s->port, ch, size);
+    } else {
+        while (size--) {
+//            printf("%c", *ch);
+            s->port.rxBuffer[s->port.rxBufferHead] = *(ch++);
+            if (s->port.rxBufferHead + 1 >= s->port.rxBufferSize) {
+                s->port.rxBufferHead = 0;
+            } else {
+                s->port.rxBufferHead++;
+            }
         }
     }
     pthread_mutex_unlock(&s->rxLock);
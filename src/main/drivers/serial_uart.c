@@ -131,8 +131,9 @@ serialPort_t *uartOpen(UARTDevice_e device, serialReceiveCallbackPtr rxCallback,
     // common serial initialisation code should move to serialPort::init()
     uartPort->port.rxBufferHead = uartPort->port.rxBufferTail = 0;
     uartPort->port.txBufferHead = uartPort->port.txBufferTail = 0;
-    // callback works for IRQ-based RX ONLY
+    // with DMA-based RX the callbacks are run on idle line
     uartPort->port.rxCallback = rxCallback;
+    uartPort->port.rxFrameCallback = NULL;
     uartPort->port.rxCallbackData = rxCallbackData;
     uartPort->port.mode = mode;
     uartPort->port.baudRate = baudRate;
@@ -187,6 +188,30 @@ static uint32_t uartTotalRxBytesWaiting(const serialPort_t *instance)
     }
 }
 
+#ifdef USE_DMA
+// Called on idle line when receiving by DMA, to pass what has arrived since the last idle line to the callbacks
+void uartRxDmaIdle(uartPort_t *uartPort)
+{
+    serialPort_t *port = &uartPort->port;
+
+    if (!port->rxCallback && !port->rxFrameCallback) {
+        // read with serialRead()
+        return;
+    }
+
+#ifdef USE_HAL_DRIVER
+    const uint32_t rxDMAHead = __HAL_DMA_GET_COUNTER(uartPort->Handle.hdmarx);
+#else
+    const uint32_t rxDMAHead = xDMA_GetCurrDataCounter(uartPort->rxDMAResource);
+#endif
+
+    // rxDMAPos and rxDMAHead count down from the end of the buffer
+    port->rxBufferTail = port->rxBufferSize - uartPort->rxDMAPos;
+    serialRxFlushBuffer(port, port->rxBufferSize - rxDMAHead);
+    uartPort->rxDMAPos = port->rxBufferSize - port->rxBufferTail;
+}
+#endif
+
 static uint32_t uartTotalTxBytesFree(const serialPort_t *instance)
 {
     const uartPort_t *uartPort = (const uartPort_t*)instance;
@@ -265,6 +290,45 @@ static uint8_t uartRead(serialPort_t *instance)
     return ch;
 }
 
+static uint32_t uartReadBuf(serialPort_t *instance, uint8_t *data, uint32_t count)
+{
+    uartPort_t *uartPort = (uartPort_t *)instance;
+    const uint32_t rxBufferSize = uartPort->port.rxBufferSize;
+    uint32_t tail;
+
+    count = MIN(count, uartTotalRxBytesWaiting(instance));
+
+#ifdef USE_DMA
+    if (uartPort->rxDMAResource) {
+        tail = rxBufferSize - uartPort->rxDMAPos;
+    } else
+#endif
+    {
+        tail = uartPort->port.rxBufferTail;
+    }
+
+    for (uint32_t remaining = count; remaining > 0; ) {
+        // Copy up to the end of the buffer, then continue from its start
+        const uint32_t chunkSize = MIN(rxBufferSize - tail, remaining);
+        memcpy(data, (const void *)&uartPort->port.rxBuffer[tail], chunkSize);
+        data += chunkSize;
+        remaining -= chunkSize;
+        tail = (tail + chunkSize) % rxBufferSize;
+    }
+
+#ifdef USE_DMA
+    if (uartPort->rxDMAResource) {
+        // rxDMAPos counts down from the end of the buffer and is never 0
+        uartPort->rxDMAPos = rxBufferSize - tail;
+    } else
+#endif
+    {
+        uartPort->port.rxBufferTail = tail;
+    }
+
+    return count;
+}
+
 static void uartWrite(serialPort_t *instance, uint8_t ch)
 {
     uartPort_t *uartPort = (uartPort_t *)instance;
@@ -370,6 +434,7 @@ const struct serialPortVTable uartVTable[] = {
         .serialTotalRxWaiting = uartTotalRxBytesWaiting,
         .serialTotalTxFree = uartTotalTxBytesFree,
         .serialRead = uartRead,
+        .readBuf = uartReadBuf,
         .serialSetBaudRate = uartSetBaudRate,
         .isSerialTransmitBufferEmpty = isUartTransmitBufferEmpty,
         .setMode = uartSetMode,
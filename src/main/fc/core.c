@@ -30,6 +30,7 @@
 #include "blackbox/blackbox_fielddefs.h"
 
 #include "build/debug.h"
+#include "build/debug_capture.h"
 
 #include "cli/cli.h"
 
@@ -53,6 +54,7 @@
 #include "drivers/transponder_ir.h"
 
 #include "fc/controlrate_profile.h"
+#include "fc/latency.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
@@ -1002,11 +1004,8 @@ void processRxModes(timeUs_t currentTimeUs)
 
     if (FLIGHT_MODE(ANGLE_MODE) || FLIGHT_MODE(HORIZON_MODE)) {
         LED1_ON;
-        // increase frequency of attitude task to reduce drift when in angle or horizon mode
-        rescheduleTask(TASK_ATTITUDE, TASK_PERIOD_HZ(acc.sampleRateHz / (float)imuConfig()->imu_process_denom));
     } else {
         LED1_OFF;
-        rescheduleTask(TASK_ATTITUDE, TASK_PERIOD_HZ(100));
     }
 
     if (!IS_RC_MODE_ACTIVE(BOXPREARM) && ARMING_FLAG(WAS_ARMED_WITH_PREARM)) {
@@ -1092,9 +1091,15 @@ void processRxModes(timeUs_t currentTimeUs)
 static FAST_CODE_NOINLINE void subTaskPidController(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_PIDLOOP) {startTime = micros();}
+    if (DEBUG_MODE_ACTIVE(DEBUG_PIDLOOP)) {startTime = micros();}
+#ifdef USE_ACC
+    imuPropagateAttitude(pidGetDT());
+#endif
     // PID - note this is function pointer set by setPIDController()
     pidController(currentPidProfile, currentTimeUs);
+#ifdef USE_LATENCY_STATS
+    latencyPidComplete();
+#endif
     DEBUG_SET(DEBUG_PIDLOOP, 1, micros() - startTime);
 
 #ifdef USE_RUNAWAY_TAKEOFF
@@ -1146,7 +1151,7 @@ static FAST_CODE_NOINLINE void subTaskPidController(timeUs_t currentTimeUs)
 static FAST_CODE_NOINLINE void subTaskPidSubprocesses(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_PIDLOOP) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
 
@@ -1184,14 +1189,14 @@ void subTaskTelemetryPollSensors(timeUs_t currentTimeUs)
 static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_CYCLETIME) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_CYCLETIME)) {
         startTime = micros();
         static uint32_t previousMotorUpdateTime;
         const uint32_t currentDeltaTime = startTime - previousMotorUpdateTime;
-        debug[2] = currentDeltaTime;
-        debug[3] = currentDeltaTime - targetPidLooptime;
+        DEBUG_SET(DEBUG_CYCLETIME, 2, currentDeltaTime);
+        DEBUG_SET(DEBUG_CYCLETIME, 3, currentDeltaTime - targetPidLooptime);
         previousMotorUpdateTime = startTime;
-    } else if (debugMode == DEBUG_PIDLOOP) {
+    } else if (DEBUG_MODE_ACTIVE(DEBUG_PIDLOOP)) {
         startTime = micros();
     }
 
@@ -1205,12 +1210,15 @@ static FAST_CODE void subTaskMotorUpdate(timeUs_t currentTimeUs)
 #endif
 
     writeMotors();
+#ifdef USE_LATENCY_STATS
+    latencyMotorOutput();
+#endif
 
 #ifdef USE_DSHOT_TELEMETRY_STATS
-    if (debugMode == DEBUG_DSHOT_RPM_ERRORS && useDshotTelemetry) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_DSHOT_RPM_ERRORS) && useDshotTelemetry) {
         const uint8_t motorCount = MIN(getMotorCount(), 4);
         for (uint8_t i = 0; i < motorCount; i++) {
-            debug[i] = getDshotTelemetryMotorInvalidPercent(i);
+            DEBUG_SET(DEBUG_DSHOT_RPM_ERRORS, i, getDshotTelemetryMotorInvalidPercent(i));
         }
     }
 #endif
@@ -1245,6 +1253,9 @@ FAST_CODE void taskGyroSample(timeUs_t currentTimeUs)
 {
     UNUSED(currentTimeUs);
     gyroUpdate();
+#ifdef USE_LATENCY_STATS
+    latencyGyroSample(gyroGetSampleTimeCycles());
+#endif
     if (pidUpdateCounter % activePidLoopDenom == 0) {
         pidUpdateCounter = 0;
     }
@@ -1274,6 +1285,9 @@ FAST_CODE void taskFiltering(timeUs_t currentTimeUs)
     updateDshotTelemetry();  // decode and update Dshot telemetry
 #endif
     gyroFiltering(currentTimeUs);
+#ifdef USE_LATENCY_STATS
+    latencyFilterComplete();
+#endif
 }
 
 // Function for loop trigger
@@ -1298,6 +1312,10 @@ FAST_CODE void taskMainPidLoop(timeUs_t currentTimeUs)
 
     DEBUG_SET(DEBUG_CYCLETIME, 0, getTaskDeltaTimeUs(TASK_SELF));
     DEBUG_SET(DEBUG_CYCLETIME, 1, getAverageSystemLoadPercent());
+
+#ifdef USE_DEBUG_CAPTURE
+    debugCaptureUpdate(currentTimeUs);
+#endif
 }
 
 bool isFlipOverAfterCrashActive(void)
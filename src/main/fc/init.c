@@ -29,6 +29,7 @@
 
 #include "build/build_config.h"
 #include "build/debug.h"
+#include "build/debug_capture.h"
 #include "build/debug_pin.h"
 
 #include "cms/cms.h"
@@ -276,8 +277,11 @@ void init(void)
 #endif
 
 #if defined(USE_TARGET_CONFIG)
-    // Call once before the config is loaded for any target specific configuration required to support loading the config
+    // Call once before the config is loaded for any target specific configuration required to support loading the config.
+    // Applied to the reset values, what it changes is recorded as part of the defaults the CLI and MSP compare against.
+    pgResetAll();
     targetConfiguration();
+    pgDefaultsCaptureOverrides();
 #endif
 
     enum {
@@ -404,6 +408,9 @@ void init(void)
 #endif
 
     debugMode = systemConfig()->debug_mode;
+#ifdef USE_DEBUG_CAPTURE
+    debugCaptureInit();
+#endif
 
 #ifdef TARGET_PREINIT
     targetPreInit();
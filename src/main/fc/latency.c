@@ -0,0 +1,184 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#ifdef USE_LATENCY_STATS
+
+#include "build/debug.h"
+
+#include "common/maths.h"
+#include "common/utils.h"
+
+#include "drivers/system.h"
+#include "drivers/time.h"
+
+#include "fc/latency.h"
+
+static latencyStats_t latencyStats[LATENCY_PATH_COUNT];
+
+// Time of the gyro sample at each stage of the loop, in cycles
+static FAST_DATA_ZERO_INIT uint32_t gyroSampleCycles;
+static FAST_DATA_ZERO_INIT uint32_t filterSampleCycles;
+static FAST_DATA_ZERO_INIT uint32_t pidSampleCycles;
+static FAST_DATA_ZERO_INIT bool gyroSampleValid;
+static FAST_DATA_ZERO_INIT bool filterSampleValid;
+static FAST_DATA_ZERO_INIT bool pidSampleValid;
+
+// Arrival of the RC frame waiting to be processed, and of the one last processed into the setpoint
+static timeUs_t rxFrameUs;
+static timeUs_t rcCommandFrameUs;
+static bool rxFramePending;
+static bool rcCommandFramePending;
+
+void latencyReset(void)
+{
+    memset(latencyStats, 0, sizeof(latencyStats));
+
+    gyroSampleValid = false;
+    filterSampleValid = false;
+    pidSampleValid = false;
+    rxFramePending = false;
+    rcCommandFramePending = false;
+}
+
+static unsigned latencyBucket(uint32_t latencyUs)
+{
+    if (latencyUs < 2) {
+        return latencyUs;
+    }
+
+    const unsigned octave = llog2(latencyUs);
+    const unsigned bucket = 2 * octave + ((latencyUs >> (octave - 1)) & 1);
+
+    return MIN(bucket, LATENCY_BUCKET_COUNT - 1U);
+}
+
+uint32_t latencyBucketLowerUs(unsigned bucket)
+{
+    if (bucket < 2) {
+        return bucket;
+    }
+
+    const unsigned octave = bucket / 2;
+
+    return (1 << octave) + ((bucket & 1) << (octave - 1));
+}
+
+// DEBUG_LATENCY shows the latest latency of each path in us, in the order of latencyPath_e
+static FAST_CODE void latencyRecord(latencyPath_e path, int32_t latencyUs)
+{
+    latencyStats_t *stats = &latencyStats[path];
+    const uint32_t us = MAX(latencyUs, 0);
+
+    stats->minUs = stats->count ? MIN(stats->minUs, us) : us;
+    stats->count++;
+    stats->sumUs += us;
+    stats->maxUs = MAX(stats->maxUs, us);
+    stats->histogram[latencyBucket(us)]++;
+
+    DEBUG_SET(DEBUG_LATENCY, path, MIN(us, (uint32_t)INT16_MAX));
+}
+
+FAST_CODE void latencyGyroSample(uint32_t sampleCycles)
+{
+    gyroSampleCycles = sampleCycles;
+    gyroSampleValid = true;
+}
+
+FAST_CODE void latencyFilterComplete(void)
+{
+    if (gyroSampleValid) {
+        filterSampleCycles = gyroSampleCycles;
+        filterSampleValid = true;
+        latencyRecord(LATENCY_GYRO_FILTER, clockCyclesToMicros(cmpTimeCycles(getCycleCounter(), filterSampleCycles)));
+    }
+}
+
+FAST_CODE void latencyPidComplete(void)
+{
+    if (filterSampleValid) {
+        pidSampleCycles = filterSampleCycles;
+        pidSampleValid = true;
+        latencyRecord(LATENCY_GYRO_PID, clockCyclesToMicros(cmpTimeCycles(getCycleCounter(), pidSampleCycles)));
+    }
+}
+
+void latencyRxFrame(timeUs_t frameTimeUs)
+{
+    rxFrameUs = frameTimeUs;
+    rxFramePending = true;
+}
+
+FAST_CODE void latencyRcCommandUpdated(void)
+{
+    if (rxFramePending) {
+        rcCommandFrameUs = rxFrameUs;
+        rcCommandFramePending = true;
+        rxFramePending = false;
+    }
+}
+
+FAST_CODE void latencyMotorOutput(void)
+{
+    if (pidSampleValid) {
+        latencyRecord(LATENCY_GYRO_MOTOR, clockCyclesToMicros(cmpTimeCycles(getCycleCounter(), pidSampleCycles)));
+    }
+
+    if (rcCommandFramePending) {
+        latencyRecord(LATENCY_RX_MOTOR, cmpTimeUs(micros(), rcCommandFrameUs));
+        rcCommandFramePending = false;
+    }
+}
+
+const latencyStats_t *latencyGetStats(latencyPath_e path)
+{
+    return &latencyStats[path];
+}
+
+uint32_t latencyMeanUs(const latencyStats_t *stats)
+{
+    return stats->count ? stats->sumUs / stats->count : 0;
+}
+
+// Upper bound of the bucket holding the percentile, limited to the largest latency seen
+uint32_t latencyPercentileUs(const latencyStats_t *stats, unsigned percent)
+{
+    const uint64_t target = ((uint64_t)stats->count * percent + 99) / 100;
+    uint64_t total = 0;
+
+    for (unsigned bucket = 0; bucket < LATENCY_BUCKET_COUNT; bucket++) {
+        total += stats->histogram[bucket];
+        if (total >= target && total > 0) {
+            if (bucket == LATENCY_BUCKET_COUNT - 1) {
+                return stats->maxUs;
+            }
+            return MIN(latencyBucketLowerUs(bucket + 1) - 1, stats->maxUs);
+        }
+    }
+
+    return 0;
+}
+
+#endif // USE_LATENCY_STATS
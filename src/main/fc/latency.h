@@ -0,0 +1,60 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/time.h"
+
+// Latencies are kept as histograms with two buckets per octave, bucket 0 and 1 holding 0 and 1us,
+// bucket 2n from 2^n us and bucket 2n + 1 from 1.5 * 2^n us
+#define LATENCY_BUCKET_COUNT 32
+
+typedef enum {
+    LATENCY_GYRO_FILTER,    // gyro sample to filtering complete
+    LATENCY_GYRO_PID,       // gyro sample to PID complete
+    LATENCY_GYRO_MOTOR,     // gyro sample to motor output
+    LATENCY_RX_MOTOR,       // RC frame arrival to the first motor output using it
+    LATENCY_PATH_COUNT
+} latencyPath_e;
+
+typedef struct latencyStats_s {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+    uint32_t histogram[LATENCY_BUCKET_COUNT];
+} latencyStats_t;
+
+void latencyReset(void);
+
+// Timestamps passed along with the data from sensor to motor output
+void latencyGyroSample(uint32_t sampleCycles);
+void latencyFilterComplete(void);
+void latencyPidComplete(void);
+void latencyRxFrame(timeUs_t frameTimeUs);
+void latencyRcCommandUpdated(void);
+void latencyMotorOutput(void);
+
+const latencyStats_t *latencyGetStats(latencyPath_e path);
+uint32_t latencyMeanUs(const latencyStats_t *stats);
+uint32_t latencyPercentileUs(const latencyStats_t *stats, unsigned percent);
+uint32_t latencyBucketLowerUs(unsigned bucket);
@@ -28,6 +28,7 @@
 #include "build/debug.h"
 
 #include "common/axis.h"
+#include "common/pwl.h"
 #include "common/utils.h"
 
 #include "config/config.h"
@@ -35,6 +36,7 @@
 
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
+#include "fc/latency.h"
 #include "fc/rc.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
@@ -148,14 +150,25 @@ float getMaxRcDeflectionAbs(void)
     return maxRcDeflectionAbs;
 }
 
-#define THROTTLE_LOOKUP_LENGTH 12
-static int16_t lookupThrottleRC[THROTTLE_LOOKUP_LENGTH];    // lookup table for expo & mid THROTTLE
+#define THROTTLE_LOOKUP_LENGTH 11
+static float throttleCurveValues[THROTTLE_LOOKUP_LENGTH];
+static pwl_t throttleCurve;     // expo & mid THROTTLE
 
 static int16_t rcLookupThrottle(int32_t tmp)
 {
-    const int32_t tmp2 = tmp / 100;
     // [0;1000] -> expo -> [MINTHROTTLE;MAXTHROTTLE]
-    return lookupThrottleRC[tmp2] + (tmp - tmp2 * 100) * (lookupThrottleRC[tmp2 + 1] - lookupThrottleRC[tmp2]) / 100;
+    return pwlInterpolate(&throttleCurve, tmp);
+}
+
+// the rates curves are odd functions of stick deflection, so only the positive half is tabulated
+#define RATES_CURVE_POINTS 129
+static float ratesCurveValues[XYZ_AXIS_COUNT][RATES_CURVE_POINTS];
+static pwl_t ratesCurve[XYZ_AXIS_COUNT];
+
+STATIC_UNIT_TESTED float applyRatesCurve(const int axis, const float rcCommandf, const float rcCommandfAbs)
+{
+    const float angleRate = pwlInterpolate(&ratesCurve[axis], rcCommandfAbs);
+    return rcCommandf < 0.0f ? -angleRate : angleRate;
 }
 
 #define SETPOINT_RATE_LIMIT_MIN -1998.0f
@@ -628,6 +641,9 @@ FAST_CODE_NOINLINE void calculateFeedforward(const pidRuntime_t *pid, int axis)
 FAST_CODE void processRcCommand(void)
 {
     if (isRxDataNew) {
+#ifdef USE_LATENCY_STATS
+        latencyRcCommandUpdated();
+#endif
         maxRcDeflectionAbs = 0.0f;
         for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
 
@@ -657,7 +673,7 @@ FAST_CODE void processRcCommand(void)
                 rcDeflectionAbs[axis] = rcCommandfAbs;
                 maxRcDeflectionAbs = fmaxf(maxRcDeflectionAbs, rcCommandfAbs);
 
-                angleRate = applyRates(axis, rcCommandf, rcCommandfAbs);
+                angleRate = applyRatesCurve(axis, rcCommandf, rcCommandfAbs);
             }
 
             rawSetpoint[axis] = constrainf(angleRate, -1.0f * currentControlRateProfile->rate_limit[axis], 1.0f * currentControlRateProfile->rate_limit[axis]);
@@ -772,11 +788,18 @@ bool isMotorsReversed(void)
     return reverseMotors;
 }
 
+static float ratesCurveFn(float rcCommandfAbs, void *args)
+{
+    const int axis = *(int *)args;
+    return applyRates(axis, rcCommandfAbs, rcCommandfAbs);
+}
+
 void initRcProcessing(void)
 {
     rcCommandDivider = 500.0f - rcControlsConfig()->deadband;
     rcCommandYawDivider = 500.0f - rcControlsConfig()->yaw_deadband;
 
+    pwlInitialize(&throttleCurve, throttleCurveValues, THROTTLE_LOOKUP_LENGTH, 0.0f, 1000.0f);
     for (int i = 0; i < THROTTLE_LOOKUP_LENGTH; i++) {
         const int16_t tmp = 10 * i - currentControlRateProfile->thrMid8;
         uint8_t y = 1;
@@ -784,8 +807,9 @@ void initRcProcessing(void)
             y = 100 - currentControlRateProfile->thrMid8;
         if (tmp < 0)
             y = currentControlRateProfile->thrMid8;
-        lookupThrottleRC[i] = 10 * currentControlRateProfile->thrMid8 + tmp * (100 - currentControlRateProfile->thrExpo8 + (int32_t) currentControlRateProfile->thrExpo8 * (tmp * tmp) / (y * y)) / 10;
-        lookupThrottleRC[i] = PWM_RANGE_MIN + PWM_RANGE * lookupThrottleRC[i] / 1000; // [MINTHROTTLE;MAXTHROTTLE]
+        int16_t throttle = 10 * currentControlRateProfile->thrMid8 + tmp * (100 - currentControlRateProfile->thrExpo8 + (int32_t) currentControlRateProfile->thrExpo8 * (tmp * tmp) / (y * y)) / 10;
+        throttle = PWM_RANGE_MIN + PWM_RANGE * throttle / 1000; // [MINTHROTTLE;MAXTHROTTLE]
+        throttleCurveValues[i] = throttle;
     }
 
     switch (currentControlRateProfile->rates_type) {
@@ -808,6 +832,8 @@ void initRcProcessing(void)
     }
 
     for (int i = 0; i < 3; i++) {
+        pwlInitialize(&ratesCurve[i], ratesCurveValues[i], RATES_CURVE_POINTS, 0.0f, 1.0f);
+        pwlFill(&ratesCurve[i], ratesCurveFn, &i);
         maxRcRate[i] = applyRates(i, 1.0f, 1.0f);
 #ifdef USE_FEEDFORWARD
         feedforwardSmoothed[i] = 0.0f;
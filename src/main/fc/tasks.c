@@ -74,6 +74,7 @@
 #include "io/vtx.h"
 
 #include "msp/msp.h"
+#include "msp/msp_dataflash_stream.h"
 #include "msp/msp_serial.h"
 
 #include "osd/osd.h"
@@ -145,7 +146,10 @@ static void taskHandleSerial(timeUs_t currentTimeUs)
     }
 #endif
     bool evaluateMspData = ARMING_FLAG(ARMED) ? MSP_SKIP_NON_MSP_DATA : MSP_EVALUATE_NON_MSP_DATA;
-    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply);
+    mspSerialProcess(evaluateMspData, mspFcProcessCommand, mspFcProcessReply, mspFcProcessOutCommand);
+#ifdef USE_FLASHFS
+    mspDataflashStreamProcess();
+#endif
 }
 
 static void taskBatteryAlerts(timeUs_t currentTimeUs)
@@ -162,6 +166,9 @@ static void taskBatteryAlerts(timeUs_t currentTimeUs)
 static void taskUpdateAccelerometer(timeUs_t currentTimeUs)
 {
     accUpdate(currentTimeUs);
+#if defined(USE_BARO) || defined(USE_GPS)
+    predictEstimatedAltitude(currentTimeUs);
+#endif
 }
 #endif
 
@@ -237,9 +244,7 @@ static void taskUpdateRxMain(timeUs_t currentTimeUs)
         }
     }
 
-    if (debugMode == DEBUG_RX_STATE_TIME) {
-        debug[oldRxState] = rxStateDurationFractionUs[oldRxState] >> RX_TASK_DECAY_SHIFT;
-    }
+    DEBUG_SET(DEBUG_RX_STATE_TIME, oldRxState, rxStateDurationFractionUs[oldRxState] >> RX_TASK_DECAY_SHIFT);
 
     schedulerSetNextStateTime(rxStateDurationFractionUs[rxState] >> RX_TASK_DECAY_SHIFT);
 }
@@ -286,8 +291,7 @@ static void taskUpdateMag(timeUs_t currentTimeUs)
 #if defined(USE_BARO) || defined(USE_GPS)
 static void taskCalculateAltitude(timeUs_t currentTimeUs)
 {
-    UNUSED(currentTimeUs);
-    calculateEstimatedAltitude();
+    calculateEstimatedAltitude(currentTimeUs);
 }
 #endif // USE_BARO || USE_GPS
 
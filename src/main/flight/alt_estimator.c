@@ -0,0 +1,199 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Vertical position estimator.
+ *
+ * A three state Kalman filter (altitude, vertical velocity and accelerometer bias) driven by the
+ * earth frame vertical acceleration and corrected by any number of altitude and vertical velocity
+ * measurements, each with its own variance.
+ *
+ * Sensors report the vehicle as it was some time ago, so measurements are compared against the state
+ * at the time they were taken rather than the current one. The resulting correction is applied to the
+ * current state and to the stored past states, so that the next delayed measurement sees it too.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+
+#include "flight/alt_estimator.h"
+
+#define ALT_EST_INITIAL_ALTITUDE_VARIANCE 10000.0f  // 1m
+#define ALT_EST_INITIAL_VELOCITY_VARIANCE 100.0f    // 10cm/s
+#define ALT_EST_INITIAL_BIAS_VARIANCE     2500.0f   // 50cm/s/s, ~5% of 1G
+#define ALT_EST_MAX_DT_S                  0.1f
+
+void altEstimatorInit(altEstimator_t *est, float biasVariance)
+{
+    memset(est, 0, sizeof(*est));
+    est->biasVariance = biasVariance;
+    est->P[ALT_EST_ACC_BIAS][ALT_EST_ACC_BIAS] = ALT_EST_INITIAL_BIAS_VARIANCE;
+    altEstimatorReset(est, 0.0f);
+}
+
+// Restarts the estimate at rest at the given altitude, keeping the learned accelerometer bias
+void altEstimatorReset(altEstimator_t *est, float altitude)
+{
+    const float biasVariance = est->P[ALT_EST_ACC_BIAS][ALT_EST_ACC_BIAS];
+
+    est->state[ALT_EST_ALTITUDE] = altitude;
+    est->state[ALT_EST_VELOCITY] = 0.0f;
+    memset(est->P, 0, sizeof(est->P));
+    est->P[ALT_EST_ALTITUDE][ALT_EST_ALTITUDE] = ALT_EST_INITIAL_ALTITUDE_VARIANCE;
+    est->P[ALT_EST_VELOCITY][ALT_EST_VELOCITY] = ALT_EST_INITIAL_VELOCITY_VARIANCE;
+    est->P[ALT_EST_ACC_BIAS][ALT_EST_ACC_BIAS] = biasVariance;
+
+    est->historyCount = 0;
+}
+
+static void altEstimatorPushHistory(altEstimator_t *est, timeUs_t currentTimeUs)
+{
+    if (est->historyCount) {
+        const altEstimatorHistory_t *newest = &est->history[est->historyHead];
+        if (cmpTimeUs(currentTimeUs, newest->timeUs) < ALT_EST_HISTORY_INTERVAL_US) {
+            return;
+        }
+        est->historyHead = (est->historyHead + 1) % ALT_EST_HISTORY_SIZE;
+    }
+    if (est->historyCount < ALT_EST_HISTORY_SIZE) {
+        est->historyCount++;
+    }
+
+    altEstimatorHistory_t *entry = &est->history[est->historyHead];
+    entry->altitude = est->state[ALT_EST_ALTITUDE];
+    entry->velocity = est->state[ALT_EST_VELOCITY];
+    entry->timeUs = currentTimeUs;
+}
+
+// accZ is the earth frame vertical acceleration in cm/s/s with gravity removed
+void altEstimatorPredict(altEstimator_t *est, float accZ, float accVariance, timeUs_t currentTimeUs)
+{
+    const float dt = est->lastPredictUs ? constrainf(cmpTimeUs(currentTimeUs, est->lastPredictUs) * 1e-6f, 0.0f, ALT_EST_MAX_DT_S) : 0.0f;
+    est->lastPredictUs = currentTimeUs;
+
+    const float halfDtSq = 0.5f * dt * dt;
+    const float acc = accZ - est->state[ALT_EST_ACC_BIAS];
+
+    est->state[ALT_EST_ALTITUDE] += est->state[ALT_EST_VELOCITY] * dt + acc * halfDtSq;
+    est->state[ALT_EST_VELOCITY] += acc * dt;
+
+    // P = F * P * F' + Q
+    const float F[ALT_EST_STATE_COUNT][ALT_EST_STATE_COUNT] = {
+        { 1.0f, dt,   -halfDtSq },
+        { 0.0f, 1.0f, -dt },
+        { 0.0f, 0.0f, 1.0f },
+    };
+    float FP[ALT_EST_STATE_COUNT][ALT_EST_STATE_COUNT];
+    for (int i = 0; i < ALT_EST_STATE_COUNT; i++) {
+        for (int j = 0; j < ALT_EST_STATE_COUNT; j++) {
+            FP[i][j] = F[i][0] * est->P[0][j] + F[i][1] * est->P[1][j] + F[i][2] * est->P[2][j];
+        }
+    }
+    for (int i = 0; i < ALT_EST_STATE_COUNT; i++) {
+        for (int j = i; j < ALT_EST_STATE_COUNT; j++) {
+            est->P[i][j] = FP[i][0] * F[j][0] + FP[i][1] * F[j][1] + FP[i][2] * F[j][2];
+            est->P[j][i] = est->P[i][j];
+        }
+    }
+
+    // acceleration noise enters through [dt^2/2, dt, 0]
+    est->P[ALT_EST_ALTITUDE][ALT_EST_ALTITUDE] += accVariance * halfDtSq * halfDtSq;
+    est->P[ALT_EST_ALTITUDE][ALT_EST_VELOCITY] += accVariance * halfDtSq * dt;
+    est->P[ALT_EST_VELOCITY][ALT_EST_ALTITUDE] = est->P[ALT_EST_ALTITUDE][ALT_EST_VELOCITY];
+    est->P[ALT_EST_VELOCITY][ALT_EST_VELOCITY] += accVariance * dt * dt;
+    est->P[ALT_EST_ACC_BIAS][ALT_EST_ACC_BIAS] += est->biasVariance * dt;
+
+    altEstimatorPushHistory(est, currentTimeUs);
+}
+
+// Returns the estimated altitude or velocity delayUs ago, interpolating between stored states
+static float altEstimatorPastState(const altEstimator_t *est, altEstimatorState_e index, timeDelta_t delayUs)
+{
+    if (delayUs <= 0 || !est->historyCount) {
+        return est->state[index];
+    }
+
+    const timeUs_t targetUs = est->lastPredictUs - delayUs;
+    const altEstimatorHistory_t *newer = NULL;
+    const altEstimatorHistory_t *older = NULL;
+    for (int i = 0; i < est->historyCount; i++) {
+        older = &est->history[(est->historyHead + ALT_EST_HISTORY_SIZE - i) % ALT_EST_HISTORY_SIZE];
+        if (cmpTimeUs(older->timeUs, targetUs) <= 0) {
+            break;
+        }
+        newer = older;
+    }
+
+    const float olderValue = index == ALT_EST_ALTITUDE ? older->altitude : older->velocity;
+    if (!newer || cmpTimeUs(older->timeUs, targetUs) > 0) {
+        // newer than the newest entry, or older than the history goes back
+        return newer ? olderValue : est->state[index];
+    }
+
+    const float newerValue = index == ALT_EST_ALTITUDE ? newer->altitude : newer->velocity;
+    const float k = (float)cmpTimeUs(targetUs, older->timeUs) / cmpTimeUs(newer->timeUs, older->timeUs);
+    return olderValue + k * (newerValue - olderValue);
+}
+
+static void altEstimatorCorrect(altEstimator_t *est, altEstimatorState_e index, float measurement, float variance, timeDelta_t delayUs)
+{
+    const float innovation = measurement - altEstimatorPastState(est, index, delayUs);
+    const float innovationVariance = est->P[index][index] + variance;
+    if (innovationVariance <= 0.0f) {
+        return;
+    }
+
+    float gain[ALT_EST_STATE_COUNT];
+    float row[ALT_EST_STATE_COUNT];
+    for (int i = 0; i < ALT_EST_STATE_COUNT; i++) {
+        gain[i] = est->P[i][index] / innovationVariance;
+        row[i] = est->P[index][i];
+    }
+
+    for (int i = 0; i < ALT_EST_STATE_COUNT; i++) {
+        est->state[i] += gain[i] * innovation;
+        for (int j = 0; j < ALT_EST_STATE_COUNT; j++) {
+            est->P[i][j] -= gain[i] * row[j];
+        }
+    }
+
+    // shift the stored states too, so the correction isn't applied again by the next delayed measurement
+    const float altitudeCorrection = gain[ALT_EST_ALTITUDE] * innovation;
+    const float velocityCorrection = gain[ALT_EST_VELOCITY] * innovation;
+    for (int i = 0; i < est->historyCount; i++) {
+        est->history[i].altitude += altitudeCorrection;
+        est->history[i].velocity += velocityCorrection;
+    }
+}
+
+void altEstimatorCorrectAltitude(altEstimator_t *est, float altitude, float variance, timeDelta_t delayUs)
+{
+    altEstimatorCorrect(est, ALT_EST_ALTITUDE, altitude, variance, delayUs);
+}
+
+void altEstimatorCorrectVelocity(altEstimator_t *est, float velocity, float variance, timeDelta_t delayUs)
+{
+    altEstimatorCorrect(est, ALT_EST_VELOCITY, velocity, variance, delayUs);
+}
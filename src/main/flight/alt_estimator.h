@@ -0,0 +1,58 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "common/time.h"
+
+#define ALT_EST_HISTORY_SIZE        32      // covers ALT_EST_HISTORY_SIZE * ALT_EST_HISTORY_INTERVAL_US of sensor delay
+#define ALT_EST_HISTORY_INTERVAL_US 10000
+
+typedef enum {
+    ALT_EST_ALTITUDE = 0,   // cm, up positive
+    ALT_EST_VELOCITY,       // cm/s, up positive
+    ALT_EST_ACC_BIAS,       // cm/s/s, subtracted from the earth frame acceleration
+    ALT_EST_STATE_COUNT
+} altEstimatorState_e;
+
+typedef struct altEstimatorHistory_s {
+    float altitude;
+    float velocity;
+    timeUs_t timeUs;
+} altEstimatorHistory_t;
+
+typedef struct altEstimator_s {
+    float state[ALT_EST_STATE_COUNT];
+    float P[ALT_EST_STATE_COUNT][ALT_EST_STATE_COUNT];  // state covariance
+    float biasVariance;                                 // acc bias random walk, (cm/s/s)^2 per second
+    timeUs_t lastPredictUs;
+    // past states, for fusing delayed measurements
+    altEstimatorHistory_t history[ALT_EST_HISTORY_SIZE];
+    uint8_t historyHead;
+    uint8_t historyCount;
+} altEstimator_t;
+
+void altEstimatorInit(altEstimator_t *est, float biasVariance);
+void altEstimatorReset(altEstimator_t *est, float altitude);
+void altEstimatorPredict(altEstimator_t *est, float accZ, float accVariance, timeUs_t currentTimeUs);
+void altEstimatorCorrectAltitude(altEstimator_t *est, float altitude, float variance, timeDelta_t delayUs);
+void altEstimatorCorrectVelocity(altEstimator_t *est, float velocity, float variance, timeDelta_t delayUs);
@@ -254,7 +254,7 @@ FAST_CODE void dynNotchUpdate(void)
 static FAST_CODE_NOINLINE void dynNotchProcess(void)
 {
     uint32_t startTime = 0;
-    if (debugMode == DEBUG_FFT_TIME) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_FFT_TIME)) {
         startTime = micros();
     }
 
@@ -113,7 +113,7 @@ quaternion offset = QUATERNION_INITIALIZE;
 // absolute angle inclination in multiple of 0.1 degree    180 deg = 1800
 attitudeEulerAngles_t attitude = EULER_INITIALIZE;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 3);
+PG_REGISTER_WITH_RESET_TEMPLATE(imuConfig_t, imuConfig, PG_IMU_CONFIG, 4);
 
 #ifdef USE_RACE_PRO
 #define DEFAULT_SMALL_ANGLE 180
@@ -125,7 +125,6 @@ PG_RESET_TEMPLATE(imuConfig_t, imuConfig,
     .imu_dcm_kp = 2500,      // 1.0 * 10000
     .imu_dcm_ki = 0,         // 0.003 * 10000
     .small_angle = DEFAULT_SMALL_ANGLE,
-    .imu_process_denom = 2,
     .mag_declination = 0
 );
 
@@ -210,7 +209,38 @@ static float invSqrt(float x)
     return 1.0f / sqrtf(x);
 }
 
-// g[xyz] - gyro reading, in rad/s
+// Integrates a body rate, in rad/s, into the attitude quaternion
+static void imuIntegrateQuaternion(float dt, float gx, float gy, float gz)
+{
+    // Integrate rate of change of quaternion
+    gx *= (0.5f * dt);
+    gy *= (0.5f * dt);
+    gz *= (0.5f * dt);
+
+    quaternion buffer;
+    buffer.w = q.w;
+    buffer.x = q.x;
+    buffer.y = q.y;
+    buffer.z = q.z;
+
+    q.w += (-buffer.x * gx - buffer.y * gy - buffer.z * gz);
+    q.x += (+buffer.w * gx + buffer.y * gz - buffer.z * gy);
+    q.y += (+buffer.w * gy - buffer.x * gz + buffer.z * gx);
+    q.z += (+buffer.w * gz + buffer.x * gy - buffer.y * gx);
+
+    // Normalise quaternion
+    float recipNorm = invSqrt(sq(q.w) + sq(q.x) + sq(q.y) + sq(q.z));
+    q.w *= recipNorm;
+    q.x *= recipNorm;
+    q.y *= recipNorm;
+    q.z *= recipNorm;
+
+    // Pre-compute rotation matrix from quaternion
+    imuComputeRotationMatrix();
+}
+
+// Applies the accelerometer, mag and CoG corrections. The gyro itself is integrated at PID rate by imuPropagateAttitude().
+// g[xyz] - gyro reading, in rad/s, only used to limit the integral term while spinning
 // useAcc, a[xyz] - accelerometer reading, direction only, normalized internally
 // headingErrMag - heading error (in earth frame) derived from magnetometter, rad/s around Z axis (* dcmKpGain)
 // headingErrCog - heading error (in earth frame) derived from CourseOverGround, rad/s around Z axis (* dcmKpGain)
@@ -269,35 +299,10 @@ STATIC_UNIT_TESTED void imuMahonyAHRSupdate(float dt,
     }
 
     // Apply proportional and integral feedback
-    gx += dcmKpGain * ex + integralFBx;
-    gy += dcmKpGain * ey + integralFBy;
-    gz += dcmKpGain * ez + integralFBz;
-
-    // Integrate rate of change of quaternion
-    gx *= (0.5f * dt);
-    gy *= (0.5f * dt);
-    gz *= (0.5f * dt);
-
-    quaternion buffer;
-    buffer.w = q.w;
-    buffer.x = q.x;
-    buffer.y = q.y;
-    buffer.z = q.z;
-
-    q.w += (-buffer.x * gx - buffer.y * gy - buffer.z * gz);
-    q.x += (+buffer.w * gx + buffer.y * gz - buffer.z * gy);
-    q.y += (+buffer.w * gy - buffer.x * gz + buffer.z * gx);
-    q.z += (+buffer.w * gz + buffer.x * gy - buffer.y * gx);
-
-    // Normalise quaternion
-    float recipNorm = invSqrt(sq(q.w) + sq(q.x) + sq(q.y) + sq(q.z));
-    q.w *= recipNorm;
-    q.x *= recipNorm;
-    q.y *= recipNorm;
-    q.z *= recipNorm;
-
-    // Pre-compute rotation matrix from quaternion
-    imuComputeRotationMatrix();
+    imuIntegrateQuaternion(dt,
+                           dcmKpGain * ex + integralFBx,
+                           dcmKpGain * ey + integralFBy,
+                           dcmKpGain * ez + integralFBz);
 
     attitudeIsEstablished = true;
 }
@@ -490,7 +495,7 @@ static void imuDebug_GPS_RESCUE_HEADING(void)
 {
     // Encapsulate additional operations in a block so that it is only executed when the according debug mode is used
     // Only re-calculate magYaw when there is a new Mag data reading, to avoid spikes
-    if (debugMode == DEBUG_GPS_RESCUE_HEADING && mag.isNewMagADCFlag) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_GPS_RESCUE_HEADING) && mag.isNewMagADCFlag) {
         fpVector3_t mag_bf = {{mag.magADC[X], mag.magADC[Y], mag.magADC[Z]}};
         fpVector3_t mag_ef;
         matrixVectorMul(&mag_ef, (const fpMat33_t*)&rMat, &mag_bf); // BF->EF true north
@@ -707,6 +712,28 @@ static int calculateThrottleAngleCorrection(void)
     return lrintf(throttleAngleValue * sin_approx(angle / (900.0f * M_PIf / 2.0f)));
 }
 
+// Gyro only attitude propagation, run every PID loop so that self levelling sees the current attitude
+// rather than that of the last imuUpdateAttitude(). dt in seconds.
+void FAST_CODE imuPropagateAttitude(float dt)
+{
+#if defined(SIMULATOR_BUILD) && !defined(USE_IMU_CALC)
+    // attitude comes from the simulator
+    UNUSED(dt);
+#else
+    if (!attitudeIsEstablished) {
+        return;
+    }
+
+    IMU_LOCK;
+    imuIntegrateQuaternion(dt, DEGREES_TO_RADIANS(gyro.gyroADCf[X]), DEGREES_TO_RADIANS(gyro.gyroADCf[Y]), DEGREES_TO_RADIANS(gyro.gyroADCf[Z]));
+    if (FLIGHT_MODE(ANGLE_MODE | HORIZON_MODE | GPS_RESCUE_MODE)) {
+        // otherwise the Euler angles can wait for imuUpdateAttitude()
+        imuUpdateEulerAngles();
+    }
+    IMU_UNLOCK;
+#endif
+}
+
 void imuUpdateAttitude(timeUs_t currentTimeUs)
 {
     if (sensors(SENSOR_ACC) && acc.isAccelUpdatedAtLeastOnce) {
@@ -56,7 +56,6 @@ typedef struct imuConfig_s {
     uint16_t imu_dcm_kp;          // DCM filter proportional gain ( x 10000)
     uint16_t imu_dcm_ki;          // DCM filter integral gain ( x 10000)
     uint8_t small_angle;
-    uint8_t imu_process_denom;
     uint16_t mag_declination;     // Magnetic declination in degrees * 10
 } imuConfig_t;
 
@@ -72,6 +71,7 @@ void imuConfigure(uint16_t throttle_correction_angle, uint8_t throttle_correctio
 float getSinPitchAngle(void);
 float getCosTiltAngle(void);
 void getQuaternion(quaternion * q);
+void imuPropagateAttitude(float dt);
 void imuUpdateAttitude(timeUs_t currentTimeUs);
 
 void imuInit(void);
@@ -644,7 +644,7 @@ STATIC_UNIT_TESTED void rotateItermAndAxisError(void)
 {
     if (pidRuntime.itermRotation
 #if defined(USE_ABSOLUTE_CONTROL)
-        || pidRuntime.acGain > 0 || debugMode == DEBUG_AC_ERROR
+        || pidRuntime.acGain > 0 || DEBUG_MODE_ACTIVE(DEBUG_AC_ERROR)
 #endif
         ) {
         const float gyroToAngle = pidRuntime.dT * RAD;
@@ -653,7 +653,7 @@ STATIC_UNIT_TESTED void rotateItermAndAxisError(void)
             rotationRads[i] = gyro.gyroADCf[i] * gyroToAngle;
         }
 #if defined(USE_ABSOLUTE_CONTROL)
-        if (pidRuntime.acGain > 0 || debugMode == DEBUG_AC_ERROR) {
+        if (pidRuntime.acGain > 0 || DEBUG_MODE_ACTIVE(DEBUG_AC_ERROR)) {
             rotateVector(axisError, rotationRads);
         }
 #endif
@@ -674,7 +674,7 @@ STATIC_UNIT_TESTED void rotateItermAndAxisError(void)
 #if defined(USE_ABSOLUTE_CONTROL)
 STATIC_UNIT_TESTED void applyAbsoluteControl(const int axis, const float gyroRate, float *currentPidSetpoint, float *itermErrorRate)
 {
-    if (pidRuntime.acGain > 0 || debugMode == DEBUG_AC_ERROR) {
+    if (pidRuntime.acGain > 0 || DEBUG_MODE_ACTIVE(DEBUG_AC_ERROR)) {
         const float setpointLpf = pt1FilterApply(&pidRuntime.acLpf[axis], *currentPidSetpoint);
         const float setpointHpf = fabsf(*currentPidSetpoint - setpointLpf);
         float acErrorRate = 0;
@@ -972,7 +972,7 @@ void FAST_CODE pidController(const pidProfile_t *pidProfile, timeUs_t currentTim
         gyroRateDterm[axis] = gyro.gyroADCf[axis];
 
         // Log the unfiltered D for ROLL and PITCH
-        if (debugMode == DEBUG_D_LPF && axis != FD_YAW) {
+        if (DEBUG_MODE_ACTIVE(DEBUG_D_LPF) && axis != FD_YAW) {
             const float delta = (previousRawGyroRateDterm[axis] - gyroRateDterm[axis]) * pidRuntime.pidFrequency / D_LPF_RAW_SCALE;
             previousRawGyroRateDterm[axis] = gyroRateDterm[axis];
             DEBUG_SET(DEBUG_D_LPF, axis, lrintf(delta)); // debug d_lpf 2 and 3 used for pre-TPA D
@@ -28,11 +28,12 @@
 
 #include "build/debug.h"
 
+#include "common/axis.h"
 #include "common/maths.h"
-#include "common/filter.h"
 
 #include "fc/runtime_config.h"
 
+#include "flight/alt_estimator.h"
 #include "flight/position.h"
 #include "flight/imu.h"
 #include "flight/pid.h"
@@ -42,7 +43,9 @@
 #include "scheduler/scheduler.h"
 
 #include "sensors/sensors.h"
+#include "sensors/acceleration.h"
 #include "sensors/barometer.h"
+#include "sensors/rangefinder.h"
 
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
@@ -52,25 +55,36 @@ static float zeroedAltitudeCm = 0.0f;
 
 #if defined(USE_BARO) || defined(USE_GPS)
 static float zeroedAltitudeDerivative = 0.0f;
+static altEstimator_t altEstimator;
 #endif
 
-static pt2Filter_t altitudeLpf;
-static pt2Filter_t altitudeDerivativeLpf;
 #ifdef USE_VARIO
 static int16_t estimatedVario = 0; // in cm/s
 #endif
 
-void positionInit(void)
-{
-    const float sampleTimeS = HZ_TO_INTERVAL(TASK_ALTITUDE_RATE_HZ);
+#define GRAVITY_CMSS                980.665f
+
+// Sensor noise, as standard deviations
+#define ACC_NOISE_CMSS              50.0f   // vibration, cm/s/s
+#define NO_ACC_NOISE_CMSS           500.0f  // with no accelerometer the estimate is driven by the measurements alone
+#define ACC_BIAS_NOISE_CMSS         5.0f    // acc bias drift, cm/s/s per sqrt(s)
+#define BARO_NOISE_CM               50.0f
+#define GPS_ALT_NOISE_CM            500.0f  // at full GPS trust, when the GPS doesn't report vertical accuracy
+#define GPS_ALT_MIN_NOISE_CM        100.0f
+#define GPS_VEL_MIN_NOISE_CMS       10.0f
+#define RANGEFINDER_NOISE_CM        5.0f
+#define DISARMED_NOISE_CM           10.0f   // while disarmed the craft is assumed to be at rest at zero altitude
 
-    const float altitudeCutoffHz = positionConfig()->altitude_lpf / 100.0f;
-    const float altitudeGain = pt2FilterGain(altitudeCutoffHz, sampleTimeS);
-    pt2FilterInit(&altitudeLpf, altitudeGain);
+// Age of each sensor's data when it reaches us
+#define BARO_DELAY_US               20000
+#define GPS_DELAY_US                100000
+#define RANGEFINDER_DELAY_US        50000
 
-    const float altitudeDerivativeCutoffHz = positionConfig()->altitude_d_lpf / 100.0f;
-    const float altitudeDerivativeGain = pt2FilterGain(altitudeDerivativeCutoffHz, sampleTimeS);
-    pt2FilterInit(&altitudeDerivativeLpf, altitudeDerivativeGain);
+void positionInit(void)
+{
+#if defined(USE_BARO) || defined(USE_GPS)
+    altEstimatorInit(&altEstimator, sq(ACC_BIAS_NOISE_CMSS));
+#endif
 }
 
 typedef enum {
@@ -79,17 +93,30 @@ typedef enum {
     GPS_ONLY
 } altitudeSource_e;
 
-PG_REGISTER_WITH_RESET_TEMPLATE(positionConfig_t, positionConfig, PG_POSITION, 4);
+PG_REGISTER_WITH_RESET_TEMPLATE(positionConfig_t, positionConfig, PG_POSITION, 5);
 
 PG_RESET_TEMPLATE(positionConfig_t, positionConfig,
     .altitude_source = DEFAULT,
     .altitude_prefer_baro = 100, // percentage 'trust' of baro data
-    .altitude_lpf = 300,
     .altitude_d_lpf = 100,
 );
 
 #if defined(USE_BARO) || defined(USE_GPS)
-void calculateEstimatedAltitude(void)
+#ifdef USE_ACC
+// Runs at the accelerometer rate, between the sensor updates in calculateEstimatedAltitude()
+void predictEstimatedAltitude(timeUs_t currentTimeUs)
+{
+    if (!acc.isAccelUpdatedAtLeastOnce) {
+        return;
+    }
+
+    // earth frame vertical acceleration, with gravity removed
+    const float accZ = (rMat[Z][X] * acc.accADC[X] + rMat[Z][Y] * acc.accADC[Y] + rMat[Z][Z] * acc.accADC[Z]) * acc.dev.acc_1G_rec;
+    altEstimatorPredict(&altEstimator, (accZ - 1.0f) * GRAVITY_CMSS, sq(ACC_NOISE_CMSS), currentTimeUs);
+}
+#endif
+
+void calculateEstimatedAltitude(timeUs_t currentTimeUs)
 {
     static bool wasArmed = false;
     static bool useZeroedGpsAltitude = false; // whether a zero for the GPS altitude value exists
@@ -97,17 +124,36 @@ void calculateEstimatedAltitude(void)
     static float gpsAltOffsetCm = 0.0f;
     static float baroAltOffsetCm = 0.0f;
     static float newBaroAltOffsetCm = 0.0f;
+#ifdef USE_BARO
+    static float lastBaroAltCm = 0.0f;
+#endif
+#ifdef USE_GPS
+    static uint8_t lastGpsUpdate = 0;
+#endif
+#ifdef USE_RANGEFINDER
+    static int32_t lastRangefinderAltCm = RANGEFINDER_OUT_OF_RANGE;
+    static float rangefinderAltOffsetCm = 0.0f;
+#endif
 
     float baroAltCm = 0.0f;
     float gpsTrust = 0.3f; // if no pDOP value, use 0.3, intended range 0-1;
     bool haveBaroAlt = false; // true if baro exists and has been calibrated on power up
+    bool newBaroAlt = false; // true if there has been a baro sample since the last run
     bool haveGpsAlt = false; // true if GPS is connected and while it has a 3D fix, set each run to false
+    bool newGpsAlt = false; // true if there has been a GPS solution since the last run
+
+    if (!sensors(SENSOR_ACC)) {
+        // no accelerometer task to predict from
+        altEstimatorPredict(&altEstimator, 0.0f, sq(NO_ACC_NOISE_CMSS), currentTimeUs);
+    }
 
     // *** Get sensor data
 #ifdef USE_BARO
     if (sensors(SENSOR_BARO)) {
         baroAltCm = getBaroAltitude();
         haveBaroAlt = true; // false only if there is no sensor on the board, or it has failed
+        newBaroAlt = baroAltCm != lastBaroAltCm;
+        lastBaroAltCm = baroAltCm;
     }
 #endif
 #ifdef USE_GPS
@@ -116,15 +162,16 @@ void calculateEstimatedAltitude(void)
         // On loss of 3D fix, gpsAltCm remains at the last value, haveGpsAlt becomes false, and gpsTrust goes to zero.
         gpsAltCm = gpsSol.llh.altCm; // static, so hold last altitude value if 3D fix is lost to prevent fly to moon
         haveGpsAlt = true; // stays false if no 3D fix
+        newGpsAlt = GPS_update != lastGpsUpdate;
         if (gpsSol.dop.pdop != 0) {
             // pDOP of 1.0 is good.  100 is very bad.  Our gpsSol.dop.pdop values are *100
             // When pDOP is a value less than 3.3, GPS trust will be stronger than default.
             gpsTrust = 100.0f / gpsSol.dop.pdop;
-            // *** TO DO - investigate if we should use vDOP or vACC with UBlox units;
         }
         // always use at least 10% of other sources besides gps if available
         gpsTrust = MIN(gpsTrust, 0.9f);
     }
+    lastGpsUpdate = GPS_update;
 #endif
 
     //  ***  DISARMED  ***
@@ -144,7 +191,12 @@ void calculateEstimatedAltitude(void)
                 displayAltitudeCm = gpsAltCm; // estimatedAltitude shows most recent ASL GPS altitude in OSD and sensors, while disarmed
             }
         }
+
+        // hold the estimate at rest at zero, which lets it learn the accelerometer bias before takeoff
+        altEstimatorCorrectAltitude(&altEstimator, 0.0f, sq(DISARMED_NOISE_CM), 0);
+        altEstimatorCorrectVelocity(&altEstimator, 0.0f, sq(DISARMED_NOISE_CM), 0);
         zeroedAltitudeCm = 0.0f; // always hold relativeAltitude at zero while disarmed
+        zeroedAltitudeDerivative = 0.0f;
         DEBUG_SET(DEBUG_ALTITUDE, 2, gpsAltCm / 100.0f); // Absolute altitude ASL in metres, max 32,767m
     //  ***  ARMED  ***
     } else {
@@ -155,60 +207,79 @@ void calculateEstimatedAltitude(void)
 
         baroAltCm -= baroAltOffsetCm; // use smoothed baro with most recent zero from disarm period
 
+        float gpsAltZeroedCm = 0.0f;
         if (haveGpsAlt) { // update relativeAltitude with every new gpsAlt value, or hold the previous value until 3D lock recovers
             if (!useZeroedGpsAltitude && haveBaroAlt) { // armed without zero offset, can use baro values to zero later
                 gpsAltOffsetCm = gpsAltCm - baroAltCm; // not very accurate
                 useZeroedGpsAltitude = true;
             }
-            if (useZeroedGpsAltitude) { // normal situation
-                zeroedAltitudeCm = gpsAltCm - gpsAltOffsetCm; // now that we have a GPS offset value, we can use it to zero relativeAltitude
-            }
+            gpsAltZeroedCm = gpsAltCm - gpsAltOffsetCm; // now that we have a GPS offset value, we can use it to zero relativeAltitude
         } else {
             gpsTrust = 0.0f;
-            // TO DO - smoothly reduce GPS trust, rather than immediately dropping to zero for what could be only a very brief loss of 3D fix 
         }
-        DEBUG_SET(DEBUG_ALTITUDE, 2, lrintf(zeroedAltitudeCm / 10.0f)); // Relative altitude above takeoff, to 0.1m, rolls over at 3,276.7m
-        
-        // Empirical mixing of GPS and Baro altitudes
-        if (useZeroedGpsAltitude && (positionConfig()->altitude_source == DEFAULT || positionConfig()->altitude_source == GPS_ONLY)) {
-            if (haveBaroAlt && positionConfig()->altitude_source == DEFAULT) {
-                // mix zeroed GPS with Baro altitude data, if Baro data exists if are in default altitude control mode 
-                const float absDifferenceM = fabsf(zeroedAltitudeCm - baroAltCm) / 100.0f * positionConfig()->altitude_prefer_baro / 100.0f;
-                if (absDifferenceM > 1.0f) { // when there is a large difference, favour Baro
-                    gpsTrust /=  absDifferenceM;
+        DEBUG_SET(DEBUG_ALTITUDE, 2, lrintf(gpsAltZeroedCm / 10.0f)); // Relative altitude above takeoff, to 0.1m, rolls over at 3,276.7m
+
+        const bool useBaro = haveBaroAlt && (positionConfig()->altitude_source == BARO_ONLY
+            || (positionConfig()->altitude_source == DEFAULT && positionConfig()->altitude_prefer_baro > 0));
+        const bool useGps = useZeroedGpsAltitude && (positionConfig()->altitude_source == GPS_ONLY
+            || positionConfig()->altitude_source == DEFAULT);
+
+        if (useBaro && newBaroAlt) {
+            // altitude_prefer_baro scales how much the baro is trusted relative to the other sensors
+            const float baroVariance = sq(BARO_NOISE_CM) * (positionConfig()->altitude_source == DEFAULT ? 100.0f / positionConfig()->altitude_prefer_baro : 1.0f);
+            altEstimatorCorrectAltitude(&altEstimator, baroAltCm, baroVariance, BARO_DELAY_US);
+        }
+
+#ifdef USE_GPS
+        if (useGps && haveGpsAlt && newGpsAlt) {
+            // u-blox reports the vertical and speed accuracy, otherwise derive it from pDOP
+            float gpsAltNoiseCm = gpsSol.acc.vAcc ? gpsSol.acc.vAcc / 10.0f : GPS_ALT_NOISE_CM / gpsTrust;
+            gpsAltNoiseCm = MAX(gpsAltNoiseCm, GPS_ALT_MIN_NOISE_CM);
+            altEstimatorCorrectAltitude(&altEstimator, gpsAltZeroedCm, sq(gpsAltNoiseCm), GPS_DELAY_US);
+
+            if (gpsSol.acc.sAcc) {
+                const float gpsVelNoiseCms = MAX(gpsSol.acc.sAcc / 10.0f, GPS_VEL_MIN_NOISE_CMS);
+                altEstimatorCorrectVelocity(&altEstimator, gpsSol.verticalSpeed, sq(gpsVelNoiseCms), GPS_DELAY_US);
+            }
+        }
+#else
+        UNUSED(useGps);
+        UNUSED(newGpsAlt);
+#endif
+
+#ifdef USE_RANGEFINDER
+        if (sensors(SENSOR_RANGEFINDER)) {
+            // the rangefinder measures height above the ground below, which is only relative to the takeoff
+            // point while it stays in range, so re-zero it against the estimate each time it comes into range
+            const int32_t rangefinderAltCm = rangefinderGetLatestAltitude();
+            if (rangefinderAltCm > RANGEFINDER_OUT_OF_RANGE) {
+                if (lastRangefinderAltCm <= RANGEFINDER_OUT_OF_RANGE) {
+                    rangefinderAltOffsetCm = altEstimator.state[ALT_EST_ALTITUDE] - rangefinderAltCm;
+                } else if (rangefinderAltCm != lastRangefinderAltCm) {
+                    altEstimatorCorrectAltitude(&altEstimator, rangefinderAltCm + rangefinderAltOffsetCm, sq(RANGEFINDER_NOISE_CM), RANGEFINDER_DELAY_US);
                 }
-                zeroedAltitudeCm = zeroedAltitudeCm * gpsTrust + baroAltCm * (1.0f - gpsTrust);
             }
-        } else if (haveBaroAlt && (positionConfig()->altitude_source == DEFAULT || positionConfig()->altitude_source == BARO_ONLY)) {
-            zeroedAltitudeCm = baroAltCm; // use Baro if no GPS data, or we want Baro only
+            lastRangefinderAltCm = rangefinderAltCm;
         }
-    }
+#endif
 
-    zeroedAltitudeCm = pt2FilterApply(&altitudeLpf, zeroedAltitudeCm);
-    // NOTE: this filter must receive 0 as its input, for the whole disarmed time, to ensure correct zeroed values on arming
+        zeroedAltitudeCm = altEstimator.state[ALT_EST_ALTITUDE];
+        zeroedAltitudeDerivative = altEstimator.state[ALT_EST_VELOCITY];
+    }
 
     if (wasArmed) {
-        displayAltitudeCm = zeroedAltitudeCm; // while armed, show filtered relative altitude in OSD / sensors tab
+        displayAltitudeCm = zeroedAltitudeCm; // while armed, show relative altitude in OSD / sensors tab
     }
 
-    // *** calculate Vario signal
-    static float previousZeroedAltitudeCm = 0.0f;
-    zeroedAltitudeDerivative = (zeroedAltitudeCm - previousZeroedAltitudeCm) * TASK_ALTITUDE_RATE_HZ; // cm/s
-    previousZeroedAltitudeCm = zeroedAltitudeCm;
-
-    zeroedAltitudeDerivative = pt2FilterApply(&altitudeDerivativeLpf, zeroedAltitudeDerivative);
-
 #ifdef USE_VARIO
     estimatedVario = lrintf(zeroedAltitudeDerivative);
     estimatedVario = applyDeadband(estimatedVario, 10); // ignore climb rates less than 0.1 m/s
 #endif
- 
+
     // *** set debugs
     DEBUG_SET(DEBUG_ALTITUDE, 0, (int32_t)(100 * gpsTrust));
     DEBUG_SET(DEBUG_ALTITUDE, 1, lrintf(baroAltCm / 10.0f)); // Relative altitude above takeoff, to 0.1m, rolls over at 3,276.7m
-#ifdef USE_VARIO
-    DEBUG_SET(DEBUG_ALTITUDE, 3, estimatedVario);
-#endif
+    DEBUG_SET(DEBUG_ALTITUDE, 3, lrintf(zeroedAltitudeDerivative));
     DEBUG_SET(DEBUG_RTH, 1, lrintf(displayAltitudeCm / 10.0f));
 }
 #endif //defined(USE_BARO) || defined(USE_GPS)
@@ -27,13 +27,13 @@
 typedef struct positionConfig_s {
     uint8_t altitude_source;
     uint8_t altitude_prefer_baro;
-    uint16_t altitude_lpf;                // lowpass cutoff (value / 100) Hz for altitude smoothing
     uint16_t altitude_d_lpf;              // lowpass for (value / 100) Hz for altitude derivative smoothing
 } positionConfig_t;
 
 PG_DECLARE(positionConfig_t, positionConfig);
 
-void calculateEstimatedAltitude(void);
+void predictEstimatedAltitude(timeUs_t currentTimeUs);
+void calculateEstimatedAltitude(timeUs_t currentTimeUs);
 void positionInit(void);
 int32_t getEstimatedAltitudeCm(void);
 float getAltitude(void);
@@ -33,6 +33,7 @@
 
 #include "drivers/display.h"
 #include "drivers/osd.h"
+#include "drivers/time.h"
 
 #include "io/displayport_msp.h"
 
@@ -47,6 +48,69 @@
 static displayPort_t mspDisplayPort;
 static serialPortIdentifier_e displayPortSerial;
 
+// The canvas holds what the remote display shows once everything marked dirty has been sent.
+// Only changed cells are sent on drawScreen, merged into string writes, rather than clearing
+// and redrawing the whole screen every frame. A full refresh is sent periodically to resync.
+#ifdef USE_OSD_HD
+#define MSP_DP_CANVAS_CELLS (OSD_HD_COLS * OSD_HD_ROWS)
+#else
+#define MSP_DP_CANVAS_CELLS (OSD_SD_COLS * OSD_SD_ROWS)
+#endif
+#define MSP_DP_FRAME_OVERHEAD 6 // MSP V1 header, size, command and checksum
+#define MSP_DP_WRITE_OVERHEAD (MSP_DP_FRAME_OVERHEAD + 4)
+// unchanged cells are resent rather than starting a new write if that is cheaper
+#define MSP_DP_MERGE_GAP (MSP_DP_WRITE_OVERHEAD - 2)
+#define MSP_DP_FULL_REFRESH_INTERVAL_MS 1000
+#define MSP_DP_MAX_SYS_ELEMENTS DISPLAYPORT_SYS_COUNT
+
+#define MSP_DP_CELL(c, attr) ((uint16_t)((attr) << 8 | (c)))
+#define MSP_DP_CELL_ATTR(cell) ((cell) >> 8)
+#define MSP_DP_CELL_CHAR(cell) ((cell) & 0xff)
+#define MSP_DP_BLANK MSP_DP_CELL(' ', 0)
+
+typedef struct mspDisplayPortSys_s {
+    uint8_t row;
+    uint8_t col;
+    uint8_t element;
+} mspDisplayPortSys_t;
+
+typedef struct mspDisplayPortCanvas_s {
+    bool clearPending;          // cells not written since the last clearScreen will be blanked
+    bool fullRefreshPending;
+    uint16_t drawCursor;        // cell to continue from if the transfer was split
+    timeMs_t lastFullRefreshMs;
+    uint16_t cells[MSP_DP_CANVAS_CELLS];
+    uint8_t dirty[(MSP_DP_CANVAS_CELLS + 7) / 8];
+    uint8_t written[(MSP_DP_CANVAS_CELLS + 7) / 8];
+    // system elements drawn since the last clearScreen, sent after the cells so that a clear cannot remove them
+    uint8_t sysCount;
+    uint8_t lastSysCount;
+    mspDisplayPortSys_t sys[MSP_DP_MAX_SYS_ELEMENTS];
+    mspDisplayPortSys_t lastSys[MSP_DP_MAX_SYS_ELEMENTS];
+} mspDisplayPortCanvas_t;
+
+STATIC_ASSERT(sizeof(mspDisplayPortCanvas_t) <= sizeof(osdDeviceBuffer), msp_displayport_canvas_too_large);
+
+// The canvas is kept in the memory of the OSD device drivers, so it is only used if the MSP displayport
+// drives the display and a serial port is assigned to it. Otherwise everything is sent as drawn.
+static bool canvasEnabled;
+static mspDisplayPortCanvas_t *const canvas = (mspDisplayPortCanvas_t *)osdDeviceBuffer;
+
+static bool isCellSet(const uint8_t *bits, int cell)
+{
+    return bits[cell / 8] & BIT(cell % 8);
+}
+
+static void setCell(uint8_t *bits, int cell)
+{
+    bits[cell / 8] |= BIT(cell % 8);
+}
+
+static void resetCell(uint8_t *bits, int cell)
+{
+    bits[cell / 8] &= ~BIT(cell % 8);
+}
+
 static int output(displayPort_t *displayPort, uint8_t cmd, uint8_t *buf, int len)
 {
     UNUSED(displayPort);
@@ -74,6 +138,10 @@ static int heartbeat(displayPort_t *displayPort)
 
 static int grab(displayPort_t *displayPort)
 {
+    if (canvasEnabled) {
+        canvas->fullRefreshPending = true;
+    }
+
     return heartbeat(displayPort);
 }
 
@@ -88,30 +156,39 @@ static int clearScreen(displayPort_t *displayPort, displayClearOption_e options)
 {
     UNUSED(options);
 
+    if (canvasEnabled) {
+        canvas->clearPending = true;
+        canvas->sysCount = 0;
+        memset(canvas->written, 0, sizeof(canvas->written));
+
+        return 0;
+    }
+
     uint8_t subcmd[] = { MSP_DP_CLEAR_SCREEN };
 
     return output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
 }
 
-static bool drawScreen(displayPort_t *displayPort)
+static int screenSize(const displayPort_t *displayPort)
 {
-    uint8_t subcmd[] = { MSP_DP_DRAW_SCREEN };
-    output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
-
-    return 0;
+    return displayPort->rows * displayPort->cols;
 }
 
-static int screenSize(const displayPort_t *displayPort)
+static uint8_t mspAttr(uint8_t attr)
 {
-    return displayPort->rows * displayPort->cols;
+    uint8_t mspAttr = displayPortProfileMsp()->fontSelection[attr & (DISPLAYPORT_SEVERITY_COUNT - 1)] & DISPLAYPORT_MSP_ATTR_FONT;
+
+    if (attr & DISPLAYPORT_BLINK) {
+        mspAttr |= DISPLAYPORT_MSP_ATTR_BLINK;
+    }
+
+    return mspAttr;
 }
 
-static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, const char *string)
+static int outputString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t mspAttr, const char *string, int len)
 {
-#define MSP_OSD_MAX_STRING_LENGTH 30 // FIXME move this
     uint8_t buf[MSP_OSD_MAX_STRING_LENGTH + 4];
 
-    int len = strlen(string);
     if (len >= MSP_OSD_MAX_STRING_LENGTH) {
         len = MSP_OSD_MAX_STRING_LENGTH;
     }
@@ -119,18 +196,38 @@ static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, uin
     buf[0] = MSP_DP_WRITE_STRING;
     buf[1] = row;
     buf[2] = col;
-    buf[3] = displayPortProfileMsp()->fontSelection[attr & (DISPLAYPORT_SEVERITY_COUNT - 1)] & DISPLAYPORT_MSP_ATTR_FONT;
-
-    if (attr & DISPLAYPORT_BLINK) {
-        buf[3] |= DISPLAYPORT_MSP_ATTR_BLINK;
-    }
+    buf[3] = mspAttr;
 
     memcpy(&buf[4], string, len);
 
     return output(displayPort, MSP_DISPLAYPORT, buf, len + 4);
 }
 
-static int writeSys(displayPort_t *displayPort, uint8_t col, uint8_t row, displayPortSystemElement_e systemElement)
+static int writeString(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, const char *string)
+{
+    if (!canvasEnabled) {
+        return outputString(displayPort, col, row, mspAttr(attr), string, strlen(string));
+    }
+
+    if (row >= displayPort->rows) {
+        return 0;
+    }
+
+    const uint8_t cellAttr = mspAttr(attr);
+    int cell = row * displayPort->cols + col;
+    for (; *string && col < displayPort->cols; string++, col++, cell++) {
+        const uint16_t value = MSP_DP_CELL((uint8_t)*string, cellAttr);
+        setCell(canvas->written, cell);
+        if (canvas->cells[cell] != value) {
+            canvas->cells[cell] = value;
+            setCell(canvas->dirty, cell);
+        }
+    }
+
+    return 0;
+}
+
+static int outputSys(displayPort_t *displayPort, uint8_t col, uint8_t row, displayPortSystemElement_e systemElement)
 {
     uint8_t syscmd[4];
 
@@ -142,6 +239,17 @@ static int writeSys(displayPort_t *displayPort, uint8_t col, uint8_t row, displa
     return output(displayPort, MSP_DISPLAYPORT, syscmd, sizeof(syscmd));
 }
 
+static int writeSys(displayPort_t *displayPort, uint8_t col, uint8_t row, displayPortSystemElement_e systemElement)
+{
+    if (canvasEnabled && canvas->sysCount < MSP_DP_MAX_SYS_ELEMENTS) {
+        canvas->sys[canvas->sysCount++] = (mspDisplayPortSys_t){ .row = row, .col = col, .element = systemElement };
+
+        return 0;
+    }
+
+    return outputSys(displayPort, col, row, systemElement);
+}
+
 static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8_t attr, uint8_t c)
 {
     char buf[2];
@@ -151,6 +259,116 @@ static int writeChar(displayPort_t *displayPort, uint8_t col, uint8_t row, uint8
     return writeString(displayPort, col, row, attr, buf);
 }
 
+// Prepare the canvas for sending at the start of a transfer
+static void canvasBeginDraw(displayPort_t *displayPort)
+{
+    const int cellCount = displayPort->rows * displayPort->cols;
+
+    if (canvas->clearPending) {
+        for (int cell = 0; cell < cellCount; cell++) {
+            if (!isCellSet(canvas->written, cell) && canvas->cells[cell] != MSP_DP_BLANK) {
+                canvas->cells[cell] = MSP_DP_BLANK;
+                setCell(canvas->dirty, cell);
+            }
+        }
+        canvas->clearPending = false;
+    }
+
+    // system elements cannot be erased individually, so if any moved or disappeared start again
+    if (canvas->sysCount != canvas->lastSysCount || memcmp(canvas->sys, canvas->lastSys, canvas->sysCount * sizeof(canvas->sys[0]))) {
+        canvas->fullRefreshPending = true;
+    }
+
+    const timeMs_t nowMs = millis();
+    if (canvas->fullRefreshPending || cmp32(nowMs, canvas->lastFullRefreshMs) >= MSP_DP_FULL_REFRESH_INTERVAL_MS) {
+        uint8_t subcmd[] = { MSP_DP_CLEAR_SCREEN };
+        output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+
+        // the remote display is now blank
+        for (int cell = 0; cell < cellCount; cell++) {
+            if (canvas->cells[cell] != MSP_DP_BLANK) {
+                setCell(canvas->dirty, cell);
+            } else {
+                resetCell(canvas->dirty, cell);
+            }
+        }
+        canvas->fullRefreshPending = false;
+        canvas->lastFullRefreshMs = nowMs;
+    }
+}
+
+static bool drawScreen(displayPort_t *displayPort)
+{
+    uint8_t subcmd[] = { MSP_DP_DRAW_SCREEN };
+
+    if (!canvasEnabled) {
+        output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+
+        return 0;
+    }
+
+    if (canvas->drawCursor == 0) {
+        canvasBeginDraw(displayPort);
+    }
+
+    uint32_t bytesFree = mspSerialTxBytesFree(displayPortSerial);
+    const int cellCount = displayPort->rows * displayPort->cols;
+
+    for (int cell = canvas->drawCursor; cell < cellCount; cell++) {
+        if (!isCellSet(canvas->dirty, cell)) {
+            continue;
+        }
+
+        // extend the write along the row while the attribute matches, bridging short unchanged gaps
+        const int rowEnd = cell - cell % displayPort->cols + displayPort->cols;
+        const uint8_t attr = MSP_DP_CELL_ATTR(canvas->cells[cell]);
+        int lastDirty = cell;
+        for (int next = cell + 1; next < rowEnd && next - cell < MSP_OSD_MAX_STRING_LENGTH; next++) {
+            if (MSP_DP_CELL_ATTR(canvas->cells[next]) != attr) {
+                break;
+            }
+            if (isCellSet(canvas->dirty, next)) {
+                lastDirty = next;
+            } else if (next - lastDirty > MSP_DP_MERGE_GAP) {
+                break;
+            }
+        }
+
+        const int len = lastDirty - cell + 1;
+        if (MSP_DP_WRITE_OVERHEAD + (uint32_t)len > bytesFree) {
+            // continue with the rest on the next call
+            canvas->drawCursor = cell;
+
+            return true;
+        }
+
+        char string[MSP_OSD_MAX_STRING_LENGTH];
+        for (int i = 0; i < len; i++) {
+            string[i] = MSP_DP_CELL_CHAR(canvas->cells[cell + i]);
+            resetCell(canvas->dirty, cell + i);
+        }
+        if (outputString(displayPort, cell % displayPort->cols, cell / displayPort->cols, attr, string, len) == 0) {
+            // not sent, make sure the remote display catches up
+            canvas->fullRefreshPending = true;
+        }
+        bytesFree -= MSP_DP_WRITE_OVERHEAD + len;
+
+        cell = lastDirty;
+    }
+
+    canvas->drawCursor = 0;
+
+    for (int i = 0; i < canvas->sysCount; i++) {
+        outputSys(displayPort, canvas->sys[i].col, canvas->sys[i].row, canvas->sys[i].element);
+    }
+    canvas->lastSysCount = canvas->sysCount;
+    memcpy(canvas->lastSys, canvas->sys, sizeof(canvas->lastSys));
+
+    output(displayPort, MSP_DISPLAYPORT, subcmd, sizeof(subcmd));
+
+    return 0;
+}
+
 static bool isTransferInProgress(const displayPort_t *displayPort)
 {
     UNUSED(displayPort);
@@ -165,13 +383,18 @@ static bool isSynced(const displayPort_t *displayPort)
 
 static void redraw(displayPort_t *displayPort)
 {
+    if (canvasEnabled) {
+        canvas->fullRefreshPending = true;
+        canvas->drawCursor = 0;
+    }
+
     drawScreen(displayPort);
 }
 
 static uint32_t txBytesFree(const displayPort_t *displayPort)
 {
     UNUSED(displayPort);
-    return mspSerialTxBytesFree();
+    return mspSerialTxBytesFree(displayPortSerial);
 }
 
 static const displayPortVTable_t mspDisplayPortVTable = {
@@ -221,6 +444,14 @@ displayPort_t *displayPortMspInit(void)
         mspDisplayPort.cols = OSD_SD_COLS + displayPortProfileMsp()->colAdjust;
     }
 
+    canvasEnabled = displayPortSerial != SERIAL_PORT_NONE && mspDisplayPort.rows * mspDisplayPort.cols <= MSP_DP_CANVAS_CELLS;
+    if (canvasEnabled) {
+        memset(canvas, 0, sizeof(*canvas));
+        for (unsigned cell = 0; cell < ARRAYLEN(canvas->cells); cell++) {
+            canvas->cells[cell] = MSP_DP_BLANK;
+        }
+    }
+
     redraw(&mspDisplayPort);
 
     return &mspDisplayPort;
@@ -38,6 +38,9 @@ typedef enum {
     MSP_DP_COUNT,
 } displayportMspCommand_e;
 
+// Longest string carried by one MSP_DP_WRITE_STRING
+#define MSP_OSD_MAX_STRING_LENGTH 30
+
 // MSP displayport V2 attribute byte bit functions
 #define DISPLAYPORT_MSP_ATTR_VERSION BIT(7) // Format indicator; must be zero for V2 (and V1)
 #define DISPLAYPORT_MSP_ATTR_BLINK   BIT(6) // Device local blink
@@ -91,6 +91,7 @@ uint8_t GPS_svinfo_cno[GPS_SV_MAXSATS_M8N];
 #define GPS_CONFIG_CHANGE_INTERVAL 110       // Time to wait, in ms, between CONFIG steps
 #define GPS_BAUDRATE_TEST_COUNT 3      // Number of times to repeat the test message when setting baudrate
 #define GPS_RECV_TIME_MAX 25           // Max permitted time, in us, for the Receive Data process
+#define GPS_RECV_CHUNK_SIZE 32         // Bytes parsed between checks of the above
 // Decay the estimated max task duration by 1/(1 << GPS_TASK_DECAY_SHIFT) on every invocation
 #define GPS_TASK_DECAY_SHIFT 9         // Smoothing factor for GPS task re-scheduler
 
@@ -376,11 +377,12 @@ static void logErrorToPacketLog(void)
 #endif  // USE_DASHBOARD
 
 static void gpsNewData(uint16_t c);
+static void gpsNewDataBuf(const uint8_t *data, size_t len);
 #ifdef USE_GPS_NMEA
 static bool gpsNewFrameNMEA(char c);
 #endif
 #ifdef USE_GPS_UBLOX
-static bool gpsNewFrameUBLOX(uint8_t data);
+static size_t gpsNewFrameUBLOX(const uint8_t *data, size_t len, bool *newPositionDataReceived);
 #endif
 
 static void gpsSetState(gpsState_e state)
@@ -1360,8 +1362,10 @@ void gpsUpdate(timeUs_t currentTimeUs)
             if (cmpTimeUs(micros(), currentTimeUs) > GPS_RECV_TIME_MAX) {
                 break;
             }
-            // Add every byte to _buffer, when enough bytes are received, convert data to values
-            gpsNewData(serialRead(gpsPort));
+            // Parse a chunk at a time, when enough bytes are received, convert data to values
+            uint8_t buf[GPS_RECV_CHUNK_SIZE];
+            const uint32_t len = serialReadBuf(gpsPort, buf, sizeof(buf));
+            gpsNewDataBuf(buf, len);
         }
         if (wait < 1) {
             wait++;
@@ -1475,13 +1479,8 @@ void gpsUpdate(timeUs_t currentTimeUs)
 //    DEBUG_SET(DEBUG_GPS_CONNECTION, 6, (gpsStateDurationFractionUs[gpsCurrentState] >> GPS_TASK_DECAY_SHIFT));
 }
 
-static void gpsNewData(uint16_t c)
+static void gpsHandleNewSolution(void)
 {
-    DEBUG_SET(DEBUG_GPS_CONNECTION, 1, gpsSol.navIntervalMs);
-    if (!gpsNewFrame(c)) {
-        // no new nav solution data
-        return;
-    }
     if (gpsData.state == GPS_STATE_RECEIVING_DATA) {
         DEBUG_SET(DEBUG_GPS_CONNECTION, 3, gpsData.now - gpsData.lastNavMessage); // interval since last Nav data was received
         gpsData.lastNavMessage = gpsData.now;
@@ -1492,6 +1491,36 @@ static void gpsNewData(uint16_t c)
     onGpsNewData();
 }
 
+static void gpsNewData(uint16_t c)
+{
+    DEBUG_SET(DEBUG_GPS_CONNECTION, 1, gpsSol.navIntervalMs);
+    if (gpsNewFrame(c)) {
+        gpsHandleNewSolution();
+    }
+}
+
+static void gpsNewDataBuf(const uint8_t *data, size_t len)
+{
+#ifdef USE_GPS_UBLOX
+    if (gpsConfig()->provider == GPS_UBLOX) {
+        DEBUG_SET(DEBUG_GPS_CONNECTION, 1, gpsSol.navIntervalMs);
+        while (len) {
+            bool newPositionDataReceived;
+            const size_t count = gpsNewFrameUBLOX(data, len, &newPositionDataReceived);
+            if (newPositionDataReceived) {
+                gpsHandleNewSolution();
+            }
+            data += count;
+            len -= count;
+        }
+        return;
+    }
+#endif
+    while (len--) {
+        gpsNewData(*data++);
+    }
+}
+
 #ifdef USE_GPS_UBLOX
 ubloxVersion_e ubloxParseVersion(const uint32_t version) {
     for (size_t i = 0; i < ARRAYLEN(ubloxVersionMap); ++i) {
@@ -1514,7 +1543,11 @@ bool gpsNewFrame(uint8_t c)
         break;
     case GPS_UBLOX:         // UBX binary
 #ifdef USE_GPS_UBLOX
-        return gpsNewFrameUBLOX(c);
+    {
+        bool newPositionDataReceived;
+        gpsNewFrameUBLOX(&c, 1, &newPositionDataReceived);
+        return newPositionDataReceived;
+    }
 #endif
         break;
     default:
@@ -2106,6 +2139,7 @@ typedef enum {
     UBX_PARSE_PAYLOAD_LENGTH_LSB,
     UBX_PARSE_PAYLOAD_LENGTH_MSB,
     UBX_PARSE_PAYLOAD_CONTENT,
+    UBX_PARSE_SKIP_PAYLOAD,
     UBX_PARSE_CHECKSUM_A,
     UBX_PARSE_CHECKSUM_B
 } ubxFrameParseState_e;
@@ -2119,6 +2153,28 @@ static uint16_t ubxFrameParsePayloadCounter;
 // Combines message class & ID for a single value to switch on.
 #define CLSMSG(cls, msg) (((cls) << 8) | (msg))
 
+// Messages handled by UBLOX_parse_gps(), anything else is skipped without being buffered or checksummed
+static bool ubloxIsParsedMessage(void)
+{
+    switch (CLSMSG(ubxRcvMsgClass, ubxRcvMsgID)) {
+    case CLSMSG(CLASS_MON, MSG_MON_VER):
+    case CLSMSG(CLASS_NAV, MSG_NAV_POSLLH):
+    case CLSMSG(CLASS_NAV, MSG_NAV_STATUS):
+    case CLSMSG(CLASS_NAV, MSG_NAV_DOP):
+    case CLSMSG(CLASS_NAV, MSG_NAV_SOL):
+    case CLSMSG(CLASS_NAV, MSG_NAV_VELNED):
+    case CLSMSG(CLASS_NAV, MSG_NAV_PVT):
+    case CLSMSG(CLASS_NAV, MSG_NAV_SVINFO):
+    case CLSMSG(CLASS_NAV, MSG_NAV_SAT):
+    case CLSMSG(CLASS_CFG, MSG_CFG_GNSS):
+    case CLSMSG(CLASS_ACK, MSG_ACK_ACK):
+    case CLSMSG(CLASS_ACK, MSG_ACK_NACK):
+        return true;
+    default:
+        return false;
+    }
+}
+
 static bool UBLOX_parse_gps(void)
 {
     uint32_t i;
@@ -2193,6 +2249,8 @@ static bool UBLOX_parse_gps(void)
         gpsSol.speed3d = ubxRcvMsgPayload.ubxNavVelned.speed_3d;       // cm/s
         gpsSol.groundSpeed = ubxRcvMsgPayload.ubxNavVelned.speed_2d;    // cm/s
         gpsSol.groundCourse = (uint16_t) (ubxRcvMsgPayload.ubxNavVelned.heading_2d / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+        gpsSol.verticalSpeed = -ubxRcvMsgPayload.ubxNavVelned.ned_down;   // cm/s
+        gpsSol.acc.sAcc = ubxRcvMsgPayload.ubxNavVelned.speed_accuracy * 10;    // cm/s to mm/s
         ubxHaveNewSpeed = true;
         break;
     case CLSMSG(CLASS_NAV, MSG_NAV_PVT):
@@ -2214,6 +2272,7 @@ static bool UBLOX_parse_gps(void)
         gpsSol.speed3d = (uint16_t) sqrtf(powf(ubxRcvMsgPayload.ubxNavPvt.gSpeed / 10, 2.0f) + powf(ubxRcvMsgPayload.ubxNavPvt.velD / 10, 2.0f));
         gpsSol.groundSpeed = ubxRcvMsgPayload.ubxNavPvt.gSpeed / 10;    // cm/s
         gpsSol.groundCourse = (uint16_t) (ubxRcvMsgPayload.ubxNavPvt.headMot / 10000);     // Heading 2D deg * 100000 rescaled to deg * 10
+        gpsSol.verticalSpeed = -ubxRcvMsgPayload.ubxNavPvt.velD / 10;    // cm/s
         gpsSol.dop.pdop = ubxRcvMsgPayload.ubxNavPvt.pDOP;
         ubxHaveNewSpeed = true;
 #ifdef USE_RTC_TIME
@@ -2347,7 +2406,8 @@ static bool UBLOX_parse_gps(void)
     return false;
 }
 
-static bool gpsNewFrameUBLOX(uint8_t data)
+// Header and checksum bytes, the payload is handled in bulk by gpsNewFrameUBLOX()
+static bool ubloxParseByte(uint8_t data)
 {
     bool newPositionDataReceived = false;
 
@@ -2409,23 +2469,9 @@ static bool gpsNewFrameUBLOX(uint8_t data)
                 }
                 break;
             }
-            // Payload length seems legit, go on to receive the payload content.
+            // Payload length seems legit, go on to receive the payload content, or to skip it if we have no use for it.
             ubxFrameParsePayloadCounter = 0;
-            ubxFrameParseState = UBX_PARSE_PAYLOAD_CONTENT;
-            break;
-        case UBX_PARSE_PAYLOAD_CONTENT:
-            ubxRcvMsgChecksumB += (ubxRcvMsgChecksumA += data);   // Accumulate both checksums.
-            if (ubxFrameParsePayloadCounter < UBLOX_PAYLOAD_SIZE) {
-                // Only add bytes to the buffer if we haven't reached the max supported payload size.
-                // Note that we still read & checksum every byte so the checksum calculates correctly.
-                ubxRcvMsgPayload.rawBytes[ubxFrameParsePayloadCounter] = data;
-            }
-            if (++ubxFrameParsePayloadCounter >= ubxRcvMsgPayloadLength) {
-                // All bytes for payload length processed.
-                ubxFrameParseState = UBX_PARSE_CHECKSUM_A;
-                break;
-            }
-            // More payload content left, stay in this state.
+            ubxFrameParseState = ubloxIsParsedMessage() ? UBX_PARSE_PAYLOAD_CONTENT : UBX_PARSE_SKIP_PAYLOAD;
             break;
         case UBX_PARSE_CHECKSUM_A:
             if (ubxRcvMsgChecksumA == data) {
@@ -2468,11 +2514,91 @@ static bool gpsNewFrameUBLOX(uint8_t data)
                 ubxFrameParseState = UBX_PARSE_PREAMBLE_SYNC_1;
             }
             break;
+        default:
+            break;
         }
 
     // Note this function returns if UBLOX_parse_gps() found new position data, NOT whether this function successfully parsed the frame or not.
     return newPositionDataReceived;
 }
+
+// 8-bit Fletcher over a run of bytes. The sums are kept in registers and only truncated to 8 bits on the way out.
+static void ubloxChecksumUpdate(const uint8_t *data, size_t len)
+{
+    uint32_t checksumA = ubxRcvMsgChecksumA;
+    uint32_t checksumB = ubxRcvMsgChecksumB;
+
+    while (len--) {
+        checksumA += *data++;
+        checksumB += checksumA;
+    }
+
+    ubxRcvMsgChecksumA = checksumA;
+    ubxRcvMsgChecksumB = checksumB;
+}
+
+// Parse a span of received data. Returns the number of bytes used, which is less than len if a message
+// with new position data was found, so that the caller can handle each new solution in turn.
+static size_t gpsNewFrameUBLOX(const uint8_t *data, size_t len, bool *newPositionDataReceived)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = data + len;
+
+    *newPositionDataReceived = false;
+
+    while (p < end) {
+        switch (ubxFrameParseState) {
+        case UBX_PARSE_PREAMBLE_SYNC_1: {
+            // Anything before the preamble is noise, or NMEA the module hasn't been told to stop sending yet
+            const uint8_t *preamble = memchr(p, PREAMBLE1, end - p);
+            if (!preamble) {
+                return len;
+            }
+            p = preamble + 1;
+            ubxFrameParseState = UBX_PARSE_PREAMBLE_SYNC_2;
+            break;
+        }
+        case UBX_PARSE_PAYLOAD_CONTENT: {
+            const size_t count = MIN((size_t)(end - p), (size_t)(ubxRcvMsgPayloadLength - ubxFrameParsePayloadCounter));
+            ubloxChecksumUpdate(p, count);
+            if (ubxFrameParsePayloadCounter < UBLOX_PAYLOAD_SIZE) {
+                // Only add bytes to the buffer if we haven't reached the max supported payload size.
+                // Note that we still checksum every byte so the checksum calculates correctly.
+                memcpy(&ubxRcvMsgPayload.rawBytes[ubxFrameParsePayloadCounter], p, MIN(count, (size_t)(UBLOX_PAYLOAD_SIZE - ubxFrameParsePayloadCounter)));
+            }
+            ubxFrameParsePayloadCounter += count;
+            p += count;
+            if (ubxFrameParsePayloadCounter >= ubxRcvMsgPayloadLength) {
+                ubxFrameParseState = UBX_PARSE_CHECKSUM_A;
+            }
+            break;
+        }
+        case UBX_PARSE_SKIP_PAYLOAD: {
+            // Payload and checksum of a message we don't use
+            const size_t count = MIN((size_t)(end - p), (size_t)(ubxRcvMsgPayloadLength + 2 - ubxFrameParsePayloadCounter));
+            ubxFrameParsePayloadCounter += count;
+            p += count;
+            if (ubxFrameParsePayloadCounter >= ubxRcvMsgPayloadLength + 2) {
+#ifdef USE_DASHBOARD
+                dashboardGpsPacketCount++;
+                shiftPacketLog();
+                *dashboardGpsPacketLogCurrentChar = DASHBOARD_LOG_IGNORED;
+#endif
+                ubxFrameParseState = UBX_PARSE_PREAMBLE_SYNC_1;
+            }
+            break;
+        }
+        default:
+            if (ubloxParseByte(*p++)) {
+                *newPositionDataReceived = true;
+                return p - data;
+            }
+            break;
+        }
+    }
+
+    return len;
+}
 #endif // USE_GPS_UBLOX
 
 static void gpsHandlePassthrough(uint8_t data)
@@ -249,6 +249,7 @@ typedef struct gpsSolutionData_s {
     uint16_t speed3d;               // speed in 0.1m/s
     uint16_t groundSpeed;           // speed in 0.1m/s
     uint16_t groundCourse;          // degrees * 10
+    int16_t verticalSpeed;          // speed in cm/s, up positive. Only available on U-blox protocol
     uint8_t numSat;
     uint32_t time;                  // GPS msToW
     uint32_t navIntervalMs;         // interval between nav solutions in ms
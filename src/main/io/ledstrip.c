@@ -32,6 +32,7 @@
 #include "build/build_config.h"
 
 #include "common/axis.h"
+#include "common/bitarray.h"
 #include "common/color.h"
 #include "common/maths.h"
 #include "common/printf.h"
@@ -286,6 +287,66 @@ enum ledBarIds {
 };
 static uint8_t ledBarStates[LED_BAR_COUNT] = {0};
 
+// LEDs each timed layer applies to, rebuilt when the LED configuration changes
+// so that the layers don't have to decode every LED's configuration on each update
+typedef enum {
+    LED_LAYER_WARNING,
+    LED_LAYER_VTX,
+    LED_LAYER_BATTERY,
+    LED_LAYER_RSSI,
+    LED_LAYER_GPS,
+    LED_LAYER_INDICATOR,
+    LED_LAYER_THRUST_RING,
+    LED_LAYER_RAINBOW,
+    LED_LAYER_LARSON,
+    LED_LAYER_BLINK,
+    LED_LAYER_COUNT
+} ledLayerId_e;
+
+#define LED_MASK_WORDS ((LED_STRIP_MAX_LENGTH + 31) / 32)
+
+static uint32_t ledLayerMask[LED_LAYER_COUNT][LED_MASK_WORDS];
+
+// LEDs whose configuration has all the bits of the mask set
+static const uint32_t ledLayerConfigMask[LED_LAYER_COUNT] = {
+    [LED_LAYER_WARNING]     = LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_WARNING)),
+    [LED_LAYER_VTX]         = LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_VTX)),
+    [LED_LAYER_BATTERY]     = LED_MOV_FUNCTION(LED_FUNCTION_BATTERY),
+    [LED_LAYER_RSSI]        = LED_MOV_FUNCTION(LED_FUNCTION_RSSI),
+    [LED_LAYER_GPS]         = LED_MOV_FUNCTION(LED_FUNCTION_GPS),
+    [LED_LAYER_INDICATOR]   = LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_INDICATOR)),
+    [LED_LAYER_THRUST_RING] = 0, // matched on the function value instead
+    [LED_LAYER_RAINBOW]     = LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_RAINBOW)),
+    [LED_LAYER_LARSON]      = LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_LARSON_SCANNER)),
+    [LED_LAYER_BLINK]       = LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_BLINK)),
+};
+
+// Return the index of the next LED from ledIndex that the layer applies to, or -1
+static int nextLayerLed(ledLayerId_e layer, int ledIndex)
+{
+    return bitArrayFindFirstSet(ledLayerMask[layer], ledIndex, sizeof(ledLayerMask[layer]));
+}
+
+static void updateLedLayerMasks(void)
+{
+    memset(ledLayerMask, 0, sizeof(ledLayerMask));
+
+    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
+        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
+
+        for (ledLayerId_e layer = 0; layer < LED_LAYER_COUNT; layer++) {
+            const uint32_t mask = ledLayerConfigMask[layer];
+            if (mask && (*ledConfig & mask) == mask) {
+                bitArraySet(ledLayerMask[layer], ledIndex);
+            }
+        }
+
+        if (ledGetFunction(ledConfig) == LED_FUNCTION_THRUST_RING) {
+            bitArraySet(ledLayerMask[LED_LAYER_THRUST_RING], ledIndex);
+        }
+    }
+}
+
 void updateLedBars(void)
 {
     memset(ledBarStates, 0, sizeof(ledBarStates));
@@ -335,6 +396,7 @@ STATIC_UNIT_TESTED void updateLedCount(void)
 void reevaluateLedConfig(void)
 {
     updateLedCount();
+    updateLedLayerMasks();
     updateDimensions();
     updateLedRingCounts();
     updateRequiredOverlay();
@@ -677,12 +739,10 @@ static void applyLedFixedLayers(void)
     }
 }
 
-static void applyLedHsv(uint32_t mask, const hsvColor_t *color)
+static void applyLedHsv(ledLayerId_e layer, const hsvColor_t *color)
 {
-    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-        if ((*ledConfig & mask) == mask)
-            setLedHsv(ledIndex, color);
+    for (int ledIndex = nextLayerLed(layer, 0); ledIndex >= 0; ledIndex = nextLayerLed(layer, ledIndex + 1)) {
+        setLedHsv(ledIndex, color);
     }
 }
 
@@ -750,7 +810,7 @@ static void applyLedWarningLayer(bool updateNow, timeUs_t *timer)
     }
 
     if (warningColor) {
-        applyLedHsv(LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_WARNING)), warningColor);
+        applyLedHsv(LED_LAYER_WARNING, warningColor);
     }
 }
 
@@ -822,26 +882,23 @@ static void applyLedVtxLayer(bool updateNow, timeUs_t *timer)
 
     if (showSettings) { // show settings
         uint8_t vtxLedCount = 0;
-        for (int i = 0; i < ledCounts.count && vtxLedCount < 6; ++i) {
-            const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[i];
-            if (ledGetOverlayBit(ledConfig, LED_OVERLAY_VTX)) {
-                hsvColor_t color = {0, 0, 0};
-                if (vtxLedCount == 0) {
-                    color.h = HSV(GREEN).h;
-                    color.s = HSV(GREEN).s;
-                    color.v = blink ? 15 : 0; // blink received settings
-                } else if (vtxLedCount > 0 && power >= vtxLedCount && !(vtxStatus & VTX_STATUS_PIT_MODE)) { // show power
-                    color.h = HSV(ORANGE).h;
-                    color.s = HSV(ORANGE).s;
-                    color.v = blink ? 15 : 0; // blink received settings
-                } else { // turn rest off
-                    color.h = HSV(BLACK).h;
-                    color.s = HSV(BLACK).s;
-                    color.v = HSV(BLACK).v;
-                }
-                setLedHsv(i, &color);
-                ++vtxLedCount;
+        for (int i = nextLayerLed(LED_LAYER_VTX, 0); i >= 0 && vtxLedCount < 6; i = nextLayerLed(LED_LAYER_VTX, i + 1)) {
+            hsvColor_t color = {0, 0, 0};
+            if (vtxLedCount == 0) {
+                color.h = HSV(GREEN).h;
+                color.s = HSV(GREEN).s;
+                color.v = blink ? 15 : 0; // blink received settings
+            } else if (vtxLedCount > 0 && power >= vtxLedCount && !(vtxStatus & VTX_STATUS_PIT_MODE)) { // show power
+                color.h = HSV(ORANGE).h;
+                color.s = HSV(ORANGE).s;
+                color.v = blink ? 15 : 0; // blink received settings
+            } else { // turn rest off
+                color.h = HSV(BLACK).h;
+                color.s = HSV(BLACK).s;
+                color.v = HSV(BLACK).v;
             }
+            setLedHsv(i, &color);
+            ++vtxLedCount;
         }
     }
     else { // show frequency
@@ -849,7 +906,7 @@ static void applyLedVtxLayer(bool updateNow, timeUs_t *timer)
         uint8_t const colorIndex = getColorByVtxFrequency(frequency);
         hsvColor_t color = ledStripStatusModeConfig()->colors[colorIndex];
         color.v = (vtxStatus & VTX_STATUS_PIT_MODE) ? (blink ? 15 : 0) : 255; // blink when in pit mode
-        applyLedHsv(LED_MOV_OVERLAY(LED_FLAG_OVERLAY(LED_OVERLAY_VTX)), &color);
+        applyLedHsv(LED_LAYER_VTX, &color);
     }
 }
 #endif
@@ -884,7 +941,7 @@ static void applyLedBatteryLayer(bool updateNow, timeUs_t *timer)
 
     if (!flash) {
        const hsvColor_t *bgc = getSC(LED_SCOLOR_BACKGROUND);
-       applyLedHsv(LED_MOV_FUNCTION(LED_FUNCTION_BATTERY), bgc);
+       applyLedHsv(LED_LAYER_BATTERY, bgc);
     }
 }
 
@@ -913,7 +970,7 @@ static void applyLedRssiLayer(bool updateNow, timeUs_t *timer)
 
     if (!flash) {
         const hsvColor_t *bgc = getSC(LED_SCOLOR_BACKGROUND);
-        applyLedHsv(LED_MOV_FUNCTION(LED_FUNCTION_RSSI), bgc);
+        applyLedHsv(LED_LAYER_RSSI, bgc);
     }
 }
 
@@ -951,7 +1008,7 @@ static void applyLedGpsLayer(bool updateNow, timeUs_t *timer)
         }
     }
 
-    applyLedHsv(LED_MOV_FUNCTION(LED_FUNCTION_GPS), gpsColor);
+    applyLedHsv(LED_LAYER_GPS, gpsColor);
 }
 #endif
 
@@ -991,12 +1048,9 @@ static void applyLedIndicatorLayer(bool updateNow, timeUs_t *timer)
         quadrants |= QUADRANT_SOUTH;
     }
 
-    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-        if (ledGetOverlayBit(ledConfig, LED_OVERLAY_INDICATOR)) {
-            if (getLedQuadrant(ledIndex) & quadrants)
-                setLedHsv(ledIndex, flashColor);
-        }
+    for (int ledIndex = nextLayerLed(LED_LAYER_INDICATOR, 0); ledIndex >= 0; ledIndex = nextLayerLed(LED_LAYER_INDICATOR, ledIndex + 1)) {
+        if (getLedQuadrant(ledIndex) & quadrants)
+            setLedHsv(ledIndex, flashColor);
     }
 }
 
@@ -1012,24 +1066,22 @@ static void applyLedThrustRingLayer(bool updateNow, timeUs_t *timer)
         *timer += HZ_TO_US(5 + (45 * scaledThrottle) / 100);  // 5 - 50Hz update rate
     }
 
-    for (int ledIndex = 0; ledIndex < ledCounts.count; ledIndex++) {
+    for (int ledIndex = nextLayerLed(LED_LAYER_THRUST_RING, 0); ledIndex >= 0; ledIndex = nextLayerLed(LED_LAYER_THRUST_RING, ledIndex + 1)) {
         const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[ledIndex];
-        if (ledGetFunction(ledConfig) == LED_FUNCTION_THRUST_RING) {
-
-            bool applyColor;
-            if (ARMING_FLAG(ARMED)) {
-                applyColor = (ledRingIndex + rotationPhase) % ledCounts.ringSeqLen < ROTATION_SEQUENCE_LED_WIDTH;
-            } else {
-                applyColor = !(ledRingIndex % 2); // alternating pattern
-            }
 
-            if (applyColor) {
-                const hsvColor_t *ringColor = &ledStripStatusModeConfig()->colors[ledGetColor(ledConfig)];
-                setLedHsv(ledIndex, ringColor);
-            }
+        bool applyColor;
+        if (ARMING_FLAG(ARMED)) {
+            applyColor = (ledRingIndex + rotationPhase) % ledCounts.ringSeqLen < ROTATION_SEQUENCE_LED_WIDTH;
+        } else {
+            applyColor = !(ledRingIndex % 2); // alternating pattern
+        }
 
-            ledRingIndex++;
+        if (applyColor) {
+            const hsvColor_t *ringColor = &ledStripStatusModeConfig()->colors[ledGetColor(ledConfig)];
+            setLedHsv(ledIndex, ringColor);
         }
+
+        ledRingIndex++;
     }
 }
 
@@ -1044,16 +1096,13 @@ static void applyRainbowLayer(bool updateNow, timeUs_t *timer)
     }
     uint8_t rainbowLedIndex = 0;
 
-    for (unsigned i = 0; i < ledCounts.count; i++) {
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[i];
-        if (ledGetOverlayBit(ledConfig, LED_OVERLAY_RAINBOW)) {
-            hsvColor_t ledColor;
-            ledColor.h = (offset / LED_OVERLAY_RAINBOW_RATE_HZ + rainbowLedIndex * ledStripConfig()->ledstrip_rainbow_delta) % (HSV_HUE_MAX + 1);
-            ledColor.s = 0;
-            ledColor.v = HSV_VALUE_MAX;
-            setLedHsv(i, &ledColor);
-            rainbowLedIndex++;
-        }
+    for (int i = nextLayerLed(LED_LAYER_RAINBOW, 0); i >= 0; i = nextLayerLed(LED_LAYER_RAINBOW, i + 1)) {
+        hsvColor_t ledColor;
+        ledColor.h = (offset / LED_OVERLAY_RAINBOW_RATE_HZ + rainbowLedIndex * ledStripConfig()->ledstrip_rainbow_delta) % (HSV_HUE_MAX + 1);
+        ledColor.s = 0;
+        ledColor.v = HSV_VALUE_MAX;
+        setLedHsv(i, &ledColor);
+        rainbowLedIndex++;
     }
 }
 
@@ -1105,17 +1154,12 @@ static void applyLarsonScannerLayer(bool updateNow, timeUs_t *timer)
     }
 
     int scannerLedIndex = 0;
-    for (unsigned i = 0; i < ledCounts.count; i++) {
-
-        const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[i];
-
-        if (ledGetOverlayBit(ledConfig, LED_OVERLAY_LARSON_SCANNER)) {
-            hsvColor_t ledColor;
-            getLedHsv(i, &ledColor);
-            ledColor.v = brightnessForLarsonIndex(&larsonParameters, scannerLedIndex);
-            setLedHsv(i, &ledColor);
-            scannerLedIndex++;
-        }
+    for (int i = nextLayerLed(LED_LAYER_LARSON, 0); i >= 0; i = nextLayerLed(LED_LAYER_LARSON, i + 1)) {
+        hsvColor_t ledColor;
+        getLedHsv(i, &ledColor);
+        ledColor.v = brightnessForLarsonIndex(&larsonParameters, scannerLedIndex);
+        setLedHsv(i, &ledColor);
+        scannerLedIndex++;
     }
 }
 
@@ -1135,12 +1179,8 @@ static void applyLedBlinkLayer(bool updateNow, timeUs_t *timer)
 
     bool ledOn = (blinkMask & 1);  // b_b_____...
     if (!ledOn) {
-        for (int i = 0; i < ledCounts.count; ++i) {
-            const ledConfig_t *ledConfig = &ledStripStatusModeConfig()->ledConfigs[i];
-
-            if (ledGetOverlayBit(ledConfig, LED_OVERLAY_BLINK)) {
-                setLedHsv(i, getSC(LED_SCOLOR_BLINKBACKGROUND));
-            }
+        for (int i = nextLayerLed(LED_LAYER_BLINK, 0); i >= 0; i = nextLayerLed(LED_LAYER_BLINK, i + 1)) {
+            setLedHsv(i, getSC(LED_SCOLOR_BLINKBACKGROUND));
         }
     }
 }
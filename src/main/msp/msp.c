@@ -40,7 +40,7 @@
 #include "common/axis.h"
 #include "common/bitarray.h"
 #include "common/color.h"
-#include "common/huffman.h"
+#include "common/crc.h"
 #include "common/maths.h"
 #include "common/streambuf.h"
 #include "common/utils.h"
@@ -76,6 +76,7 @@
 #include "fc/controlrate_profile.h"
 #include "fc/core.h"
 #include "fc/dispatch.h"
+#include "fc/latency.h"
 #include "fc/rc.h"
 #include "fc/rc_adjustments.h"
 #include "fc/rc_controls.h"
@@ -108,10 +109,14 @@
 
 #include "msp/msp_box.h"
 #include "msp/msp_build_info.h"
+#include "msp/msp_dataflash_read.h"
+#include "msp/msp_dataflash_stream.h"
+#include "msp/msp_multi.h"
 #include "msp/msp_protocol.h"
 #include "msp/msp_protocol_v2_betaflight.h"
 #include "msp/msp_protocol_v2_common.h"
 #include "msp/msp_serial.h"
+#include "msp/msp_settings.h"
 
 #include "osd/osd.h"
 #include "osd/osd_elements.h"
@@ -514,106 +519,6 @@ static void serializeDataflashSummaryReply(sbuf_t *dst)
     }
 }
 
-#ifdef USE_FLASHFS
-enum compressionType_e {
-    NO_COMPRESSION,
-    HUFFMAN
-};
-
-static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, bool allowCompression)
-{
-    STATIC_ASSERT(MSP_PORT_DATAFLASH_INFO_SIZE >= 16, MSP_PORT_DATAFLASH_INFO_SIZE_invalid);
-
-    uint16_t readLen = size;
-    const int bytesRemainingInBuf = sbufBytesRemaining(dst) - MSP_PORT_DATAFLASH_INFO_SIZE;
-    if (readLen > bytesRemainingInBuf) {
-        readLen = bytesRemainingInBuf;
-    }
-    // size will be lower than that requested if we reach end of volume
-    const uint32_t flashfsSize = flashfsGetSize();
-    if (readLen > flashfsSize - address) {
-        // truncate the request
-        readLen = flashfsSize - address;
-    }
-    sbufWriteU32(dst, address);
-
-    // legacy format does not support compression
-#ifdef USE_HUFFMAN
-    const uint8_t compressionMethod = (!allowCompression || useLegacyFormat) ? NO_COMPRESSION : HUFFMAN;
-#else
-    const uint8_t compressionMethod = NO_COMPRESSION;
-    UNUSED(allowCompression);
-#endif
-
-    if (compressionMethod == NO_COMPRESSION) {
-
-        uint16_t *readLenPtr = (uint16_t *)sbufPtr(dst);
-        if (!useLegacyFormat) {
-            // new format supports variable read lengths
-            sbufWriteU16(dst, readLen);
-            sbufWriteU8(dst, 0); // placeholder for compression format
-        }
-
-        const int bytesRead = flashfsReadAbs(address, sbufPtr(dst), readLen);
-
-        if (!useLegacyFormat) {
-            // update the 'read length' with the actual amount read from flash.
-            *readLenPtr = bytesRead;
-        }
-
-        sbufAdvance(dst, bytesRead);
-
-        if (useLegacyFormat) {
-            // pad the buffer with zeros
-            for (int i = bytesRead; i < size; i++) {
-                sbufWriteU8(dst, 0);
-            }
-        }
-    } else {
-#ifdef USE_HUFFMAN
-        // compress in 256-byte chunks
-        const uint16_t READ_BUFFER_SIZE = 256;
-        // This may be DMAable, so make it cache aligned
-        __attribute__ ((aligned(32))) uint8_t readBuffer[READ_BUFFER_SIZE];
-
-        huffmanState_t state = {
-            .bytesWritten = 0,
-            .outByte = sbufPtr(dst) + sizeof(uint16_t) + sizeof(uint8_t) + HUFFMAN_INFO_SIZE,
-            .outBufLen = readLen,
-            .outBit = 0x80,
-        };
-        *state.outByte = 0;
-
-        uint16_t bytesReadTotal = 0;
-        // read until output buffer overflows or flash is exhausted
-        while (state.bytesWritten < state.outBufLen && address + bytesReadTotal < flashfsSize) {
-            const int bytesRead = flashfsReadAbs(address + bytesReadTotal, readBuffer,
-                MIN(sizeof(readBuffer), flashfsSize - address - bytesReadTotal));
-
-            const int status = huffmanEncodeBufStreaming(&state, readBuffer, bytesRead, huffmanTable);
-            if (status == -1) {
-                // overflow
-                break;
-            }
-
-            bytesReadTotal += bytesRead;
-        }
-
-        if (state.outBit != 0x80) {
-            ++state.bytesWritten;
-        }
-
-        // header
-        sbufWriteU16(dst, HUFFMAN_INFO_SIZE + state.bytesWritten);
-        sbufWriteU8(dst, compressionMethod);
-        // payload
-        sbufWriteU16(dst, bytesReadTotal);
-        sbufAdvance(dst, state.bytesWritten);
-#endif
-    }
-}
-#endif // USE_FLASHFS
-
 /*
  * Returns true if the command was processd, false otherwise.
  * May set mspPostProcessFunc to a function to be called once the command has been processed
@@ -2555,6 +2460,39 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_
 
         break;
 
+#ifdef USE_LATENCY_STATS
+    case MSP2_LATENCY_STATS:
+        {
+            // path, optionally followed by a flag to reset the statistics of all paths once read
+            const uint8_t path = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+            const bool reset = sbufBytesRemaining(src) && sbufReadU8(src);
+
+            if (path >= LATENCY_PATH_COUNT) {
+                return MSP_RESULT_ERROR;
+            }
+
+            const latencyStats_t *stats = latencyGetStats(path);
+
+            sbufWriteU8(dst, path);
+            sbufWriteU8(dst, LATENCY_PATH_COUNT);
+            sbufWriteU32(dst, stats->count);
+            sbufWriteU32(dst, stats->minUs);
+            sbufWriteU32(dst, latencyMeanUs(stats));
+            sbufWriteU32(dst, latencyPercentileUs(stats, 50));
+            sbufWriteU32(dst, latencyPercentileUs(stats, 99));
+            sbufWriteU32(dst, stats->maxUs);
+            sbufWriteU8(dst, LATENCY_BUCKET_COUNT);
+            for (unsigned i = 0; i < LATENCY_BUCKET_COUNT; i++) {
+                sbufWriteU32(dst, stats->histogram[i]);
+            }
+
+            if (reset) {
+                latencyReset();
+            }
+        }
+        break;
+#endif
+
     case MSP2_GET_TEXT:
         {
             // type byte, then length byte followed by the actual characters
@@ -2603,6 +2541,40 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_
             }
         }
         break;
+#ifdef USE_FLASHFS
+    case MSP2_DATAFLASH_STREAM_START:
+        return mspDataflashStreamStart(srcDesc, dst, src);
+
+    case MSP2_DATAFLASH_STREAM_ACK:
+        mspDataflashStreamAck(srcDesc, src);
+        return MSP_RESULT_NO_REPLY;
+
+    case MSP2_DATAFLASH_STREAM_STOP:
+        mspDataflashStreamStop(srcDesc);
+        break;
+#endif
+    case MSP2_SET_SUBSCRIPTIONS:
+        {
+            // U32 bytes per second (0 for no limit), then pairs of U16 command, U16 interval in ms
+            const unsigned int dataSize = sbufBytesRemaining(src);
+            if (dataSize < sizeof(uint32_t)) {
+                return MSP_RESULT_ERROR;
+            }
+            const uint32_t bytesPerSecond = sbufReadU32(src);
+
+            int16_t cmds[MSP_MAX_SUBSCRIPTIONS];
+            uint16_t intervalsMs[MSP_MAX_SUBSCRIPTIONS];
+            int count = 0;
+            while (sbufBytesRemaining(src) >= 2 * (int)sizeof(uint16_t) && count < MSP_MAX_SUBSCRIPTIONS) {
+                cmds[count] = sbufReadU16(src);
+                intervalsMs[count] = sbufReadU16(src);
+                count++;
+            }
+
+            sbufWriteU8(dst, mspSerialSetSubscriptions(srcDesc, cmds, intervalsMs, count, bytesPerSecond));
+        }
+        break;
+
 #ifdef USE_LED_STRIP
     case MSP2_GET_LED_STRIP_CONFIG_VALUES:
         sbufWriteU8(dst, ledStripConfig()->ledstrip_brightness);
@@ -2617,29 +2589,6 @@ static mspResult_e mspFcProcessOutCommandWithArg(mspDescriptor_t srcDesc, int16_
     return MSP_RESULT_ACK;
 }
 
-#ifdef USE_FLASHFS
-static void mspFcDataFlashReadCommand(sbuf_t *dst, sbuf_t *src)
-{
-    const unsigned int dataSize = sbufBytesRemaining(src);
-    const uint32_t readAddress = sbufReadU32(src);
-    uint16_t readLength;
-    bool allowCompression = false;
-    bool useLegacyFormat;
-    if (dataSize >= sizeof(uint32_t) + sizeof(uint16_t)) {
-        readLength = sbufReadU16(src);
-        if (sbufBytesRemaining(src)) {
-            allowCompression = sbufReadU8(src);
-        }
-        useLegacyFormat = false;
-    } else {
-        readLength = 128;
-        useLegacyFormat = true;
-    }
-
-    serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, allowCompression);
-}
-#endif
-
 static mspResult_e mspProcessInCommand(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *src)
 {
     uint32_t i;
@@ -4395,12 +4344,16 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
         ret = MSP_RESULT_ACK;
     } else if ((ret = mspFcProcessOutCommandWithArg(srcDesc, cmdMSP, src, dst, mspPostProcessFn)) != MSP_RESULT_CMD_UNKNOWN) {
         /* ret */;
+    } else if ((ret = mspSettingsProcessCommand(cmdMSP, src, dst)) != MSP_RESULT_CMD_UNKNOWN) {
+        /* ret */;
     } else if (cmdMSP == MSP_SET_PASSTHROUGH) {
         mspFcSetPassthroughCommand(dst, src, mspPostProcessFn);
         ret = MSP_RESULT_ACK;
+    } else if (cmdMSP == MSP2_MULTI) {
+        ret = mspMultiProcessCommand(srcDesc, dst, src, mspPostProcessFn, mspFcProcessCommand, mspFcProcessOutCommand);
 #ifdef USE_FLASHFS
     } else if (cmdMSP == MSP_DATAFLASH_READ) {
-        mspFcDataFlashReadCommand(dst, src);
+        mspDataflashReadCommand(dst, src);
         ret = MSP_RESULT_ACK;
 #endif
     } else {
@@ -4410,6 +4363,21 @@ mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPa
     return ret;
 }
 
+/*
+ * Serialize the reply of a command that only reports state, returns false for any other command.
+ * Used for replies pushed without a request, so commands that take arguments or change state are excluded.
+ */
+bool mspFcProcessOutCommand(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *dst)
+{
+    mspPostProcessFnPtr mspPostProcessFn = NULL;
+
+    if (mspCommonProcessOutCommand(cmdMSP, dst, &mspPostProcessFn)) {
+        return !mspPostProcessFn;
+    }
+
+    return mspProcessOutCommand(srcDesc, cmdMSP, dst);
+}
+
 void mspFcProcessReply(mspPacket_t *reply)
 {
     sbuf_t *src = &reply->buf;
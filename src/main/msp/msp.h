@@ -60,10 +60,12 @@ struct serialPort_s;
 typedef void (*mspPostProcessFnPtr)(struct serialPort_s *port); // msp post process function, used for gracefully handling reboots, etc.
 typedef mspResult_e (*mspProcessCommandFnPtr)(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
 typedef void (*mspProcessReplyFnPtr)(mspPacket_t *cmd);
+typedef bool (*mspProcessOutCommandFnPtr)(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *dst); // side effect free commands, used for subscriptions
 
 
 void mspInit(void);
 mspResult_e mspFcProcessCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn);
 void mspFcProcessReply(mspPacket_t *reply);
+bool mspFcProcessOutCommand(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *dst);
 
 mspDescriptor_t mspDescriptorAlloc(void);
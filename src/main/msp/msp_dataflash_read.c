@@ -0,0 +1,280 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_FLASHFS
+
+#include "common/huffman.h"
+#include "common/lz.h"
+#include "common/maths.h"
+#include "common/streambuf.h"
+#include "common/utils.h"
+
+#include "io/flashfs.h"
+
+#include "msp/msp_serial.h"
+
+#include "msp_dataflash_read.h"
+
+enum compressionType_e {
+    NO_COMPRESSION,
+    HUFFMAN,
+    LZ,
+    LZ_HUFFMAN,
+};
+
+static uint8_t dataflashCompressionMethod(uint8_t requested)
+{
+    switch (requested) {
+    case NO_COMPRESSION:
+        return NO_COMPRESSION;
+#if defined(USE_LZ)
+    case LZ:
+        return LZ;
+#endif
+#if defined(USE_LZ) && defined(USE_HUFFMAN)
+    case LZ_HUFFMAN:
+        return LZ_HUFFMAN;
+#endif
+    default:
+        // older configurators send any non-zero value to allow compression
+#ifdef USE_HUFFMAN
+        return HUFFMAN;
+#else
+        return NO_COMPRESSION;
+#endif
+    }
+}
+
+#ifdef USE_LZ
+// flash is compressed in independent blocks of this size, which together with the hash table bounds the RAM used
+#define DATAFLASH_LZ_BLOCK_SIZE 512
+// each block is prefixed with its compressed length
+#define DATAFLASH_LZ_BLOCK_HEADER_SIZE sizeof(uint16_t)
+// largest flash read whose compressed block (plus its header) is guaranteed to fit in len bytes
+#define DATAFLASH_LZ_READ_LIMIT(len) ((int)((len) - DATAFLASH_LZ_BLOCK_HEADER_SIZE - 16) * 255 / 256)
+
+static lzState_t dataflashLzState;
+
+/*
+ * Read up to readLen bytes at address and append them to out as one length-prefixed LZ4 block.
+ * Returns the number of flash bytes consumed, and advances *outLen by the bytes written.
+ */
+static int dataflashLzBlock(uint8_t *out, int *outLen, int outBufLen, uint32_t address, int readLen)
+{
+    // This may be DMAable, so make it cache aligned
+    static __attribute__ ((aligned(32))) uint8_t readBuffer[DATAFLASH_LZ_BLOCK_SIZE];
+
+    readLen = MIN(readLen, MIN(DATAFLASH_LZ_BLOCK_SIZE, DATAFLASH_LZ_READ_LIMIT(outBufLen - *outLen)));
+    if (readLen <= 0) {
+        return 0;
+    }
+
+    const int bytesRead = flashfsReadAbs(address, readBuffer, readLen);
+    uint8_t *block = out + *outLen;
+    const int compressedLen = lzCompressBlock(&dataflashLzState, block + DATAFLASH_LZ_BLOCK_HEADER_SIZE, outBufLen - *outLen - DATAFLASH_LZ_BLOCK_HEADER_SIZE, readBuffer, bytesRead);
+    if (compressedLen < 0) {
+        return 0;
+    }
+    block[0] = compressedLen & 0xff;
+    block[1] = compressedLen >> 8;
+    *outLen += DATAFLASH_LZ_BLOCK_HEADER_SIZE + compressedLen;
+
+    return bytesRead;
+}
+#endif
+
+#if defined(USE_LZ) || defined(USE_HUFFMAN)
+/*
+ * Flash bytes that can still be read for a compressed reply. Its uncompressed byte count is a U16, which erased
+ * flash would exceed long before the reply is full.
+ */
+static uint32_t dataflashReadLimit(uint32_t address, uint32_t bytesReadTotal, uint32_t flashfsSize)
+{
+    return MIN(flashfsSize - address - bytesReadTotal, UINT16_MAX - bytesReadTotal);
+}
+#endif
+
+static void serializeDataflashReadReply(sbuf_t *dst, uint32_t address, const uint16_t size, bool useLegacyFormat, uint8_t compressionRequested)
+{
+    STATIC_ASSERT(MSP_PORT_DATAFLASH_INFO_SIZE >= 16, MSP_PORT_DATAFLASH_INFO_SIZE_invalid);
+
+    uint16_t readLen = size;
+    const int bytesRemainingInBuf = sbufBytesRemaining(dst) - MSP_PORT_DATAFLASH_INFO_SIZE;
+    if (readLen > bytesRemainingInBuf) {
+        readLen = bytesRemainingInBuf;
+    }
+    // size will be lower than that requested if we reach end of volume
+    const uint32_t flashfsSize = flashfsGetSize();
+    if (readLen > flashfsSize - address) {
+        // truncate the request
+        readLen = flashfsSize - address;
+    }
+    sbufWriteU32(dst, address);
+
+    // legacy format does not support compression
+    const uint8_t compressionMethod = useLegacyFormat ? NO_COMPRESSION : dataflashCompressionMethod(compressionRequested);
+
+    if (compressionMethod == NO_COMPRESSION) {
+
+        uint16_t *readLenPtr = (uint16_t *)sbufPtr(dst);
+        if (!useLegacyFormat) {
+            // new format supports variable read lengths
+            sbufWriteU16(dst, readLen);
+            sbufWriteU8(dst, 0); // placeholder for compression format
+        }
+
+        const int bytesRead = flashfsReadAbs(address, sbufPtr(dst), readLen);
+
+        if (!useLegacyFormat) {
+            // update the 'read length' with the actual amount read from flash.
+            *readLenPtr = bytesRead;
+        }
+
+        sbufAdvance(dst, bytesRead);
+
+        if (useLegacyFormat) {
+            // pad the buffer with zeros
+            for (int i = bytesRead; i < size; i++) {
+                sbufWriteU8(dst, 0);
+            }
+        }
+#ifdef USE_LZ
+    } else if (compressionMethod == LZ) {
+        // payload: U16 uncompressed byte count, then length-prefixed LZ4 blocks
+        uint8_t *out = sbufPtr(dst) + sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint16_t);
+        int outLen = 0;
+        uint32_t bytesReadTotal = 0;
+        while (address + bytesReadTotal < flashfsSize) {
+            const int bytesRead = dataflashLzBlock(out, &outLen, readLen, address + bytesReadTotal, dataflashReadLimit(address, bytesReadTotal, flashfsSize));
+            if (bytesRead <= 0) {
+                break;
+            }
+            bytesReadTotal += bytesRead;
+        }
+
+        // header
+        sbufWriteU16(dst, sizeof(uint16_t) + outLen);
+        sbufWriteU8(dst, compressionMethod);
+        // payload
+        sbufWriteU16(dst, bytesReadTotal);
+        sbufAdvance(dst, outLen);
+#endif
+    } else {
+#ifdef USE_HUFFMAN
+        // compress in 256-byte chunks
+        const uint16_t READ_BUFFER_SIZE = 256;
+        // This may be DMAable, so make it cache aligned
+        __attribute__ ((aligned(32))) uint8_t readBuffer[READ_BUFFER_SIZE];
+
+        // LZ_HUFFMAN carries the number of LZ bytes that were Huffman coded after the uncompressed byte count
+        const int infoSize = (compressionMethod == LZ_HUFFMAN) ? HUFFMAN_INFO_SIZE + sizeof(uint16_t) : HUFFMAN_INFO_SIZE;
+
+        huffmanState_t state = {
+            .bytesWritten = 0,
+            .outByte = sbufPtr(dst) + sizeof(uint16_t) + sizeof(uint8_t) + infoSize,
+            .outBufLen = readLen,
+            .outBit = 0x80,
+        };
+        *state.outByte = 0;
+
+        uint32_t bytesReadTotal = 0;
+        uint32_t lzBytesTotal = 0;
+        // read until output buffer overflows or flash is exhausted
+        while (state.bytesWritten < state.outBufLen && address + bytesReadTotal < flashfsSize) {
+            const uint8_t *encodeBuf = readBuffer;
+            int encodeLen;
+            int bytesRead;
+#ifdef USE_LZ
+            if (compressionMethod == LZ_HUFFMAN) {
+                static uint8_t lzBuffer[DATAFLASH_LZ_BLOCK_HEADER_SIZE + DATAFLASH_LZ_BLOCK_SIZE + DATAFLASH_LZ_BLOCK_SIZE / 255 + 16];
+                encodeBuf = lzBuffer;
+                encodeLen = 0;
+                bytesRead = dataflashLzBlock(lzBuffer, &encodeLen, sizeof(lzBuffer), address + bytesReadTotal, dataflashReadLimit(address, bytesReadTotal, flashfsSize));
+                if (bytesRead <= 0 || lzBytesTotal + encodeLen > UINT16_MAX) {
+                    break;
+                }
+            } else
+#endif
+            {
+                bytesRead = flashfsReadAbs(address + bytesReadTotal, readBuffer,
+                    MIN(sizeof(readBuffer), dataflashReadLimit(address, bytesReadTotal, flashfsSize)));
+                if (bytesRead <= 0) {
+                    break;
+                }
+                encodeLen = bytesRead;
+            }
+
+            const huffmanState_t savedState = state;
+            const int status = huffmanEncodeBufStreaming(&state, encodeBuf, encodeLen, huffmanTable);
+            if (status == -1) {
+                // overflow, drop the partially encoded chunk
+                state = savedState;
+                break;
+            }
+
+            bytesReadTotal += bytesRead;
+            lzBytesTotal += encodeLen;
+        }
+
+        if (state.outBit != 0x80) {
+            ++state.bytesWritten;
+        }
+
+        // header
+        sbufWriteU16(dst, infoSize + state.bytesWritten);
+        sbufWriteU8(dst, compressionMethod);
+        // payload
+        sbufWriteU16(dst, bytesReadTotal);
+        if (compressionMethod == LZ_HUFFMAN) {
+            sbufWriteU16(dst, lzBytesTotal);
+        }
+        sbufAdvance(dst, state.bytesWritten);
+#endif
+    }
+}
+
+void mspDataflashReadCommand(sbuf_t *dst, sbuf_t *src)
+{
+    const unsigned int dataSize = sbufBytesRemaining(src);
+    const uint32_t readAddress = sbufReadU32(src);
+    uint16_t readLength;
+    uint8_t compressionRequested = NO_COMPRESSION;
+    bool useLegacyFormat;
+    if (dataSize >= sizeof(uint32_t) + sizeof(uint16_t)) {
+        readLength = sbufReadU16(src);
+        if (sbufBytesRemaining(src)) {
+            // 1 (or any unknown value) selects Huffman, 2 LZ, 3 LZ followed by Huffman
+            compressionRequested = sbufReadU8(src);
+        }
+        useLegacyFormat = false;
+    } else {
+        readLength = 128;
+        useLegacyFormat = true;
+    }
+
+    serializeDataflashReadReply(dst, readAddress, readLength, useLegacyFormat, compressionRequested);
+}
+
+#endif // USE_FLASHFS
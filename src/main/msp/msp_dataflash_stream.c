@@ -0,0 +1,221 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "platform.h"
+
+#ifdef USE_FLASHFS
+
+#include "common/crc.h"
+#include "common/maths.h"
+#include "common/streambuf.h"
+#include "common/utils.h"
+
+#include "drivers/time.h"
+
+#include "io/flashfs.h"
+
+#include "msp/msp_protocol_v2_betaflight.h"
+#include "msp/msp_serial.h"
+
+#include "msp_dataflash_stream.h"
+
+#define DATAFLASH_STREAM_CHUNK_SIZE_DEFAULT 256
+#define DATAFLASH_STREAM_CHUNK_SIZE_MIN     16
+#define DATAFLASH_STREAM_CHUNK_SIZE_MAX     512
+#define DATAFLASH_STREAM_WINDOW_DEFAULT     8
+#define DATAFLASH_STREAM_WINDOW_MAX         32      // limited by the width of the resend mask
+#define DATAFLASH_STREAM_RETRANSMIT_MS      250
+#define DATAFLASH_STREAM_TIMEOUT_MS         3000
+#define DATAFLASH_STREAM_CHUNK_OVERHEAD     (sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint16_t))
+#define DATAFLASH_STREAM_FRAME_OVERHEAD     (MSP_MAX_HEADER_SIZE + 2)
+
+typedef struct dataflashStream_s {
+    bool active;
+    mspDescriptor_t descriptor;
+    uint32_t address;           // address of the first chunk
+    uint32_t length;
+    uint32_t chunkCount;
+    uint16_t chunkSize;
+    uint8_t windowSize;
+    uint32_t ackSeq;            // all chunks before this one have been received by the host
+    uint32_t nextSeq;           // first chunk that has not been sent yet
+    uint32_t resendMask;        // chunks the host asked for again, relative to ackSeq
+    timeMs_t lastAckMs;
+    timeMs_t lastRetransmitMs;
+} dataflashStream_t;
+
+static dataflashStream_t dataflashStream;
+
+mspResult_e mspDataflashStreamStart(mspDescriptor_t srcDesc, sbuf_t *dst, sbuf_t *src)
+{
+    const unsigned int dataSize = sbufBytesRemaining(src);
+    if (dataSize < 2 * sizeof(uint32_t) || !flashfsIsSupported()) {
+        return MSP_RESULT_ERROR;
+    }
+
+    const uint32_t address = sbufReadU32(src);
+    uint32_t length = sbufReadU32(src);
+    uint16_t chunkSize = (dataSize >= 2 * sizeof(uint32_t) + sizeof(uint16_t)) ? sbufReadU16(src) : 0;
+    uint8_t windowSize = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+
+    const uint32_t flashfsSize = flashfsGetSize();
+    if (address >= flashfsSize) {
+        return MSP_RESULT_ERROR;
+    }
+    // truncate the range at the end of the volume
+    length = MIN(length, flashfsSize - address);
+
+    chunkSize = chunkSize ? constrain(chunkSize, DATAFLASH_STREAM_CHUNK_SIZE_MIN, DATAFLASH_STREAM_CHUNK_SIZE_MAX) : DATAFLASH_STREAM_CHUNK_SIZE_DEFAULT;
+    windowSize = windowSize ? MIN(windowSize, DATAFLASH_STREAM_WINDOW_MAX) : DATAFLASH_STREAM_WINDOW_DEFAULT;
+
+    const timeMs_t now = millis();
+    dataflashStream = (dataflashStream_t) {
+        .active = length > 0,
+        .descriptor = srcDesc,
+        .address = address,
+        .length = length,
+        .chunkCount = (length + chunkSize - 1) / chunkSize,
+        .chunkSize = chunkSize,
+        .windowSize = windowSize,
+        .lastAckMs = now,
+        .lastRetransmitMs = now,
+    };
+
+    sbufWriteU32(dst, dataflashStream.address);
+    sbufWriteU32(dst, dataflashStream.length);
+    sbufWriteU16(dst, dataflashStream.chunkSize);
+    sbufWriteU8(dst, dataflashStream.windowSize);
+    sbufWriteU32(dst, dataflashStream.chunkCount);
+
+    return MSP_RESULT_ACK;
+}
+
+void mspDataflashStreamAck(mspDescriptor_t srcDesc, sbuf_t *src)
+{
+    const unsigned int dataSize = sbufBytesRemaining(src);
+    if (!dataflashStream.active || dataflashStream.descriptor != srcDesc || dataSize < sizeof(uint32_t)) {
+        return;
+    }
+
+    const uint32_t ackSeq = sbufReadU32(src);
+    const uint32_t resendMask = (dataSize >= 2 * sizeof(uint32_t)) ? sbufReadU32(src) : 0;
+
+    if (ackSeq < dataflashStream.ackSeq || ackSeq > dataflashStream.nextSeq) {
+        // stale or bogus acknowledgement
+        return;
+    }
+
+    dataflashStream.ackSeq = ackSeq;
+    dataflashStream.lastAckMs = millis();
+    dataflashStream.lastRetransmitMs = dataflashStream.lastAckMs;
+
+    // only chunks that have actually been sent can be requested again
+    const uint32_t inFlight = dataflashStream.nextSeq - ackSeq;
+    dataflashStream.resendMask = resendMask & ((inFlight >= 32) ? UINT32_MAX : ((1U << inFlight) - 1));
+
+    if (ackSeq == dataflashStream.chunkCount) {
+        dataflashStream.active = false;
+    }
+}
+
+void mspDataflashStreamStop(mspDescriptor_t srcDesc)
+{
+    if (dataflashStream.descriptor == srcDesc) {
+        dataflashStream.active = false;
+    }
+}
+
+/*
+ * Push as many chunks as the window and the TX buffer of the requesting port allow.
+ *
+ * Called periodically by the serial task.
+ */
+void mspDataflashStreamProcess(void)
+{
+    static uint8_t chunkBuf[DATAFLASH_STREAM_CHUNK_OVERHEAD + DATAFLASH_STREAM_CHUNK_SIZE_MAX];
+
+    if (!dataflashStream.active) {
+        return;
+    }
+
+    const timeMs_t now = millis();
+    if (now - dataflashStream.lastAckMs > DATAFLASH_STREAM_TIMEOUT_MS) {
+        // host has gone away
+        dataflashStream.active = false;
+        return;
+    }
+
+    if (dataflashStream.nextSeq > dataflashStream.ackSeq && now - dataflashStream.lastRetransmitMs > DATAFLASH_STREAM_RETRANSMIT_MS) {
+        // nothing acknowledged for a while, go back and resend the window
+        dataflashStream.nextSeq = dataflashStream.ackSeq;
+        dataflashStream.resendMask = 0;
+        dataflashStream.lastRetransmitMs = now;
+    }
+
+    const uint32_t windowEnd = MIN(dataflashStream.chunkCount, dataflashStream.ackSeq + dataflashStream.windowSize);
+
+    for (unsigned sent = 0; sent < dataflashStream.windowSize; sent++) {
+        uint32_t seq;
+        if (dataflashStream.resendMask) {
+            seq = dataflashStream.ackSeq + __builtin_ctz(dataflashStream.resendMask);
+        } else if (dataflashStream.nextSeq < windowEnd) {
+            seq = dataflashStream.nextSeq;
+        } else {
+            break;
+        }
+
+        const uint32_t offset = seq * dataflashStream.chunkSize;
+        const uint16_t chunkLen = MIN(dataflashStream.chunkSize, dataflashStream.length - offset);
+        if (!mspSerialCanPushDescriptor(dataflashStream.descriptor, DATAFLASH_STREAM_FRAME_OVERHEAD + DATAFLASH_STREAM_CHUNK_OVERHEAD + chunkLen)) {
+            break;
+        }
+
+        sbuf_t buf = { .ptr = chunkBuf, .end = ARRAYEND(chunkBuf), };
+        sbufWriteU32(&buf, seq);
+        uint8_t *lengthPtr = sbufPtr(&buf);
+        sbufWriteU16(&buf, chunkLen);
+        const int bytesRead = flashfsReadAbs(dataflashStream.address + offset, sbufPtr(&buf), chunkLen);
+        const uint16_t crc = crc16_ccitt_update(0, sbufPtr(&buf), bytesRead);
+        sbufAdvance(&buf, bytesRead);
+        sbufWriteU16(&buf, crc);
+        // update the length with the actual amount read from flash
+        lengthPtr[0] = bytesRead & 0xff;
+        lengthPtr[1] = bytesRead >> 8;
+
+        const int written = mspSerialPushDescriptor(dataflashStream.descriptor, MSP2_DATAFLASH_STREAM_DATA, chunkBuf, sbufPtr(&buf) - chunkBuf, MSP_V2_NATIVE);
+        if (written < 0) {
+            // port has been closed
+            dataflashStream.active = false;
+            return;
+        } else if (written == 0) {
+            break;
+        }
+
+        if (seq < dataflashStream.nextSeq) {
+            dataflashStream.resendMask &= ~(1U << (seq - dataflashStream.ackSeq));
+        } else {
+            dataflashStream.nextSeq++;
+        }
+    }
+}
+#endif // USE_FLASHFS
@@ -0,0 +1,45 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/streambuf.h"
+
+#include "msp/msp.h"
+
+/*
+ * Windowed bulk transfer of a dataflash range.
+ *
+ * The host names a range with MSP2_DATAFLASH_STREAM_START and the FC then pushes MSP2_DATAFLASH_STREAM_DATA
+ * frames as fast as the TX buffer of the requesting port allows, without waiting for a request per chunk.
+ * Each chunk carries its sequence number and a CRC16 of its payload:
+ *
+ *   U32 seq, U16 length, <length> bytes of data, U16 crc16_ccitt(data)
+ *
+ * At most windowSize chunks are in flight beyond the last acknowledged one. The host acknowledges with
+ * MSP2_DATAFLASH_STREAM_ACK carrying the first sequence number it has not received yet and a bitmask of
+ * chunks after that one that it wants again (bit n -> ackSeq + n). If no acknowledgement arrives the
+ * unacknowledged part of the window is resent, and the stream is abandoned if the host goes quiet.
+ */
+
+mspResult_e mspDataflashStreamStart(mspDescriptor_t srcDesc, sbuf_t *dst, sbuf_t *src);
+void mspDataflashStreamAck(mspDescriptor_t srcDesc, sbuf_t *src);
+void mspDataflashStreamStop(mspDescriptor_t srcDesc);
+void mspDataflashStreamProcess(void);
@@ -0,0 +1,137 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * MSP2_MULTI carries several sub-requests, each as U16 command, U16 size, payload.
+ * They are processed in order by the normal dispatch and answered with one reply:
+ *
+ *   U8 number of sub-requests processed, then for each: U16 command, U8 result, U16 size, payload
+ *
+ * Processing stops early when the reply buffer is full, the host sends the remaining sub-requests again.
+ * A sub-request only runs once its reply is known to fit, so it is never left half done:
+ *  - commands that only report state are serialized first, a reply that is too large changes nothing
+ *  - other commands run only while there is room for any reply that fits the buffer of a port without flash
+ * The first sub-request always runs, if its reply doesn't fit it is reported as truncated and must be sent
+ * on its own. The batch ends after a sub-request that leaves an action to run after the reply (e.g. a reboot),
+ * so a later one can't replace it.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "common/maths.h"
+#include "common/streambuf.h"
+
+#include "msp/msp_protocol.h"
+#include "msp/msp_protocol_v2_betaflight.h"
+#include "msp/msp_serial.h"
+
+#include "msp_multi.h"
+
+#define MSP_MULTI_REPLY_HEADER_SIZE (sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint16_t))
+
+// replies sized to fill the whole reply buffer, or nested envelopes
+static bool mspMultiIsRejected(int16_t cmdMSP)
+{
+    switch (cmdMSP) {
+    case MSP_DATAFLASH_READ:
+    case MSP_MULTIPLE_MSP:
+    case MSP2_MULTI:
+        return true;
+    default:
+        return false;
+    }
+}
+
+mspResult_e mspMultiProcessCommand(mspDescriptor_t srcDesc, sbuf_t *dst, sbuf_t *src, mspPostProcessFnPtr *mspPostProcessFn,
+    mspProcessCommandFnPtr processCommandFn, mspProcessOutCommandFnPtr processOutCommandFn)
+{
+    // handlers don't check the space left, so replies are built in a buffer of the size they all assume
+    static uint8_t subReplyBuf[MSP_PORT_OUTBUF_SIZE];
+
+    uint8_t *countPtr = sbufPtr(dst);
+    sbufWriteU8(dst, 0);
+    uint8_t count = 0;
+
+    while (sbufBytesRemaining(src) >= 2 * (int)sizeof(uint16_t) && count < UINT8_MAX) {
+        const int replySpace = MIN(sbufBytesRemaining(dst) - (int)MSP_MULTI_REPLY_HEADER_SIZE, (int)sizeof(subReplyBuf));
+        if (replySpace < 0 || (mspPostProcessFn && *mspPostProcessFn)) {
+            break;
+        }
+
+        const int16_t subCmdMSP = sbufReadU16(src);
+        const int subSize = MIN(sbufReadU16(src), sbufBytesRemaining(src));
+
+        mspPacket_t subCmd = {
+            .buf = { .ptr = sbufPtr(src), .end = sbufPtr(src) + subSize, },
+            .cmd = subCmdMSP,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REQUEST,
+        };
+        // handlers that size their reply to the space left get only what fits in the envelope
+        mspPacket_t subReply = {
+            .buf = { .ptr = subReplyBuf, .end = subReplyBuf + replySpace, },
+            .cmd = -1,
+            .flags = 0,
+            .result = 0,
+            .direction = MSP_DIRECTION_REPLY,
+        };
+
+        int8_t result;
+        if (mspMultiIsRejected(subCmdMSP)) {
+            result = MSP_RESULT_ERROR;
+        } else if (processOutCommandFn(srcDesc, subCmdMSP, &subReply.buf)) {
+            if (count > 0 && sbufPtr(&subReply.buf) - subReplyBuf > replySpace) {
+                break;
+            }
+            result = MSP_RESULT_ACK;
+        } else if (count > 0 && replySpace < MSP_PORT_OUTBUF_SIZE_MIN) {
+            break;
+        } else {
+            subReply.buf.ptr = subReplyBuf;
+            mspPostProcessFnPtr subPostProcessFn = NULL;
+            result = processCommandFn(srcDesc, &subCmd, &subReply, mspPostProcessFn ? &subPostProcessFn : NULL);
+            if (mspPostProcessFn) {
+                *mspPostProcessFn = subPostProcessFn;
+            }
+        }
+        sbufAdvance(src, subSize);
+
+        int replyLen = (result == MSP_RESULT_NO_REPLY) ? 0 : sbufPtr(&subReply.buf) - subReplyBuf;
+        if (replyLen > replySpace) {
+            result = MSP2MULTI_RESULT_TRUNCATED;
+            replyLen = 0;
+        }
+
+        sbufWriteU16(dst, subCmdMSP);
+        sbufWriteU8(dst, result);
+        sbufWriteU16(dst, replyLen);
+        sbufWriteData(dst, subReplyBuf, replyLen);
+        count++;
+    }
+
+    *countPtr = count;
+
+    return MSP_RESULT_ACK;
+}
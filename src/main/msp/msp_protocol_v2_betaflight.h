@@ -29,6 +29,18 @@
 #define MSP2_GET_LED_STRIP_CONFIG_VALUES    0x3008
 #define MSP2_SET_LED_STRIP_CONFIG_VALUES    0x3009
 #define MSP2_SENSOR_CONFIG_ACTIVE           0x300A
+#define MSP2_DATAFLASH_STREAM_START         0x300B  // start a windowed bulk read of a dataflash range
+#define MSP2_DATAFLASH_STREAM_ACK           0x300C  // acknowledge received chunks and request missing ones
+#define MSP2_DATAFLASH_STREAM_STOP          0x300D
+#define MSP2_DATAFLASH_STREAM_DATA          0x300E  // pushed by the FC, one per chunk
+#define MSP2_SET_SUBSCRIPTIONS              0x300F  // replace the set of commands the FC pushes periodically on this port
+#define MSP2_MULTI                          0x3010  // several requests in one frame, answered by one frame
+#define MSP2_SETTINGS_INFO                  0x3011  // number of settings and hash of the settings schema
+#define MSP2_SETTINGS_SCHEMA                0x3012  // name, type and range of settings, by index
+#define MSP2_SETTINGS_LOOKUP                0x3013  // value names of a lookup table
+#define MSP2_SETTINGS_GET                   0x3014  // packed binary values of settings, by index
+#define MSP2_SETTINGS_SET                   0x3015
+#define MSP2_LATENCY_STATS                  0x3016  // latency distribution of a path from sensor or RC frame to motor output
 
 // MSP2_SET_TEXT and MSP2_GET_TEXT variable types
 #define MSP2TEXT_PILOT_NAME                      1
@@ -37,3 +49,6 @@
 #define MSP2TEXT_RATE_PROFILE_NAME               4
 #define MSP2TEXT_BUILDKEY                        5
 #define MSP2TEXT_RELEASENAME                     6
+
+// MSP2_MULTI result codes, in addition to mspResult_e
+#define MSP2MULTI_RESULT_TRUNCATED               2  // processed, but the reply did not fit and was dropped
@@ -31,6 +31,7 @@
 #include "common/streambuf.h"
 #include "common/utils.h"
 #include "common/crc.h"
+#include "common/maths.h"
 
 #include "drivers/system.h"
 
@@ -44,6 +45,9 @@
 
 static mspPort_t mspPorts[MAX_MSP_PORT_COUNT];
 
+// shared by replies and subscription pushes, only one frame is built at a time
+static uint8_t mspSerialOutBuf[MSP_PORT_OUTBUF_SIZE];
+
 static void resetMspPort(mspPort_t *mspPortToReset, serialPort_t *serialPort, bool sharedWithTelemetry)
 {
     memset(mspPortToReset, 0, sizeof(mspPort_t));
@@ -96,6 +100,17 @@ void mspSerialReleasePortIfAllocated(serialPort_t *serialPort)
     }
 }
 
+static mspPort_t *mspSerialFindPortByDescriptor(mspDescriptor_t descriptor)
+{
+    for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
+        mspPort_t *candidateMspPort = &mspPorts[portIndex];
+        if (candidateMspPort->port && candidateMspPort->descriptor == descriptor) {
+            return candidateMspPort;
+        }
+    }
+    return NULL;
+}
+
 mspDescriptor_t getMspSerialPortDescriptor(const uint8_t portIdentifier)
 {
     for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
@@ -415,8 +430,6 @@ static int mspSerialEncode(mspPort_t *msp, mspPacket_t *packet, mspVersion_e msp
 
 static mspPostProcessFnPtr mspSerialProcessReceivedCommand(mspPort_t *msp, mspProcessCommandFnPtr mspProcessCommandFn)
 {
-    static uint8_t mspSerialOutBuf[MSP_PORT_OUTBUF_SIZE];
-
     mspPacket_t reply = {
         .buf = { .ptr = mspSerialOutBuf, .end = ARRAYEND(mspSerialOutBuf), },
         .cmd = -1,
@@ -501,12 +514,84 @@ static void mspSerialProcessReceivedReply(mspPort_t *msp, mspProcessReplyFnPtr m
     msp->c_state = MSP_IDLE;
 }
 
+/*
+ * Push the replies of subscribed commands that are due, within the bandwidth budget of the port
+ * and without using the TX buffer space kept free for replies to requests.
+ */
+static void mspSerialProcessSubscriptions(mspPort_t *msp, mspProcessOutCommandFnPtr mspProcessOutCommandFn)
+{
+    if (!msp->subscriptionCount || !mspProcessOutCommandFn || msp->c_state != MSP_IDLE || serialRxBytesWaiting(msp->port)) {
+        // replies come first, don't push while a request is arriving; half duplex ports would also collide
+        return;
+    }
+
+    // keep room in the TX buffer for the reply to the next request, whatever the bandwidth limit
+    const int txReserve = msp->port->txBufferSize ? MIN(MSP_PORT_TX_REPLY_RESERVE, (int)msp->port->txBufferSize / 2) : MSP_PORT_TX_REPLY_RESERVE;
+
+    const timeMs_t now = millis();
+
+    if (msp->subscriptionBytesPerSecond) {
+        // token bucket, allowing bursts of up to 100ms worth of data
+        const int32_t budgetMax = MAX(msp->subscriptionBytesPerSecond / 10, (uint32_t)MSP_PORT_OUTBUF_SIZE_MIN);
+        const int32_t refill = (uint64_t)(now - msp->subscriptionBudgetUpdateMs) * msp->subscriptionBytesPerSecond / 1000;
+        msp->subscriptionBudget = MIN(msp->subscriptionBudget + refill, budgetMax);
+        msp->subscriptionBudgetUpdateMs = now;
+    }
+
+    const int firstIndex = msp->subscriptionIndex;
+    for (int i = 0; i < msp->subscriptionCount; i++) {
+        if (msp->subscriptionBytesPerSecond && msp->subscriptionBudget <= 0) {
+            break;
+        }
+
+        const int index = (firstIndex + i) % msp->subscriptionCount;
+        mspSubscription_t *subscription = &msp->subscriptions[index];
+        if (!subscription->intervalMs || now - subscription->lastSentMs < subscription->intervalMs) {
+            continue;
+        }
+
+        mspPacket_t push = {
+            .buf = { .ptr = mspSerialOutBuf, .end = ARRAYEND(mspSerialOutBuf), },
+            .cmd = subscription->cmd,
+            .flags = 0,
+            .result = MSP_RESULT_ACK,
+            .direction = MSP_DIRECTION_REPLY,
+        };
+
+        if (!mspProcessOutCommandFn(msp->descriptor, subscription->cmd, &push.buf)) {
+            // not a command that can be pushed, stop trying
+            subscription->intervalMs = 0;
+            continue;
+        }
+        sbufSwitchToReader(&push.buf, mspSerialOutBuf);
+
+        const int frameLength = MSP_MAX_HEADER_SIZE + 2 + sbufBytesRemaining(&push.buf);
+        if ((int)serialTxBytesFree(msp->port) - frameLength < txReserve) {
+            // carry on from here once the TX buffer has drained
+            msp->subscriptionIndex = index;
+            break;
+        }
+
+        const mspVersion_e version = (subscription->cmd > 255 && msp->subscriptionVersion == MSP_V1) ? MSP_V2_NATIVE : msp->subscriptionVersion;
+        const int written = mspSerialEncode(msp, &push, version);
+        if (!written) {
+            // TX buffer is full, carry on from here next time
+            msp->subscriptionIndex = index;
+            break;
+        }
+
+        subscription->lastSentMs = now;
+        msp->subscriptionBudget -= written;
+        msp->subscriptionIndex = (index + 1) % msp->subscriptionCount;
+    }
+}
+
 /*
  * Process MSP commands from serial ports configured as MSP ports.
  *
  * Called periodically by the scheduler.
  */
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn)
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn, mspProcessOutCommandFnPtr mspProcessOutCommandFn)
 {
     for (uint8_t portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
         mspPort_t * const mspPort = &mspPorts[portIndex];
@@ -548,6 +633,8 @@ void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessComm
         } else {
             mspProcessPendingRequest(mspPort);
         }
+
+        mspSerialProcessSubscriptions(mspPort, mspProcessOutCommandFn);
     }
 }
 
@@ -572,7 +659,7 @@ void mspSerialInit(void)
     mspSerialAllocatePorts();
 }
 
-int mspSerialPush(serialPortIdentifier_e port, uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction, mspVersion_e mspVersion)
+int mspSerialPush(serialPortIdentifier_e port, int16_t cmd, uint8_t *data, int datalen, mspDirection_e direction, mspVersion_e mspVersion)
 {
     int ret = 0;
 
@@ -601,18 +688,20 @@ int mspSerialPush(serialPortIdentifier_e port, uint8_t cmd, uint8_t *data, int d
 }
 
 
-uint32_t mspSerialTxBytesFree(void)
+// Returns the TX buffer space of the ports mspSerialPush() writes to for port, the smallest one for SERIAL_PORT_ALL.
+uint32_t mspSerialTxBytesFree(serialPortIdentifier_e port)
 {
     uint32_t ret = UINT32_MAX;
 
     for (int portIndex = 0; portIndex < MAX_MSP_PORT_COUNT; portIndex++) {
         mspPort_t * const mspPort = &mspPorts[portIndex];
-        if (!mspPort->port) {
-            continue;
-        }
 
         // XXX Kludge!!! Avoid zombie VCP port (avoid VCP entirely for now)
-        if (mspPort->port->identifier == SERIAL_PORT_USB_VCP) {
+        if (!mspPort->port
+#ifndef USE_MSP_PUSH_OVER_VCP
+            || mspPort->port->identifier == SERIAL_PORT_USB_VCP
+#endif
+            || (port != SERIAL_PORT_ALL && mspPort->port->identifier != port)) {
             continue;
         }
 
@@ -624,3 +713,69 @@ uint32_t mspSerialTxBytesFree(void)
 
     return ret;
 }
+
+/*
+ * Push a frame to the single MSP port identified by descriptor, e.g. to stream data back to the host that requested it.
+ * Unlike mspSerialPush() this includes the USB VCP, the port is known to be in use by the host.
+ * Returns the number of bytes written, 0 if the frame did not fit in the TX buffer, or -1 if the port no longer exists.
+ */
+int mspSerialPushDescriptor(mspDescriptor_t descriptor, int16_t cmd, uint8_t *data, int datalen, mspVersion_e mspVersion)
+{
+    mspPort_t * const mspPort = mspSerialFindPortByDescriptor(descriptor);
+    if (!mspPort) {
+        return -1;
+    }
+
+    mspPacket_t push = {
+        .buf = { .ptr = data, .end = data + datalen, },
+        .cmd = cmd,
+        .result = 0,
+        .direction = MSP_DIRECTION_REPLY,
+    };
+
+    return mspSerialEncode(mspPort, &push, mspVersion);
+}
+
+// Returns true if a frame of the given total length would currently be accepted by mspSerialPushDescriptor()
+bool mspSerialCanPushDescriptor(mspDescriptor_t descriptor, int frameLength)
+{
+    const mspPort_t * const mspPort = mspSerialFindPortByDescriptor(descriptor);
+    if (!mspPort) {
+        return false;
+    }
+
+    // same rule as mspSerialSendFrame()
+    return isSerialTransmitBufferEmpty(mspPort->port) || (int)serialTxBytesFree(mspPort->port) >= frameLength;
+}
+
+/*
+ * Replace the set of commands pushed periodically on the port identified by descriptor.
+ * Replies are sent with the MSP version of the frame that set up the subscriptions.
+ * A count of 0 cancels all subscriptions. Returns the number of subscriptions accepted.
+ */
+int mspSerialSetSubscriptions(mspDescriptor_t descriptor, const int16_t *cmds, const uint16_t *intervalsMs, int count, uint32_t bytesPerSecond)
+{
+    mspPort_t * const mspPort = mspSerialFindPortByDescriptor(descriptor);
+    if (!mspPort) {
+        return 0;
+    }
+
+    count = MIN(count, MSP_MAX_SUBSCRIPTIONS);
+
+    const timeMs_t now = millis();
+    for (int i = 0; i < count; i++) {
+        mspPort->subscriptions[i] = (mspSubscription_t) {
+            .cmd = cmds[i],
+            .intervalMs = MAX(intervalsMs[i], 1),
+            .lastSentMs = now - intervalsMs[i],   // due straight away
+        };
+    }
+    mspPort->subscriptionCount = count;
+    mspPort->subscriptionIndex = 0;
+    mspPort->subscriptionVersion = mspPort->mspVersion;
+    mspPort->subscriptionBytesPerSecond = bytesPerSecond;
+    mspPort->subscriptionBudget = 0;
+    mspPort->subscriptionBudgetUpdateMs = now;
+
+    return count;
+}
@@ -69,6 +69,7 @@ typedef enum {
 
 #define MSP_PORT_INBUF_SIZE 192
 #define MSP_PORT_OUTBUF_SIZE_MIN 320
+#define MSP_PORT_TX_REPLY_RESERVE 128 // TX buffer space subscription pushes leave free for replies
 
 #ifdef USE_FLASHFS
 #define MSP_PORT_DATAFLASH_BUFFER_SIZE 4096
@@ -95,6 +96,14 @@ typedef struct __attribute__((packed)) {
 
 #define MSP_MAX_HEADER_SIZE     9
 
+#define MSP_MAX_SUBSCRIPTIONS   12
+
+typedef struct mspSubscription_s {
+    int16_t cmd;
+    uint16_t intervalMs;    // 0 when the command can't be pushed
+    timeMs_t lastSentMs;
+} mspSubscription_t;
+
 struct serialPort_s;
 typedef struct mspPort_s {
     struct serialPort_s *port; // null when port unused.
@@ -112,14 +121,24 @@ typedef struct mspPort_s {
     uint8_t checksum2;
     bool sharedWithTelemetry;
     mspDescriptor_t descriptor;
+    mspSubscription_t subscriptions[MSP_MAX_SUBSCRIPTIONS];
+    uint8_t subscriptionCount;
+    uint8_t subscriptionIndex;          // round robin start, so slow ports don't starve the last subscriptions
+    mspVersion_e subscriptionVersion;
+    uint32_t subscriptionBytesPerSecond; // 0 for no limit other than the TX buffer
+    int32_t subscriptionBudget;
+    timeMs_t subscriptionBudgetUpdateMs;
 } mspPort_t;
 
 void mspSerialInit(void);
 bool mspSerialWaiting(void);
-void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn);
+void mspSerialProcess(mspEvaluateNonMspData_e evaluateNonMspData, mspProcessCommandFnPtr mspProcessCommandFn, mspProcessReplyFnPtr mspProcessReplyFn, mspProcessOutCommandFnPtr mspProcessOutCommandFn);
 void mspSerialAllocatePorts(void);
 void mspSerialReleasePortIfAllocated(struct serialPort_s *serialPort);
 void mspSerialReleaseSharedTelemetryPorts(void);
 mspDescriptor_t getMspSerialPortDescriptor(const uint8_t portIdentifier);
-int mspSerialPush(serialPortIdentifier_e port, uint8_t cmd, uint8_t *data, int datalen, mspDirection_e direction, mspVersion_e mspVersion);
-uint32_t mspSerialTxBytesFree(void);
+int mspSerialPush(serialPortIdentifier_e port, int16_t cmd, uint8_t *data, int datalen, mspDirection_e direction, mspVersion_e mspVersion);
+uint32_t mspSerialTxBytesFree(serialPortIdentifier_e port);
+int mspSerialPushDescriptor(mspDescriptor_t descriptor, int16_t cmd, uint8_t *data, int datalen, mspVersion_e mspVersion);
+bool mspSerialCanPushDescriptor(mspDescriptor_t descriptor, int frameLength);
+int mspSerialSetSubscriptions(mspDescriptor_t descriptor, const int16_t *cmds, const uint16_t *intervalsMs, int count, uint32_t bytesPerSecond);
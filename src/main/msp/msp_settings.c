@@ -0,0 +1,511 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Binary access to the CLI settings (valueTable) over MSP, addressed by table index.
+ *
+ * The schema (names, types, ranges and lookup tables) is read once and can be cached by the host
+ * against the schema hash, after that values are read and written as packed binary records:
+ *
+ *   U16 index, U8 size, <size> bytes of value
+ *
+ * A value is one little endian element for direct and lookup settings, all elements for arrays,
+ * the characters without terminator for strings and 0 / 1 for bitsets.
+ * Profile values refer to the currently selected PID and rate profiles.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "platform.h"
+
+#include "cli/settings.h"
+
+#include "common/crc.h"
+#include "common/maths.h"
+#include "common/streambuf.h"
+#include "common/utils.h"
+
+#include "config/config.h"
+
+#include "fc/controlrate_profile.h"
+#include "fc/rc.h"
+#include "fc/runtime_config.h"
+
+#include "flight/pid.h"
+#include "flight/pid_init.h"
+
+#include "msp/msp_protocol_v2_betaflight.h"
+
+#include "pg/pg.h"
+
+#include "msp_settings.h"
+
+#define SETTING_INDEX_NONE 0xFFFF
+
+// flags for MSP2_SETTINGS_GET
+#define SETTINGS_GET_CHANGED_ONLY (1 << 0)
+
+static uint8_t settingElementSize(const clivalue_t *value)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_INT8:
+    default:
+        return 1;
+    case VAR_UINT16:
+    case VAR_INT16:
+        return 2;
+    case VAR_UINT32:
+    case VAR_INT32:
+        return 4;
+    }
+}
+
+static uint16_t settingValueOffset(const clivalue_t *value)
+{
+    switch (value->type & VALUE_SECTION_MASK) {
+    case PROFILE_VALUE:
+        return value->offset + sizeof(pidProfile_t) * getCurrentPidProfileIndex();
+    case PROFILE_RATE_VALUE:
+        return value->offset + sizeof(controlRateConfig_t) * getCurrentControlRateProfileIndex();
+    default:
+        return value->offset;
+    }
+}
+
+static uint32_t settingReadElement(const clivalue_t *value, const uint8_t *ptr, int index)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_INT8:
+    default:
+        return ((const uint8_t *)ptr)[index];
+    case VAR_UINT16:
+    case VAR_INT16:
+        return ((const uint16_t *)ptr)[index];
+    case VAR_UINT32:
+    case VAR_INT32:
+        return ((const uint32_t *)ptr)[index];
+    }
+}
+
+static void settingWriteElement(const clivalue_t *value, uint8_t *ptr, int index, uint32_t element)
+{
+    switch (value->type & VALUE_TYPE_MASK) {
+    case VAR_UINT8:
+    case VAR_INT8:
+    default:
+        ((uint8_t *)ptr)[index] = element;
+        break;
+    case VAR_UINT16:
+    case VAR_INT16:
+        ((uint16_t *)ptr)[index] = element;
+        break;
+    case VAR_UINT32:
+    case VAR_INT32:
+        ((uint32_t *)ptr)[index] = element;
+        break;
+    }
+}
+
+// size of the encoded value, as sent over MSP
+static uint8_t settingValueSize(const clivalue_t *value, const uint8_t *ptr)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_ARRAY:
+        return value->config.array.length * settingElementSize(value);
+    case MODE_BITSET:
+        return 1;
+    case MODE_STRING:
+        return strnlen((const char *)ptr, value->config.string.maxlength);
+    default:
+        return settingElementSize(value);
+    }
+}
+
+static bool settingValueEquals(const clivalue_t *value, const uint8_t *ptr, const uint8_t *other)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_BITSET:
+        {
+            const uint32_t mask = 1U << value->config.bitpos;
+            return (settingReadElement(value, ptr, 0) & mask) == (settingReadElement(value, other, 0) & mask);
+        }
+    case MODE_STRING:
+        return strncmp((const char *)ptr, (const char *)other, value->config.string.maxlength) == 0;
+    default:
+        return memcmp(ptr, other, settingValueSize(value, ptr)) == 0;
+    }
+}
+
+static void serializeSettingValue(sbuf_t *dst, const clivalue_t *value, const uint8_t *ptr)
+{
+    if ((value->type & VALUE_MODE_MASK) == MODE_BITSET) {
+        sbufWriteU8(dst, (settingReadElement(value, ptr, 0) >> value->config.bitpos) & 1);
+        return;
+    }
+
+    const uint8_t size = settingValueSize(value, ptr);
+    if ((value->type & VALUE_MODE_MASK) == MODE_STRING) {
+        sbufWriteData(dst, ptr, size);
+        return;
+    }
+
+    const uint8_t elementSize = settingElementSize(value);
+    for (int i = 0; i < size / elementSize; i++) {
+        const uint32_t element = settingReadElement(value, ptr, i);
+        for (int b = 0; b < elementSize; b++) {
+            sbufWriteU8(dst, element >> (8 * b));
+        }
+    }
+}
+
+static bool settingElementInRange(const clivalue_t *value, uint32_t element)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_LOOKUP:
+        return element < lookupTables[value->config.lookup.tableIndex].valueCount;
+    case MODE_DIRECT:
+        switch (value->type & VALUE_TYPE_MASK) {
+        case VAR_UINT8:
+        case VAR_UINT16:
+            return element >= value->config.minmaxUnsigned.min && element <= value->config.minmaxUnsigned.max;
+        case VAR_INT8:
+            return (int8_t)element >= value->config.minmax.min && (int8_t)element <= value->config.minmax.max;
+        case VAR_INT16:
+            return (int16_t)element >= value->config.minmax.min && (int16_t)element <= value->config.minmax.max;
+        case VAR_UINT32:
+            return element <= value->config.u32Max;
+        case VAR_INT32:
+            return (int32_t)element >= -value->config.d32Max && (int32_t)element <= value->config.d32Max;
+        }
+        return false;
+    case MODE_ARRAY:
+        return !value->config.array.max || element <= value->config.array.max;
+    default:
+        return true;
+    }
+}
+
+static uint32_t decodeSettingElement(const clivalue_t *value, const uint8_t *data, int index)
+{
+    const uint8_t elementSize = settingElementSize(value);
+    uint32_t element = 0;
+    for (int b = 0; b < elementSize; b++) {
+        element |= (uint32_t)data[index * elementSize + b] << (8 * b);
+    }
+    return element;
+}
+
+// check one encoded value against the limits of the setting, without changing it
+static bool settingValueValid(const clivalue_t *value, const uint8_t *ptr, const uint8_t *data, uint8_t size)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_BITSET:
+        return size == 1 && data[0] <= 1;
+
+    case MODE_STRING:
+        {
+            const cliStringLengthConfig_t *config = &value->config.string;
+            if ((size && size < config->minlength) || size > config->maxlength || memchr(data, 0, size)) {
+                return false;
+            }
+            const uint8_t currentLength = strnlen((const char *)ptr, config->maxlength);
+            return !(config->flags & STRING_FLAGS_WRITEONCE) || !currentLength
+                || (currentLength == size && !memcmp(ptr, data, size));
+        }
+
+    default:
+        {
+            const int elementCount = ((value->type & VALUE_MODE_MASK) == MODE_ARRAY) ? value->config.array.length : 1;
+            if (size != settingElementSize(value) * elementCount) {
+                return false;
+            }
+            for (int i = 0; i < elementCount; i++) {
+                if (!settingElementInRange(value, decodeSettingElement(value, data, i))) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+// store one value that has been checked by settingValueValid()
+static void deserializeSettingValue(const clivalue_t *value, uint8_t *ptr, const uint8_t *data, uint8_t size)
+{
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_BITSET:
+        {
+            const uint32_t mask = 1U << value->config.bitpos;
+            const uint32_t element = settingReadElement(value, ptr, 0);
+            settingWriteElement(value, ptr, 0, data[0] ? element | mask : element & ~mask);
+        }
+        break;
+
+    case MODE_STRING:
+        memset(ptr, 0, value->config.string.maxlength);
+        memcpy(ptr, data, size);
+        break;
+
+    default:
+        for (int i = 0; i < size / settingElementSize(value); i++) {
+            settingWriteElement(value, ptr, i, decodeSettingElement(value, data, i));
+        }
+        break;
+    }
+}
+
+static void serializeSettingSchema(sbuf_t *dst, const clivalue_t *value)
+{
+    const uint8_t nameLength = strlen(value->name);
+
+    sbufWriteU8(dst, value->type);
+    sbufWriteU8(dst, nameLength);
+    sbufWriteData(dst, value->name, nameLength);
+
+    switch (value->type & VALUE_MODE_MASK) {
+    case MODE_DIRECT:
+        switch (value->type & VALUE_TYPE_MASK) {
+        case VAR_UINT8:
+        case VAR_UINT16:
+            sbufWriteU32(dst, value->config.minmaxUnsigned.min);
+            sbufWriteU32(dst, value->config.minmaxUnsigned.max);
+            break;
+        case VAR_UINT32:
+            sbufWriteU32(dst, 0);
+            sbufWriteU32(dst, value->config.u32Max);
+            break;
+        case VAR_INT32:
+            sbufWriteU32(dst, -value->config.d32Max);
+            sbufWriteU32(dst, value->config.d32Max);
+            break;
+        default:
+            sbufWriteU32(dst, value->config.minmax.min);
+            sbufWriteU32(dst, value->config.minmax.max);
+            break;
+        }
+        break;
+    case MODE_LOOKUP:
+        sbufWriteU8(dst, value->config.lookup.tableIndex);
+        break;
+    case MODE_ARRAY:
+        sbufWriteU8(dst, value->config.array.length);
+        sbufWriteU8(dst, value->config.array.max);
+        break;
+    case MODE_STRING:
+        sbufWriteU8(dst, value->config.string.minlength);
+        sbufWriteU8(dst, value->config.string.maxlength);
+        sbufWriteU8(dst, value->config.string.flags);
+        break;
+    case MODE_BITSET:
+        sbufWriteU8(dst, value->config.bitpos);
+        break;
+    }
+}
+
+// worst case size of a schema record, so records are never split across replies
+#define SETTING_SCHEMA_RECORD_MAX (sizeof(uint16_t) + 2 + UINT8_MAX + 2 * sizeof(uint32_t))
+
+static uint32_t settingsSchemaHash(void)
+{
+    static uint32_t hash;
+
+    if (!hash) {
+        uint8_t buf[SETTING_SCHEMA_RECORD_MAX];
+        hash = FNV_OFFSET_BASIS;
+        for (unsigned i = 0; i < valueTableEntryCount; i++) {
+            sbuf_t sbuf = { .ptr = buf, .end = ARRAYEND(buf) };
+            serializeSettingSchema(&sbuf, &valueTable[i]);
+            hash = fnv_update(hash, buf, sbufPtr(&sbuf) - buf);
+        }
+        for (unsigned i = 0; i < LOOKUP_TABLE_COUNT; i++) {
+            for (unsigned j = 0; j < lookupTables[i].valueCount; j++) {
+                const char *name = lookupTables[i].values[j];
+                hash = name ? fnv_update(hash, name, strlen(name) + 1) : fnv_update(hash, "", 1);
+            }
+        }
+    }
+
+    return hash;
+}
+
+static const uint8_t *settingValuePointer(const clivalue_t *value, const uint8_t *base)
+{
+    return base + settingValueOffset(value);
+}
+
+mspResult_e mspSettingsProcessCommand(int16_t cmdMSP, sbuf_t *src, sbuf_t *dst)
+{
+    const unsigned int dataSize = sbufBytesRemaining(src);
+
+    switch (cmdMSP) {
+    case MSP2_SETTINGS_INFO:
+        sbufWriteU16(dst, valueTableEntryCount);
+        sbufWriteU8(dst, LOOKUP_TABLE_COUNT);
+        sbufWriteU32(dst, settingsSchemaHash());
+        break;
+
+    case MSP2_SETTINGS_SCHEMA:
+        {
+            // U16 first index, reply: U16 next index (SETTING_INDEX_NONE when done), then schema records
+            uint16_t index = (dataSize >= sizeof(uint16_t)) ? sbufReadU16(src) : 0;
+            uint8_t *nextIndexPtr = sbufPtr(dst);
+            sbufWriteU16(dst, SETTING_INDEX_NONE);
+            for (; index < valueTableEntryCount; index++) {
+                if (sbufBytesRemaining(dst) < (int)SETTING_SCHEMA_RECORD_MAX) {
+                    nextIndexPtr[0] = index & 0xff;
+                    nextIndexPtr[1] = index >> 8;
+                    break;
+                }
+                sbufWriteU16(dst, index);
+                serializeSettingSchema(dst, &valueTable[index]);
+            }
+        }
+        break;
+
+    case MSP2_SETTINGS_LOOKUP:
+        {
+            // U8 table, U8 first entry, reply: U8 entry count, U8 first entry, then U8 length + name while they fit
+            if (dataSize < 1) {
+                return MSP_RESULT_ERROR;
+            }
+            const uint8_t table = sbufReadU8(src);
+            uint8_t entry = (dataSize >= 2) ? sbufReadU8(src) : 0;
+            if (table >= LOOKUP_TABLE_COUNT) {
+                return MSP_RESULT_ERROR;
+            }
+            const lookupTableEntry_t *tableEntry = &lookupTables[table];
+            sbufWriteU8(dst, tableEntry->valueCount);
+            sbufWriteU8(dst, entry);
+            for (; entry < tableEntry->valueCount; entry++) {
+                const char *name = tableEntry->values[entry];
+                const uint8_t nameLength = name ? strlen(name) : 0;
+                if (sbufBytesRemaining(dst) < 1 + nameLength) {
+                    break;
+                }
+                sbufWriteU8(dst, nameLength);
+                sbufWriteData(dst, name, nameLength);
+            }
+        }
+        break;
+
+    case MSP2_SETTINGS_GET:
+        {
+            // U16 first index, U16 count, U8 flags, reply: U16 next index (SETTING_INDEX_NONE when done), then value records
+            if (dataSize < 2 * sizeof(uint16_t)) {
+                return MSP_RESULT_ERROR;
+            }
+            uint16_t index = sbufReadU16(src);
+            const uint16_t end = MIN(index + sbufReadU16(src), valueTableEntryCount);
+            const uint8_t flags = sbufBytesRemaining(src) ? sbufReadU8(src) : 0;
+
+            uint8_t *nextIndexPtr = sbufPtr(dst);
+            sbufWriteU16(dst, SETTING_INDEX_NONE);
+            for (; index < end; index++) {
+                const clivalue_t *value = &valueTable[index];
+                const pgRegistry_t *pg = pgFind(value->pgn);
+                if (!pg) {
+                    continue;
+                }
+                const uint8_t *ptr = settingValuePointer(value, pg->address);
+
+                if (flags & SETTINGS_GET_CHANGED_ONLY) {
+                    const uint8_t *defaults = pgDefaults(pg);
+                    if (settingValueEquals(value, ptr, settingValuePointer(value, defaults))) {
+                        continue;
+                    }
+                }
+
+                const uint8_t size = settingValueSize(value, ptr);
+                if (sbufBytesRemaining(dst) < (int)sizeof(uint16_t) + 1 + size) {
+                    nextIndexPtr[0] = index & 0xff;
+                    nextIndexPtr[1] = index >> 8;
+                    break;
+                }
+                sbufWriteU16(dst, index);
+                sbufWriteU8(dst, size);
+                serializeSettingValue(dst, value, ptr);
+            }
+        }
+        break;
+
+    case MSP2_SETTINGS_SET:
+        {
+            // value records, reply: U16 number of values set, U16 index of the first rejected record (SETTING_INDEX_NONE if none)
+            // the frame is applied as a whole, nothing is set if any record is rejected
+            if (ARMING_FLAG(ARMED)) {
+                return MSP_RESULT_ERROR;
+            }
+
+            uint16_t recordCount = 0;
+            uint16_t firstRejected = SETTING_INDEX_NONE;
+            for (sbuf_t records = *src; sbufBytesRemaining(&records); recordCount++) {
+                if (sbufBytesRemaining(&records) < (int)sizeof(uint16_t) + 1) {
+                    return MSP_RESULT_ERROR;
+                }
+                const uint16_t index = sbufReadU16(&records);
+                const uint8_t size = sbufReadU8(&records);
+                if (sbufBytesRemaining(&records) < size) {
+                    return MSP_RESULT_ERROR;
+                }
+                const pgRegistry_t *pg = (index < valueTableEntryCount) ? pgFind(valueTable[index].pgn) : NULL;
+                if (!pg || !settingValueValid(&valueTable[index], settingValuePointer(&valueTable[index], pg->address), sbufPtr(&records), size)) {
+                    firstRejected = index;
+                    break;
+                }
+                sbufAdvance(&records, size);
+            }
+
+            if (firstRejected == SETTING_INDEX_NONE) {
+                bool pidProfileChanged = false;
+                bool rateProfileChanged = false;
+                for (int i = 0; i < recordCount; i++) {
+                    const clivalue_t *value = &valueTable[sbufReadU16(src)];
+                    const uint8_t size = sbufReadU8(src);
+                    deserializeSettingValue(value, CONST_CAST(uint8_t *, settingValuePointer(value, pgFind(value->pgn)->address)), sbufPtr(src), size);
+                    sbufAdvance(src, size);
+
+                    pidProfileChanged |= (value->type & VALUE_SECTION_MASK) == PROFILE_VALUE;
+                    rateProfileChanged |= (value->type & VALUE_SECTION_MASK) == PROFILE_RATE_VALUE;
+                }
+
+                // take the new values into use, as the MSP commands for the same settings do
+                if (pidProfileChanged) {
+                    pidInitConfig(currentPidProfile);
+                }
+                if (rateProfileChanged) {
+                    initRcProcessing();
+                }
+            }
+
+            sbufWriteU16(dst, (firstRejected == SETTING_INDEX_NONE) ? recordCount : 0);
+            sbufWriteU16(dst, firstRejected);
+        }
+        break;
+
+    default:
+        return MSP_RESULT_CMD_UNKNOWN;
+    }
+
+    return MSP_RESULT_ACK;
+}
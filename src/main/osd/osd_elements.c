@@ -51,6 +51,18 @@
     Add the mapping for the element ID to the background drawing function to the
     osdElementBackgroundFunction array.
 
+    Create the function to key the element's value (optional).
+    ----------------------------------------------------------
+    If the rendered text of an element only depends on a few values that can be read
+    cheaply, create a function returning those values packed into an osdElementKey_t.
+    It should be named like "osdKeySomething()". While the key is unchanged the element
+    is written from its cached text instead of being formatted again. Everything that
+    affects the text or attribute must be part of the key, and the draw function must
+    not have side effects (filters, blink bits, multi-pass rendering).
+
+    Add the mapping for the element ID to the key function to the
+    osdElementKeyFunction array.
+
     Accelerometer reqirement:
     -------------------------
     If the new element utilizes the accelerometer, add it to the osdElementsNeedAccelerometer() function.
@@ -226,6 +238,7 @@ static const char compassBar[] = {
 
 static unsigned activeOsdElementCount = 0;
 static uint8_t activeOsdElementArray[OSD_ITEM_COUNT];
+static uint8_t activeOsdElementCacheSlot[OSD_ITEM_COUNT];
 static bool backgroundLayerSupported = false;
 
 // Blink control
@@ -237,6 +250,23 @@ static uint32_t blinkBits[(OSD_ITEM_COUNT + 31) / 32];
 #define IS_BLINK(item) (blinkBits[(item) / 32] & (1 << ((item) % 32)))
 #define BLINK(item) (IS_BLINK(item) && blinkState)
 
+// Rendered text of keyed elements, reused while their key is unchanged
+#define OSD_ELEMENT_CACHE_COUNT 24
+#define OSD_ELEMENT_CACHE_LENGTH 16
+#define OSD_ELEMENT_CACHE_NONE 0xff
+
+#define OSD_KEY(value, state) (((osdElementKey_t)(uint32_t)(state) << 32) | (uint32_t)(value))
+
+typedef struct osdElementCache_s {
+    osdElementKey_t key;
+    bool valid;
+    uint8_t attr;
+    char buff[OSD_ELEMENT_CACHE_LENGTH];
+} osdElementCache_t;
+
+static osdElementCache_t osdElementCache[OSD_ELEMENT_CACHE_COUNT];
+static unsigned osdElementCacheCount = 0;
+
 // Return whether element is a SYS element and needs special handling
 #define IS_SYS_OSD_ELEMENT(item) (item >= OSD_SYS_GOGGLE_VOLTAGE) && (item <= OSD_SYS_FAN_SPEED)
 
@@ -1780,6 +1810,209 @@ static void osdElementSys(osdElementParms_t *element)
 }
 #endif
 
+// ****************************
+// Element value key functions
+// ****************************
+
+static osdElementKey_t osdKeyAltitude(const osdElementParms_t *element)
+{
+    bool haveMeasure = false;
+#ifdef USE_BARO
+    haveMeasure |= sensors(SENSOR_BARO);
+#endif
+#ifdef USE_GPS
+    haveMeasure |= sensors(SENSOR_GPS) && STATE(GPS_FIX);
+#endif
+    int32_t alt = getEstimatedAltitudeCm();
+#ifdef USE_GPS
+    if (element->type == OSD_ELEMENT_TYPE_3 || element->type == OSD_ELEMENT_TYPE_4) {
+        alt = getAltitudeAsl();
+    }
+#endif
+    const bool alarm = (osdGetMetersToSelectedUnit(getEstimatedAltitudeCm()) / 100 >= osdConfig()->alt_alarm) && ARMING_FLAG(ARMED);
+
+    return OSD_KEY(alt, haveMeasure | alarm << 1 | element->type << 2 | osdConfig()->units << 4);
+}
+
+#ifdef USE_ACC
+static osdElementKey_t osdKeyAngleRollPitch(const osdElementParms_t *element)
+{
+    return OSD_KEY((element->item == OSD_PITCH_ANGLE) ? attitude.values.pitch : attitude.values.roll, 0);
+}
+#endif
+
+static osdElementKey_t osdKeyAverageCellVoltage(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    const int cellV = getBatteryAverageCellVoltage();
+
+    return OSD_KEY(cellV, getBatteryState() | osdGetBatterySymbol(cellV) << 8);
+}
+
+#ifdef USE_ADC_INTERNAL
+static osdElementKey_t osdKeyCoreTemperature(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(getCoreTemperatureCelsius(), osdConfig()->units);
+}
+#endif
+
+static osdElementKey_t osdKeyCurrentDraw(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(getAmperage(), 0);
+}
+
+#ifdef USE_GPS
+static osdElementKey_t osdKeyGpsFlightDistance(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(GPS_distanceFlownInCm / 100, (STATE(GPS_FIX) && STATE(GPS_FIX_HOME)) | osdConfig()->units << 1);
+}
+
+static osdElementKey_t osdKeyGpsHomeDistance(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    int distance = GPS_distanceToHome;
+#ifdef USE_GPS_LAP_TIMER
+    if (gpsLapTimerData.timerRunning) {
+        distance = lrintf(gpsLapTimerData.distToPointCM * 0.01f);
+    }
+#endif
+
+    return OSD_KEY(distance, (STATE(GPS_FIX) && STATE(GPS_FIX_HOME)) | osdConfig()->units << 1);
+}
+
+static osdElementKey_t osdKeyGpsSats(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    bool rescueWarning = false;
+#ifdef USE_GPS_RESCUE
+    rescueWarning = (gpsSol.numSat < gpsRescueConfig()->minSats) && gpsRescueIsConfigured();
+#endif
+    const bool showPdop = osdConfig()->gps_sats_show_pdop;
+    const uint16_t pdop = showPdop ? gpsSol.dop.pdop : 0;
+
+    return OSD_KEY(gpsSol.numSat | pdop << 8, (STATE(GPS_FIX) != 0) | gpsIsHealthy() << 1 | rescueWarning << 2 | showPdop << 3);
+}
+
+static osdElementKey_t osdKeyGpsSpeed(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    const bool use3dSpeed = gpsConfig()->gps_use_3d_speed;
+
+    return OSD_KEY(use3dSpeed ? gpsSol.speed3d : gpsSol.groundSpeed, (STATE(GPS_FIX) != 0) | use3dSpeed << 1 | osdConfig()->units << 2);
+}
+#endif // USE_GPS
+
+#ifdef USE_RX_LINK_QUALITY_INFO
+static osdElementKey_t osdKeyLinkQuality(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    const bool alarm = rxGetLinkQualityPercent() < osdConfig()->link_quality_alarm;
+
+    return OSD_KEY(rxGetLinkQuality(), rxGetRfMode() | linkQualitySource << 8 | alarm << 16);
+}
+#endif
+
+static osdElementKey_t osdKeyMahDrawn(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    const int mAhDrawn = getMAhDrawn();
+
+    return OSD_KEY(mAhDrawn, mAhDrawn >= osdConfig()->cap_alarm);
+}
+
+static osdElementKey_t osdKeyMainBatteryVoltage(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(getBatteryVoltage(), getBatteryState() | osdGetBatterySymbol(getBatteryAverageCellVoltage()) << 8);
+}
+
+static osdElementKey_t osdKeyNumericalHeading(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(DECIDEGREES_TO_DEGREES(attitude.values.yaw), 0);
+}
+
+#ifdef USE_VARIO
+static osdElementKey_t osdKeyNumericalVario(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    bool haveMeasure = false;
+#ifdef USE_BARO
+    haveMeasure |= sensors(SENSOR_BARO);
+#endif
+#ifdef USE_GPS
+    haveMeasure |= sensors(SENSOR_GPS) && STATE(GPS_FIX);
+#endif
+
+    return OSD_KEY(getEstimatedVario(), haveMeasure | osdConfig()->units << 1);
+}
+#endif
+
+static osdElementKey_t osdKeyPidRateProfile(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(getCurrentPidProfileIndex() | getCurrentControlRateProfileIndex() << 8, 0);
+}
+
+static osdElementKey_t osdKeyPower(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(getAmperage() * getBatteryVoltage() / 10000, 0);
+}
+
+static osdElementKey_t osdKeyRssi(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(getRssi(), getRssiPercent() < osdConfig()->rssi_alarm);
+}
+
+static osdElementKey_t osdKeyThrottlePosition(const osdElementParms_t *element)
+{
+    UNUSED(element);
+
+    return OSD_KEY(calculateThrottlePercent(), 0);
+}
+
+static osdElementKey_t osdKeyTimer(const osdElementParms_t *element)
+{
+    static const uint32_t precisionUs[OSD_TIMER_PREC_COUNT] = {
+        [OSD_TIMER_PREC_SECOND] = 1000000,
+        [OSD_TIMER_PREC_HUNDREDTHS] = 10000,
+        [OSD_TIMER_PREC_TENTHS] = 100000,
+    };
+
+    // osdElementTimer() flags the element if any timer is in alarm
+    bool alarm = false;
+    for (int i = 0; i < OSD_TIMER_COUNT; i++) {
+        const uint16_t timer = osdConfig()->timers[i];
+        const timeUs_t alarmTime = OSD_TIMER_ALARM(timer) * 60000000;
+        alarm |= alarmTime != 0 && osdGetTimerValue(OSD_TIMER_SRC(timer)) >= alarmTime;
+    }
+
+    const uint16_t timer = osdConfig()->timers[element->item - OSD_ITEM_TIMER_1];
+    const unsigned precision = OSD_TIMER_PRECISION(timer) < OSD_TIMER_PREC_COUNT ? OSD_TIMER_PRECISION(timer) : OSD_TIMER_PREC_SECOND;
+
+    return OSD_KEY(osdGetTimerValue(OSD_TIMER_SRC(timer)) / precisionUs[precision], alarm | timer << 1);
+}
+
 // Define the order in which the elements are drawn.
 // Elements positioned later in the list will overlay the earlier
 // ones if their character positions overlap
@@ -2024,6 +2257,43 @@ const osdElementDrawFn osdElementDrawFunction[OSD_ITEM_COUNT] = {
 #endif
 };
 
+// Define the mapping between the OSD element id and the function to key its value
+// Elements without a key function are formatted on every refresh
+
+static const osdElementKeyFn osdElementKeyFunction[OSD_ITEM_COUNT] = {
+    [OSD_RSSI_VALUE]              = osdKeyRssi,
+    [OSD_MAIN_BATT_VOLTAGE]       = osdKeyMainBatteryVoltage,
+    [OSD_ITEM_TIMER_1]            = osdKeyTimer,
+    [OSD_ITEM_TIMER_2]            = osdKeyTimer,
+    [OSD_THROTTLE_POS]            = osdKeyThrottlePosition,
+    [OSD_CURRENT_DRAW]            = osdKeyCurrentDraw,
+    [OSD_MAH_DRAWN]               = osdKeyMahDrawn,
+    [OSD_ALTITUDE]                = osdKeyAltitude,
+    [OSD_POWER]                   = osdKeyPower,
+    [OSD_PIDRATE_PROFILE]         = osdKeyPidRateProfile,
+    [OSD_AVG_CELL_VOLTAGE]        = osdKeyAverageCellVoltage,
+    [OSD_NUMERICAL_HEADING]       = osdKeyNumericalHeading,
+#ifdef USE_ACC
+    [OSD_PITCH_ANGLE]             = osdKeyAngleRollPitch,
+    [OSD_ROLL_ANGLE]              = osdKeyAngleRollPitch,
+#endif
+#ifdef USE_VARIO
+    [OSD_NUMERICAL_VARIO]         = osdKeyNumericalVario,
+#endif
+#ifdef USE_ADC_INTERNAL
+    [OSD_CORE_TEMPERATURE]        = osdKeyCoreTemperature,
+#endif
+#ifdef USE_GPS
+    [OSD_GPS_SATS]                = osdKeyGpsSats,
+    [OSD_GPS_SPEED]               = osdKeyGpsSpeed,
+    [OSD_HOME_DIST]               = osdKeyGpsHomeDistance,
+    [OSD_FLIGHT_DIST]             = osdKeyGpsFlightDistance,
+#endif
+#ifdef USE_RX_LINK_QUALITY_INFO
+    [OSD_LINK_QUALITY]            = osdKeyLinkQuality,
+#endif
+};
+
 // Define the mapping between the OSD element id and the function to draw its background (static part)
 // Only necessary to define the entries that actually have a background function
 
@@ -2041,6 +2311,12 @@ const osdElementDrawFn osdElementBackgroundFunction[OSD_ITEM_COUNT] = {
 static void osdAddActiveElement(osd_items_e element)
 {
     if (VISIBLE(osdElementConfig()->item_pos[element])) {
+        uint8_t cacheSlot = OSD_ELEMENT_CACHE_NONE;
+        if (osdElementKeyFunction[element] && osdElementCacheCount < OSD_ELEMENT_CACHE_COUNT) {
+            cacheSlot = osdElementCacheCount++;
+            osdElementCache[cacheSlot].valid = false;
+        }
+        activeOsdElementCacheSlot[activeOsdElementCount] = cacheSlot;
         activeOsdElementArray[activeOsdElementCount++] = element;
     }
 }
@@ -2050,7 +2326,9 @@ static void osdAddActiveElement(osd_items_e element)
 
 void osdAddActiveElements(void)
 {
+    // Element configuration may have changed, so drop all cached text
     activeOsdElementCount = 0;
+    osdElementCacheCount = 0;
 
 #ifdef USE_ACC
     if (sensors(SENSOR_ACC)) {
@@ -2098,7 +2376,7 @@ void osdAddActiveElements(void)
 #endif
 }
 
-static bool osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
+static bool osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item, osdElementCache_t *cache)
 {
     if (!osdElementDrawFunction[item]) {
         // Element has no drawing function
@@ -2126,6 +2404,24 @@ static bool osdDrawSingleElement(displayPort_t *osdDisplayPort, uint8_t item)
     // Call the element drawing function
     if (IS_SYS_OSD_ELEMENT(item)) {
         displaySys(osdDisplayPort, elemPosX, elemPosY, (displayPortSystemElement_e)(item - OSD_SYS_GOGGLE_VOLTAGE + DISPLAYPORT_SYS_GOGGLE_VOLTAGE));
+    } else if (cache) {
+        // Only format the element if the values it shows have changed
+        const osdElementKey_t key = osdElementKeyFunction[item](&element);
+        if (!cache->valid || cache->key != key) {
+            osdElementDrawFunction[item](&element);
+            const size_t length = strlen(buff);
+            cache->valid = element.drawElement && element.rendered && length < OSD_ELEMENT_CACHE_LENGTH;
+            if (cache->valid) {
+                cache->key = key;
+                cache->attr = element.attr;
+                memcpy(cache->buff, buff, length + 1);
+            } else if (element.drawElement) {
+                osdDisplayWrite(&element, elemPosX, elemPosY, element.attr, buff);
+            }
+        }
+        if (cache->valid) {
+            osdDisplayWrite(&element, elemPosX, elemPosY, cache->attr, cache->buff);
+        }
     } else {
         osdElementDrawFunction[item](&element);
         if (element.drawElement) {
@@ -2197,8 +2493,11 @@ bool osdDrawNextActiveElement(displayPort_t *osdDisplayPort, timeUs_t currentTim
         return retval;
     }
 
+    const uint8_t cacheSlot = activeOsdElementCacheSlot[activeElement];
+    osdElementCache_t *cache = (cacheSlot != OSD_ELEMENT_CACHE_NONE) ? &osdElementCache[cacheSlot] : NULL;
+
     // Only advance to the next element if rendering is complete
-    if (osdDrawSingleElement(osdDisplayPort, activeOsdElementArray[activeElement])) {
+    if (osdDrawSingleElement(osdDisplayPort, activeOsdElementArray[activeElement], cache)) {
         // Prepare to render the background of the next element
         backgroundRendered = false;
         if (++activeElement >= activeOsdElementCount) {
@@ -2316,6 +2615,7 @@ void osdElementsInit(bool backgroundLayerFlag)
 {
     backgroundLayerSupported = backgroundLayerFlag;
     activeOsdElementCount = 0;
+    osdElementCacheCount = 0;
     pt1FilterInit(&batteryEfficiencyFilt, pt1FilterGain(EFFICIENCY_CUTOFF_HZ, 1.0f / osdConfig()->framerate_hz));
 }
 
@@ -45,6 +45,11 @@ typedef struct osdElementParms_s {
 
 typedef void (*osdElementDrawFn)(osdElementParms_t *element);
 
+// Packed source values an element's rendered text depends on
+typedef uint64_t osdElementKey_t;
+
+typedef osdElementKey_t (*osdElementKeyFn)(const osdElementParms_t *element);
+
 int osdConvertTemperatureToSelectedUnit(int tempInDegreesCelcius);
 void osdFormatDistanceString(char *result, int distance, char leadingSymbol);
 bool osdFormatRtcDateTime(char *buffer);
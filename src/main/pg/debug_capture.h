@@ -0,0 +1,33 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include "pg/pg.h"
+
+#define DEBUG_CAPTURE_SLOT_COUNT 4
+
+typedef struct debugCaptureConfig_s {
+    uint8_t mode[DEBUG_CAPTURE_SLOT_COUNT];     // debug mode captured by each slot, DEBUG_NONE when unused
+    uint8_t divider[DEBUG_CAPTURE_SLOT_COUNT];  // record the slot every n PID loops
+} debugCaptureConfig_t;
+
+PG_DECLARE(debugCaptureConfig_t, debugCaptureConfig);
@@ -0,0 +1,36 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include "pg/pg.h"
+#include "pg/gyrodev.h"
+
+// Sensors found by the last full probe, verified first on the following boots. Zero when none was found.
+typedef struct detectedHardwareConfig_s {
+    uint8_t gyroSensor[MAX_GYRODEV_COUNT];      // mpuSensor_e
+    uint8_t gyroDetectIndex[MAX_GYRODEV_COUNT]; // entry of the SPI gyro detection table which found it
+    uint8_t baroHardware;                       // baroSensor_e
+    uint8_t magHardware;                        // magSensor_e
+} detectedHardwareConfig_t;
+
+PG_DECLARE(detectedHardwareConfig_t, detectedHardwareConfig);
@@ -73,6 +73,122 @@ bool pgResetCopy(void *copy, pgn_t pgn)
     return false;
 }
 
+// Reset values are only needed for comparison by the CLI and MSP, so rather than keeping a shadow
+// copy of every PG they are generated on demand into a small arena that is recycled when full.
+// PG_REGISTER refuses to build a PG that would not fit the arena.
+#define PG_DEFAULTS_SLOT_COUNT 16
+
+typedef struct pgDefaultsSlot_s {
+    pgn_t pgn;
+    uint16_t offset;
+} pgDefaultsSlot_t;
+
+static uint32_t pgDefaultsArena[PG_DEFAULTS_ARENA_SIZE / sizeof(uint32_t)];
+static pgDefaultsSlot_t pgDefaultsSlots[PG_DEFAULTS_SLOT_COUNT];
+static uint8_t pgDefaultsSlotCount;
+static uint16_t pgDefaultsArenaUsed;
+
+#ifdef USE_TARGET_CONFIG
+// Runs of bytes in which the target configuration differs from the reset values, each a header followed by the bytes.
+typedef struct pgDefaultsOverride_s {
+    pgn_t pgn;
+    uint16_t offset;
+    uint16_t length;
+} pgDefaultsOverride_t;
+
+static uint8_t pgDefaultsOverrides[PG_DEFAULTS_OVERRIDES_SIZE];
+static uint16_t pgDefaultsOverridesSize;
+
+static void pgDefaultsApplyOverrides(const pgRegistry_t *reg, uint8_t *base)
+{
+    for (unsigned i = 0; i < pgDefaultsOverridesSize; ) {
+        pgDefaultsOverride_t override;
+        memcpy(&override, &pgDefaultsOverrides[i], sizeof(override));
+        i += sizeof(override);
+        if (override.pgn == pgN(reg)) {
+            memcpy(base + override.offset, &pgDefaultsOverrides[i], override.length);
+        }
+        i += override.length;
+    }
+}
+
+// Records how the live config differs from the reset values, pgDefaults() then includes those differences.
+// Call once with targetConfiguration() applied to the reset values, before the config is loaded.
+// Returns false if the differences don't fit PG_DEFAULTS_OVERRIDES_SIZE, only the ones that did are recorded.
+bool pgDefaultsCaptureOverrides(void)
+{
+    uint8_t *resetValues = (uint8_t *)pgDefaultsArena;
+
+    pgDefaultsRelease();
+    pgDefaultsOverridesSize = 0;
+
+    PG_FOREACH(reg) {
+        const uint8_t *values = reg->address;
+        const uint16_t size = pgSize(reg);
+        pgResetInstance(reg, resetValues);
+
+        for (unsigned offset = 0; offset < size; offset++) {
+            if (values[offset] == resetValues[offset]) {
+                continue;
+            }
+            unsigned end = offset + 1;
+            while (end < size && values[end] != resetValues[end]) {
+                end++;
+            }
+
+            const pgDefaultsOverride_t override = { .pgn = pgN(reg), .offset = offset, .length = end - offset };
+            if (pgDefaultsOverridesSize + sizeof(override) + override.length > sizeof(pgDefaultsOverrides)) {
+                return false;
+            }
+            memcpy(&pgDefaultsOverrides[pgDefaultsOverridesSize], &override, sizeof(override));
+            pgDefaultsOverridesSize += sizeof(override);
+            memcpy(&pgDefaultsOverrides[pgDefaultsOverridesSize], values + offset, override.length);
+            pgDefaultsOverridesSize += override.length;
+
+            offset = end;
+        }
+    }
+
+    return true;
+}
+#endif
+
+// Returns the reset values of reg, including the changes made by the target configuration.
+// The result stays valid until defaults are requested for PGs that no longer fit, or pgDefaultsRelease().
+const void *pgDefaults(const pgRegistry_t *reg)
+{
+    uint8_t *arena = (uint8_t *)pgDefaultsArena;
+
+    for (unsigned i = 0; i < pgDefaultsSlotCount; i++) {
+        if (pgDefaultsSlots[i].pgn == pgN(reg)) {
+            return arena + pgDefaultsSlots[i].offset;
+        }
+    }
+
+    const uint16_t size = (pgSize(reg) + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+    if (pgDefaultsArenaUsed + size > sizeof(pgDefaultsArena) || pgDefaultsSlotCount == PG_DEFAULTS_SLOT_COUNT) {
+        pgDefaultsRelease();
+    }
+
+    pgDefaultsSlot_t *slot = &pgDefaultsSlots[pgDefaultsSlotCount++];
+    slot->pgn = pgN(reg);
+    slot->offset = pgDefaultsArenaUsed;
+    pgDefaultsArenaUsed += size;
+
+    pgResetInstance(reg, arena + slot->offset);
+#ifdef USE_TARGET_CONFIG
+    pgDefaultsApplyOverrides(reg, arena + slot->offset);
+#endif
+
+    return arena + slot->offset;
+}
+
+void pgDefaultsRelease(void)
+{
+    pgDefaultsSlotCount = 0;
+    pgDefaultsArenaUsed = 0;
+}
+
 bool pgLoad(const pgRegistry_t* reg, const void *from, int size, int version)
 {
     pgResetInstance(reg, pgOffset(reg));
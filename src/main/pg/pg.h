@@ -25,6 +25,8 @@
 
 #include "build/build_config.h"
 
+#include "common/utils.h"
+
 typedef uint16_t pgn_t;
 
 // parameter group registry flags
@@ -48,7 +50,6 @@ typedef struct pgRegistry_s {
     uint8_t length;        // The number of elements in the group
     uint16_t size;         // Size of the group in RAM, the top 4 bits are reserved for flags
     uint8_t *address;      // Address of the group in RAM.
-    uint8_t *copy;         // Address of the copy in RAM.
     uint8_t **ptr;         // The pointer to update after loading the record into ram.
     union {
         void *ptr;         // Pointer to init template
@@ -84,6 +85,18 @@ extern const uint8_t __pg_resetdata_end[];
 
 #define PG_REGISTRY_SIZE (__pg_registry_end - __pg_registry_start)
 
+// Reset values are generated on demand into an arena of this size, see pgDefaults(), every PG has to fit it.
+#ifndef PG_DEFAULTS_ARENA_SIZE
+#define PG_DEFAULTS_ARENA_SIZE 2048
+#endif
+#ifdef USE_TARGET_CONFIG
+// Changes targetConfiguration() makes to the reset values are kept in this many bytes, see pgDefaultsCaptureOverrides().
+#ifndef PG_DEFAULTS_OVERRIDES_SIZE
+#define PG_DEFAULTS_OVERRIDES_SIZE 256
+#endif
+#endif
+#define PG_DEFAULTS_FITS_ARENA(_size) ((((_size) + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1)) <= PG_DEFAULTS_ARENA_SIZE)
+
 // Helper to iterate over the PG register.  Cheaper than a visitor style callback.
 #define PG_FOREACH(_name) \
     for (const pgRegistry_t *(_name) = __pg_registry_start; (_name) < __pg_registry_end; _name++)
@@ -99,7 +112,6 @@ extern const uint8_t __pg_resetdata_end[];
 // Declare system config
 #define PG_DECLARE(_type, _name)                                        \
     extern _type _name ## _System;                                      \
-    extern _type _name ## _Copy;                                        \
     static inline const _type* _name(void) { return &_name ## _System; }\
     static inline _type* _name ## Mutable(void) { return &_name ## _System; }\
     struct _dummy                                                       \
@@ -108,7 +120,6 @@ extern const uint8_t __pg_resetdata_end[];
 // Declare system config array
 #define PG_DECLARE_ARRAY(_type, _length, _name)                         \
     extern _type _name ## _SystemArray[_length];                        \
-    extern _type _name ## _CopyArray[_length];                          \
     static inline const _type* _name(int _index) { return &_name ## _SystemArray[_index]; } \
     static inline _type* _name ## Mutable(int _index) { return &_name ## _SystemArray[_index]; } \
     static inline _type (* _name ## _array(void))[_length] { return &_name ## _SystemArray; } \
@@ -117,8 +128,8 @@ extern const uint8_t __pg_resetdata_end[];
 
 // Register system config
 #define PG_REGISTER_I(_type, _name, _pgn, _version, _reset)             \
+    STATIC_ASSERT(PG_DEFAULTS_FITS_ARENA(sizeof(_type)), _name ## _too_large_for_defaults_arena); \
     _type _name ## _System;                                             \
-    _type _name ## _Copy;                                               \
     uint32_t _name ## _fnv_hash;                                        \
     /* Force external linkage for g++. Catch multi registration */      \
     extern const pgRegistry_t _name ## _Registry;                       \
@@ -127,7 +138,6 @@ extern const uint8_t __pg_resetdata_end[];
         .length = 1,                                                    \
         .size = sizeof(_type) | PGR_SIZE_SYSTEM_FLAG,                   \
         .address = (uint8_t*)&_name ## _System,                         \
-        .copy = (uint8_t*)&_name ## _Copy,                              \
         .ptr = 0,                                                       \
         _reset,                                                         \
         .fnv_hash = &_name ## _fnv_hash,                                \
@@ -150,8 +160,8 @@ extern const uint8_t __pg_resetdata_end[];
 
 // Register system config array
 #define PG_REGISTER_ARRAY_I(_type, _length, _name, _pgn, _version, _reset)  \
+    STATIC_ASSERT(PG_DEFAULTS_FITS_ARENA(sizeof(_type) * _length), _name ## _too_large_for_defaults_arena); \
     _type _name ## _SystemArray[_length];                               \
-    _type _name ## _CopyArray[_length];                                 \
     uint32_t _name ## _fnv_hash;                                        \
     extern const pgRegistry_t _name ##_Registry;                        \
     const pgRegistry_t _name ## _Registry PG_REGISTER_ATTRIBUTES = {    \
@@ -159,7 +169,6 @@ extern const uint8_t __pg_resetdata_end[];
         .length = _length,                                              \
         .size = (sizeof(_type) * _length) | PGR_SIZE_SYSTEM_FLAG,       \
         .address = (uint8_t*)&_name ## _SystemArray,                    \
-        .copy = (uint8_t*)&_name ## _CopyArray,                         \
         .ptr = 0,                                                       \
         _reset,                                                         \
         .fnv_hash = &_name ## _fnv_hash,                                \
@@ -203,4 +212,9 @@ int pgStore(const pgRegistry_t* reg, void *to, int size);
 void pgResetAll(void);
 void pgResetInstance(const pgRegistry_t *reg, uint8_t *base);
 bool pgResetCopy(void *copy, pgn_t pgn);
+const void *pgDefaults(const pgRegistry_t *reg);
+void pgDefaultsRelease(void);
+#ifdef USE_TARGET_CONFIG
+bool pgDefaultsCaptureOverrides(void);
+#endif
 void pgReset(const pgRegistry_t* reg);
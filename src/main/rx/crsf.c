@@ -345,15 +345,12 @@ STATIC_UNIT_TESTED uint8_t crsfFrameCmdCRC(void)
 #endif
 
 // Receive ISR callback, called back from serial port
-STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
+static void crsfReceiveByte(uint8_t c, timeUs_t currentTimeUs, rxRuntimeState_t *rxRuntimeState)
 {
-    rxRuntimeState_t *const rxRuntimeState = (rxRuntimeState_t *const)data;
-
     static uint8_t crsfFramePosition = 0;
 #if defined(USE_CRSF_V3)
     static uint8_t crsfFrameErrorCnt = 0;
 #endif
-    const timeUs_t currentTimeUs = microsISR();
 
 #ifdef DEBUG_CRSF_PACKETS
     debug[2] = currentTimeUs - crsfFrameStartAtUs;
@@ -380,7 +377,7 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     const int fullFrameLength = crsfFramePosition < 3 ? 5 : MIN(crsfFrame.frame.frameLength + CRSF_FRAME_LENGTH_ADDRESS + CRSF_FRAME_LENGTH_FRAMELENGTH, CRSF_FRAME_SIZE_MAX);
 
     if (crsfFramePosition < fullFrameLength) {
-        crsfFrame.bytes[crsfFramePosition++] = (uint8_t)c;
+        crsfFrame.bytes[crsfFramePosition++] = c;
         if (crsfFramePosition >= fullFrameLength) {
             crsfFramePosition = 0;
             const uint8_t crc = crsfFrameCRC();
@@ -479,6 +476,21 @@ STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
     }
 }
 
+STATIC_UNIT_TESTED void crsfDataReceive(uint16_t c, void *data)
+{
+    crsfReceiveByte(c, microsISR(), data);
+}
+
+// A span is delivered on idle line, so the bytes in it can share a timestamp
+STATIC_UNIT_TESTED void crsfDataReceiveFrame(const uint8_t *buf, size_t len, void *data)
+{
+    const timeUs_t currentTimeUs = microsISR();
+
+    for (size_t i = 0; i < len; i++) {
+        crsfReceiveByte(buf[i], currentTimeUs, data);
+    }
+}
+
 STATIC_UNIT_TESTED uint8_t crsfFrameStatus(rxRuntimeState_t *rxRuntimeState)
 {
     UNUSED(rxRuntimeState);
@@ -652,6 +664,11 @@ bool crsfRxInit(const rxConfig_t *rxConfig, rxRuntimeState_t *rxRuntimeState)
         CRSF_PORT_OPTIONS | (rxConfig->serialrx_inverted ? SERIAL_INVERTED : 0)
         );
 
+    if (serialPort) {
+        // keeps crsfDataReceive() if the port buffer cannot hold two frames
+        serialSetRxFrameCallback(serialPort, crsfDataReceiveFrame, CRSF_FRAME_SIZE_MAX);
+    }
+
     if (rssiSource == RSSI_SOURCE_NONE) {
         rssiSource = RSSI_SOURCE_RX_PROTOCOL_CRSF;
     }
@@ -41,6 +41,7 @@
 #include "drivers/rx/rx_pwm.h"
 #include "drivers/time.h"
 
+#include "fc/latency.h"
 #include "fc/rc_controls.h"
 #include "fc/rc_modes.h"
 #include "fc/runtime_config.h"
@@ -552,6 +553,9 @@ FAST_CODE_NOINLINE void rxFrameCheck(timeUs_t currentTimeUs, timeDelta_t current
         //  true only when a new packet arrives
         needRxSignalBefore = currentTimeUs + needRxSignalMaxDelayUs;
         rxSignalReceived = true; // immediately process packet data
+#ifdef USE_LATENCY_STATS
+        latencyRxFrame(rxRuntimeState.rcFrameTimeUsFn ? rxRuntimeState.rcFrameTimeUsFn() : currentTimeUs);
+#endif
         if (useDataDrivenProcessing) {
             rxDataProcessingRequired = true;
             //  process the new Rx packet when it arrives
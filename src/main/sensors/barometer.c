@@ -31,6 +31,7 @@
 #include "common/maths.h"
 #include "common/filter.h"
 
+#include "pg/detected_hardware.h"
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
 
@@ -185,47 +186,26 @@ void baroPreInit(void)
 #endif
 }
 
-static bool baroDetect(baroDev_t *baroDev, baroSensor_e baroHardwareToUse)
+// Order in which sensors are probed
+static const baroSensor_e baroProbeOrder[] = {
+    BARO_BMP085,
+    BARO_MS5611,
+    BARO_LPS,
+    BARO_DPS310,
+    BARO_BMP388,
+    BARO_BMP280,
+    BARO_QMP6988,
+    BARO_2SMPB_02B,
+    BARO_LPS22DF,
+    BARO_VIRTUAL,
+};
+
+// Probe for a single type of sensor
+static bool baroDetectHardware(baroDev_t *baroDev, baroSensor_e baroHardware)
 {
-    extDevice_t *dev = &baroDev->dev;
-
-    // Detect what pressure sensors are available. baro->update() is set to sensor-specific update function
-
-    baroSensor_e baroHardware = baroHardwareToUse;
-
-#if !defined(USE_BARO_BMP085) && !defined(USE_BARO_MS5611) && !defined(USE_BARO_SPI_MS5611) && !defined(USE_BARO_BMP388) && !defined(USE_BARO_BMP280) && !defined(USE_BARO_SPI_BMP280)&& !defined(USE_BARO_QMP6988) && !defined(USE_BARO_SPI_QMP6988) && !defined(USE_BARO_DPS310) && !defined(USE_BARO_SPI_DPS310) && !defined(DEFAULT_BARO_SPI_2SMBP_02B) && !defined(DEFAULT_BARO_2SMBP_02B)
-    UNUSED(dev);
-#endif
-
-#ifndef USE_VIRTUAL_BARO
-    switch (barometerConfig()->baro_busType) {
-#ifdef USE_I2C
-    case BUS_TYPE_I2C:
-        i2cBusSetInstance(dev, barometerConfig()->baro_i2c_device);
-        dev->busType_u.i2c.address = barometerConfig()->baro_i2c_address;
-        break;
-#endif
-
-#ifdef USE_SPI
-    case BUS_TYPE_SPI:
-        {
-            if (!spiSetBusInstance(dev, barometerConfig()->baro_spi_device)) {
-                return false;
-            }
-
-            dev->busType_u.spi.csnPin = IOGetByTag(barometerConfig()->baro_spi_csn);
-        }
-        break;
-#endif
-    default:
-        return false;
-    }
-#endif // USE_VIRTUAL_BARO
+    UNUSED(baroDev);
 
     switch (baroHardware) {
-    case BARO_DEFAULT:
-        FALLTHROUGH;
-
     case BARO_BMP085:
 #ifdef USE_BARO_BMP085
         {
@@ -233,42 +213,28 @@ static bool baroDetect(baroDev_t *baroDev, baroSensor_e baroHardwareToUse)
                 .xclrTag = barometerConfig()->baro_xclr_tag,
                 .eocTag = barometerConfig()->baro_eoc_tag
             };
-            if (bmp085Detect(&defaultBMP085Config, baroDev)) {
-                baroHardware = BARO_BMP085;
-                break;
-            }
+            return bmp085Detect(&defaultBMP085Config, baroDev);
         }
 #endif
-        FALLTHROUGH;
+        break;
 
     case BARO_MS5611:
 #if defined(USE_BARO_MS5611) || defined(USE_BARO_SPI_MS5611)
-        if (ms5611Detect(baroDev)) {
-            baroHardware = BARO_MS5611;
-            break;
-        }
+        return ms5611Detect(baroDev);
 #endif
-        FALLTHROUGH;
+        break;
 
     case BARO_LPS:
 #if defined(USE_BARO_SPI_LPS)
-        if (lpsDetect(baroDev)) {
-            baroHardware = BARO_LPS;
-            break;
-        }
+        return lpsDetect(baroDev);
 #endif
-        FALLTHROUGH;
+        break;
 
     case BARO_DPS310:
 #if defined(USE_BARO_DPS310) || defined(USE_BARO_SPI_DPS310)
-        {
-            if (baroDPS310Detect(baroDev)) {
-                baroHardware = BARO_DPS310;
-                break;
-            }
-        }
+        return baroDPS310Detect(baroDev);
 #endif
-        FALLTHROUGH;
+        break;
 
     case BARO_BMP388:
 #if defined(USE_BARO_BMP388) || defined(USE_BARO_SPI_BMP388)
@@ -276,62 +242,99 @@ static bool baroDetect(baroDev_t *baroDev, baroSensor_e baroHardwareToUse)
             const bmp388Config_t defaultBMP388Config = {
                 .eocTag = barometerConfig()->baro_eoc_tag,
             };
-            if (bmp388Detect(&defaultBMP388Config, baroDev)) {
-                baroHardware = BARO_BMP388;
-                break;
-            }
+            return bmp388Detect(&defaultBMP388Config, baroDev);
         }
 #endif
-        FALLTHROUGH;
+        break;
 
     case BARO_BMP280:
 #if defined(USE_BARO_BMP280) || defined(USE_BARO_SPI_BMP280)
-        if (bmp280Detect(baroDev)) {
-            baroHardware = BARO_BMP280;
-            break;
-        }
+        return bmp280Detect(baroDev);
 #endif
-        FALLTHROUGH;
+        break;
 
-     case BARO_QMP6988:
+    case BARO_QMP6988:
 #if defined(USE_BARO_QMP6988) || defined(USE_BARO_SPI_QMP6988)
-        if (qmp6988Detect(baroDev)) {
-            baroHardware = BARO_QMP6988;
-            break;
-        }
+        return qmp6988Detect(baroDev);
 #endif
-        FALLTHROUGH;
+        break;
 
-     case BARO_2SMPB_02B:
+    case BARO_2SMPB_02B:
 #if defined(USE_BARO_2SMBP_02B) || defined(USE_BARO_SPI_2SMBP_02B)
-        if (baro2SMPB02BDetect(baroDev)) {
-            baroHardware = BARO_2SMPB_02B;
-            break;
-        }
+        return baro2SMPB02BDetect(baroDev);
 #endif
-        FALLTHROUGH;
+        break;
 
-     case BARO_LPS22DF:
+    case BARO_LPS22DF:
 #if defined(USE_BARO_LPS22DF) || defined(USE_BARO_SPI_LPS22DF)
-        if (lps22dfDetect(baroDev)) {
-            baroHardware = BARO_LPS22DF;
-            break;
-        }
+        return lps22dfDetect(baroDev);
 #endif
-        FALLTHROUGH;
+        break;
 
     case BARO_VIRTUAL:
 #ifdef USE_VIRTUAL_BARO
-        if (virtualBaroDetect(baroDev)) {
-            baroHardware = BARO_VIRTUAL;
-            break;
-        }
+        return virtualBaroDetect(baroDev);
+#endif
+        break;
+
+    default:
+        break;
+    }
+
+    return false;
+}
+
+static bool baroDetect(baroDev_t *baroDev, baroSensor_e baroHardwareToUse, baroSensor_e previousHardware)
+{
+    extDevice_t *dev = &baroDev->dev;
+
+    // Detect what pressure sensors are available. baro->update() is set to sensor-specific update function
+
+#if !defined(USE_BARO_BMP085) && !defined(USE_BARO_MS5611) && !defined(USE_BARO_SPI_MS5611) && !defined(USE_BARO_BMP388) && !defined(USE_BARO_BMP280) && !defined(USE_BARO_SPI_BMP280)&& !defined(USE_BARO_QMP6988) && !defined(USE_BARO_SPI_QMP6988) && !defined(USE_BARO_DPS310) && !defined(USE_BARO_SPI_DPS310) && !defined(DEFAULT_BARO_SPI_2SMBP_02B) && !defined(DEFAULT_BARO_2SMBP_02B)
+    UNUSED(dev);
+#endif
+
+#ifndef USE_VIRTUAL_BARO
+    switch (barometerConfig()->baro_busType) {
+#ifdef USE_I2C
+    case BUS_TYPE_I2C:
+        i2cBusSetInstance(dev, barometerConfig()->baro_i2c_device);
+        dev->busType_u.i2c.address = barometerConfig()->baro_i2c_address;
+        break;
 #endif
-        FALLTHROUGH;
 
-    case BARO_NONE:
-        baroHardware = BARO_NONE;
+#ifdef USE_SPI
+    case BUS_TYPE_SPI:
+        {
+            if (!spiSetBusInstance(dev, barometerConfig()->baro_spi_device)) {
+                return false;
+            }
+
+            dev->busType_u.spi.csnPin = IOGetByTag(barometerConfig()->baro_spi_csn);
+        }
         break;
+#endif
+    default:
+        return false;
+    }
+#endif // USE_VIRTUAL_BARO
+
+    baroSensor_e baroHardware = BARO_NONE;
+
+    // The sensor found on a previous boot is verified on its own, the others are only probed if it has gone
+    if (previousHardware != BARO_DEFAULT && baroDetectHardware(baroDev, previousHardware)) {
+        baroHardware = previousHardware;
+    } else {
+        // Probe from baro_hardware on, or all sensors for BARO_DEFAULT
+        bool probe = baroHardwareToUse == BARO_DEFAULT;
+
+        for (unsigned i = 0; i < ARRAYLEN(baroProbeOrder); i++) {
+            probe = probe || baroProbeOrder[i] == baroHardwareToUse;
+            if (probe && baroDetectHardware(baroDev, baroProbeOrder[i])) {
+                baroHardware = baroProbeOrder[i];
+                break;
+            }
+        }
     }
 
     if (baroHardware == BARO_NONE) {
@@ -346,9 +349,18 @@ static bool baroDetect(baroDev_t *baroDev, baroSensor_e baroHardwareToUse)
 void baroInit(void)
 {
 #ifndef USE_VIRTUAL_BARO
-    baroReady = baroDetect(&baro.dev, barometerConfig()->baro_hardware);
+    const bool autoDetect = barometerConfig()->baro_hardware == BARO_DEFAULT;
+    detectedHardwareConfig_t *detectedHardware = detectedHardwareConfigMutable();
+
+    // Only an automatically detected sensor is saved, for the next boot to verify first
+    baroReady = baroDetect(&baro.dev, barometerConfig()->baro_hardware, autoDetect ? detectedHardware->baroHardware : BARO_DEFAULT);
+
+    // The last sensor found is kept when none is, so that it is verified first again once it is back
+    if (autoDetect && baroReady) {
+        detectedHardware->baroHardware = detectedSensors[SENSOR_INDEX_BARO];
+    }
 #else
-    baroReady = baroDetect(&baro.dev, BARO_VIRTUAL);
+    baroReady = baroDetect(&baro.dev, BARO_VIRTUAL, BARO_DEFAULT);
 #endif
 }
 
@@ -481,7 +493,7 @@ uint32_t baroUpdate(timeUs_t currentTimeUs)
                 }
             }
 
-            if (debugMode == DEBUG_BARO) {
+            if (DEBUG_MODE_ACTIVE(DEBUG_BARO)) {
                 DEBUG_SET(DEBUG_BARO, 1, lrintf(baro.pressure / 100.0f));   // hPa
                 DEBUG_SET(DEBUG_BARO, 2, baro.temperature);                 // c°C
                 DEBUG_SET(DEBUG_BARO, 3, lrintf(baro.altitude));            // cm
@@ -66,6 +66,7 @@ static bool isBoardAlignmentStandard(const boardAlignment_t *boardAlignment)
 void initBoardAlignment(const boardAlignment_t *boardAlignment)
 {
     if (isBoardAlignmentStandard(boardAlignment)) {
+        standardBoardAlignment = true;
         return;
     }
 
@@ -147,3 +148,24 @@ void alignSensorViaRotation(float *dest, uint8_t rotation)
         alignBoard(dest);
     }
 }
+
+// Builds a matrix taking a zeroed, raw sensor sample straight to its aligned, board aligned and scaled value,
+// so that the per sample work is a single matrix multiply. The result is identical to
+// alignSensorViaRotation() or alignSensorViaMatrix() followed by multiplying by scale.
+void buildAlignmentTransform(float transform[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT], sensor_align_e alignment, fp_rotationMatrix_t *sensorRotationMatrix, float scale)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        float column[XYZ_AXIS_COUNT] = { 0.0f, 0.0f, 0.0f };
+        column[axis] = scale;
+
+        if (alignment == ALIGN_CUSTOM) {
+            alignSensorViaMatrix(column, sensorRotationMatrix);
+        } else {
+            alignSensorViaRotation(column, alignment);
+        }
+
+        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+            transform[i][axis] = column[i];
+        }
+    }
+}
@@ -22,6 +22,7 @@
 
 #include "common/axis.h"
 #include "common/maths.h"
+#include "common/sensor_alignment.h"
 
 #include "pg/pg.h"
 
@@ -35,5 +36,6 @@ PG_DECLARE(boardAlignment_t, boardAlignment);
 
 void alignSensorViaMatrix(float *dest, fp_rotationMatrix_t* rotationMatrix);
 void alignSensorViaRotation(float *dest, uint8_t rotation);
+void buildAlignmentTransform(float transform[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT], sensor_align_e alignment, fp_rotationMatrix_t *sensorRotationMatrix, float scale);
 
 void initBoardAlignment(const boardAlignment_t *boardAlignment);
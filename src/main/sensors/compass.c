@@ -57,6 +57,7 @@
 
 #include "io/beeper.h"
 
+#include "pg/detected_hardware.h"
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
 
@@ -156,64 +157,26 @@ void compassPreInit(void)
 }
 
 #if !defined(SIMULATOR_BUILD)
-bool compassDetect(magDev_t *magDev, uint8_t *alignment)
+// Order in which sensors are probed, MAG_MPU925X_AK8963 is only used when set explicitly
+static const magSensor_e magProbeOrder[] = {
+    MAG_HMC5883,
+    MAG_LIS2MDL,
+    MAG_LIS3MDL,
+    MAG_AK8975,
+    MAG_AK8963,
+    MAG_QMC5883,
+    MAG_IST8310,
+};
+
+// Probe for a single type of sensor
+static bool compassDetectHardware(magDev_t *magDev, uint8_t *alignment, magSensor_e magHardware)
 {
-    *alignment = ALIGN_DEFAULT;  // may be overridden if target specifies MAG_*_ALIGN
-
-    magSensor_e magHardware = MAG_NONE;
-
     extDevice_t *dev = &magDev->dev;
-    // Associate magnetometer bus with its device
-    dev->bus = &magDev->bus;
 
-#ifdef USE_MAG_DATA_READY_SIGNAL
-    magDev->magIntExtiTag = compassConfig()->interruptTag;
-#endif
-
-    switch (compassConfig()->mag_busType) {
-#ifdef USE_I2C
-    case BUS_TYPE_I2C:
-        i2cBusSetInstance(dev, compassConfig()->mag_i2c_device);
-        dev->busType_u.i2c.address = compassConfig()->mag_i2c_address;
-        break;
-#endif
-
-#ifdef USE_SPI
-    case BUS_TYPE_SPI:
-        {
-            if (!spiSetBusInstance(dev, compassConfig()->mag_spi_device)) {
-                return false;
-            }
-
-            dev->busType_u.spi.csnPin = IOGetByTag(compassConfig()->mag_spi_csn);
-        }
-        break;
-#endif
-
-#if defined(USE_MAG_AK8963) && (defined(USE_GYRO_SPI_MPU6500) || defined(USE_GYRO_SPI_MPU9250))
-    case BUS_TYPE_MPU_SLAVE:
-        {
-            if (gyroMpuDetectionResult()->sensor == MPU_9250_SPI) {
-                extDevice_t *masterDev = &gyroActiveDev()->dev;
-
-                dev->busType_u.i2c.address = compassConfig()->mag_i2c_address;
-                dev->bus->busType = BUS_TYPE_MPU_SLAVE;
-                dev->bus->busType_u.mpuSlave.master = masterDev;
-            } else {
-                return false;
-            }
-        }
-        break;
-#endif
-
-    default:
-        return false;
-    }
-
-    switch (compassConfig()->mag_hardware) {
-    case MAG_DEFAULT:
-        FALLTHROUGH;
+    UNUSED(dev);
+    UNUSED(alignment);
 
+    switch (magHardware) {
     case MAG_HMC5883:
 #if defined(USE_MAG_HMC5883) || defined(USE_MAG_SPI_HMC5883)
         if (dev->bus->busType == BUS_TYPE_I2C) {
@@ -224,11 +187,10 @@ bool compassDetect(magDev_t *magDev, uint8_t *alignment)
 #ifdef MAG_HMC5883_ALIGN
             *alignment = MAG_HMC5883_ALIGN;
 #endif
-            magHardware = MAG_HMC5883;
-            break;
+            return true;
         }
 #endif
-        FALLTHROUGH;
+        break;
 
     case MAG_LIS2MDL:
 #if defined(USE_MAG_LIS2MDL)
@@ -240,11 +202,10 @@ bool compassDetect(magDev_t *magDev, uint8_t *alignment)
 #ifdef MAG_LIS3MDL_ALIGN
             *alignment = MAG_LIS2MDL_ALIGN;
 #endif
-            magHardware = MAG_LIS2MDL;
-            break;
+            return true;
         }
 #endif
-        FALLTHROUGH;
+        break;
 
     case MAG_LIS3MDL:
 #if defined(USE_MAG_LIS3MDL)
@@ -256,11 +217,10 @@ bool compassDetect(magDev_t *magDev, uint8_t *alignment)
 #ifdef MAG_LIS3MDL_ALIGN
             *alignment = MAG_LIS3MDL_ALIGN;
 #endif
-            magHardware = MAG_LIS3MDL;
-            break;
+            return true;
         }
 #endif
-        FALLTHROUGH;
+        break;
 
     case MAG_AK8975:
 #ifdef USE_MAG_AK8975
@@ -272,11 +232,10 @@ bool compassDetect(magDev_t *magDev, uint8_t *alignment)
 #ifdef MAG_AK8975_ALIGN
             *alignment = MAG_AK8975_ALIGN;
 #endif
-            magHardware = MAG_AK8975;
-            break;
+            return true;
         }
 #endif
-        FALLTHROUGH;
+        break;
 
     case MAG_AK8963:
 #if defined(USE_MAG_AK8963) || defined(USE_MAG_SPI_AK8963)
@@ -293,11 +252,10 @@ bool compassDetect(magDev_t *magDev, uint8_t *alignment)
 #ifdef MAG_AK8963_ALIGN
             *alignment = MAG_AK8963_ALIGN;
 #endif
-            magHardware = MAG_AK8963;
-            break;
+            return true;
         }
 #endif
-        FALLTHROUGH;
+        break;
 
     case MAG_QMC5883:
 #ifdef USE_MAG_QMC5883
@@ -309,11 +267,10 @@ bool compassDetect(magDev_t *magDev, uint8_t *alignment)
 #ifdef MAG_QMC5883L_ALIGN
             *alignment = MAG_QMC5883L_ALIGN;
 #endif
-            magHardware = MAG_QMC5883;
-            break;
+            return true;
         }
 #endif
-        FALLTHROUGH;
+        break;
 
     case MAG_IST8310:
 #ifdef USE_MAG_IST8310
@@ -325,28 +282,100 @@ bool compassDetect(magDev_t *magDev, uint8_t *alignment)
 #ifdef MAG_IST8310_ALIGN
             *alignment = MAG_IST8310_ALIGN;
 #endif
-            magHardware = MAG_IST8310;
-            break;
+            return true;
         }
 #endif
-        FALLTHROUGH;
+        break;
+
+    case MAG_MPU925X_AK8963:
+#ifdef USE_MAG_MPU925X_AK8963
+        return mpu925Xak8963CompassDetect(magDev);
+#endif
+        break;
 
-    case MAG_NONE:
-        magHardware = MAG_NONE;
+    default:
         break;
     }
 
-    // MAG_MPU925X_AK8963 is an MPU925x configured as I2C passthrough to the built-in AK8963 magnetometer
-    // Passthrough mode disables the gyro/acc part of the MPU, so we only want to detect this sensor if mag_hardware was explicitly set to MAG_MPU925X_AK8963
-#ifdef USE_MAG_MPU925X_AK8963
-    if (compassConfig()->mag_hardware == MAG_MPU925X_AK8963){
-        if (mpu925Xak8963CompassDetect(magDev)) {
+    return false;
+}
+
+
+static bool compassDetect(magDev_t *magDev, uint8_t *alignment, magSensor_e magHardwareToUse, magSensor_e previousHardware)
+{
+    *alignment = ALIGN_DEFAULT;  // may be overridden if target specifies MAG_*_ALIGN
+
+    extDevice_t *dev = &magDev->dev;
+    // Associate magnetometer bus with its device
+    dev->bus = &magDev->bus;
+
+#ifdef USE_MAG_DATA_READY_SIGNAL
+    magDev->magIntExtiTag = compassConfig()->interruptTag;
+#endif
+
+    switch (compassConfig()->mag_busType) {
+#ifdef USE_I2C
+    case BUS_TYPE_I2C:
+        i2cBusSetInstance(dev, compassConfig()->mag_i2c_device);
+        dev->busType_u.i2c.address = compassConfig()->mag_i2c_address;
+        break;
+#endif
+
+#ifdef USE_SPI
+    case BUS_TYPE_SPI:
+        {
+            if (!spiSetBusInstance(dev, compassConfig()->mag_spi_device)) {
+                return false;
+            }
+
+            dev->busType_u.spi.csnPin = IOGetByTag(compassConfig()->mag_spi_csn);
+        }
+        break;
+#endif
+
+#if defined(USE_MAG_AK8963) && (defined(USE_GYRO_SPI_MPU6500) || defined(USE_GYRO_SPI_MPU9250))
+    case BUS_TYPE_MPU_SLAVE:
+        {
+            if (gyroMpuDetectionResult()->sensor == MPU_9250_SPI) {
+                extDevice_t *masterDev = &gyroActiveDev()->dev;
+
+                dev->busType_u.i2c.address = compassConfig()->mag_i2c_address;
+                dev->bus->busType = BUS_TYPE_MPU_SLAVE;
+                dev->bus->busType_u.mpuSlave.master = masterDev;
+            } else {
+                return false;
+            }
+        }
+        break;
+#endif
+
+    default:
+        return false;
+    }
+
+    magSensor_e magHardware = MAG_NONE;
+
+    // The sensor found on a previous boot is verified on its own, the others are only probed if it has gone
+    if (previousHardware != MAG_DEFAULT && compassDetectHardware(magDev, alignment, previousHardware)) {
+        magHardware = previousHardware;
+    } else if (magHardwareToUse == MAG_MPU925X_AK8963) {
+        // MAG_MPU925X_AK8963 is an MPU925x configured as I2C passthrough to the built-in AK8963 magnetometer
+        // Passthrough mode disables the gyro/acc part of the MPU, so we only want to detect this sensor if mag_hardware was explicitly set to MAG_MPU925X_AK8963
+        if (compassDetectHardware(magDev, alignment, MAG_MPU925X_AK8963)) {
             magHardware = MAG_MPU925X_AK8963;
-        } else {
-            return false;
+        }
+    } else {
+        // Probe from mag_hardware on, or all sensors for MAG_DEFAULT
+        bool probe = magHardwareToUse == MAG_DEFAULT;
+
+        for (unsigned i = 0; i < ARRAYLEN(magProbeOrder); i++) {
+            probe = probe || magProbeOrder[i] == magHardwareToUse;
+            if (probe && compassDetectHardware(magDev, alignment, magProbeOrder[i])) {
+                magHardware = magProbeOrder[i];
+                break;
+            }
         }
     }
-#endif
 
     if (magHardware == MAG_NONE) {
         return false;
@@ -357,10 +386,12 @@ bool compassDetect(magDev_t *magDev, uint8_t *alignment)
     return true;
 }
 #else
-bool compassDetect(magDev_t *dev, sensor_align_e *alignment)
+static bool compassDetect(magDev_t *dev, sensor_align_e *alignment, magSensor_e magHardwareToUse, magSensor_e previousHardware)
 {
     UNUSED(dev);
     UNUSED(alignment);
+    UNUSED(magHardwareToUse);
+    UNUSED(previousHardware);
 
     return false;
 }
@@ -371,8 +402,18 @@ bool compassInit(void)
     // initialize and calibration. turn on led during mag calibration (calibration routine blinks it)
 
     sensor_align_e alignment;
+    const bool autoDetect = compassConfig()->mag_hardware == MAG_DEFAULT;
+    detectedHardwareConfig_t *detectedHardware = detectedHardwareConfigMutable();
+
+    // Only an automatically detected sensor is saved, for the next boot to verify first
+    const bool magDetected = compassDetect(&magDev, &alignment, compassConfig()->mag_hardware, autoDetect ? detectedHardware->magHardware : MAG_DEFAULT);
+
+    // The last sensor found is kept when none is, so that it is verified first again once it is back
+    if (autoDetect && magDetected) {
+        detectedHardware->magHardware = detectedSensors[SENSOR_INDEX_MAG];
+    }
 
-    if (!compassDetect(&magDev, &alignment)) {
+    if (!magDetected) {
         return false;
     }
 
@@ -514,7 +555,7 @@ uint32_t compassUpdate(timeUs_t currentTimeUs)
         mag.magADC[axis] -= magZero->raw[axis];
     }
 
-    if (debugMode == DEBUG_MAG_CALIB) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_MAG_CALIB)) {
         for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
             // DEBUG 0-2: magADC[X], magADC[Y], magADC[Z]
             DEBUG_SET(DEBUG_MAG_CALIB, axis, lrintf(mag.magADC[axis]));
@@ -535,7 +576,7 @@ uint32_t compassUpdate(timeUs_t currentTimeUs)
         DEBUG_SET(DEBUG_MAG_CALIB, 7, lrintf(displayLambdaGain));
     }
 
-    if (debugMode == DEBUG_MAG_TASK_RATE) {
+    if (DEBUG_MODE_ACTIVE(DEBUG_MAG_TASK_RATE)) {
         static timeUs_t previousTimeUs = 0;
         const timeDelta_t dataIntervalUs = cmpTimeUs(currentTimeUs, previousTimeUs); // time since last data received
         previousTimeUs = currentTimeUs;
@@ -37,6 +37,8 @@
 
 #include "pg/pg.h"
 
+#include "sensors/gyro_fusion.h"
+
 #define LPF_MAX_HZ 1000 // so little filtering above 1000hz that if the user wants less delay, they must disable the filter
 #define DYN_LPF_MAX_HZ 1000
 
@@ -77,6 +79,7 @@ typedef struct gyroCalibration_s {
 typedef struct gyroSensor_s {
     gyroDev_t gyroDev;
     gyroCalibration_t calibration;
+    float transform[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];   // alignment, board alignment and scale
 } gyroSensor_t;
 
 typedef struct gyro_s {
@@ -93,6 +96,7 @@ typedef struct gyro_s {
     gyroSensor_t gyroSensor1;
 #ifdef USE_MULTI_GYRO
     gyroSensor_t gyroSensor2;
+    gyroFusion_t fusion;               // blends gyroSensor1 and gyroSensor2 when using both
 #endif
 
     gyroDev_t *rawSensorDev;           // pointer to the sensor providing the raw data for DEBUG_GYRO_RAW
@@ -213,6 +217,9 @@ int16_t gyroGetTemperature(void);
 bool gyroOverflowDetected(void);
 bool gyroYawSpinDetected(void);
 uint16_t gyroAbsRateDps(int axis);
+#ifdef USE_LATENCY_STATS
+uint32_t gyroGetSampleTimeCycles(void);
+#endif
 #ifdef USE_DYN_LPF
 float dynThrottle(float throttle);
 void dynLpfGyroUpdate(float throttle);
@@ -28,7 +28,7 @@ static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(void)
 
         // DEBUG_GYRO_SCALED records the unfiltered, scaled gyro output
         // If downsampling than the last value in the sample group will be output
-        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_SCALED, axis, lrintf(gyro.gyroADC[axis]));
+        GYRO_FILTER_DEBUG_SET_FLOAT(DEBUG_GYRO_SCALED, axis, gyro.gyroADC[axis]);
 
         // DEBUG_GYRO_SAMPLE(0) Record the pre-downsample value for the selected debug axis (same as DEBUG_GYRO_SCALED)
         GYRO_FILTER_AXIS_DEBUG_SET(axis, DEBUG_GYRO_SAMPLE, 0, lrintf(gyro.gyroADC[axis]));
@@ -83,7 +83,7 @@ static FAST_CODE void GYRO_FILTER_FUNCTION_NAME(void)
 #endif
 
         // DEBUG_GYRO_FILTERED records the scaled, filtered, after all software filtering has been applied.
-        GYRO_FILTER_DEBUG_SET(DEBUG_GYRO_FILTERED, axis, lrintf(gyroADCf));
+        GYRO_FILTER_DEBUG_SET_FLOAT(DEBUG_GYRO_FILTERED, axis, gyroADCf);
 
         gyro.gyroADCf[axis] = gyroADCf;
     }
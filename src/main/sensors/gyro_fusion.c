@@ -0,0 +1,141 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Dual gyro fusion.
+ *
+ * Each sensor's noise is estimated from the variance of the second difference of its samples, which
+ * for white noise is six times the noise variance and which the motion of the craft barely contributes
+ * to at gyro sample rates. The sensors are then blended per axis by inverse variance, so that a quiet
+ * gyro paired with a noisy one is not dragged down to the average of the two.
+ *
+ * A sensor reporting clipped samples, or repeating exactly the same sample on every axis for too long,
+ * is left out of the blend until it has behaved for a while.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "platform.h"
+
+#ifdef USE_MULTI_GYRO
+
+#include "common/maths.h"
+
+#include "gyro_fusion.h"
+
+#define GYRO_FUSION_INITIAL_VARIANCE    1.0f    // (deg/s)^2, both sensors start out equally weighted
+#define GYRO_FUSION_MIN_VARIANCE        1e-6f
+
+void gyroFusionInit(gyroFusion_t *fusion, uint32_t sampleLooptimeUs)
+{
+    const float k = pt1FilterGain(GYRO_FUSION_NOISE_CUTOFF_HZ, sampleLooptimeUs * 1e-6f);
+
+    for (int i = 0; i < GYRO_FUSION_SENSOR_COUNT; i++) {
+        gyroFusionSensor_t *sensor = &fusion->sensor[i];
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            pt1FilterInit(&sensor->noiseVariance[axis], k);
+            sensor->noiseVariance[axis].state = GYRO_FUSION_INITIAL_VARIANCE;
+            sensor->previous[axis] = 0.0f;
+            sensor->previousPrevious[axis] = 0.0f;
+            sensor->previousRaw[axis] = 0;
+        }
+        sensor->stuckCount = 0;
+        sensor->faultHoldoff = 0;
+    }
+
+    const uint32_t looptimeUs = MAX(sampleLooptimeUs, 1U);
+    fusion->stuckSamples = constrain(GYRO_FUSION_STUCK_TIME_US / looptimeUs, 1, UINT16_MAX);
+    fusion->faultHoldoffSamples = constrain(GYRO_FUSION_FAULT_HOLDOFF_US / looptimeUs, 1, UINT16_MAX);
+}
+
+static FAST_CODE void gyroFusionUpdateSensor(gyroFusion_t *fusion, gyroFusionSensor_t *sensor, const float *gyroADC, const int16_t *gyroADCRaw)
+{
+    bool clipped = false;
+    bool repeated = true;
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        clipped |= abs(gyroADCRaw[axis]) >= GYRO_FUSION_CLIP_RAW;
+        repeated &= gyroADCRaw[axis] == sensor->previousRaw[axis];
+        sensor->previousRaw[axis] = gyroADCRaw[axis];
+    }
+
+    sensor->stuckCount = repeated ? MIN(sensor->stuckCount + 1, UINT16_MAX) : 0;
+    const bool stuck = sensor->stuckCount >= fusion->stuckSamples;
+
+    if (clipped || stuck) {
+        sensor->faultHoldoff = fusion->faultHoldoffSamples;
+    } else {
+        if (sensor->faultHoldoff) {
+            sensor->faultHoldoff--;
+        }
+        // a faulty sample says nothing about the noise
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            const float difference = gyroADC[axis] - 2.0f * sensor->previous[axis] + sensor->previousPrevious[axis];
+            pt1FilterApply(&sensor->noiseVariance[axis], sq(difference) / 6.0f);
+        }
+    }
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        sensor->previousPrevious[axis] = sensor->previous[axis];
+        sensor->previous[axis] = gyroADC[axis];
+    }
+}
+
+FAST_CODE void gyroFusionUpdate(gyroFusion_t *fusion, float *dest, const float *gyroADC1, const int16_t *gyroADCRaw1, const float *gyroADC2, const int16_t *gyroADCRaw2)
+{
+    gyroFusionSensor_t *sensor1 = &fusion->sensor[0];
+    gyroFusionSensor_t *sensor2 = &fusion->sensor[1];
+
+    gyroFusionUpdateSensor(fusion, sensor1, gyroADC1, gyroADCRaw1);
+    gyroFusionUpdateSensor(fusion, sensor2, gyroADC2, gyroADCRaw2);
+
+    if (sensor1->faultHoldoff && !sensor2->faultHoldoff) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            dest[axis] = gyroADC2[axis];
+        }
+    } else if (sensor2->faultHoldoff && !sensor1->faultHoldoff) {
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            dest[axis] = gyroADC1[axis];
+        }
+    } else {
+        // both healthy, or nothing better to do than trust both
+        for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+            dest[axis] = gyroADC1[axis] + (gyroADC2[axis] - gyroADC1[axis]) * gyroFusionGetWeight(fusion, 1, axis);
+        }
+    }
+}
+
+bool gyroFusionIsSensorHealthy(const gyroFusion_t *fusion, int sensorIndex)
+{
+    return !fusion->sensor[sensorIndex].faultHoldoff;
+}
+
+// inverse variance weight of the sensor, ignoring faults
+float gyroFusionGetWeight(const gyroFusion_t *fusion, int sensorIndex, int axis)
+{
+    const float variance1 = fusion->sensor[0].noiseVariance[axis].state + GYRO_FUSION_MIN_VARIANCE;
+    const float variance2 = fusion->sensor[1].noiseVariance[axis].state + GYRO_FUSION_MIN_VARIANCE;
+    const float otherVariance = sensorIndex == 0 ? variance2 : variance1;
+
+    return otherVariance / (variance1 + variance2);
+}
+
+#endif // USE_MULTI_GYRO
@@ -0,0 +1,53 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/axis.h"
+#include "common/filter.h"
+
+#define GYRO_FUSION_SENSOR_COUNT        2
+#define GYRO_FUSION_NOISE_CUTOFF_HZ     2.0f    // bandwidth of the noise estimate
+#define GYRO_FUSION_CLIP_RAW            32000   // raw samples at or beyond this are treated as clipped
+#define GYRO_FUSION_STUCK_TIME_US       20000   // a sensor repeating the same sample for this long is stuck
+#define GYRO_FUSION_FAULT_HOLDOFF_US    200000  // a faulty sensor must look good for this long before it is used again
+
+typedef struct gyroFusionSensor_s {
+    pt1Filter_t noiseVariance[XYZ_AXIS_COUNT];  // (deg/s)^2
+    float previous[XYZ_AXIS_COUNT];
+    float previousPrevious[XYZ_AXIS_COUNT];
+    int16_t previousRaw[XYZ_AXIS_COUNT];
+    uint16_t stuckCount;
+    uint16_t faultHoldoff;                      // samples until a faulty sensor is used again, 0 when healthy
+} gyroFusionSensor_t;
+
+typedef struct gyroFusion_s {
+    gyroFusionSensor_t sensor[GYRO_FUSION_SENSOR_COUNT];
+    uint16_t stuckSamples;
+    uint16_t faultHoldoffSamples;
+} gyroFusion_t;
+
+void gyroFusionInit(gyroFusion_t *fusion, uint32_t sampleLooptimeUs);
+void gyroFusionUpdate(gyroFusion_t *fusion, float *dest, const float *gyroADC1, const int16_t *gyroADCRaw1, const float *gyroADC2, const int16_t *gyroADCRaw2);
+bool gyroFusionIsSensorHealthy(const gyroFusion_t *fusion, int sensorIndex);
+float gyroFusionGetWeight(const gyroFusion_t *fusion, int sensorIndex, int axis);
@@ -67,8 +67,11 @@
 #include "flight/dyn_notch_filter.h"
 #endif
 
+#include "pg/debug_capture.h"
+#include "pg/detected_hardware.h"
 #include "pg/gyrodev.h"
 
+#include "sensors/boardalignment.h"
 #include "sensors/gyro.h"
 #include "sensors/sensors.h"
 
@@ -282,6 +285,10 @@ void gyroInitFilters(void)
     for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
         pt1FilterInit(&gyro.imuGyroFilter[axis], k);
     }
+
+#ifdef USE_MULTI_GYRO
+    gyroFusionInit(&gyro.fusion, gyro.sampleLooptime);
+#endif
 }
 
 #if defined(USE_GYRO_SLEW_LIMITER)
@@ -314,6 +321,7 @@ void gyroInitSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t *config)
     // The targetLooptime gets set later based on the active sensor's gyroSampleRateHz and pid_process_denom
     gyroSensor->gyroDev.gyroSampleRateHz = gyroSetSampleRate(&gyroSensor->gyroDev);
     gyroSensor->gyroDev.initFn(&gyroSensor->gyroDev);
+    buildAlignmentTransform(gyroSensor->transform, gyroSensor->gyroDev.gyroAlign, &gyroSensor->gyroDev.rotationMatrix, gyroSensor->gyroDev.scale);
 
     // As new gyros are supported, be sure to add them below based on whether they are subject to the overflow/inversion bug
     // Any gyro not explicitly defined will default to not having built-in overflow protection as a safe alternative.
@@ -546,7 +554,13 @@ static bool gyroDetectSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t
 #ifdef USE_VIRTUAL_GYRO
     UNUSED(config);
 #else
-    bool gyroFound = mpuDetect(&gyroSensor->gyroDev, config);
+    // Verify the sensor found on a previous boot before probing for all of them
+    const mpuDetectionResult_t previousResult = {
+        .sensor = detectedHardwareConfig()->gyroSensor[config->index],
+        .spiDetectIndex = detectedHardwareConfig()->gyroDetectIndex[config->index],
+    };
+
+    bool gyroFound = mpuDetect(&gyroSensor->gyroDev, config, &previousResult);
     if (!gyroFound) {
         return false;
     }
@@ -558,6 +572,18 @@ static bool gyroDetectSensor(gyroSensor_t *gyroSensor, const gyroDeviceConfig_t
     return gyroHardware != GYRO_NONE;
 }
 
+#ifndef USE_VIRTUAL_GYRO
+// Record the sensor found for the next boot to verify
+static void gyroUpdateDetectedHardware(const gyroSensor_t *gyroSensor, const gyroDeviceConfig_t *config)
+{
+    const mpuDetectionResult_t *result = &gyroSensor->gyroDev.mpuDetectionResult;
+    detectedHardwareConfig_t *detectedHardware = detectedHardwareConfigMutable();
+
+    detectedHardware->gyroSensor[config->index] = result->sensor;
+    detectedHardware->gyroDetectIndex[config->index] = result->spiDetectIndex;
+}
+#endif
+
 static void gyroPreInitSensor(const gyroDeviceConfig_t *config)
 {
 #ifdef USE_VIRTUAL_GYRO
@@ -575,6 +601,27 @@ void gyroPreInit(void)
 #endif
 }
 
+// Debug modes taking the filter and dual gyro debug paths, which are skipped when no mode needs them
+static void gyroInitDebugMode(uint8_t mode)
+{
+    switch (mode) {
+    case DEBUG_FFT:
+    case DEBUG_FFT_FREQ:
+    case DEBUG_GYRO_RAW:
+    case DEBUG_GYRO_SCALED:
+    case DEBUG_GYRO_FILTERED:
+    case DEBUG_DYN_LPF:
+    case DEBUG_GYRO_SAMPLE:
+        gyro.gyroDebugMode = mode;
+        break;
+    case DEBUG_DUAL_GYRO_DIFF:
+    case DEBUG_DUAL_GYRO_RAW:
+    case DEBUG_DUAL_GYRO_SCALED:
+        gyro.useDualGyroDebugging = true;
+        break;
+    }
+}
+
 bool gyroInit(void)
 {
 #ifdef USE_GYRO_OVERFLOW_CHECK
@@ -591,22 +638,12 @@ bool gyroInit(void)
     gyro.useDualGyroDebugging = false;
     gyro.gyroHasOverflowProtection = true;
 
-    switch (debugMode) {
-    case DEBUG_FFT:
-    case DEBUG_FFT_FREQ:
-    case DEBUG_GYRO_RAW:
-    case DEBUG_GYRO_SCALED:
-    case DEBUG_GYRO_FILTERED:
-    case DEBUG_DYN_LPF:
-    case DEBUG_GYRO_SAMPLE:
-        gyro.gyroDebugMode = debugMode;
-        break;
-    case DEBUG_DUAL_GYRO_DIFF:
-    case DEBUG_DUAL_GYRO_RAW:
-    case DEBUG_DUAL_GYRO_SCALED:
-        gyro.useDualGyroDebugging = true;
-        break;
+    gyroInitDebugMode(debugMode);
+#ifdef USE_DEBUG_CAPTURE
+    for (unsigned slot = 0; slot < DEBUG_CAPTURE_SLOT_COUNT; slot++) {
+        gyroInitDebugMode(debugCaptureConfig()->mode[slot]);
     }
+#endif
 
     gyroDetectionFlags = GYRO_NONE_MASK;
     uint8_t gyrosToScan = gyroConfig()->gyrosDetected;
@@ -628,12 +665,22 @@ bool gyroInit(void)
         return false;
     }
 
-    bool eepromWriteRequired = false;
+    // Changes to the config are saved by sensorsAutodetect() along with those of the other sensors
     if (!gyrosToScan) {
         gyroConfigMutable()->gyrosDetected = gyroDetectionFlags;
-        eepromWriteRequired = true;
     }
 
+#ifndef USE_VIRTUAL_GYRO
+    if (gyroDetectionFlags & GYRO_1_MASK) {
+        gyroUpdateDetectedHardware(&gyro.gyroSensor1, gyroDeviceConfig(0));
+    }
+#if defined(USE_MULTI_GYRO)
+    if (gyroDetectionFlags & GYRO_2_MASK) {
+        gyroUpdateDetectedHardware(&gyro.gyroSensor2, gyroDeviceConfig(1));
+    }
+#endif
+#endif
+
 #if defined(USE_MULTI_GYRO)
     if ((gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH && !((gyroDetectionFlags & GYRO_ALL_MASK) == GYRO_ALL_MASK))
         || (gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_1 && !(gyroDetectionFlags & GYRO_1_MASK))
@@ -645,7 +692,6 @@ bool gyroInit(void)
         }
 
         gyroConfigMutable()->gyro_to_use = gyro.gyroToUse;
-        eepromWriteRequired = true;
     }
 
     // Only allow using both gyros simultaneously if they are the same hardware type.
@@ -655,7 +701,6 @@ bool gyroInit(void)
         // If the user selected "BOTH" and they are not the same type, then reset to using only the first gyro.
         gyro.gyroToUse = GYRO_CONFIG_USE_GYRO_1;
         gyroConfigMutable()->gyro_to_use = gyro.gyroToUse;
-        eepromWriteRequired = true;
     }
 
     if (gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_2 || gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
@@ -670,10 +715,6 @@ bool gyroInit(void)
     }
 #endif
 
-    if (eepromWriteRequired) {
-        writeEEPROM();
-    }
-
     if (gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_1 || gyro.gyroToUse == GYRO_CONFIG_USE_GYRO_BOTH) {
         static DMA_DATA uint8_t gyroBuf1[GYRO_BUF_SIZE];
         // SPI DMA buffer required per device
@@ -33,6 +33,7 @@
 
 #include "flight/pid.h"
 
+#include "pg/detected_hardware.h"
 #include "pg/pg.h"
 #include "pg/pg_ids.h"
 
@@ -67,6 +68,13 @@ void sensorsPreInit(void)
 bool sensorsAutodetect(void)
 {
 
+    // Detection updates the sensors saved for the next boot to verify first, and may update the gyros to use.
+    // Whatever changed is saved in a single write once all sensors are detected.
+    gyroConfig_t previousGyroConfig;
+    detectedHardwareConfig_t previousHardware;
+    memcpy(&previousGyroConfig, gyroConfig(), sizeof(previousGyroConfig));
+    memcpy(&previousHardware, detectedHardwareConfig(), sizeof(previousHardware));
+
     // gyro must be initialised before accelerometer
 
     bool gyroDetected = gyroInit();
@@ -85,6 +93,11 @@ bool sensorsAutodetect(void)
     compassInit();
 #endif
 
+    if (memcmp(&previousGyroConfig, gyroConfig(), sizeof(previousGyroConfig)) != 0
+        || memcmp(&previousHardware, detectedHardwareConfig(), sizeof(previousHardware)) != 0) {
+        writeEEPROM();
+    }
+
 #ifdef USE_RANGEFINDER
     rangefinderInit();
 #endif
@@ -295,6 +295,7 @@
 #endif // USE_VTX
 
 #define USE_HUFFMAN
+#define USE_LZ
 
 #define PID_PROFILE_COUNT 4
 #define CONTROL_RATE_PROFILE_COUNT  4
@@ -363,6 +364,8 @@
 #define USE_ESC_SENSOR_TELEMETRY
 #define USE_TELEMETRY_SENSORS_DISABLED_DETAILS
 #define USE_PERSISTENT_STATS
+#define USE_LATENCY_STATS
+#define USE_DEBUG_CAPTURE
 #define USE_PROFILE_NAMES
 #define USE_FEEDFORWARD
 #define USE_CUSTOM_BOX_NAMES
@@ -417,3 +417,59 @@ TEST(AlignSensorTest, AlignmentBitmasks)
     EXPECT_EQ(2, ALIGNMENT_AXIS_ROTATIONS(bits, FD_PITCH));
     EXPECT_EQ(0, ALIGNMENT_AXIS_ROTATIONS(bits, FD_ROLL));
 }
+
+static void testAlignmentTransform(sensor_align_e alignment, fp_rotationMatrix_t *rotationMatrix)
+{
+    const float scale = 0.061f;
+    float transform[XYZ_AXIS_COUNT][XYZ_AXIS_COUNT];
+
+    buildAlignmentTransform(transform, alignment, rotationMatrix, scale);
+
+    for (int n = 0; n < 10; n++) {
+        const float raw[XYZ_AXIS_COUNT] = {
+            (float)(rand() % 65536 - 32768),
+            (float)(rand() % 65536 - 32768),
+            (float)(rand() % 65536 - 32768),
+        };
+
+        float expected[XYZ_AXIS_COUNT] = { raw[X], raw[Y], raw[Z] };
+        if (alignment == ALIGN_CUSTOM) {
+            alignSensorViaMatrix(expected, rotationMatrix);
+        } else {
+            alignSensorViaRotation(expected, alignment);
+        }
+
+        for (int i = 0; i < XYZ_AXIS_COUNT; i++) {
+            const float transformed = transform[i][X] * raw[X] + transform[i][Y] * raw[Y] + transform[i][Z] * raw[Z];
+            EXPECT_NEAR(expected[i] * scale, transformed, 0.01f) << "alignment: " << alignment << " axis: " << i;
+        }
+    }
+}
+
+static void testAlignmentTransformForAllAlignments(void)
+{
+    for (int alignment = CW0_DEG; alignment <= CW270_DEG_FLIP; alignment++) {
+        testAlignmentTransform((sensor_align_e)alignment, NULL);
+    }
+    testAlignmentTransform(ALIGN_DEFAULT, NULL);
+
+    const sensorAlignment_t customAlignment = SENSOR_ALIGNMENT(10, -20, 135);
+    fp_rotationMatrix_t rotationMatrix;
+    buildRotationMatrixFromAlignment(&customAlignment, &rotationMatrix);
+    testAlignmentTransform(ALIGN_CUSTOM, &rotationMatrix);
+}
+
+TEST(AlignSensorTest, AlignmentTransformMatchesAlignSensor)
+{
+    srand(time(NULL));
+
+    const boardAlignment_t standardAlignment = { 0, 0, 0 };
+    initBoardAlignment(&standardAlignment);
+    testAlignmentTransformForAllAlignments();
+
+    const boardAlignment_t boardAlignment = { 15, -30, 200 };
+    initBoardAlignment(&boardAlignment);
+    testAlignmentTransformForAllAlignments();
+
+    initBoardAlignment(&standardAlignment);
+}
@@ -1070,6 +1070,8 @@ extern "C" {
     void gyroStartCalibration(bool) {}
     bool isFirstArmingGyroCalibrationRunning(void) { return false; }
     void pidController(const pidProfile_t *, timeUs_t) {}
+    float pidGetDT(void) { return 0; }
+    void imuPropagateAttitude(float) {}
     void pidStabilisationState(pidStabilisationState_e) {}
     void mixTable(timeUs_t) {};
     void writeMotors(void) {};
@@ -0,0 +1,374 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/bus.h"
+    #include "drivers/bus_spi_queue.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Bus simulation following the DMA completion interrupt of bus_spi.c, one segment at a time
+
+typedef struct transfer_s {
+    const extDevice_t *dev;
+    const busSegment_t *segment;
+} transfer_t;
+
+static busDevice_t bus;
+static extDevice_t flash;
+static extDevice_t osd;
+static extDevice_t baro;
+static extDevice_t gyro;
+
+static const extDevice_t *busDev;
+static const extDevice_t *csAssertedDev;
+static std::vector<transfer_t> transfers;
+
+static void initBus(void)
+{
+    bus = {};
+    spiQueueInit(&bus);
+    transfers.clear();
+    busDev = NULL;
+    csAssertedDev = NULL;
+
+    const struct {
+        extDevice_t *dev;
+        busPriority_e priority;
+    } devices[] = {
+        { &flash, BUS_PRIORITY_LOW },
+        { &osd, BUS_PRIORITY_LOW },
+        { &baro, BUS_PRIORITY_NORMAL },
+        { &gyro, BUS_PRIORITY_HIGH },
+    };
+
+    for (const auto &device : devices) {
+        *device.dev = {};
+        device.dev->bus = &bus;
+        device.dev->priority = device.priority;
+    }
+}
+
+static void initSegments(busSegment_t *segments, int count, bool holdLastCS = false)
+{
+    for (int i = 0; i < count; i++) {
+        segments[i] = {};
+        segments[i].len = 1;
+        segments[i].negateCS = true;
+    }
+    if (holdLastCS) {
+        segments[count - 1].negateCS = false;
+    }
+    segments[count] = {};
+    segments[count].negateCS = true;
+}
+
+static void sequence(const extDevice_t *dev, busSegment_t *segments)
+{
+    if (bus.curSegment != (busSegment_t *)BUS_SPI_FREE) {
+        spiQueueSegments(&bus, dev, segments);
+    } else {
+        bus.curSegment = segments;
+        busDev = dev;
+    }
+}
+
+// Complete the segment in progress, returning false once the bus is free
+static bool completeSegment(void)
+{
+    busSegment_t *segment = (busSegment_t *)bus.curSegment;
+    busSegment_t *nextSegment = segment + 1;
+
+    // No other device may use the bus while chip select is asserted
+    EXPECT_TRUE(csAssertedDev == NULL || csAssertedDev == busDev);
+    csAssertedDev = segment->negateCS ? NULL : busDev;
+
+    transfers.push_back({ busDev, segment });
+
+    if (nextSegment->len == 0) {
+        // With nothing linked the list gives up the bus, as it would were the next transfer started on a free bus
+        if (!nextSegment->u.link.dev) {
+            csAssertedDev = NULL;
+        }
+        busDev = spiQueueNext(&bus, nextSegment);
+    } else {
+        const extDevice_t *nextDev = segment->negateCS ? spiQueuePreempt(&bus, busDev, nextSegment) : NULL;
+
+        if (nextDev) {
+            busDev = nextDev;
+        } else {
+            bus.curSegment = nextSegment;
+        }
+    }
+
+    return busDev != NULL;
+}
+
+static void completeAll(void)
+{
+    while (completeSegment());
+
+    // Nothing may be left held aside once the bus is free
+    EXPECT_EQ((busSegment_t *)BUS_SPI_FREE, bus.curSegment);
+    EXPECT_EQ(NULL, bus.preemptDev);
+}
+
+static void expectTransfers(const std::vector<transfer_t> &expected)
+{
+    ASSERT_EQ(expected.size(), transfers.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(expected[i].dev, transfers[i].dev) << "transfer " << i;
+        EXPECT_EQ(expected[i].segment, transfers[i].segment) << "transfer " << i;
+    }
+}
+
+TEST(BusSpiQueueTest, TestSamePriorityInOrder)
+{
+    busSegment_t first[2], second[2], third[2];
+
+    initBus();
+    initSegments(first, 1);
+    initSegments(second, 1);
+    initSegments(third, 1);
+
+    sequence(&baro, first);
+    sequence(&baro, second);
+    sequence(&baro, third);
+    completeAll();
+
+    expectTransfers({ { &baro, &first[0] }, { &baro, &second[0] }, { &baro, &third[0] } });
+    EXPECT_EQ((busSegment_t *)BUS_SPI_FREE, bus.curSegment);
+}
+
+TEST(BusSpiQueueTest, TestPriorityOrder)
+{
+    busSegment_t flashSegments[2], osdSegments[2], baroSegments[2];
+
+    initBus();
+    initSegments(flashSegments, 1);
+    initSegments(osdSegments, 1);
+    initSegments(baroSegments, 1);
+
+    // a normal priority transfer passes a queued low priority one, but not the one in progress
+    sequence(&flash, flashSegments);
+    sequence(&osd, osdSegments);
+    sequence(&baro, baroSegments);
+    completeAll();
+
+    expectTransfers({ { &flash, &flashSegments[0] }, { &baro, &baroSegments[0] }, { &osd, &osdSegments[0] } });
+}
+
+TEST(BusSpiQueueTest, TestPreemptAtChipSelectNegation)
+{
+    busSegment_t flashSegments[4], gyroSegments[3];
+
+    initBus();
+    // status poll, write enable and program
+    initSegments(flashSegments, 3);
+    initSegments(gyroSegments, 2, false);
+    gyroSegments[0].negateCS = false;
+
+    sequence(&flash, flashSegments);
+    sequence(&gyro, gyroSegments);
+    completeAll();
+
+    // the gyro takes over after the status poll, the flash transfer continues where it left off
+    expectTransfers({
+        { &flash, &flashSegments[0] },
+        { &gyro, &gyroSegments[0] },
+        { &gyro, &gyroSegments[1] },
+        { &flash, &flashSegments[1] },
+        { &flash, &flashSegments[2] },
+    });
+    EXPECT_EQ((busSegment_t *)BUS_SPI_FREE, bus.curSegment);
+    EXPECT_EQ(NULL, bus.preemptDev);
+}
+
+TEST(BusSpiQueueTest, TestNoPreemptWithChipSelectAsserted)
+{
+    busSegment_t flashSegments[4], gyroSegments[2];
+
+    initBus();
+    // status poll, then a read command followed by its data
+    initSegments(flashSegments, 3);
+    flashSegments[1].negateCS = false;
+    initSegments(gyroSegments, 1);
+
+    sequence(&flash, flashSegments);
+    completeSegment();
+    sequence(&gyro, gyroSegments);
+    completeAll();
+
+    expectTransfers({
+        { &flash, &flashSegments[0] },
+        { &flash, &flashSegments[1] },
+        { &flash, &flashSegments[2] },
+        { &gyro, &gyroSegments[0] },
+    });
+}
+
+TEST(BusSpiQueueTest, TestPreemptAheadOfQueue)
+{
+    busSegment_t flashSegments[2], baroSegments[2], gyroSegments[2];
+
+    initBus();
+    initSegments(flashSegments, 1);
+    initSegments(baroSegments, 1);
+    initSegments(gyroSegments, 1);
+
+    // with nothing to interrupt the gyro goes ahead of the queued transfers
+    sequence(&flash, flashSegments);
+    sequence(&baro, baroSegments);
+    sequence(&gyro, gyroSegments);
+    completeAll();
+
+    expectTransfers({ { &flash, &flashSegments[0] }, { &gyro, &gyroSegments[0] }, { &baro, &baroSegments[0] } });
+}
+
+TEST(BusSpiQueueTest, TestSecondHighPriorityQueued)
+{
+    busSegment_t osdSegments[3], gyroSegments[2], gyroSegments2[2];
+
+    initBus();
+    initSegments(osdSegments, 2);
+    initSegments(gyroSegments, 1);
+    initSegments(gyroSegments2, 1);
+
+    // only one transfer is held aside, the next is queued behind the transfer in progress
+    sequence(&osd, osdSegments);
+    sequence(&gyro, gyroSegments);
+    sequence(&gyro, gyroSegments2);
+    completeAll();
+
+    expectTransfers({
+        { &osd, &osdSegments[0] },
+        { &gyro, &gyroSegments[0] },
+        { &osd, &osdSegments[1] },
+        { &gyro, &gyroSegments2[0] },
+    });
+}
+
+TEST(BusSpiQueueTest, TestDuplicateAborted)
+{
+    busSegment_t baroSegments[2], osdSegments[2], gyroSegments[2];
+
+    initBus();
+    initSegments(baroSegments, 1);
+    initSegments(osdSegments, 1);
+    initSegments(gyroSegments, 1);
+
+    sequence(&baro, baroSegments);
+    sequence(&osd, osdSegments);
+    sequence(&gyro, gyroSegments);
+
+    // queueing a list already in progress, queued or held aside is ignored
+    sequence(&baro, baroSegments);
+    sequence(&osd, osdSegments);
+    sequence(&gyro, gyroSegments);
+    completeAll();
+
+    expectTransfers({ { &baro, &baroSegments[0] }, { &gyro, &gyroSegments[0] }, { &osd, &osdSegments[0] } });
+}
+
+TEST(BusSpiQueueTest, TestInsertKeepsChipSelectAsserted)
+{
+    busSegment_t osdSegments[2], continuation[2], baroSegments[2], gyroSegments[2];
+
+    initBus();
+    initSegments(osdSegments, 1, true);
+    initSegments(continuation, 1);
+    initSegments(baroSegments, 1);
+    initSegments(gyroSegments, 1);
+
+    // a transfer ending with chip select asserted is continued by the one queued after it
+    sequence(&osd, osdSegments);
+    sequence(&osd, continuation);
+    sequence(&baro, baroSegments);
+    sequence(&gyro, gyroSegments);
+    completeAll();
+
+    expectTransfers({
+        { &osd, &osdSegments[0] },
+        { &osd, &continuation[0] },
+        { &gyro, &gyroSegments[0] },
+        { &baro, &baroSegments[0] },
+    });
+}
+
+TEST(BusSpiQueueTest, TestPreemptAfterChipSelectHeld)
+{
+    busSegment_t osdSegments[3], gyroSegments[2];
+
+    initBus();
+    initSegments(osdSegments, 2, true);
+    osdSegments[0].negateCS = false;
+    initSegments(gyroSegments, 1);
+
+    // a list ending with chip select asserted and nothing linked after it still hands over to the held transfer
+    sequence(&osd, osdSegments);
+    sequence(&gyro, gyroSegments);
+    completeSegment();
+    completeSegment();
+
+    EXPECT_EQ(&gyro, busDev);
+    EXPECT_EQ(gyroSegments, bus.curSegment);
+    EXPECT_EQ(NULL, bus.preemptDev);
+
+    completeAll();
+
+    expectTransfers({ { &osd, &osdSegments[0] }, { &osd, &osdSegments[1] }, { &gyro, &gyroSegments[0] } });
+}
+
+TEST(BusSpiQueueTest, TestTransferLimit)
+{
+    // 8MHz clocks out 100 bytes in SPI_LOW_PRIORITY_TRANSFER_US
+    const uint32_t clockHz = 8000000;
+    const uint32_t limit = clockHz / 8 / (1000000 / SPI_LOW_PRIORITY_TRANSFER_US);
+
+    initBus();
+
+    // a low priority device alone on the bus is not limited
+    spiQueueRegisterPriority(&bus, osd.priority);
+    EXPECT_EQ(1000U, spiQueueTransferLimit(&osd, clockHz, 1000));
+
+    // nor once another low priority device shares it
+    spiQueueRegisterPriority(&bus, flash.priority);
+    EXPECT_EQ(1000U, spiQueueTransferLimit(&osd, clockHz, 1000));
+
+    // a normal priority device is waited for no longer than SPI_LOW_PRIORITY_TRANSFER_US
+    spiQueueRegisterPriority(&bus, baro.priority);
+    EXPECT_EQ(limit, spiQueueTransferLimit(&osd, clockHz, 1000));
+    EXPECT_EQ(50U, spiQueueTransferLimit(&osd, clockHz, 50));
+    EXPECT_EQ(1000U, spiQueueTransferLimit(&baro, clockHz, 1000));
+
+    // and the gyro limits the baro in turn
+    spiQueueRegisterPriority(&bus, gyro.priority);
+    EXPECT_EQ(limit, spiQueueTransferLimit(&baro, clockHz, 1000));
+    EXPECT_EQ(1000U, spiQueueTransferLimit(&gyro, clockHz, 1000));
+}
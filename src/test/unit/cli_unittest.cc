@@ -60,15 +60,21 @@ extern "C" {
     #include "sensors/gyro.h"
 
     void cliSet(const char *cmdName, char *cmdline);
+    void cliDefaults(const char *cmdName, char *cmdline);
     int cliGetSettingIndex(char *name, uint8_t length);
     void *cliGetValuePointer(const clivalue_t *value);
     
+    // deliberately not in name order and not all lower case, cliGetSettingIndex() goes through valueTableNameIndex
     const clivalue_t valueTable[] = {
-        { .name = "array_unit_test",   .type = VAR_INT8  | MODE_ARRAY  | MASTER_VALUE, .config = { .array = { .length = 3}},                     .pgn = PG_RESERVED_FOR_TESTING_1, .offset = 0 },
-        { .name = "str_unit_test",     .type = VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 0, 16, 0 }},                      .pgn = PG_RESERVED_FOR_TESTING_1, .offset = 0 },
         { .name = "wos_unit_test",     .type = VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 0, 16, STRING_FLAGS_WRITEONCE }}, .pgn = PG_RESERVED_FOR_TESTING_1, .offset = 0 },
+        { .name = "Str_Unit_Test",     .type = VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 0, 16, 0 }},                      .pgn = PG_RESERVED_FOR_TESTING_1, .offset = 0 },
+        { .name = "array_unit_test",   .type = VAR_INT8  | MODE_ARRAY  | MASTER_VALUE, .config = { .array = { .length = 3}},                     .pgn = PG_RESERVED_FOR_TESTING_1, .offset = 0 },
+        { .name = "str_unit",          .type = VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 0, 16, 0 }},                      .pgn = PG_RESERVED_FOR_TESTING_1, .offset = 0 },
+        { .name = "str_unitZ",         .type = VAR_UINT8 | MODE_STRING | MASTER_VALUE, .config = { .string = { 0, 16, 0 }},                      .pgn = PG_RESERVED_FOR_TESTING_1, .offset = 0 },
     };
     const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
+    // what make_settings_index.sh generates for the table above, names compare as lower case so "str_unitz" follows "str_unit_test"
+    const uint16_t valueTableNameIndex[] = { 2, 3, 1, 4, 0 };
     const lookupTableEntry_t lookupTables[] = {};
     const char * const lookupTableOsdDisplayPortDevice[] = {};
     const char * const buildKey = NULL;
@@ -105,6 +111,28 @@ extern "C" {
 
 const bool PRINT_TEST_DATA = false;
 
+TEST(CLIUnittest, TestCliGetSettingIndex)
+{
+    EXPECT_EQ(2, cliGetSettingIndex((char *)"array_unit_test", 15));
+    EXPECT_EQ(1, cliGetSettingIndex((char *)"STR_UNIT_TEST", 13));
+    EXPECT_EQ(1, cliGetSettingIndex((char *)"str_unit_test", 13));
+    EXPECT_EQ(3, cliGetSettingIndex((char *)"str_unit", 8));
+    EXPECT_EQ(4, cliGetSettingIndex((char *)"STR_UNITZ", 9));
+    EXPECT_EQ(0, cliGetSettingIndex((char *)"wos_unit_test = 1", 13));
+
+    // every entry is found through the index
+    for (unsigned i = 0; i < valueTableEntryCount; i++) {
+        EXPECT_EQ(i, cliGetSettingIndex((char *)valueTable[i].name, strlen(valueTable[i].name)));
+    }
+
+    // only exact matches are accepted
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"str_uni", 7));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"str_unit_test_x", 15));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"str_unit_", 9));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"aaa", 3));
+    EXPECT_EQ(valueTableEntryCount, cliGetSettingIndex((char *)"zzz", 3));
+}
+
 TEST(CLIUnittest, TestCliSetArray)
 {
     char *str = (char *)"array_unit_test    =   123,  -3  , 1";
@@ -205,6 +233,23 @@ TEST(CLIUnittest, TestCliSetStringWriteOnce)
     EXPECT_EQ(0,   data[6]);
 }
 
+TEST(CLIUnittest, TestCliDefaultsGroupTargetOverride)
+{
+    // the target configuration names the craft
+    pgResetAll();
+    strcpy(pilotConfigMutable()->craftName, "TARGET");
+    EXPECT_TRUE(pgDefaultsCaptureOverrides());
+
+    strcpy(pilotConfigMutable()->craftName, "MINE");
+    EXPECT_STREQ("TARGET", ((const pilotConfig_t *)pgDefaults(pgFind(PG_PILOT_CONFIG)))->craftName);
+
+    char cmdline[32];
+    snprintf(cmdline, sizeof(cmdline), "nosave group_id %d", PG_PILOT_CONFIG);
+    cliDefaults("defaults", cmdline);
+
+    EXPECT_STREQ("TARGET", pilotConfig()->craftName);
+}
+
 // STUBS
 extern "C" {
 
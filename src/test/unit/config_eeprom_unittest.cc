@@ -0,0 +1,325 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "config/config_eeprom.h"
+    #include "config/config_streamer.h"
+
+    #include "drivers/system.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    typedef struct testConfigA_s {
+        uint8_t values[40];
+    } testConfigA_t;
+
+    typedef struct testConfigB_s {
+        uint32_t value;
+    } testConfigB_t;
+
+    PG_DECLARE(testConfigA_t, testConfigA);
+    PG_DECLARE(testConfigB_t, testConfigB);
+
+    PG_REGISTER(testConfigA_t, testConfigA, PG_RESERVED_FOR_TESTING_1, 0);
+    PG_REGISTER_WITH_RESET_TEMPLATE(testConfigB_t, testConfigB, PG_RESERVED_FOR_TESTING_2, 0);
+    PG_RESET_TEMPLATE(testConfigB_t, testConfigB,
+        .value = 1234,
+    );
+
+    // page aligned, so page boundaries in the config area are the ones of the flash
+    __attribute__((aligned(FLASH_PAGE_SIZE))) uint8_t eepromData[EEPROM_SIZE];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// header, two records, footer and CRC
+#define SAVED_COPY_SIZE     (4 + 6 + sizeof(testConfigA_t) + 6 + sizeof(testConfigB_t) + 2 + 2)
+// generation, record and CRC, padded to the write size
+#define LOG_ENTRY_SIZE(pgSize) ((2 + 6 + (pgSize) + 2 + CONFIG_STREAMER_BUFFER_SIZE - 1) / CONFIG_STREAMER_BUFFER_SIZE * CONFIG_STREAMER_BUFFER_SIZE)
+
+static int writeBudget;     // words written before the power fails, -1 for no failure
+static bool failed;
+
+static void eraseFlash(void)
+{
+    memset(eepromData, 0xFF, sizeof(eepromData));
+    writeBudget = -1;
+    failed = false;
+}
+
+// power cycle, everything in RAM is lost and the config is loaded again
+static void reboot(void)
+{
+    writeBudget = -1;
+    memset(testConfigAMutable(), 0x55, sizeof(testConfigA_t));
+    memset(testConfigBMutable(), 0x55, sizeof(testConfigB_t));
+
+    ASSERT_TRUE(isEEPROMVersionValid());
+    ASSERT_TRUE(isEEPROMStructureValid());
+    loadEEPROM();
+}
+
+static uint16_t generation(void)
+{
+    uint16_t generation;
+    memcpy(&generation, &eepromData[2], sizeof(generation));
+    return generation;
+}
+
+static void initConfig(void)
+{
+    eraseFlash();
+    pgResetAll();
+    writeConfigToEEPROM();
+    reboot();
+    EXPECT_EQ(SAVED_COPY_SIZE, getEEPROMConfigSize());
+}
+
+TEST(ConfigEepromTest, TestAppend)
+{
+    initConfig();
+    const std::vector<uint8_t> savedCopy(eepromData, eepromData + SAVED_COPY_SIZE);
+
+    testConfigAMutable()->values[0] = 1;
+    writeConfigToEEPROM();
+
+    // only the changed PG is appended, the saved copy is left alone
+    EXPECT_EQ(SAVED_COPY_SIZE + LOG_ENTRY_SIZE(sizeof(testConfigA_t)), getEEPROMConfigSize());
+    EXPECT_EQ(0, memcmp(savedCopy.data(), eepromData, SAVED_COPY_SIZE));
+
+    // saving again without changes writes nothing
+    writeConfigToEEPROM();
+    EXPECT_EQ(SAVED_COPY_SIZE + LOG_ENTRY_SIZE(sizeof(testConfigA_t)), getEEPROMConfigSize());
+
+    reboot();
+    EXPECT_EQ(1, testConfigA()->values[0]);
+    EXPECT_EQ(0, testConfigA()->values[1]);
+    EXPECT_EQ(1234U, testConfigB()->value);
+}
+
+TEST(ConfigEepromTest, TestReplayLatestRecord)
+{
+    initConfig();
+
+    testConfigAMutable()->values[0] = 1;
+    writeConfigToEEPROM();
+    testConfigBMutable()->value = 42;
+    writeConfigToEEPROM();
+    testConfigAMutable()->values[0] = 2;
+    testConfigAMutable()->values[39] = 3;
+    writeConfigToEEPROM();
+
+    reboot();
+    EXPECT_EQ(SAVED_COPY_SIZE + 2 * LOG_ENTRY_SIZE(sizeof(testConfigA_t)) + LOG_ENTRY_SIZE(sizeof(testConfigB_t)), getEEPROMConfigSize());
+    EXPECT_EQ(2, testConfigA()->values[0]);
+    EXPECT_EQ(3, testConfigA()->values[39]);
+    EXPECT_EQ(42U, testConfigB()->value);
+}
+
+TEST(ConfigEepromTest, TestLogAcrossPageBoundary)
+{
+    initConfig();
+
+    // the streamer erases each page as the log reaches it
+    int value = 0;
+    while (getEEPROMConfigSize() < 2 * FLASH_PAGE_SIZE) {
+        testConfigAMutable()->values[0] = ++value;
+        writeConfigToEEPROM();
+    }
+
+    reboot();
+    EXPECT_GT(getEEPROMConfigSize(), 2 * FLASH_PAGE_SIZE);
+    EXPECT_EQ(value, testConfigA()->values[0]);
+    EXPECT_EQ(1234U, testConfigB()->value);
+}
+
+TEST(ConfigEepromTest, TestCompaction)
+{
+    initConfig();
+    const uint16_t firstGeneration = generation();
+    testConfigBMutable()->value = 42;
+    writeConfigToEEPROM();
+
+    // fill the log until it no longer fits and the config is rewritten
+    int value = 0;
+    uint16_t lastSize;
+    do {
+        lastSize = getEEPROMConfigSize();
+        testConfigAMutable()->values[0] = ++value;
+        writeConfigToEEPROM();
+    } while (getEEPROMConfigSize() > lastSize);
+
+    EXPECT_GT(lastSize + LOG_ENTRY_SIZE(sizeof(testConfigA_t)), EEPROM_SIZE);
+    EXPECT_EQ(SAVED_COPY_SIZE, getEEPROMConfigSize());
+    EXPECT_EQ(firstGeneration + 1, generation());
+
+    reboot();
+    EXPECT_EQ(value, testConfigA()->values[0]);
+    EXPECT_EQ(42U, testConfigB()->value);
+
+    // the log starts again after the new copy
+    testConfigAMutable()->values[1] = 7;
+    writeConfigToEEPROM();
+    reboot();
+    EXPECT_EQ(SAVED_COPY_SIZE + LOG_ENTRY_SIZE(sizeof(testConfigA_t)), getEEPROMConfigSize());
+    EXPECT_EQ(value, testConfigA()->values[0]);
+    EXPECT_EQ(7, testConfigA()->values[1]);
+}
+
+TEST(ConfigEepromTest, TestTornWriteRecovery)
+{
+    initConfig();
+    testConfigAMutable()->values[0] = 1;
+    writeConfigToEEPROM();
+    const uint16_t generationBefore = generation();
+
+    // the power fails half way through appending the next record
+    testConfigAMutable()->values[0] = 2;
+    writeBudget = LOG_ENTRY_SIZE(sizeof(testConfigA_t)) / CONFIG_STREAMER_BUFFER_SIZE / 2;
+    writeConfigToEEPROM();
+    EXPECT_TRUE(failed);
+
+    // the partial record is ignored, the previous one still applies
+    reboot();
+    EXPECT_EQ(SAVED_COPY_SIZE + LOG_ENTRY_SIZE(sizeof(testConfigA_t)), getEEPROMConfigSize());
+    EXPECT_EQ(1, testConfigA()->values[0]);
+
+    // nothing can be appended on top of the partial record, so the next save compacts
+    testConfigAMutable()->values[0] = 3;
+    writeConfigToEEPROM();
+    EXPECT_EQ(SAVED_COPY_SIZE, getEEPROMConfigSize());
+    EXPECT_EQ(generationBefore + 1, generation());
+
+    reboot();
+    EXPECT_EQ(3, testConfigA()->values[0]);
+    EXPECT_EQ(1234U, testConfigB()->value);
+}
+
+TEST(ConfigEepromTest, TestStaleRecordNotReplayed)
+{
+    initConfig();
+    const std::vector<uint8_t> savedCopy(eepromData, eepromData + SAVED_COPY_SIZE);
+
+    testConfigAMutable()->values[0] = 1;
+    writeConfigToEEPROM();
+    const std::vector<uint8_t> staleLog(eepromData + SAVED_COPY_SIZE, eepromData + getEEPROMConfigSize());
+
+    // the config goes back to what the saved copy holds and a rewrite is forced
+    testConfigAMutable()->values[0] = 0;
+    eepromData[getEEPROMConfigSize()] = 0;
+    writeConfigToEEPROM();
+    EXPECT_EQ(SAVED_COPY_SIZE, getEEPROMConfigSize());
+
+    // only the generation tells the new copy from the old one
+    EXPECT_NE(0, memcmp(savedCopy.data(), eepromData, SAVED_COPY_SIZE));
+    EXPECT_EQ(0, memcmp(savedCopy.data() + 4, eepromData + 4, SAVED_COPY_SIZE - 4 - 2));
+
+    // the log of the old copy survives next to the new one, it must not be replayed
+    memcpy(eepromData + SAVED_COPY_SIZE, staleLog.data(), staleLog.size());
+    reboot();
+    EXPECT_EQ(SAVED_COPY_SIZE, getEEPROMConfigSize());
+    EXPECT_EQ(0, testConfigA()->values[0]);
+}
+
+// STUBS
+
+extern "C" {
+    // page erased embedded flash, a page is erased when writing reaches its start
+    void config_streamer_init(config_streamer_t *c)
+    {
+        memset(c, 0, sizeof(*c));
+    }
+
+    void config_streamer_start(config_streamer_t *c, uintptr_t base, int size)
+    {
+        c->address = base;
+        c->size = size;
+        c->unlocked = true;
+    }
+
+    static void writeWord(config_streamer_t *c)
+    {
+        uint8_t *p = (uint8_t *)c->address;
+        EXPECT_GE(p, eepromData);
+        EXPECT_LE(p + CONFIG_STREAMER_BUFFER_SIZE, ARRAYEND(eepromData));
+
+        if (writeBudget == 0) {
+            failed = true;
+        } else {
+            if (writeBudget > 0) {
+                writeBudget--;
+            }
+            if (c->address % FLASH_PAGE_SIZE == 0) {
+                memset(p, 0xFF, FLASH_PAGE_SIZE);
+            }
+            // programming can only clear bits
+            for (int i = 0; i < CONFIG_STREAMER_BUFFER_SIZE; i++) {
+                p[i] &= c->buffer.b[i];
+            }
+        }
+        c->address += CONFIG_STREAMER_BUFFER_SIZE;
+    }
+
+    int config_streamer_write(config_streamer_t *c, const uint8_t *p, uint32_t size)
+    {
+        for (uint32_t i = 0; i < size; i++) {
+            c->buffer.b[c->at++] = p[i];
+            if (c->at == sizeof(c->buffer)) {
+                writeWord(c);
+                c->at = 0;
+            }
+        }
+        return c->err;
+    }
+
+    int config_streamer_flush(config_streamer_t *c)
+    {
+        if (c->at != 0) {
+            memset(c->buffer.b + c->at, 0, sizeof(c->buffer) - c->at);
+            writeWord(c);
+            c->at = 0;
+        }
+        return c->err;
+    }
+
+    int config_streamer_finish(config_streamer_t *c)
+    {
+        c->unlocked = false;
+        return c->err;
+    }
+
+    void failureMode(failureMode_e mode)
+    {
+        UNUSED(mode);
+        FAIL();
+    }
+}
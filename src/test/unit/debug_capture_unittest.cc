@@ -0,0 +1,257 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+    #include "build/debug_capture.h"
+
+    #include "pg/pg.h"
+    #include "pg/debug_capture.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static void captureInit(uint8_t mode1, uint8_t divider1, uint8_t mode2, uint8_t divider2)
+{
+    PG_RESET(debugCaptureConfig);
+    debugCaptureConfigMutable()->mode[0] = mode1;
+    debugCaptureConfigMutable()->divider[0] = divider1;
+    debugCaptureConfigMutable()->mode[1] = mode2;
+    debugCaptureConfigMutable()->divider[1] = divider2;
+
+    debugMode = DEBUG_NONE;
+    memset(debug, 0, sizeof(debug));
+    debugCaptureInit();
+}
+
+// Reads back the encoding described in debug_capture.c
+typedef struct decodedRecord_s {
+    uint8_t mode;
+    uint32_t timeUs;
+    uint32_t dropped;
+    uint8_t writtenMask;
+    uint8_t floatMask;
+    int32_t value[DEBUG16_VALUE_COUNT];
+    float floatValue[DEBUG16_VALUE_COUNT];
+} decodedRecord_t;
+
+static uint32_t readUnsignedVB(const uint8_t **p)
+{
+    uint32_t value = 0;
+    for (int shift = 0; ; shift += 7) {
+        const uint8_t byte = *(*p)++;
+        value |= (uint32_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+
+static bool decodeNext(decodedRecord_t *record)
+{
+    uint8_t buf[DEBUG_CAPTURE_RECORD_MAX_BYTES];
+    const unsigned length = debugCaptureEncodeNext(buf);
+    if (!length) {
+        return false;
+    }
+
+    memset(record, 0, sizeof(*record));
+    const uint8_t *p = buf;
+    record->mode = *p++;
+    record->timeUs = readUnsignedVB(&p);
+    record->dropped = readUnsignedVB(&p);
+    record->writtenMask = *p++;
+    record->floatMask = *p++;
+    for (int index = 0; index < DEBUG16_VALUE_COUNT; index++) {
+        if (!(record->writtenMask & (1 << index))) {
+            continue;
+        }
+        if (record->floatMask & (1 << index)) {
+            uint32_t bits = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+            memcpy(&record->floatValue[index], &bits, sizeof(float));
+            p += 4;
+        } else {
+            const uint32_t zigzag = readUnsignedVB(&p);
+            record->value[index] = (zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+        }
+    }
+
+    EXPECT_EQ(length, (unsigned)(p - buf));
+    return true;
+}
+
+TEST(DebugCaptureUnittest, TestSlots)
+{
+    // a mode asked for twice is captured by the first slot only
+    captureInit(DEBUG_GYRO_SCALED, 1, DEBUG_PIDLOOP, 1);
+    debugCaptureConfigMutable()->mode[2] = DEBUG_GYRO_SCALED;
+    debugCaptureInit();
+
+    EXPECT_EQ(1, debugCaptureSlot[DEBUG_GYRO_SCALED]);
+    EXPECT_EQ(2, debugCaptureSlot[DEBUG_PIDLOOP]);
+    EXPECT_EQ(0, debugCaptureSlot[DEBUG_NONE]);
+    EXPECT_EQ(0, debugCaptureSlot[DEBUG_BATTERY]);
+
+    EXPECT_TRUE(DEBUG_MODE_ACTIVE(DEBUG_PIDLOOP));
+    EXPECT_FALSE(DEBUG_MODE_ACTIVE(DEBUG_BATTERY));
+    debugMode = DEBUG_BATTERY;
+    EXPECT_TRUE(DEBUG_MODE_ACTIVE(DEBUG_BATTERY));
+}
+
+TEST(DebugCaptureUnittest, TestLegacyDebugAlongside)
+{
+    captureInit(DEBUG_GYRO_SCALED, 1, DEBUG_PIDLOOP, 1);
+    debugMode = DEBUG_PIDLOOP;
+
+    // debug[] keeps showing debug_mode, clipped to 16 bits, while the capture keeps the full value
+    int32_t largeValue = 100000;
+    DEBUG_SET(DEBUG_PIDLOOP, 0, largeValue);
+    DEBUG_SET_FLOAT(DEBUG_GYRO_SCALED, 1, 12.5f);
+    DEBUG_SET(DEBUG_GYRO_SCALED, 2, -3);
+    DEBUG_SET(DEBUG_BATTERY, 3, 7);
+
+    EXPECT_EQ((int16_t)largeValue, debug[0]);
+    EXPECT_EQ(0, debug[1]);
+    EXPECT_EQ(0, debug[2]);
+    EXPECT_EQ(0, debug[3]);
+
+    debugCaptureUpdate(1000);
+
+    decodedRecord_t record;
+    ASSERT_TRUE(decodeNext(&record));
+    EXPECT_EQ(DEBUG_GYRO_SCALED, record.mode);
+    EXPECT_EQ(1000u, record.timeUs);
+    EXPECT_EQ(0x06, record.writtenMask);
+    EXPECT_EQ(0x02, record.floatMask);
+    EXPECT_FLOAT_EQ(12.5f, record.floatValue[1]);
+    EXPECT_EQ(-3, record.value[2]);
+
+    ASSERT_TRUE(decodeNext(&record));
+    EXPECT_EQ(DEBUG_PIDLOOP, record.mode);
+    EXPECT_EQ(0x01, record.writtenMask);
+    EXPECT_EQ(0x00, record.floatMask);
+    EXPECT_EQ(largeValue, record.value[0]);
+
+    EXPECT_FALSE(decodeNext(&record));
+
+    // debug_mode floats are rounded into debug[]
+    debugMode = DEBUG_GYRO_SCALED;
+    DEBUG_SET_FLOAT(DEBUG_GYRO_SCALED, 1, 12.6f);
+    EXPECT_EQ(13, debug[1]);
+}
+
+TEST(DebugCaptureUnittest, TestSingleEvaluation)
+{
+    captureInit(DEBUG_GYRO_SCALED, 1, DEBUG_PIDLOOP, 1);
+    debugMode = DEBUG_GYRO_SCALED;
+
+    // shown and captured, each argument is still evaluated once
+    int counter = 0;
+    int index = 0;
+    DEBUG_SET(DEBUG_GYRO_SCALED, index++, ++counter);
+    DEBUG_SET_FLOAT(DEBUG_GYRO_SCALED, index++, ++counter);
+    EXPECT_EQ(2, counter);
+    EXPECT_EQ(2, index);
+    EXPECT_EQ(1, debug[0]);
+    EXPECT_EQ(2, debug[1]);
+
+    // neither shown nor captured, nothing is evaluated
+    DEBUG_SET(DEBUG_BATTERY, index++, ++counter);
+    DEBUG_SET_FLOAT(DEBUG_BATTERY, index++, ++counter);
+    EXPECT_EQ(2, counter);
+    EXPECT_EQ(2, index);
+
+    debugCaptureUpdate(1000);
+
+    decodedRecord_t record;
+    ASSERT_TRUE(decodeNext(&record));
+    EXPECT_EQ(DEBUG_GYRO_SCALED, record.mode);
+    EXPECT_EQ(0x03, record.writtenMask);
+    EXPECT_EQ(1, record.value[0]);
+    EXPECT_FLOAT_EQ(2.0f, record.floatValue[1]);
+    EXPECT_FALSE(decodeNext(&record));
+}
+
+TEST(DebugCaptureUnittest, TestDividers)
+{
+    captureInit(DEBUG_GYRO_SCALED, 1, DEBUG_PIDLOOP, 3);
+
+    // nothing is recorded for a slot until one of its channels is written
+    debugCaptureUpdate(0);
+    EXPECT_EQ(NULL, debugCapturePeek());
+
+    DEBUG_SET(DEBUG_GYRO_SCALED, 0, 1);
+    DEBUG_SET(DEBUG_PIDLOOP, 0, 2);
+
+    int recorded[2] = { 0, 0 };
+    for (int loop = 1; loop <= 12; loop++) {
+        debugCaptureUpdate(loop * 125);
+        decodedRecord_t record;
+        while (decodeNext(&record)) {
+            recorded[record.mode == DEBUG_PIDLOOP]++;
+            EXPECT_EQ(loop * 125u, record.timeUs);
+        }
+    }
+
+    EXPECT_EQ(12, recorded[0]);
+    EXPECT_EQ(4, recorded[1]);
+}
+
+TEST(DebugCaptureUnittest, TestRingFull)
+{
+    captureInit(DEBUG_GYRO_SCALED, 1, DEBUG_NONE, 1);
+    int32_t smallestValue = INT32_MIN;
+    DEBUG_SET(DEBUG_GYRO_SCALED, 7, smallestValue);
+
+    for (int loop = 0; loop < DEBUG_CAPTURE_RING_SIZE + 5; loop++) {
+        debugCaptureUpdate(loop);
+    }
+
+    // the oldest records are kept, the first one taken out reports those dropped
+    decodedRecord_t record;
+    ASSERT_TRUE(decodeNext(&record));
+    EXPECT_EQ(0u, record.timeUs);
+    EXPECT_EQ(5u, record.dropped);
+    EXPECT_EQ(INT32_MIN, record.value[7]);
+
+    ASSERT_TRUE(decodeNext(&record));
+    EXPECT_EQ(1u, record.timeUs);
+    EXPECT_EQ(0u, record.dropped);
+
+    debugCaptureReset();
+    EXPECT_FALSE(decodeNext(&record));
+}
+
+// STUBS
+
+extern "C" {
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+}
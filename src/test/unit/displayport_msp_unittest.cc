@@ -0,0 +1,266 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/display.h"
+    #include "drivers/osd.h"
+
+    #include "io/displayport_msp.h"
+
+    #include "msp/msp_protocol.h"
+    #include "msp/msp_serial.h"
+
+    #include "osd/osd.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/vcd.h"
+
+    PG_REGISTER(osdConfig_t, osdConfig, PG_OSD_CONFIG, 0);
+
+    static uint32_t simulationTime;
+    static uint32_t simulationTxBytesFree;
+    static serialPortIdentifier_e txBytesFreePort;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+typedef std::vector<uint8_t> frame_t;
+static std::vector<frame_t> frames;
+
+static displayPort_t *initDisplay(serialPortIdentifier_e serialPort = SERIAL_PORT_USART1)
+{
+    vcdProfileMutable()->video_system = VIDEO_SYSTEM_HD;
+    osdConfigMutable()->canvas_cols = OSD_HD_COLS;
+    osdConfigMutable()->canvas_rows = OSD_HD_ROWS;
+    simulationTime = 0;
+    simulationTxBytesFree = UINT32_MAX;
+    txBytesFreePort = SERIAL_PORT_NONE;
+
+    displayPortMspSetSerial(serialPort);
+    displayPort_t *displayPort = displayPortMspInit();
+    frames.clear();
+
+    return displayPort;
+}
+
+static int countSubcommand(uint8_t subcmd)
+{
+    int count = 0;
+    for (const frame_t &frame : frames) {
+        count += frame[0] == subcmd;
+    }
+    return count;
+}
+
+static const frame_t *findWrite(uint8_t row, uint8_t col)
+{
+    for (const frame_t &frame : frames) {
+        if (frame[0] == MSP_DP_WRITE_STRING && frame[1] == row && frame[2] == col) {
+            return &frame;
+        }
+    }
+    return NULL;
+}
+
+static std::string writeText(const frame_t *frame)
+{
+    return std::string(frame->begin() + 4, frame->end());
+}
+
+static void drawFrame(displayPort_t *displayPort, void (*draw)(displayPort_t *))
+{
+    frames.clear();
+    displayClearScreen(displayPort, DISPLAY_CLEAR_NONE);
+    draw(displayPort);
+    while (displayDrawScreen(displayPort)) {
+    }
+}
+
+static void drawHello(displayPort_t *displayPort)
+{
+    displayWrite(displayPort, 2, 3, DISPLAYPORT_SEVERITY_NORMAL, "HELLO");
+}
+
+TEST(DisplayPortMspTest, TestOnlyChangesAreSent)
+{
+    displayPort_t *displayPort = initDisplay();
+
+    drawFrame(displayPort, drawHello);
+    EXPECT_EQ(1, countSubcommand(MSP_DP_WRITE_STRING));
+    ASSERT_NE(nullptr, findWrite(3, 2));
+    EXPECT_EQ("HELLO", writeText(findWrite(3, 2)));
+    EXPECT_EQ(1, countSubcommand(MSP_DP_DRAW_SCREEN));
+
+    // an identical frame only needs the draw
+    drawFrame(displayPort, drawHello);
+    EXPECT_EQ(0, countSubcommand(MSP_DP_WRITE_STRING));
+    EXPECT_EQ(0, countSubcommand(MSP_DP_CLEAR_SCREEN));
+    EXPECT_EQ(1, countSubcommand(MSP_DP_DRAW_SCREEN));
+
+    // text that is no longer drawn is blanked
+    drawFrame(displayPort, [](displayPort_t *displayPort) {
+        displayWrite(displayPort, 2, 3, DISPLAYPORT_SEVERITY_NORMAL, "HE");
+    });
+    EXPECT_EQ(1, countSubcommand(MSP_DP_WRITE_STRING));
+    ASSERT_NE(nullptr, findWrite(3, 4));
+    EXPECT_EQ("   ", writeText(findWrite(3, 4)));
+}
+
+TEST(DisplayPortMspTest, TestNoCanvasWithoutSerialPort)
+{
+    displayPort_t *displayPort = initDisplay(SERIAL_PORT_NONE);
+
+    // without a port the canvas memory is left alone and writes go straight out
+    osdDeviceBuffer[0] = 0x12345678;
+    frames.clear();
+    displayClearScreen(displayPort, DISPLAY_CLEAR_NONE);
+    displayWrite(displayPort, 2, 3, DISPLAYPORT_SEVERITY_NORMAL, "HELLO");
+    EXPECT_EQ(2, (int)frames.size());
+    EXPECT_EQ(1, countSubcommand(MSP_DP_CLEAR_SCREEN));
+    ASSERT_NE(nullptr, findWrite(3, 2));
+    EXPECT_EQ("HELLO", writeText(findWrite(3, 2)));
+
+    displayDrawScreen(displayPort);
+    EXPECT_EQ(1, countSubcommand(MSP_DP_DRAW_SCREEN));
+    EXPECT_EQ(0x12345678U, osdDeviceBuffer[0]);
+}
+
+TEST(DisplayPortMspTest, TestChangesAreMerged)
+{
+    displayPort_t *displayPort = initDisplay();
+
+    drawFrame(displayPort, [](displayPort_t *displayPort) {
+        displayWrite(displayPort, 0, 0, DISPLAYPORT_SEVERITY_NORMAL, "0123456789");
+        displayWrite(displayPort, 0, 1, DISPLAYPORT_SEVERITY_NORMAL, "0123456789");
+        displayWrite(displayPort, 30, 1, DISPLAYPORT_SEVERITY_NORMAL, "X");
+    });
+
+    // nearby changes become a single write including the unchanged cells between them
+    drawFrame(displayPort, [](displayPort_t *displayPort) {
+        displayWrite(displayPort, 0, 0, DISPLAYPORT_SEVERITY_NORMAL, "0A2345B789");
+        displayWrite(displayPort, 0, 1, DISPLAYPORT_SEVERITY_NORMAL, "C123456789");
+        displayWrite(displayPort, 30, 1, DISPLAYPORT_SEVERITY_NORMAL, "D");
+    });
+    EXPECT_EQ(3, countSubcommand(MSP_DP_WRITE_STRING));
+    ASSERT_NE(nullptr, findWrite(0, 1));
+    EXPECT_EQ("A2345B", writeText(findWrite(0, 1)));
+    ASSERT_NE(nullptr, findWrite(1, 0));
+    EXPECT_EQ("C", writeText(findWrite(1, 0)));
+    ASSERT_NE(nullptr, findWrite(1, 30));
+    EXPECT_EQ("D", writeText(findWrite(1, 30)));
+}
+
+TEST(DisplayPortMspTest, TestPeriodicFullRefresh)
+{
+    displayPort_t *displayPort = initDisplay();
+
+    drawFrame(displayPort, drawHello);
+    simulationTime += 500;
+    drawFrame(displayPort, drawHello);
+    EXPECT_EQ(0, countSubcommand(MSP_DP_CLEAR_SCREEN));
+
+    simulationTime += 600;
+    drawFrame(displayPort, drawHello);
+    EXPECT_EQ(1, countSubcommand(MSP_DP_CLEAR_SCREEN));
+    ASSERT_NE(nullptr, findWrite(3, 2));
+    EXPECT_EQ("HELLO", writeText(findWrite(3, 2)));
+    // the clear comes first
+    EXPECT_EQ(MSP_DP_CLEAR_SCREEN, frames[0][0]);
+}
+
+TEST(DisplayPortMspTest, TestTransferIsSplit)
+{
+    displayPort_t *displayPort = initDisplay();
+
+    displayClearScreen(displayPort, DISPLAY_CLEAR_NONE);
+    for (int row = 0; row < 10; row++) {
+        displayWrite(displayPort, 0, row, DISPLAYPORT_SEVERITY_NORMAL, "ABCDEFGHIJ");
+    }
+
+    frames.clear();
+    simulationTxBytesFree = 50;
+    EXPECT_TRUE(displayDrawScreen(displayPort));
+    EXPECT_EQ(2, countSubcommand(MSP_DP_WRITE_STRING));
+    EXPECT_EQ(0, countSubcommand(MSP_DP_DRAW_SCREEN));
+    // only the space of the displayport's own port counts
+    EXPECT_EQ(SERIAL_PORT_USART1, txBytesFreePort);
+
+    simulationTxBytesFree = UINT32_MAX;
+    EXPECT_FALSE(displayDrawScreen(displayPort));
+    EXPECT_EQ(10, countSubcommand(MSP_DP_WRITE_STRING));
+    EXPECT_EQ(1, countSubcommand(MSP_DP_DRAW_SCREEN));
+}
+
+TEST(DisplayPortMspTest, TestSystemElements)
+{
+    displayPort_t *displayPort = initDisplay();
+
+    drawFrame(displayPort, [](displayPort_t *displayPort) {
+        displaySys(displayPort, 1, 1, DISPLAYPORT_SYS_LQ);
+        drawHello(displayPort);
+    });
+    EXPECT_EQ(1, countSubcommand(MSP_DP_SYS));
+    // sent after the cells, just before the draw
+    EXPECT_EQ(MSP_DP_SYS, frames[frames.size() - 2][0]);
+
+    drawFrame(displayPort, [](displayPort_t *displayPort) {
+        displaySys(displayPort, 1, 1, DISPLAYPORT_SYS_LQ);
+        drawHello(displayPort);
+    });
+    EXPECT_EQ(1, countSubcommand(MSP_DP_SYS));
+    EXPECT_EQ(0, countSubcommand(MSP_DP_CLEAR_SCREEN));
+
+    // a system element can only be removed by clearing the remote display
+    drawFrame(displayPort, drawHello);
+    EXPECT_EQ(0, countSubcommand(MSP_DP_SYS));
+    EXPECT_EQ(1, countSubcommand(MSP_DP_CLEAR_SCREEN));
+    ASSERT_NE(nullptr, findWrite(3, 2));
+}
+
+// STUBS
+
+extern "C" {
+    bool cliMode = false;
+
+    uint32_t millis(void) { return simulationTime; }
+
+    int mspSerialPush(serialPortIdentifier_e, int16_t cmd, uint8_t *data, int datalen, mspDirection_e, mspVersion_e)
+    {
+        EXPECT_EQ(MSP_DISPLAYPORT, cmd);
+        frames.push_back(frame_t(data, data + datalen));
+        return datalen + 6;
+    }
+
+    uint32_t mspSerialTxBytesFree(serialPortIdentifier_e port)
+    {
+        txBytesFreePort = port;
+        return simulationTxBytesFree;
+    }
+}
@@ -0,0 +1,335 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/maths.h"
+
+    #include "drivers/dshot.h"
+    #include "drivers/dshot_bitbang_decode.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Port input buffer as captured by the bitbang driver, with room for the reference decoder reading ahead
+#define PORT_INPUT_COUNT 140
+#define PORT_INPUT_PADDING 4
+
+#define FRAME_START 24
+#define FRAME_BITS 21
+
+typedef enum {
+    CAPTURE_CLEAN,
+    CAPTURE_NOISY,
+    CAPTURE_GLITCHED,
+} captureType_e;
+
+typedef struct capture_s {
+    captureType_e type;
+    uint32_t bit;
+    uint32_t value;
+    uint16_t buffer[PORT_INPUT_COUNT + PORT_INPUT_PADDING];
+} capture_t;
+
+// Bit at a time decoding the word wide decoder replaces, kept as the reference
+#define MIN_VALID_BBSAMPLES ((21 - 2) * 3)
+#define MAX_VALID_BBSAMPLES ((21 + 2) * 3)
+
+static uint32_t referenceDecodeValue(uint32_t value)
+{
+#define iv 0xffffffff
+    value &= 0xfffff;
+    static const uint32_t decode[32] = {
+        iv, iv, iv, iv, iv, iv, iv, iv, iv, 9, 10, 11, iv, 13, 14, 15,
+        iv, iv, 2, 3, iv, 5, 6, 7, iv, 0, 8, 1, iv, 4, 12, iv };
+#undef iv
+
+    uint32_t decodedValue = decode[value & 0x1f];
+    decodedValue |= decode[(value >> 5) & 0x1f] << 4;
+    decodedValue |= decode[(value >> 10) & 0x1f] << 8;
+    decodedValue |= decode[(value >> 15) & 0x1f] << 12;
+
+    uint32_t csum = decodedValue;
+    csum = csum ^ (csum >> 8);
+    csum = csum ^ (csum >> 4);
+
+    if ((csum & 0xf) != 0xf || decodedValue > 0xffff) {
+        return DSHOT_TELEMETRY_INVALID;
+    }
+    return decodedValue >> 4;
+}
+
+static uint32_t referenceDecode(uint16_t buffer[], uint32_t count, uint32_t bit, uint8_t preambleSkip)
+{
+    uint32_t mask = 1 << bit;
+    uint16_t lastValue = 0;
+    uint32_t value = 0;
+
+    uint16_t *p = buffer;
+    uint16_t *endP = p + count - MIN_VALID_BBSAMPLES;
+
+    p += preambleSkip;
+
+    while (p < endP) {
+        if (!(*p++ & mask) || !(*p++ & mask) || !(*p++ & mask) || !(*p++ & mask)) {
+            break;
+        }
+    }
+
+    const uint32_t startMargin = p - buffer;
+
+    if (p >= endP) {
+        return DSHOT_TELEMETRY_NOEDGE;
+    }
+
+    const int remaining = MIN(count - startMargin, (unsigned int)MAX_VALID_BBSAMPLES);
+    uint16_t *oldP = p;
+    uint32_t bits = 0;
+    endP = p + remaining;
+
+    while (endP > p) {
+        if ((*p++ & mask) != lastValue || (*p++ & mask) != lastValue ||
+            (*p++ & mask) != lastValue || (*p++ & mask) != lastValue) {
+            if (endP > p) {
+                const int len = MAX((p - oldP + 1) / 3, 1);
+                bits += len;
+                value <<= len;
+                value |= 1 << (len - 1);
+                oldP = p;
+                lastValue = *(p - 1) & mask;
+            }
+        }
+    }
+
+    if (bits < 18) {
+        return DSHOT_TELEMETRY_NOEDGE;
+    }
+
+    const int nlen = 21 - bits;
+    if (nlen < 0) {
+        return DSHOT_TELEMETRY_NOEDGE;
+    }
+
+    if (nlen > 0) {
+        value <<= nlen;
+        value |= 1 << (nlen - 1);
+    }
+
+    return referenceDecodeValue(value);
+}
+
+static bool telemetryValid(uint32_t value)
+{
+    return value != DSHOT_TELEMETRY_INVALID && value != DSHOT_TELEMETRY_NOEDGE;
+}
+
+// Corpus of port captures, synthesised the way an ESC drives the line and the bitbang driver samples it
+
+static uint32_t gcrFrame(uint32_t value)
+{
+    static const uint8_t gcrEncode[16] = {
+        0x19, 0x1b, 0x12, 0x13, 0x1d, 0x15, 0x16, 0x17, 0x1a, 0x09, 0x0a, 0x0b, 0x1e, 0x0d, 0x0e, 0x0f };
+
+    const uint32_t csum = ~(value ^ (value >> 4) ^ (value >> 8)) & 0xf;
+    const uint32_t packet = (value << 4) | csum;
+
+    uint32_t gcr = 1; // start bit
+    for (int shift = 12; shift >= 0; shift -= 4) {
+        gcr = (gcr << 5) | gcrEncode[(packet >> shift) & 0xf];
+    }
+    return gcr;
+}
+
+static float randomFloat(float min, float max)
+{
+    return min + (max - min) * rand() / (float)RAND_MAX;
+}
+
+static capture_t makeCapture(captureType_e type, uint32_t bit, uint32_t value)
+{
+    capture_t capture;
+    capture.type = type;
+    capture.bit = bit;
+    capture.value = value;
+
+    // ESC clock within 5% and a start position varying by a couple of samples
+    const float samplesPerBit = type == CAPTURE_CLEAN ? 3.0f : 3.0f * randomFloat(0.95f, 1.05f);
+    const float start = FRAME_START + (type == CAPTURE_CLEAN ? 0.0f : randomFloat(-2.0f, 2.0f));
+    const uint32_t gcr = gcrFrame(value);
+
+    for (int i = 0; i < PORT_INPUT_COUNT + PORT_INPUT_PADDING; i++) {
+        // other pins of the port carry unrelated data
+        uint16_t sample = rand() & ~(1 << bit);
+
+        float t = i;
+        if (type != CAPTURE_CLEAN) {
+            t += randomFloat(-0.3f, 0.3f);
+        }
+
+        // the line idles high and every 1 in the GCR stream toggles it
+        int level = 1;
+        const int bitIndex = t < start ? -1 : (int)((t - start) / samplesPerBit);
+        for (int b = 0; b <= MIN(bitIndex, FRAME_BITS - 1); b++) {
+            level ^= (gcr >> (FRAME_BITS - 1 - b)) & 1;
+        }
+        if (bitIndex >= FRAME_BITS) {
+            level = 1;
+        }
+
+        capture.buffer[i] = sample | (level << bit);
+    }
+
+    if (type == CAPTURE_GLITCHED) {
+        const int glitches = 1 + rand() % 3;
+        for (int i = 0; i < glitches; i++) {
+            capture.buffer[FRAME_START - 4 + rand() % (FRAME_BITS * 3 + 8)] ^= 1 << bit;
+        }
+    }
+
+    return capture;
+}
+
+static std::vector<capture_t> makeCorpus(void)
+{
+    std::vector<capture_t> corpus;
+
+    srand(1);
+
+    // a clean capture first so the preamble skip settles on the frame position
+    corpus.push_back(makeCapture(CAPTURE_CLEAN, 0, 0x123));
+
+    for (uint32_t value = 0; value < 0x1000; value += 7) {
+        const uint32_t bit = value % 16;
+        corpus.push_back(makeCapture(CAPTURE_CLEAN, bit, value));
+        corpus.push_back(makeCapture(CAPTURE_NOISY, bit, value));
+        corpus.push_back(makeCapture(CAPTURE_GLITCHED, bit, value));
+    }
+
+    return corpus;
+}
+
+// The decoder skips a learnt preamble and learns it from the first valid frame, the corpus keeps the frame
+// position stable so the learnt value is known
+static uint8_t corpusPreambleSkip(void)
+{
+    return FRAME_START + 1 - 5;
+}
+
+TEST(DshotBitbangDecodeTest, TestCorpus)
+{
+    std::vector<capture_t> corpus = makeCorpus();
+    int decoded[3] = { 0 };
+    int count[3] = { 0 };
+
+    for (size_t i = 0; i < corpus.size(); i++) {
+        capture_t &capture = corpus[i];
+        const uint8_t preambleSkip = i == 0 ? 0 : corpusPreambleSkip();
+
+        const uint32_t reference = referenceDecode(capture.buffer, PORT_INPUT_COUNT, capture.bit, preambleSkip);
+        const uint32_t value = decode_bb(capture.buffer, PORT_INPUT_COUNT, capture.bit);
+
+        count[capture.type]++;
+        decoded[capture.type] += value == capture.value;
+
+        switch (capture.type) {
+        case CAPTURE_CLEAN:
+        case CAPTURE_NOISY:
+            EXPECT_EQ(capture.value, value) << "capture " << i;
+            EXPECT_EQ(reference, value) << "capture " << i;
+            break;
+        case CAPTURE_GLITCHED:
+            // whenever the bit at a time decoder accepts a frame so does this one, and
+            // any frame it rejects is rejected, if possibly earlier and for another reason
+            if (telemetryValid(reference)) {
+                EXPECT_EQ(reference, value) << "capture " << i;
+            } else {
+                EXPECT_FALSE(telemetryValid(value)) << "capture " << i;
+            }
+            break;
+        }
+    }
+
+    EXPECT_EQ(count[CAPTURE_CLEAN], decoded[CAPTURE_CLEAN]);
+    EXPECT_EQ(count[CAPTURE_NOISY], decoded[CAPTURE_NOISY]);
+    // some glitches fall outside the frame or between samples that are decoded the same
+    EXPECT_GT(decoded[CAPTURE_GLITCHED], 0);
+    EXPECT_LT(decoded[CAPTURE_GLITCHED], count[CAPTURE_GLITCHED]);
+}
+
+TEST(DshotBitbangDecodeTest, TestNoFrame)
+{
+    uint16_t buffer[PORT_INPUT_COUNT + PORT_INPUT_PADDING];
+
+    // an idle line holds no frame
+    memset(buffer, 0xff, sizeof(buffer));
+    EXPECT_EQ(DSHOT_TELEMETRY_NOEDGE, decode_bb(buffer, PORT_INPUT_COUNT, 3));
+
+    // nor does a line that is stuck low
+    memset(buffer, 0, sizeof(buffer));
+    EXPECT_EQ(DSHOT_TELEMETRY_NOEDGE, decode_bb(buffer, PORT_INPUT_COUNT, 3));
+}
+
+// Timing only, run with --gtest_also_run_disabled_tests
+TEST(DshotBitbangDecodeTest, DISABLED_TestBenchmark)
+{
+    std::vector<capture_t> corpus = makeCorpus();
+    volatile uint32_t sink = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < 20; repeat++) {
+        for (capture_t &capture : corpus) {
+            sink = sink + referenceDecode(capture.buffer, PORT_INPUT_COUNT, capture.bit, corpusPreambleSkip());
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int repeat = 0; repeat < 20; repeat++) {
+        for (capture_t &capture : corpus) {
+            sink = sink + decode_bb(capture.buffer, PORT_INPUT_COUNT, capture.bit);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const double frames = 20.0 * corpus.size();
+    printf("bit at a time %.1f ns/frame, word wide %.1f ns/frame\n",
+        std::chrono::duration<double, std::nano>(middle - begin).count() / frames,
+        std::chrono::duration<double, std::nano>(end - middle).count() / frames);
+}
+
+// STUBS
+
+extern "C" {
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+
+    timeUs_t micros(void) { return 0; }
+}
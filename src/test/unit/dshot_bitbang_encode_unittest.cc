@@ -0,0 +1,139 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/utils.h"
+
+    #include "drivers/dshot_bitbang_encode.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BUFFER_SIZE ((MOTOR_DSHOT_FRAME_BITS + 1) * MOTOR_DSHOT_STATE_PER_SYMBOL)
+
+// The bit at a time encoding the table replaces
+static void referenceDataSet(uint32_t *buffer, int pinNumber, uint16_t value, bool inverted)
+{
+    const uint32_t middleBit = inverted ? (1 << (pinNumber + 0)) : (1 << (pinNumber + 16));
+
+    for (int pos = 0; pos < 16; pos++) {
+        if (!(value & 0x8000)) {
+            buffer[pos * 3 + 1] |= middleBit;
+        }
+        value <<= 1;
+    }
+}
+
+static void referenceDataClear(uint32_t *buffer)
+{
+    for (int bitpos = 0; bitpos < 16; bitpos++) {
+        buffer[bitpos * 3 + 1] = 0;
+    }
+}
+
+static void initBuffers(uint32_t *buffer, uint32_t *reference, const int *pins, int motorCount, bool inverted)
+{
+    memset(buffer, 0, BUFFER_SIZE * sizeof(uint32_t));
+    memset(reference, 0, BUFFER_SIZE * sizeof(uint32_t));
+    for (int i = 0; i < motorCount; i++) {
+        bbOutputDataInit(buffer, 1 << pins[i], inverted);
+        bbOutputDataInit(reference, 1 << pins[i], inverted);
+    }
+}
+
+TEST(DshotBitbangEncodeTest, TestMatchesBitwiseEncoding)
+{
+    const int pins[] = { 0, 3, 7, 15 };
+    const int motorCount = ARRAYLEN(pins);
+    uint32_t buffer[BUFFER_SIZE];
+    uint32_t reference[BUFFER_SIZE];
+    uint32_t pinMasks[ARRAYLEN(pins)];
+    uint16_t packets[ARRAYLEN(pins)];
+
+    srand(1);
+
+    for (int inverted = 0; inverted <= 1; inverted++) {
+        for (int i = 0; i < motorCount; i++) {
+            pinMasks[i] = bbOutputPinMask(pins[i], inverted);
+        }
+        initBuffers(buffer, reference, pins, motorCount, inverted);
+
+        for (int frame = 0; frame < 1000; frame++) {
+            referenceDataClear(reference);
+            for (int i = 0; i < motorCount; i++) {
+                packets[i] = rand() & 0xffff;
+                referenceDataSet(reference, pins[i], packets[i], inverted);
+            }
+
+            bbOutputDataEncode(buffer, packets, pinMasks, motorCount);
+
+            ASSERT_EQ(0, memcmp(reference, buffer, sizeof(buffer))) << "frame " << frame << " inverted " << inverted;
+        }
+    }
+}
+
+TEST(DshotBitbangEncodeTest, TestUnwrittenMotorLeavesLineAlone)
+{
+    const int pins[] = { 2, 5 };
+    uint32_t buffer[BUFFER_SIZE];
+    uint32_t reference[BUFFER_SIZE];
+    const uint32_t pinMasks[] = { bbOutputPinMask(pins[0], false), bbOutputPinMask(pins[1], false) };
+    const uint16_t packets[] = { 0x1234, 0xffff };
+
+    initBuffers(buffer, reference, pins, ARRAYLEN(pins), false);
+    referenceDataSet(reference, pins[0], packets[0], false);
+
+    bbOutputDataEncode(buffer, packets, pinMasks, ARRAYLEN(pins));
+
+    EXPECT_EQ(0, memcmp(reference, buffer, sizeof(buffer)));
+    for (int bit = 0; bit < MOTOR_DSHOT_FRAME_BITS; bit++) {
+        EXPECT_EQ(0u, buffer[bit * MOTOR_DSHOT_STATE_PER_SYMBOL + 1] & pinMasks[1]);
+    }
+}
+
+TEST(DshotBitbangEncodeTest, TestFrameFramingIsUntouched)
+{
+    const int pins[] = { 1, 9 };
+    uint32_t buffer[BUFFER_SIZE];
+    uint32_t reference[BUFFER_SIZE];
+    const uint32_t pinMasks[] = { bbOutputPinMask(pins[0], true), bbOutputPinMask(pins[1], true) };
+    const uint16_t packets[] = { 0x0000, 0x0000 };
+
+    initBuffers(buffer, reference, pins, ARRAYLEN(pins), true);
+
+    bbOutputDataEncode(buffer, packets, pinMasks, ARRAYLEN(pins));
+
+    // only the middle word of each bit is written, the set, reset and hold words stay as initialised
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        if (i % MOTOR_DSHOT_STATE_PER_SYMBOL == 1 && i < MOTOR_DSHOT_FRAME_BITS * MOTOR_DSHOT_STATE_PER_SYMBOL) {
+            EXPECT_EQ(pinMasks[0] | pinMasks[1], buffer[i]);
+        } else {
+            EXPECT_EQ(reference[i], buffer[i]);
+        }
+    }
+}
@@ -0,0 +1,236 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+
+    #include "flight/alt_estimator.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define ACC_RATE_HZ         1000
+#define ACC_INTERVAL_US     (1000000 / ACC_RATE_HZ)
+#define ACC_VARIANCE        (50.0f * 50.0f)
+#define BIAS_VARIANCE       (5.0f * 5.0f)
+
+// repeatable, roughly gaussian noise with unit standard deviation
+static uint32_t noiseSeed;
+
+static float noise(void)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < 12; i++) {
+        noiseSeed = noiseSeed * 1664525 + 1013904223;
+        sum += (noiseSeed >> 8) / 16777216.0f;
+    }
+    return sum - 6.0f;
+}
+
+// a trajectory, giving altitude, velocity and acceleration at time t
+typedef struct trajectory_s {
+    float altitude;
+    float velocity;
+    float acceleration;
+} trajectory_t;
+
+typedef trajectory_t (*trajectoryFn)(float t);
+
+// climbs 10m and back down, every 10s
+static trajectory_t bobbing(float t)
+{
+    const float w = 2.0f * M_PIf / 10.0f;
+    return { 500.0f * (1.0f - cosf(w * t)), 500.0f * w * sinf(w * t), 500.0f * w * w * cosf(w * t) };
+}
+
+static trajectory_t climbing(float t)
+{
+    return { 200.0f * t, 200.0f, 0.0f };
+}
+
+typedef struct simulation_s {
+    float accBias;
+    float accNoise;
+    float accVariance;
+    float altitudeNoise;
+    timeDelta_t altitudeDelayUs;
+    timeDelta_t altitudeAssumedDelayUs;
+    int altitudeIntervalMs;
+    bool useVelocity;
+    timeDelta_t velocityDelayUs;
+    // results, after the settling time
+    float altitudeErrorRms;
+    float velocityErrorRms;
+} simulation_t;
+
+static void simulate(altEstimator_t *est, trajectoryFn trajectory, simulation_t *sim, float durationS, float settleS)
+{
+    float altitudeErrorSq = 0.0f;
+    float velocityErrorSq = 0.0f;
+    int count = 0;
+
+    for (int step = 1; step <= durationS * ACC_RATE_HZ; step++) {
+        const timeUs_t timeUs = step * ACC_INTERVAL_US;
+        const float t = timeUs * 1e-6f;
+
+        altEstimatorPredict(est, trajectory(t).acceleration + sim->accBias + sim->accNoise * noise(), sim->accVariance, timeUs);
+
+        if (step % sim->altitudeIntervalMs == 0) {
+            const trajectory_t past = trajectory(t - sim->altitudeDelayUs * 1e-6f);
+            altEstimatorCorrectAltitude(est, past.altitude + sim->altitudeNoise * noise(), sq(sim->altitudeNoise), sim->altitudeAssumedDelayUs);
+            if (sim->useVelocity) {
+                const trajectory_t pastVel = trajectory(t - sim->velocityDelayUs * 1e-6f);
+                altEstimatorCorrectVelocity(est, pastVel.velocity + 10.0f * noise(), sq(10.0f), sim->velocityDelayUs);
+            }
+        }
+
+        if (t > settleS) {
+            const trajectory_t truth = trajectory(t);
+            altitudeErrorSq += sq(est->state[ALT_EST_ALTITUDE] - truth.altitude);
+            velocityErrorSq += sq(est->state[ALT_EST_VELOCITY] - truth.velocity);
+            count++;
+        }
+    }
+
+    sim->altitudeErrorRms = sqrtf(altitudeErrorSq / count);
+    sim->velocityErrorRms = sqrtf(velocityErrorSq / count);
+}
+
+TEST(AltEstimatorTest, TestLearnsAccBias)
+{
+    altEstimator_t est;
+    altEstimatorInit(&est, BIAS_VARIANCE);
+    noiseSeed = 1;
+
+    simulation_t sim = {};
+    sim.accBias = 30.0f;
+    sim.accNoise = 50.0f;
+    sim.accVariance = ACC_VARIANCE;
+    sim.altitudeNoise = 50.0f;
+    sim.altitudeIntervalMs = 20;
+
+    simulate(&est, [](float) { return trajectory_t{ 0.0f, 0.0f, 0.0f }; }, &sim, 30.0f, 20.0f);
+
+    EXPECT_NEAR(30.0f, est.state[ALT_EST_ACC_BIAS], 5.0f);
+    EXPECT_LT(sim.altitudeErrorRms, 20.0f);
+    EXPECT_LT(sim.velocityErrorRms, 10.0f);
+
+    // a reset restarts at rest, but keeps what was learned about the accelerometer
+    altEstimatorReset(&est, 100.0f);
+    EXPECT_EQ(100.0f, est.state[ALT_EST_ALTITUDE]);
+    EXPECT_EQ(0.0f, est.state[ALT_EST_VELOCITY]);
+    EXPECT_NEAR(30.0f, est.state[ALT_EST_ACC_BIAS], 5.0f);
+}
+
+TEST(AltEstimatorTest, TestTracksTrajectory)
+{
+    altEstimator_t est;
+    altEstimatorInit(&est, BIAS_VARIANCE);
+    noiseSeed = 2;
+
+    // baro like altitude, noisy and slightly delayed
+    simulation_t sim = {};
+    sim.accBias = -20.0f;
+    sim.accNoise = 50.0f;
+    sim.accVariance = ACC_VARIANCE;
+    sim.altitudeNoise = 50.0f;
+    sim.altitudeDelayUs = 20000;
+    sim.altitudeAssumedDelayUs = 20000;
+    sim.altitudeIntervalMs = 20;
+
+    simulate(&est, bobbing, &sim, 40.0f, 20.0f);
+
+    // far better than the altitude measurements alone, and the velocity isn't a noisy derivative
+    EXPECT_LT(sim.altitudeErrorRms, 20.0f);
+    EXPECT_LT(sim.velocityErrorRms, 15.0f);
+}
+
+TEST(AltEstimatorTest, TestDelayCompensation)
+{
+    // GPS like altitude and velocity, 100ms old when they arrive, with a poor accelerometer
+    simulation_t compensated = {};
+    compensated.accBias = 20.0f;
+    compensated.accNoise = 300.0f;
+    compensated.accVariance = sq(300.0f);
+    compensated.altitudeNoise = 20.0f;
+    compensated.altitudeDelayUs = 100000;
+    compensated.altitudeAssumedDelayUs = 100000;
+    compensated.altitudeIntervalMs = 100;
+    compensated.useVelocity = true;
+    compensated.velocityDelayUs = 100000;
+
+    simulation_t uncompensated = compensated;
+    uncompensated.altitudeAssumedDelayUs = 0;
+    uncompensated.velocityDelayUs = 0;
+
+    altEstimator_t est;
+    altEstimatorInit(&est, BIAS_VARIANCE);
+    noiseSeed = 3;
+    simulate(&est, bobbing, &compensated, 40.0f, 20.0f);
+
+    altEstimatorInit(&est, BIAS_VARIANCE);
+    noiseSeed = 3;
+    simulate(&est, bobbing, &uncompensated, 40.0f, 20.0f);
+
+    EXPECT_LT(compensated.altitudeErrorRms, 10.0f);
+    EXPECT_LT(compensated.velocityErrorRms, 10.0f);
+    // fusing the same data as if it were current lags the trajectory
+    EXPECT_LT(compensated.altitudeErrorRms * 2, uncompensated.altitudeErrorRms);
+}
+
+TEST(AltEstimatorTest, TestWithoutAccelerometer)
+{
+    altEstimator_t est;
+    altEstimatorInit(&est, 0.0f);
+
+    // only altitude measurements, with the acceleration left to the process noise
+    for (int step = 1; step <= 10 * ACC_RATE_HZ; step++) {
+        const timeUs_t timeUs = step * ACC_INTERVAL_US;
+        altEstimatorPredict(&est, 0.0f, sq(500.0f), timeUs);
+        if (step % 20 == 0) {
+            altEstimatorCorrectAltitude(&est, climbing(timeUs * 1e-6f).altitude, sq(10.0f), 0);
+        }
+    }
+
+    EXPECT_NEAR(2000.0f, est.state[ALT_EST_ALTITUDE], 10.0f);
+    EXPECT_NEAR(200.0f, est.state[ALT_EST_VELOCITY], 5.0f);
+}
+
+TEST(AltEstimatorTest, TestDelayBeyondHistory)
+{
+    altEstimator_t est;
+    altEstimatorInit(&est, BIAS_VARIANCE);
+
+    for (int step = 1; step <= ACC_RATE_HZ; step++) {
+        altEstimatorPredict(&est, 0.0f, ACC_VARIANCE, step * ACC_INTERVAL_US);
+    }
+
+    // older than the history goes back, the oldest stored state is used
+    altEstimatorCorrectAltitude(&est, 100.0f, 100.0f, 10 * 1000000);
+    EXPECT_GT(est.state[ALT_EST_ALTITUDE], 0.0f);
+    EXPECT_LT(est.state[ALT_EST_ALTITUDE], 100.0f);
+}
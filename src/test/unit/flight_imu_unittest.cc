@@ -178,6 +178,42 @@ TEST(FlightImuTest, TestUpdateEulerAngles)
     EXPECT_EQ(450, attitude.values.yaw);
 }
 
+TEST(FlightImuTest, TestPropagateAttitude)
+{
+    // level
+    quaternion_from_axis_angle(&q, 0, 1, 0, 0);
+    imuComputeRotationMatrix();
+    attitude.values.roll = 0;
+    attitudeIsEstablished = true;
+    flightModeFlags = 0;
+
+    // one second of 30deg/s roll at 8kHz
+    gyro.gyroADCf[X] = 30;
+    gyro.gyroADCf[Y] = 0;
+    gyro.gyroADCf[Z] = 0;
+    for (int i = 0; i < 8000; i++) {
+        imuPropagateAttitude(1.0f / 8000);
+    }
+
+    EXPECT_NEAR(cosf(DEGREES_TO_RADIANS(30)), getCosTiltAngle(), 1e-3);
+    // the Euler angles are only needed at PID rate when self levelling
+    EXPECT_EQ(0, attitude.values.roll);
+
+    enableFlightMode(ANGLE_MODE);
+    imuPropagateAttitude(1.0f / 8000);
+    EXPECT_NEAR(300, attitude.values.roll, 2);
+    EXPECT_NEAR(0, attitude.values.pitch, 2);
+    disableFlightMode(ANGLE_MODE);
+
+    // nothing to propagate until the attitude has been established
+    attitudeIsEstablished = false;
+    const float cosTilt = getCosTiltAngle();
+    imuPropagateAttitude(1.0f / 8000);
+    EXPECT_EQ(cosTilt, getCosTiltAngle());
+
+    gyro.gyroADCf[X] = 0;
+}
+
 TEST(FlightImuTest, TestSmallAngle)
 {
     const float r1 = 0.898;
@@ -394,6 +430,7 @@ extern "C" {
     mag_t mag;
 
     gpsSolutionData_t gpsSol;
+    uint8_t GPS_update = 0;
 
     uint8_t debugMode;
     int16_t debug[DEBUG16_VALUE_COUNT];
@@ -0,0 +1,280 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <algorithm>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/serial.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "io/beeper.h"
+    #include "io/dashboard.h"
+
+    #include "flight/gps_rescue.h"
+
+    #include "io/gps.h"
+    #include "io/serial.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "scheduler/scheduler.h"
+
+    PG_REGISTER(gpsRescueConfig_t, gpsRescueConfig, PG_GPS_RESCUE, 0);
+
+    static int solutionCount;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+// Synthesised to look like a u-blox M8 at 10Hz with NAV-PVT, NAV-SAT and NAV-TIMEUTC enabled, with GGA
+// still being sent at the start. Two epochs:
+//   GGA, NAV-TIMEUTC, NAV-PVT, NAV-TIMEUTC, NAV-SAT (3 sats), NAV-PVT
+static const uint8_t ubxStream[] = {
+    0x24, 0x47, 0x4e, 0x47, 0x47, 0x41, 0x2c, 0x31, 0x32, 0x33, 0x30, 0x31, 0x35, 0x2e, 0x30, 0x30,
+    0x2c, 0x33, 0x37, 0x33, 0x30, 0x2e, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2c, 0x4e, 0x2c, 0x31, 0x32,
+    0x32, 0x33, 0x30, 0x2e, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2c, 0x57, 0x2c, 0x31, 0x2c, 0x31, 0x34,
+    0x2c, 0x30, 0x2e, 0x39, 0x30, 0x2c, 0x33, 0x32, 0x2e, 0x30, 0x2c, 0x4d, 0x2c, 0x2d, 0x32, 0x38,
+    0x2e, 0x30, 0x2c, 0x4d, 0x2c, 0x2c, 0x2a, 0x34, 0x45, 0x0d, 0x0a, 0xb5, 0x62, 0x01, 0x21, 0x14,
+    0x00, 0xd8, 0xdf, 0xae, 0x02, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe7, 0x07, 0x06,
+    0x01, 0x0c, 0x1e, 0x0f, 0x37, 0x20, 0xe3, 0xb5, 0x62, 0x01, 0x07, 0x5c, 0x00, 0xd8, 0xdf, 0xae,
+    0x02, 0xe7, 0x07, 0x06, 0x01, 0x0c, 0x1e, 0x0f, 0x07, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x03, 0x01, 0x00, 0x0e, 0xc0, 0xfb, 0xfb, 0xb6, 0xc0, 0x0b, 0x5a, 0x16, 0x60, 0xea, 0x00,
+    0x00, 0x00, 0x7d, 0x00, 0x00, 0xdc, 0x05, 0x00, 0x00, 0xc4, 0x09, 0x00, 0x00, 0x2c, 0x01, 0x00,
+    0x00, 0x90, 0x01, 0x00, 0x00, 0x9c, 0xff, 0xff, 0xff, 0xf4, 0x01, 0x00, 0x00, 0x40, 0x54, 0x89,
+    0x00, 0xc8, 0x00, 0x00, 0x00, 0x88, 0x13, 0x00, 0x00, 0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa4, 0xaf, 0xb5, 0x62, 0x01, 0x21, 0x14,
+    0x00, 0x3c, 0xe0, 0xae, 0x02, 0x1e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe7, 0x07, 0x06,
+    0x01, 0x0c, 0x1e, 0x0f, 0x37, 0x85, 0xc6, 0xb5, 0x62, 0x01, 0x35, 0x2c, 0x00, 0x3c, 0xe0, 0xae,
+    0x02, 0x01, 0x03, 0x00, 0x00, 0x00, 0x02, 0x28, 0x2d, 0xb4, 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00,
+    0x00, 0x00, 0x05, 0x23, 0x2d, 0xb4, 0x00, 0x00, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x06, 0x0c, 0x1c,
+    0x2d, 0xb4, 0x00, 0x00, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x9f, 0xf4, 0xb5, 0x62, 0x01, 0x07, 0x5c,
+    0x00, 0x3c, 0xe0, 0xae, 0x02, 0xe7, 0x07, 0x06, 0x01, 0x0c, 0x1e, 0x0f, 0x07, 0x14, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x01, 0x00, 0x0f, 0xf8, 0xfa, 0xfb, 0xb6, 0x24, 0x0c, 0x5a,
+    0x16, 0xc4, 0xea, 0x00, 0x00, 0x64, 0x7d, 0x00, 0x00, 0xdc, 0x05, 0x00, 0x00, 0xc4, 0x09, 0x00,
+    0x00, 0x2c, 0x01, 0x00, 0x00, 0x90, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58, 0x02, 0x00,
+    0x00, 0x80, 0xa8, 0x12, 0x01, 0xc8, 0x00, 0x00, 0x00, 0x88, 0x13, 0x00, 0x00, 0x96, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58, 0x5f,
+};
+
+#define UBX_FIRST_PVT_END 203   // offset of the byte after the first NAV-PVT
+
+// A serial port replaying the stream
+static const uint8_t *mockRxData;
+static uint32_t mockRxLength;
+static uint32_t mockRxPos;
+static uint32_t mockRxChunkLimit;
+
+static uint32_t mockTotalRxWaiting(const serialPort_t *)
+{
+    return std::min(mockRxLength - mockRxPos, mockRxChunkLimit);
+}
+
+static uint8_t mockRead(serialPort_t *)
+{
+    ADD_FAILURE() << "GPS data should be read with serialReadBuf()";
+    return mockRxData[mockRxPos++];
+}
+
+static uint32_t mockReadBuf(serialPort_t *instance, uint8_t *data, uint32_t count)
+{
+    count = std::min(count, mockTotalRxWaiting(instance));
+    memcpy(data, &mockRxData[mockRxPos], count);
+    mockRxPos += count;
+    return count;
+}
+
+static void mockWrite(serialPort_t *, uint8_t) { }
+
+static const struct serialPortVTable mockVTable = {
+    .serialWrite = mockWrite,
+    .serialTotalRxWaiting = mockTotalRxWaiting,
+    .serialTotalTxFree = NULL,
+    .serialRead = mockRead,
+    .readBuf = mockReadBuf,
+    .serialSetBaudRate = NULL,
+    .isSerialTransmitBufferEmpty = NULL,
+    .setMode = NULL,
+    .setCtrlLineStateCb = NULL,
+    .setBaudRateCb = NULL,
+    .writeBuf = NULL,
+    .beginWrite = NULL,
+    .endWrite = NULL,
+};
+
+static serialPort_t mockPort;
+
+static void initGps(void)
+{
+    gpsConfigMutable()->provider = GPS_UBLOX;
+    gpsConfigMutable()->autoConfig = GPS_AUTOCONFIG_OFF;
+    mockPort.vTable = &mockVTable;
+    gpsInit();
+    gpsData.state = GPS_STATE_RECEIVING_DATA;
+
+    memset(&gpsSol, 0, sizeof(gpsSol));
+    DISABLE_STATE(GPS_FIX);
+    solutionCount = 0;
+}
+
+static void replay(const uint8_t *data, uint32_t length, uint32_t chunkLimit)
+{
+    mockRxData = data;
+    mockRxLength = length;
+    mockRxPos = 0;
+    mockRxChunkLimit = chunkLimit;
+
+    while (mockRxPos < mockRxLength) {
+        gpsUpdate(0);
+    }
+}
+
+static void expectFirstSolution(void)
+{
+    EXPECT_EQ(375000000, gpsSol.llh.lat);
+    EXPECT_EQ(-1225000000, gpsSol.llh.lon);
+    EXPECT_EQ(3200, gpsSol.llh.altCm);
+    EXPECT_EQ(14, gpsSol.numSat);
+    EXPECT_EQ(50, gpsSol.groundSpeed);
+    EXPECT_EQ(50, gpsSol.speed3d);
+    EXPECT_EQ(900, gpsSol.groundCourse);
+    EXPECT_EQ(150, gpsSol.dop.pdop);
+    EXPECT_EQ(1500U, gpsSol.acc.hAcc);
+    EXPECT_EQ(2500U, gpsSol.acc.vAcc);
+    EXPECT_EQ(10, gpsSol.verticalSpeed);
+    EXPECT_EQ(45015000U, gpsSol.time);
+    EXPECT_TRUE(STATE(GPS_FIX));
+}
+
+TEST(GpsUbloxTest, TestNavPvt)
+{
+    initGps();
+
+    replay(ubxStream, UBX_FIRST_PVT_END, UINT32_MAX);
+
+    EXPECT_EQ(1, solutionCount);
+    expectFirstSolution();
+}
+
+TEST(GpsUbloxTest, TestSynthesisedStream)
+{
+    initGps();
+
+    replay(ubxStream, sizeof(ubxStream), UINT32_MAX);
+
+    // every solution is handled, even when more than one arrives in a single update
+    EXPECT_EQ(2, solutionCount);
+    EXPECT_EQ(375000100, gpsSol.llh.lat);
+    EXPECT_EQ(-1225000200, gpsSol.llh.lon);
+    EXPECT_EQ(3210, gpsSol.llh.altCm);
+    EXPECT_EQ(15, gpsSol.numSat);
+    EXPECT_EQ(60, gpsSol.groundSpeed);
+    EXPECT_EQ(1800, gpsSol.groundCourse);
+    EXPECT_EQ(45015100U, gpsSol.time);
+    EXPECT_EQ(100, gpsSol.navIntervalMs);
+
+    // NAV-SAT
+    EXPECT_EQ(GPS_SV_MAXSATS_M8N, GPS_numCh);
+    EXPECT_EQ(0, GPS_svinfo_chn[0]);
+    EXPECT_EQ(2, GPS_svinfo_svid[0]);
+    EXPECT_EQ(40, GPS_svinfo_cno[0]);
+    EXPECT_EQ(6, GPS_svinfo_chn[2]);
+    EXPECT_EQ(12, GPS_svinfo_svid[2]);
+    EXPECT_EQ(28, GPS_svinfo_cno[2]);
+    EXPECT_EQ(0x0c, GPS_svinfo_quality[2]);
+    EXPECT_EQ(255, GPS_svinfo_chn[3]);
+}
+
+TEST(GpsUbloxTest, TestArbitrarySpans)
+{
+    // however the stream is split, the result is the same
+    for (uint32_t chunkLimit = 1; chunkLimit <= 40; chunkLimit++) {
+        initGps();
+
+        replay(ubxStream, UBX_FIRST_PVT_END, chunkLimit);
+
+        EXPECT_EQ(1, solutionCount);
+        expectFirstSolution();
+    }
+}
+
+TEST(GpsUbloxTest, TestByteAtATime)
+{
+    initGps();
+
+    int frames = 0;
+    for (unsigned i = 0; i < sizeof(ubxStream); i++) {
+        frames += gpsNewFrame(ubxStream[i]);
+    }
+    EXPECT_EQ(2, frames);
+    EXPECT_EQ(375000100, gpsSol.llh.lat);
+}
+
+TEST(GpsUbloxTest, TestBadChecksum)
+{
+    initGps();
+
+    uint8_t stream[sizeof(ubxStream)];
+    memcpy(stream, ubxStream, sizeof(stream));
+    // corrupt the first NAV-PVT payload
+    stream[UBX_FIRST_PVT_END - 40] ^= 0x01;
+
+    replay(stream, sizeof(stream), UINT32_MAX);
+
+    // only the second epoch gets through
+    EXPECT_EQ(1, solutionCount);
+    EXPECT_EQ(375000100, gpsSol.llh.lat);
+}
+
+// STUBS
+
+extern "C" {
+    uint32_t millis(void) { return 0; }
+    uint32_t micros(void) { return 0; }
+
+    static serialPortConfig_t gpsPortConfig = { .functionMask = FUNCTION_GPS, .identifier = SERIAL_PORT_USART1 };
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) { return &gpsPortConfig; }
+    serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return &mockPort; }
+
+    const uint32_t baudRates[] = {0, 9600, 19200, 38400, 57600, 115200, 230400, 250000, 400000}; // see baudRate_e
+    baudRate_e lookupBaudRateIndex(uint32_t) { return BAUD_115200; }
+    void waitForSerialPortToFinishTransmitting(serialPort_t *) { }
+    void serialPassthrough(serialPort_t *, serialPort_t *, serialConsumer *, serialConsumer *) { }
+
+    bool featureIsEnabled(uint32_t) { return false; }
+    void beeper(beeperMode_e) { }
+    void beeperConfirmationBeeps(uint8_t) { }
+    void rescheduleTask(taskId_e, timeDelta_t) { }
+    void schedulerSetNextStateTime(timeDelta_t) { }
+
+    void dashboardUpdate(timeUs_t) { }
+    void dashboardShowFixedPage(pageId_e) { }
+
+    void gpsRescueNewGpsData(void) { solutionCount++; }
+}
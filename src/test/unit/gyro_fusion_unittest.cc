@@ -0,0 +1,213 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+
+    #include "sensors/gyro_fusion.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define SAMPLE_RATE_HZ      8000
+#define SAMPLE_LOOPTIME_US  (1000000 / SAMPLE_RATE_HZ)
+#define LSB_PER_DPS         16.4f
+
+// repeatable, roughly gaussian noise with unit standard deviation
+static uint32_t noiseSeed;
+
+static float noise(void)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < 12; i++) {
+        noiseSeed = noiseSeed * 1664525 + 1013904223;
+        sum += (noiseSeed >> 8) / 16777216.0f;
+    }
+    return sum - 6.0f;
+}
+
+typedef struct gyroSample_s {
+    float gyroADC[XYZ_AXIS_COUNT];
+    int16_t gyroADCRaw[XYZ_AXIS_COUNT];
+} gyroSample_t;
+
+static float truth(int sample, int axis)
+{
+    const float t = (float)sample / SAMPLE_RATE_HZ;
+    return 200.0f * sinf(2.0f * M_PIf * (5.0f + axis) * t) + 50.0f * sinf(2.0f * M_PIf * 31.0f * t);
+}
+
+static void makeSample(gyroSample_t *gyro, int sample, float noiseStdDev)
+{
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        gyro->gyroADC[axis] = truth(sample, axis) + noiseStdDev * noise();
+        gyro->gyroADCRaw[axis] = lrintf(gyro->gyroADC[axis] * LSB_PER_DPS);
+    }
+}
+
+typedef struct result_s {
+    float fusedRms;
+    float averageRms;
+    float sensor1Rms;
+} result_t;
+
+// runs two sensors with the given noise and returns the errors over the second half of the run
+static result_t runFusion(gyroFusion_t *fusion, float noise1, float noise2, int samples)
+{
+    gyroSample_t gyro1;
+    gyroSample_t gyro2;
+    float fused[XYZ_AXIS_COUNT];
+    float fusedError = 0.0f;
+    float averageError = 0.0f;
+    float sensor1Error = 0.0f;
+    int count = 0;
+
+    for (int sample = 0; sample < samples; sample++) {
+        makeSample(&gyro1, sample, noise1);
+        makeSample(&gyro2, sample, noise2);
+        gyroFusionUpdate(fusion, fused, gyro1.gyroADC, gyro1.gyroADCRaw, gyro2.gyroADC, gyro2.gyroADCRaw);
+
+        if (sample >= samples / 2) {
+            for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+                fusedError += sq(fused[axis] - truth(sample, axis));
+                averageError += sq((gyro1.gyroADC[axis] + gyro2.gyroADC[axis]) / 2.0f - truth(sample, axis));
+                sensor1Error += sq(gyro1.gyroADC[axis] - truth(sample, axis));
+                count++;
+            }
+        }
+    }
+
+    result_t result;
+    result.fusedRms = sqrtf(fusedError / count);
+    result.averageRms = sqrtf(averageError / count);
+    result.sensor1Rms = sqrtf(sensor1Error / count);
+    return result;
+}
+
+TEST(GyroFusionTest, EqualSensorsAreAveraged)
+{
+    gyroFusion_t fusion;
+    gyroFusionInit(&fusion, SAMPLE_LOOPTIME_US);
+    noiseSeed = 1;
+
+    const result_t result = runFusion(&fusion, 1.0f, 1.0f, 2 * SAMPLE_RATE_HZ);
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_NEAR(0.5f, gyroFusionGetWeight(&fusion, 0, axis), 0.1f);
+        EXPECT_FLOAT_EQ(1.0f, gyroFusionGetWeight(&fusion, 0, axis) + gyroFusionGetWeight(&fusion, 1, axis));
+    }
+    EXPECT_LT(result.fusedRms, 0.8f);
+    EXPECT_NEAR(result.averageRms, result.fusedRms, 0.05f);
+}
+
+TEST(GyroFusionTest, QuieterSensorDominates)
+{
+    gyroFusion_t fusion;
+    gyroFusionInit(&fusion, SAMPLE_LOOPTIME_US);
+    noiseSeed = 2;
+
+    // inverse variance weights are 16/17 and 1/17
+    const result_t result = runFusion(&fusion, 0.5f, 2.0f, 2 * SAMPLE_RATE_HZ);
+
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_NEAR(16.0f / 17.0f, gyroFusionGetWeight(&fusion, 0, axis), 0.04f);
+    }
+    // better than the quieter sensor on its own, and much better than the plain average
+    EXPECT_LT(result.fusedRms, result.sensor1Rms);
+    EXPECT_LT(result.fusedRms, 0.6f * result.averageRms);
+}
+
+TEST(GyroFusionTest, ClippingSensorIsDropped)
+{
+    gyroFusion_t fusion;
+    gyroFusionInit(&fusion, SAMPLE_LOOPTIME_US);
+    noiseSeed = 3;
+
+    int sample = SAMPLE_RATE_HZ / 2;
+    runFusion(&fusion, 1.0f, 1.0f, sample);
+    EXPECT_TRUE(gyroFusionIsSensorHealthy(&fusion, 0));
+    EXPECT_TRUE(gyroFusionIsSensorHealthy(&fusion, 1));
+
+    gyroSample_t gyro1;
+    gyroSample_t gyro2;
+    float fused[XYZ_AXIS_COUNT];
+
+    makeSample(&gyro1, sample, 1.0f);
+    makeSample(&gyro2, sample, 1.0f);
+    gyro2.gyroADCRaw[Y] = INT16_MIN;
+    gyro2.gyroADC[Y] = INT16_MIN / LSB_PER_DPS;
+    gyroFusionUpdate(&fusion, fused, gyro1.gyroADC, gyro1.gyroADCRaw, gyro2.gyroADC, gyro2.gyroADCRaw);
+
+    EXPECT_TRUE(gyroFusionIsSensorHealthy(&fusion, 0));
+    EXPECT_FALSE(gyroFusionIsSensorHealthy(&fusion, 1));
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_FLOAT_EQ(gyro1.gyroADC[axis], fused[axis]);
+    }
+
+    // the sensor is used again once it has behaved for the holdoff time
+    const int holdoffSamples = GYRO_FUSION_FAULT_HOLDOFF_US / SAMPLE_LOOPTIME_US;
+    for (int i = 0; i < holdoffSamples; i++) {
+        sample++;
+        makeSample(&gyro1, sample, 1.0f);
+        makeSample(&gyro2, sample, 1.0f);
+        EXPECT_FALSE(gyroFusionIsSensorHealthy(&fusion, 1));
+        gyroFusionUpdate(&fusion, fused, gyro1.gyroADC, gyro1.gyroADCRaw, gyro2.gyroADC, gyro2.gyroADCRaw);
+    }
+    EXPECT_TRUE(gyroFusionIsSensorHealthy(&fusion, 1));
+    EXPECT_NE(gyro1.gyroADC[X], fused[X]);
+}
+
+TEST(GyroFusionTest, StuckSensorIsDropped)
+{
+    gyroFusion_t fusion;
+    gyroFusionInit(&fusion, SAMPLE_LOOPTIME_US);
+    noiseSeed = 4;
+
+    int sample = SAMPLE_RATE_HZ / 2;
+    runFusion(&fusion, 1.0f, 1.0f, sample);
+
+    // sensor 1 stops updating and repeats its last sample
+    gyroSample_t gyro1;
+    gyroSample_t gyro2;
+    float fused[XYZ_AXIS_COUNT];
+    makeSample(&gyro1, sample, 1.0f);
+
+    const int stuckSamples = GYRO_FUSION_STUCK_TIME_US / SAMPLE_LOOPTIME_US;
+    for (int i = 0; i <= stuckSamples; i++) {
+        EXPECT_TRUE(gyroFusionIsSensorHealthy(&fusion, 0));
+        sample++;
+        makeSample(&gyro2, sample, 1.0f);
+        gyroFusionUpdate(&fusion, fused, gyro1.gyroADC, gyro1.gyroADCRaw, gyro2.gyroADC, gyro2.gyroADCRaw);
+    }
+
+    EXPECT_FALSE(gyroFusionIsSensorHealthy(&fusion, 0));
+    EXPECT_TRUE(gyroFusionIsSensorHealthy(&fusion, 1));
+    for (int axis = 0; axis < XYZ_AXIS_COUNT; axis++) {
+        EXPECT_FLOAT_EQ(gyro2.gyroADC[axis], fused[axis]);
+    }
+}
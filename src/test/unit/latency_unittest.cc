@@ -0,0 +1,197 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "fc/latency.h"
+
+    // one cycle per microsecond keeps the arithmetic readable
+    static uint32_t simulationCycles;
+    static timeUs_t simulationTimeUs;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static void runLoop(uint32_t sampleToFilterUs, uint32_t filterToPidUs, uint32_t pidToMotorUs)
+{
+    latencyGyroSample(simulationCycles);
+    simulationCycles += sampleToFilterUs;
+    latencyFilterComplete();
+    simulationCycles += filterToPidUs;
+    latencyPidComplete();
+    simulationCycles += pidToMotorUs;
+    simulationTimeUs += sampleToFilterUs + filterToPidUs + pidToMotorUs;
+    latencyMotorOutput();
+}
+
+TEST(LatencyUnittest, TestBuckets)
+{
+    // two buckets per octave, each starting where the previous one ends
+    EXPECT_EQ(0u, latencyBucketLowerUs(0));
+    EXPECT_EQ(1u, latencyBucketLowerUs(1));
+    EXPECT_EQ(2u, latencyBucketLowerUs(2));
+    EXPECT_EQ(3u, latencyBucketLowerUs(3));
+    EXPECT_EQ(4u, latencyBucketLowerUs(4));
+    EXPECT_EQ(6u, latencyBucketLowerUs(5));
+    EXPECT_EQ(128u, latencyBucketLowerUs(14));
+    EXPECT_EQ(192u, latencyBucketLowerUs(15));
+
+    latencyReset();
+    latencyGyroSample(simulationCycles);
+    for (uint32_t us : { 0, 1, 5, 127, 128, 191, 192, 1000000 }) {
+        simulationCycles += us;
+        latencyFilterComplete();
+        simulationCycles -= us;
+    }
+
+    const latencyStats_t *stats = latencyGetStats(LATENCY_GYRO_FILTER);
+    EXPECT_EQ(1u, stats->histogram[0]);
+    EXPECT_EQ(1u, stats->histogram[1]);
+    EXPECT_EQ(1u, stats->histogram[4]);
+    EXPECT_EQ(1u, stats->histogram[13]);
+    EXPECT_EQ(2u, stats->histogram[14]);
+    EXPECT_EQ(1u, stats->histogram[15]);
+    EXPECT_EQ(1u, stats->histogram[LATENCY_BUCKET_COUNT - 1]);
+    EXPECT_EQ(0u, stats->minUs);
+    EXPECT_EQ(1000000u, stats->maxUs);
+}
+
+TEST(LatencyUnittest, TestGyroPath)
+{
+    latencyReset();
+
+    // nothing is recorded before the first sample reaches each stage
+    latencyMotorOutput();
+    latencyPidComplete();
+    EXPECT_EQ(0u, latencyGetStats(LATENCY_GYRO_MOTOR)->count);
+    EXPECT_EQ(0u, latencyGetStats(LATENCY_GYRO_PID)->count);
+
+    for (int i = 0; i < 100; i++) {
+        runLoop(20, 30, 10);
+    }
+
+    const latencyStats_t *filter = latencyGetStats(LATENCY_GYRO_FILTER);
+    const latencyStats_t *pid = latencyGetStats(LATENCY_GYRO_PID);
+    const latencyStats_t *motor = latencyGetStats(LATENCY_GYRO_MOTOR);
+
+    EXPECT_EQ(100u, filter->count);
+    EXPECT_EQ(20u, latencyMeanUs(filter));
+    EXPECT_EQ(50u, latencyMeanUs(pid));
+    EXPECT_EQ(60u, latencyMeanUs(motor));
+    EXPECT_EQ(60u, motor->minUs);
+    EXPECT_EQ(60u, motor->maxUs);
+
+    // a loop that skips filtering carries the age of the previously filtered sample to the motors
+    latencyGyroSample(simulationCycles);
+    simulationCycles += 125;
+    latencyPidComplete();
+    latencyMotorOutput();
+    EXPECT_EQ(101u, motor->count);
+    EXPECT_EQ(185u, motor->maxUs);
+
+}
+
+TEST(LatencyUnittest, TestDebug)
+{
+    latencyReset();
+    debugMode = DEBUG_LATENCY;
+
+    runLoop(20, 30, 10);
+    EXPECT_EQ(20, debug[LATENCY_GYRO_FILTER]);
+    EXPECT_EQ(50, debug[LATENCY_GYRO_PID]);
+    EXPECT_EQ(60, debug[LATENCY_GYRO_MOTOR]);
+
+    debugMode = DEBUG_NONE;
+}
+
+TEST(LatencyUnittest, TestPercentiles)
+{
+    latencyReset();
+
+    for (int i = 0; i < 98; i++) {
+        runLoop(10, 10, 10);
+    }
+    runLoop(100, 100, 100);
+    runLoop(1000, 1000, 1000);
+
+    const latencyStats_t *motor = latencyGetStats(LATENCY_GYRO_MOTOR);
+    EXPECT_EQ(100u, motor->count);
+    // upper bounds of the buckets holding 30, 300 and the maximum
+    EXPECT_EQ(31u, latencyPercentileUs(motor, 50));
+    EXPECT_EQ(383u, latencyPercentileUs(motor, 99));
+    EXPECT_EQ(3000u, latencyPercentileUs(motor, 100));
+
+    latencyReset();
+    EXPECT_EQ(0u, latencyPercentileUs(motor, 50));
+    EXPECT_EQ(0u, latencyMeanUs(motor));
+}
+
+TEST(LatencyUnittest, TestRxPath)
+{
+    latencyReset();
+
+    // an RC frame counts once, at the first motor output after it reaches the setpoint
+    latencyRxFrame(simulationTimeUs);
+    simulationTimeUs += 400;
+    runLoop(10, 10, 10);
+    EXPECT_EQ(0u, latencyGetStats(LATENCY_RX_MOTOR)->count);
+
+    latencyRcCommandUpdated();
+    runLoop(10, 10, 10);
+    runLoop(10, 10, 10);
+    runLoop(10, 10, 10);
+
+    const latencyStats_t *rx = latencyGetStats(LATENCY_RX_MOTOR);
+    EXPECT_EQ(1u, rx->count);
+    EXPECT_EQ(460u, rx->maxUs);
+
+    // a processing pass without a new frame records nothing
+    latencyRcCommandUpdated();
+    runLoop(10, 10, 10);
+    EXPECT_EQ(1u, rx->count);
+
+    // of frames arriving before processing the latest counts
+    latencyRxFrame(simulationTimeUs);
+    simulationTimeUs += 1000;
+    latencyRxFrame(simulationTimeUs);
+    simulationTimeUs += 100;
+    latencyRcCommandUpdated();
+    runLoop(10, 10, 10);
+    EXPECT_EQ(2u, rx->count);
+    EXPECT_EQ(130u, rx->minUs);
+}
+
+// STUBS
+
+extern "C" {
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t debugMode;
+
+    uint32_t getCycleCounter(void) { return simulationCycles; }
+    int32_t clockCyclesToMicros(int32_t clockCycles) { return clockCycles; }
+    timeUs_t micros(void) { return simulationTimeUs; }
+}
@@ -0,0 +1,165 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+
+extern "C" {
+    #include "common/lz.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define BUF_LEN 4096
+
+static lzState_t lzState;
+static uint8_t inBuf[BUF_LEN];
+static uint8_t outBuf[BUF_LEN + BUF_LEN / 255 + 16];
+static uint8_t decodedBuf[BUF_LEN];
+
+/*
+ * Reference LZ4 block decoder, used to check the compressed stream.
+ * Returns the number of bytes decoded or -1 on a malformed block.
+ */
+static int lz4DecodeBlock(uint8_t *dst, int dstLen, const uint8_t *src, int srcLen)
+{
+    const uint8_t *ip = src;
+    const uint8_t *ipEnd = src + srcLen;
+    uint8_t *op = dst;
+    uint8_t *opEnd = dst + dstLen;
+
+    while (ip < ipEnd) {
+        const uint8_t token = *ip++;
+        int literalLen = token >> 4;
+        if (literalLen == 15) {
+            uint8_t b;
+            do {
+                b = *ip++;
+                literalLen += b;
+            } while (b == 255);
+        }
+        if (op + literalLen > opEnd || ip + literalLen > ipEnd) {
+            return -1;
+        }
+        memcpy(op, ip, literalLen);
+        op += literalLen;
+        ip += literalLen;
+        if (ip == ipEnd) {
+            break; // last sequence has no match
+        }
+
+        const int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        int matchLen = (token & 0x0f);
+        if (matchLen == 15) {
+            uint8_t b;
+            do {
+                b = *ip++;
+                matchLen += b;
+            } while (b == 255);
+        }
+        matchLen += 4;
+        if (offset == 0 || op - offset < dst || op + matchLen > opEnd) {
+            return -1;
+        }
+        const uint8_t *match = op - offset;
+        while (matchLen--) {
+            *op++ = *match++; // byte by byte, matches may overlap
+        }
+    }
+    return op - dst;
+}
+
+static int compressAndCheck(const uint8_t *data, int len)
+{
+    const int compressedLen = lzCompressBlock(&lzState, outBuf, sizeof(outBuf), data, len);
+    EXPECT_GE(compressedLen, 0);
+
+    memset(decodedBuf, 0xAA, sizeof(decodedBuf));
+    const int decodedLen = lz4DecodeBlock(decodedBuf, sizeof(decodedBuf), outBuf, compressedLen);
+    EXPECT_EQ(len, decodedLen);
+    EXPECT_EQ(0, memcmp(data, decodedBuf, len));
+
+    return compressedLen;
+}
+
+TEST(LzUnittest, TestEmptyAndShortInput)
+{
+    // an empty block is a single token
+    EXPECT_EQ(1, compressAndCheck(inBuf, 0));
+
+    // short blocks are stored as literals only
+    for (int ii = 0; ii < 13; ++ii) {
+        inBuf[ii] = 'a';
+    }
+    EXPECT_EQ(1 + 12, compressAndCheck(inBuf, 12));
+}
+
+TEST(LzUnittest, TestRepeatedData)
+{
+    // a run of identical bytes compresses to a handful of bytes
+    memset(inBuf, 0, BUF_LEN);
+    const int compressedLen = compressAndCheck(inBuf, BUF_LEN);
+    EXPECT_LT(compressedLen, 32);
+}
+
+TEST(LzUnittest, TestLogLikeData)
+{
+    // header text followed by frames that differ only in a few fields, as in a blackbox log
+    int len = 0;
+    for (int ii = 0; len < BUF_LEN - 64; ++ii) {
+        len += snprintf((char *)inBuf + len, BUF_LEN - len, "H Field I name:loopIteration,time,axisP[%d]\n", ii % 3);
+    }
+    int compressedLen = compressAndCheck(inBuf, len);
+    EXPECT_LT(compressedLen * 3, len);
+
+    len = 0;
+    for (int ii = 0; len < BUF_LEN - 16; ++ii) {
+        const uint8_t frame[] = { 'I', 0x10, 0x20, (uint8_t)ii, 0x00, 0x01, 0x80, 0x7f, (uint8_t)(ii >> 3), 0x55, 0x00, 0x00 };
+        memcpy(inBuf + len, frame, sizeof(frame));
+        len += sizeof(frame);
+    }
+    compressedLen = compressAndCheck(inBuf, len);
+    EXPECT_LT(compressedLen * 2, len);
+}
+
+TEST(LzUnittest, TestIncompressibleData)
+{
+    uint32_t seed = 12345;
+    for (int ii = 0; ii < BUF_LEN; ++ii) {
+        seed = seed * 1103515245 + 12345;
+        inBuf[ii] = seed >> 16;
+    }
+    const int compressedLen = compressAndCheck(inBuf, BUF_LEN);
+    // worst case expansion is the literal length encoding
+    EXPECT_LE(compressedLen, BUF_LEN + BUF_LEN / 255 + 16);
+}
+
+TEST(LzUnittest, TestOutputOverflow)
+{
+    memset(inBuf, 'x', 256);
+    EXPECT_EQ(-1, lzCompressBlock(&lzState, outBuf, 4, inBuf, 256));
+
+    uint32_t seed = 1;
+    for (int ii = 0; ii < 256; ++ii) {
+        seed = seed * 1103515245 + 12345;
+        inBuf[ii] = seed >> 16;
+    }
+    EXPECT_EQ(-1, lzCompressBlock(&lzState, outBuf, 200, inBuf, 256));
+}
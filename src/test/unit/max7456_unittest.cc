@@ -0,0 +1,251 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/maths.h"
+
+    #include "drivers/bus_spi.h"
+    #include "drivers/io.h"
+    #include "drivers/max7456.h"
+    #include "drivers/osd.h"
+    #include "drivers/time.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint32_t osdDeviceBuffer[OSD_DEVICE_BUFFER_SIZE / sizeof(uint32_t)];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define DMM     0x04
+#define DMAH    0x05
+#define DMAL    0x06
+#define DMDI    0x07
+#define AUTO_INC 0x01
+#define END     0xff
+
+static bool useDma;
+static uint32_t transferLimit;
+static std::vector<std::vector<uint8_t>> transfers;
+
+// display memory, as written by the transfers
+static uint8_t displayMemory[VIDEO_BUFFER_CHARS_PAL];
+
+static void decodeTransfer(const std::vector<uint8_t> &transfer)
+{
+    ASSERT_EQ(0U, transfer.size() % 2);
+
+    bool autoInc = false;
+    uint16_t address = 0;
+    for (unsigned i = 0; i < transfer.size(); i += 2) {
+        const uint8_t value = transfer[i + 1];
+        switch (transfer[i]) {
+        case DMM:
+            autoInc = value & AUTO_INC;
+            break;
+        case DMAH:
+            address = (address & 0xff) | (value << 8);
+            break;
+        case DMAL:
+            address = (address & 0xff00) | value;
+            break;
+        case DMDI:
+            if (autoInc && value == END) {
+                // ends auto-increment
+                autoInc = false;
+                break;
+            }
+            ASSERT_LT(address, VIDEO_BUFFER_CHARS_PAL);
+            displayMemory[address] = value;
+            if (autoInc) {
+                address++;
+            }
+            break;
+        default:
+            FAIL() << "unexpected register " << (int)transfer[i];
+        }
+    }
+    EXPECT_FALSE(autoInc);
+}
+
+static void initScreen(bool dma, uint32_t limit)
+{
+    useDma = dma;
+    transferLimit = limit;
+    memset(osdDeviceBuffer, 0, sizeof(osdDeviceBuffer));
+    memset(displayMemory, 0, sizeof(displayMemory));
+    transfers.clear();
+}
+
+// draws until the frame is sent, each call is one transfer at most
+static int drawFrame(void)
+{
+    int calls = 1;
+    while (max7456DrawScreen()) {
+        calls++;
+    }
+    return calls;
+}
+
+static std::vector<uint8_t> frame(std::initializer_list<std::vector<uint8_t>> parts)
+{
+    std::vector<uint8_t> bytes;
+    for (const auto &part : parts) {
+        bytes.insert(bytes.end(), part.begin(), part.end());
+    }
+    return bytes;
+}
+
+TEST(Max7456Test, TestSingleCharacter)
+{
+    initScreen(true, UINT32_MAX);
+    max7456WriteChar(5, 1, 'A');
+
+    EXPECT_EQ(1, drawFrame());
+
+    // a single character is written without auto-increment, so DMM needs no restore
+    ASSERT_EQ(1U, transfers.size());
+    EXPECT_EQ(std::vector<uint8_t>({ DMM, 0, DMAH, 0, DMAL, 35, DMDI, 'A' }), transfers[0]);
+    EXPECT_TRUE(max7456BuffersSynced());
+}
+
+TEST(Max7456Test, TestRunsInOneTransfer)
+{
+    initScreen(true, UINT32_MAX);
+    max7456WriteChar(10, 0, 'A');
+    max7456WriteChar(12, 0, 'B');
+    max7456WriteChar(20, 0, 'C');
+    max7456WriteChar(0, 10, 'D');
+
+    EXPECT_EQ(1, drawFrame());
+
+    // the unchanged character between A and B is resent rather than starting a new run,
+    // a gap of more than three characters starts one
+    ASSERT_EQ(1U, transfers.size());
+    EXPECT_EQ(frame({
+        { DMM, AUTO_INC, DMAH, 0, DMAL, 10, DMDI, 'A', DMDI, 0, DMDI, 'B', DMDI, END },
+        { DMM, 0, DMAH, 0, DMAL, 20, DMDI, 'C' },
+        { DMM, 0, DMAH, 1, DMAL, 300 - 256, DMDI, 'D' },
+        { DMM, 0 },
+    }), transfers[0]);
+
+    decodeTransfer(transfers[0]);
+    EXPECT_EQ(0, memcmp(displayMemory, osdDeviceBuffer, VIDEO_BUFFER_CHARS_PAL));
+
+    // nothing changed, nothing sent
+    EXPECT_EQ(1, drawFrame());
+    EXPECT_EQ(1U, transfers.size());
+}
+
+TEST(Max7456Test, TestBufferFullSplit)
+{
+    // room for a run of seven characters per transfer
+    initScreen(true, 24);
+    max7456Write(0, 2, "ABCDEFGHIJKLMNOPQRST");
+
+    EXPECT_EQ(3, drawFrame());
+
+    ASSERT_EQ(3U, transfers.size());
+    EXPECT_EQ(frame({
+        { DMM, AUTO_INC, DMAH, 0, DMAL, 60 },
+        { DMDI, 'A', DMDI, 'B', DMDI, 'C', DMDI, 'D', DMDI, 'E', DMDI, 'F', DMDI, 'G', DMDI, END },
+        { DMM, 0 },
+    }), transfers[0]);
+    EXPECT_EQ(frame({
+        { DMM, AUTO_INC, DMAH, 0, DMAL, 67 },
+        { DMDI, 'H', DMDI, 'I', DMDI, 'J', DMDI, 'K', DMDI, 'L', DMDI, 'M', DMDI, 'N', DMDI, END },
+        { DMM, 0 },
+    }), transfers[1]);
+    EXPECT_EQ(frame({
+        { DMM, AUTO_INC, DMAH, 0, DMAL, 74 },
+        { DMDI, 'O', DMDI, 'P', DMDI, 'Q', DMDI, 'R', DMDI, 'S', DMDI, 'T', DMDI, END },
+        { DMM, 0 },
+    }), transfers[2]);
+
+    for (const auto &transfer : transfers) {
+        EXPECT_LE(transfer.size(), transferLimit);
+        decodeTransfer(transfer);
+    }
+    EXPECT_EQ(0, memcmp(displayMemory, osdDeviceBuffer, VIDEO_BUFFER_CHARS_PAL));
+    EXPECT_TRUE(max7456BuffersSynced());
+}
+
+TEST(Max7456Test, TestPolled)
+{
+    initScreen(false, UINT32_MAX);
+    max7456Write(0, 0, "AB");
+
+    // without DMA each transfer is short, so the run is sent a character at a time
+    // and the frame only ends on the call that finds nothing left to send
+    EXPECT_EQ(3, drawFrame());
+
+    ASSERT_EQ(2U, transfers.size());
+    EXPECT_EQ(std::vector<uint8_t>({ DMM, 0, DMAH, 0, DMAL, 0, DMDI, 'A' }), transfers[0]);
+    EXPECT_EQ(std::vector<uint8_t>({ DMM, 0, DMAH, 0, DMAL, 1, DMDI, 'B' }), transfers[1]);
+}
+
+// STUBS
+
+extern "C" {
+    bool spiIsBusy(const extDevice_t *) { return false; }
+    bool spiUseSDO_DMA(const extDevice_t *) { return useDma; }
+    uint32_t spiTransferLimit(const extDevice_t *, uint32_t length) { return MIN(length, transferLimit); }
+
+    void spiSequence(const extDevice_t *, busSegment_t *segments)
+    {
+        transfers.push_back(std::vector<uint8_t>(segments[0].u.buffers.txData, segments[0].u.buffers.txData + segments[0].len));
+        if (segments[0].callback) {
+            segments[0].callback(0);
+        }
+    }
+
+    void spiPreinitRegister(ioTag_t, uint8_t, uint8_t) { }
+    bool spiSetBusInstance(extDevice_t *, uint32_t) { return true; }
+    uint16_t spiCalculateDivider(uint32_t) { return 0; }
+    void spiSetClkDivisor(const extDevice_t *, uint16_t) { }
+    void spiSetPriority(const extDevice_t *, busPriority_e) { }
+    void spiWait(const extDevice_t *) { }
+    uint8_t spiReadRegMsk(const extDevice_t *, uint8_t) { return 0; }
+    void spiWrite(const extDevice_t *, uint8_t) { }
+    void spiWriteReg(const extDevice_t *, uint8_t, uint8_t) { }
+    void spiReadWriteBuf(const extDevice_t *, uint8_t *, uint8_t *, int) { }
+
+    IO_t IOGetByTag(ioTag_t) { return NULL; }
+    bool IOIsFreeOrPreinit(IO_t) { return true; }
+    void IOInit(IO_t, resourceOwner_e, uint8_t) { }
+    void IOConfigGPIO(IO_t, ioConfig_t) { }
+    void IOHi(IO_t) { }
+
+    void delay(uint32_t) { }
+    void delayMicroseconds(uint32_t) { }
+    timeMs_t millis(void) { return 0; }
+    timeUs_t micros(void) { return 0; }
+}
@@ -0,0 +1,229 @@
+/*
+ * This file is part of Cleanflight.
+ *
+ * Cleanflight is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Cleanflight is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Cleanflight.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+    #include "common/streambuf.h"
+
+    #include "msp/msp_dataflash_read.h"
+    #include "msp/msp_serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FLASH_SIZE (256 * 1024)
+
+#define COMPRESSION_LZ          2
+#define COMPRESSION_LZ_HUFFMAN  3
+
+static uint8_t flash[FLASH_SIZE];
+
+/*
+ * Reference LZ4 block decoder, used to check the compressed stream.
+ * Returns the number of bytes decoded or -1 on a malformed block.
+ */
+static int lz4DecodeBlock(uint8_t *dst, int dstLen, const uint8_t *src, int srcLen)
+{
+    const uint8_t *ip = src;
+    const uint8_t *ipEnd = src + srcLen;
+    uint8_t *op = dst;
+    uint8_t *opEnd = dst + dstLen;
+
+    while (ip < ipEnd) {
+        const uint8_t token = *ip++;
+        int literalLen = token >> 4;
+        if (literalLen == 15) {
+            uint8_t b;
+            do {
+                b = *ip++;
+                literalLen += b;
+            } while (b == 255);
+        }
+        if (op + literalLen > opEnd || ip + literalLen > ipEnd) {
+            return -1;
+        }
+        memcpy(op, ip, literalLen);
+        op += literalLen;
+        ip += literalLen;
+        if (ip == ipEnd) {
+            break; // last sequence has no match
+        }
+
+        const int offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        int matchLen = (token & 0x0f);
+        if (matchLen == 15) {
+            uint8_t b;
+            do {
+                b = *ip++;
+                matchLen += b;
+            } while (b == 255);
+        }
+        matchLen += 4;
+        if (offset == 0 || op - offset < dst || op + matchLen > opEnd) {
+            return -1;
+        }
+        const uint8_t *match = op - offset;
+        while (matchLen--) {
+            *op++ = *match++; // byte by byte, matches may overlap
+        }
+    }
+    return op - dst;
+}
+
+typedef struct readReply_s {
+    uint32_t address;
+    uint16_t size;
+    uint8_t compression;
+    uint16_t bytesRead;
+    sbuf_t payload;         // after the uncompressed byte count
+} readReply_t;
+
+static uint8_t replyBuf[MSP_PORT_OUTBUF_SIZE];
+
+static readReply_t readFlash(uint32_t address, uint16_t length, uint8_t compression)
+{
+    uint8_t request[sizeof(uint32_t) + sizeof(uint16_t) + sizeof(uint8_t)];
+    sbuf_t src = { .ptr = request, .end = ARRAYEND(request) };
+    sbufWriteU32(&src, address);
+    sbufWriteU16(&src, length);
+    sbufWriteU8(&src, compression);
+    sbufSwitchToReader(&src, request);
+
+    sbuf_t dst = { .ptr = replyBuf, .end = ARRAYEND(replyBuf) };
+    mspDataflashReadCommand(&dst, &src);
+    EXPECT_LE(dst.ptr, ARRAYEND(replyBuf));
+
+    readReply_t reply;
+    sbuf_t buf = { .ptr = replyBuf, .end = dst.ptr };
+    reply.address = sbufReadU32(&buf);
+    reply.size = sbufReadU16(&buf);
+    reply.compression = sbufReadU8(&buf);
+    EXPECT_EQ(reply.size, sbufBytesRemaining(&buf));
+    reply.bytesRead = sbufReadU16(&buf);
+    reply.payload = buf;
+
+    return reply;
+}
+
+// decodes the length-prefixed LZ4 blocks of an LZ reply
+static std::vector<uint8_t> decodeLz(sbuf_t payload)
+{
+    std::vector<uint8_t> decoded;
+    static uint8_t block[1024];
+
+    while (sbufBytesRemaining(&payload)) {
+        const int compressedLen = sbufReadU16(&payload);
+        EXPECT_LE(compressedLen, sbufBytesRemaining(&payload));
+        const int decodedLen = lz4DecodeBlock(block, sizeof(block), sbufPtr(&payload), compressedLen);
+        EXPECT_GT(decodedLen, 0);
+        if (decodedLen <= 0) {
+            break;
+        }
+        decoded.insert(decoded.end(), block, block + decodedLen);
+        sbufAdvance(&payload, compressedLen);
+    }
+
+    return decoded;
+}
+
+TEST(MspDataflashReadTest, TestLzErasedFlash)
+{
+    memset(flash, 0xFF, sizeof(flash));
+
+    // a 4K reply holds far more erased flash than its U16 byte count can report, so reading stops there
+    const readReply_t reply = readFlash(0, 4096, COMPRESSION_LZ);
+
+    EXPECT_EQ(0U, reply.address);
+    EXPECT_EQ(COMPRESSION_LZ, reply.compression);
+    EXPECT_EQ(UINT16_MAX, reply.bytesRead);
+    EXPECT_EQ(std::vector<uint8_t>(UINT16_MAX, 0xFF), decodeLz(reply.payload));
+
+    // the next request picks up where this one ended
+    const readReply_t nextReply = readFlash(reply.bytesRead, 4096, COMPRESSION_LZ);
+
+    EXPECT_EQ(UINT16_MAX, nextReply.address);
+    EXPECT_EQ(UINT16_MAX, nextReply.bytesRead);
+}
+
+TEST(MspDataflashReadTest, TestLzHuffmanErasedFlash)
+{
+    memset(flash, 0xFF, sizeof(flash));
+
+    const readReply_t reply = readFlash(0, 4096, COMPRESSION_LZ_HUFFMAN);
+
+    EXPECT_EQ(COMPRESSION_LZ_HUFFMAN, reply.compression);
+    EXPECT_EQ(UINT16_MAX, reply.bytesRead);
+}
+
+TEST(MspDataflashReadTest, TestLzEndOfFlash)
+{
+    memset(flash, 0xFF, sizeof(flash));
+
+    const readReply_t reply = readFlash(FLASH_SIZE - 1000, 4096, COMPRESSION_LZ);
+
+    EXPECT_EQ(1000, reply.bytesRead);
+    EXPECT_EQ(std::vector<uint8_t>(1000, 0xFF), decodeLz(reply.payload));
+}
+
+TEST(MspDataflashReadTest, TestLzIncompressibleData)
+{
+    srand(1);
+    for (unsigned i = 0; i < sizeof(flash); i++) {
+        flash[i] = rand();
+    }
+
+    // the reply fills up long before the byte count limit
+    const readReply_t reply = readFlash(1000, 4096, COMPRESSION_LZ);
+
+    EXPECT_EQ(1000U, reply.address);
+    EXPECT_GT(reply.bytesRead, 3000);
+    EXPECT_LT(reply.bytesRead, 4096);
+    EXPECT_EQ(std::vector<uint8_t>(flash + 1000, flash + 1000 + reply.bytesRead), decodeLz(reply.payload));
+}
+
+// STUBS
+
+extern "C" {
+    uint32_t flashfsGetSize(void)
+    {
+        return FLASH_SIZE;
+    }
+
+    int flashfsReadAbs(uint32_t offset, uint8_t *data, unsigned int len)
+    {
+        if (offset >= FLASH_SIZE) {
+            return 0;
+        }
+        len = MIN(len, FLASH_SIZE - offset);
+        memcpy(data, &flash[offset], len);
+        return len;
+    }
+}
@@ -0,0 +1,391 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/crc.h"
+    #include "common/maths.h"
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+
+    #include "drivers/time.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_dataflash_stream.h"
+    #include "msp/msp_protocol_v2_betaflight.h"
+    #include "msp/msp_serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define FLASH_SIZE      1000
+#define STREAM_PORT     1
+#define OTHER_PORT      2
+
+typedef struct chunk_s {
+    uint32_t seq;
+    uint16_t length;
+    std::vector<uint8_t> data;
+    uint16_t crc;
+} chunk_t;
+
+static uint8_t flash[FLASH_SIZE];
+static timeMs_t simulationTime;
+static int txBytesFree;
+static bool portClosed;
+static std::vector<chunk_t> chunks;
+
+static void resetStream(void)
+{
+    for (int i = 0; i < FLASH_SIZE; i++) {
+        flash[i] = i * 7 + 3;
+    }
+    simulationTime = 1000;
+    txBytesFree = 10000;
+    portClosed = false;
+    chunks.clear();
+
+    // drop any stream left over from the previous test
+    mspDataflashStreamStop(STREAM_PORT);
+}
+
+typedef struct startReply_s {
+    mspResult_e result;
+    uint32_t address;
+    uint32_t length;
+    uint16_t chunkSize;
+    uint8_t windowSize;
+    uint32_t chunkCount;
+} startReply_t;
+
+static startReply_t startStream(uint32_t address, uint32_t length, uint16_t chunkSize, uint8_t windowSize)
+{
+    uint8_t request[11];
+    uint8_t reply[32];
+    sbuf_t src = { .ptr = request, .end = ARRAYEND(request) };
+    sbuf_t dst = { .ptr = reply, .end = ARRAYEND(reply) };
+
+    sbufWriteU32(&src, address);
+    sbufWriteU32(&src, length);
+    sbufWriteU16(&src, chunkSize);
+    sbufWriteU8(&src, windowSize);
+    sbufSwitchToReader(&src, request);
+
+    startReply_t result = {};
+    result.result = mspDataflashStreamStart(STREAM_PORT, &dst, &src);
+    if (result.result == MSP_RESULT_ACK) {
+        sbufSwitchToReader(&dst, reply);
+        result.address = sbufReadU32(&dst);
+        result.length = sbufReadU32(&dst);
+        result.chunkSize = sbufReadU16(&dst);
+        result.windowSize = sbufReadU8(&dst);
+        result.chunkCount = sbufReadU32(&dst);
+    }
+    return result;
+}
+
+static void ackStream(mspDescriptor_t descriptor, uint32_t ackSeq, uint32_t resendMask)
+{
+    uint8_t request[8];
+    sbuf_t src = { .ptr = request, .end = ARRAYEND(request) };
+
+    sbufWriteU32(&src, ackSeq);
+    sbufWriteU32(&src, resendMask);
+    sbufSwitchToReader(&src, request);
+
+    mspDataflashStreamAck(descriptor, &src);
+}
+
+static std::vector<uint32_t> sentSequence(void)
+{
+    std::vector<uint32_t> seqs;
+    for (const auto &chunk : chunks) {
+        seqs.push_back(chunk.seq);
+    }
+    chunks.clear();
+    return seqs;
+}
+
+TEST(MspDataflashStreamTest, TestStartLimits)
+{
+    resetStream();
+
+    // range truncated at the end of the volume, defaults for chunk and window size
+    startReply_t reply = startStream(100, 2000, 0, 0);
+    EXPECT_EQ(MSP_RESULT_ACK, reply.result);
+    EXPECT_EQ(100, reply.address);
+    EXPECT_EQ(900, reply.length);
+    EXPECT_EQ(256, reply.chunkSize);
+    EXPECT_EQ(8, reply.windowSize);
+    EXPECT_EQ(4, reply.chunkCount);
+
+    reply = startStream(0, 100, 4, 100);
+    EXPECT_EQ(16, reply.chunkSize);
+    EXPECT_EQ(32, reply.windowSize);
+    EXPECT_EQ(7, reply.chunkCount);
+
+    reply = startStream(0, FLASH_SIZE, 1000, 1);
+    EXPECT_EQ(512, reply.chunkSize);
+    EXPECT_EQ(2, reply.chunkCount);
+
+    // start beyond the end of the volume
+    reply = startStream(FLASH_SIZE, 10, 0, 0);
+    EXPECT_EQ(MSP_RESULT_ERROR, reply.result);
+}
+
+TEST(MspDataflashStreamTest, TestChunking)
+{
+    resetStream();
+
+    const startReply_t reply = startStream(0, FLASH_SIZE, 64, 32);
+    ASSERT_EQ(16, reply.chunkCount);
+
+    mspDataflashStreamProcess();
+
+    ASSERT_EQ(16, chunks.size());
+    for (unsigned i = 0; i < chunks.size(); i++) {
+        const chunk_t &chunk = chunks[i];
+        const unsigned expectedLength = (i < 15) ? 64 : FLASH_SIZE - 15 * 64;
+
+        EXPECT_EQ(i, chunk.seq);
+        EXPECT_EQ(expectedLength, chunk.length);
+        ASSERT_EQ(expectedLength, chunk.data.size());
+        EXPECT_EQ(0, memcmp(&flash[i * 64], chunk.data.data(), expectedLength));
+        EXPECT_EQ(crc16_ccitt_update(0, &flash[i * 64], expectedLength), chunk.crc);
+    }
+
+    // nothing more to send until the host acknowledges
+    mspDataflashStreamProcess();
+    EXPECT_EQ(16, chunks.size());
+}
+
+TEST(MspDataflashStreamTest, TestWindow)
+{
+    resetStream();
+
+    startStream(0, 160, 16, 4);
+
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2, 3 }), sentSequence());
+
+    mspDataflashStreamProcess();
+    EXPECT_TRUE(sentSequence().empty());
+
+    // the window slides along with the acknowledgement
+    ackStream(STREAM_PORT, 2, 0);
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 4, 5 }), sentSequence());
+}
+
+TEST(MspDataflashStreamTest, TestResume)
+{
+    resetStream();
+
+    startStream(0, 160, 16, 4);
+    mspDataflashStreamProcess();
+    sentSequence();
+
+    // chunks 2 and 3 went missing, resent ahead of new chunks
+    ackStream(STREAM_PORT, 2, 0x3);
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 2, 3, 4, 5 }), sentSequence());
+
+    // only chunks actually sent can be requested again
+    ackStream(STREAM_PORT, 4, 0xff);
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 4, 5, 6, 7 }), sentSequence());
+}
+
+TEST(MspDataflashStreamTest, TestRetransmit)
+{
+    resetStream();
+
+    startStream(0, 160, 16, 4);
+    mspDataflashStreamProcess();
+    ackStream(STREAM_PORT, 1, 0);
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2, 3, 4 }), sentSequence());
+
+    simulationTime += 250;
+    mspDataflashStreamProcess();
+    EXPECT_TRUE(sentSequence().empty());
+
+    // no acknowledgement, the unacknowledged part of the window is sent again
+    simulationTime += 1;
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 1, 2, 3, 4 }), sentSequence());
+}
+
+TEST(MspDataflashStreamTest, TestTxBufferFull)
+{
+    resetStream();
+
+    startStream(0, 160, 16, 8);
+
+    // room for two frames
+    txBytesFree = 2 * (MSP_MAX_HEADER_SIZE + 2 + 8 + 16);
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1 }), sentSequence());
+
+    // the stream picks up where it stopped once there is room
+    txBytesFree = 10000;
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 2, 3, 4, 5, 6, 7 }), sentSequence());
+}
+
+TEST(MspDataflashStreamTest, TestEndOfStream)
+{
+    resetStream();
+
+    const startReply_t reply = startStream(0, 40, 16, 8);
+    ASSERT_EQ(3, reply.chunkCount);
+
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2 }), sentSequence());
+
+    // acknowledgements from another port or beyond what was sent are ignored
+    ackStream(OTHER_PORT, 3, 0);
+    ackStream(STREAM_PORT, 4, 0);
+    simulationTime += 251;
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2 }), sentSequence());
+
+    // acknowledging the last chunk ends the stream
+    ackStream(STREAM_PORT, 3, 0);
+    simulationTime += 251;
+    mspDataflashStreamProcess();
+    EXPECT_TRUE(sentSequence().empty());
+}
+
+TEST(MspDataflashStreamTest, TestTimeout)
+{
+    resetStream();
+
+    startStream(0, 160, 16, 4);
+    mspDataflashStreamProcess();
+    sentSequence();
+
+    // the host went quiet, the stream is abandoned
+    simulationTime += 3001;
+    mspDataflashStreamProcess();
+    EXPECT_TRUE(sentSequence().empty());
+
+    ackStream(STREAM_PORT, 4, 0);
+    mspDataflashStreamProcess();
+    EXPECT_TRUE(sentSequence().empty());
+}
+
+TEST(MspDataflashStreamTest, TestStop)
+{
+    resetStream();
+
+    startStream(0, 160, 16, 4);
+
+    // another port can't stop the stream
+    mspDataflashStreamStop(OTHER_PORT);
+    mspDataflashStreamProcess();
+    EXPECT_EQ(std::vector<uint32_t>({ 0, 1, 2, 3 }), sentSequence());
+
+    mspDataflashStreamStop(STREAM_PORT);
+    ackStream(STREAM_PORT, 4, 0);
+    mspDataflashStreamProcess();
+    EXPECT_TRUE(sentSequence().empty());
+}
+
+TEST(MspDataflashStreamTest, TestPortClosed)
+{
+    resetStream();
+
+    startStream(0, 160, 16, 4);
+    portClosed = true;
+    mspDataflashStreamProcess();
+
+    portClosed = false;
+    mspDataflashStreamProcess();
+    EXPECT_TRUE(sentSequence().empty());
+}
+
+// STUBS
+
+extern "C" {
+    bool flashfsIsSupported(void)
+    {
+        return true;
+    }
+
+    uint32_t flashfsGetSize(void)
+    {
+        return FLASH_SIZE;
+    }
+
+    int flashfsReadAbs(uint32_t offset, uint8_t *data, unsigned int len)
+    {
+        if (offset >= FLASH_SIZE) {
+            return 0;
+        }
+        len = MIN(len, FLASH_SIZE - offset);
+        memcpy(data, &flash[offset], len);
+        return len;
+    }
+
+    uint32_t millis(void)
+    {
+        return simulationTime;
+    }
+
+    bool mspSerialCanPushDescriptor(mspDescriptor_t descriptor, int frameLength)
+    {
+        EXPECT_EQ(STREAM_PORT, descriptor);
+        return frameLength <= txBytesFree;
+    }
+
+    int mspSerialPushDescriptor(mspDescriptor_t descriptor, int16_t cmd, uint8_t *data, int datalen, mspVersion_e mspVersion)
+    {
+        EXPECT_EQ(STREAM_PORT, descriptor);
+        EXPECT_EQ(MSP2_DATAFLASH_STREAM_DATA, cmd);
+        EXPECT_EQ(MSP_V2_NATIVE, mspVersion);
+
+        if (portClosed) {
+            return -1;
+        }
+
+        sbuf_t buf = { .ptr = data, .end = data + datalen };
+        chunk_t chunk;
+        chunk.seq = sbufReadU32(&buf);
+        chunk.length = sbufReadU16(&buf);
+        chunk.data.assign(sbufPtr(&buf), sbufPtr(&buf) + chunk.length);
+        sbufAdvance(&buf, chunk.length);
+        chunk.crc = sbufReadU16(&buf);
+        EXPECT_EQ(0, sbufBytesRemaining(&buf));
+        chunks.push_back(chunk);
+
+        const int frameLength = MSP_MAX_HEADER_SIZE + 2 + datalen;
+        txBytesFree -= frameLength;
+        return frameLength;
+    }
+}
@@ -0,0 +1,259 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/streambuf.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_multi.h"
+    #include "msp/msp_protocol_v2_betaflight.h"
+    #include "msp/msp_serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+enum {
+    CMD_STATUS = 1,         // reports state, 4 byte reply
+    CMD_LARGE_STATUS,       // reports state, LARGE_REPLY_SIZE byte reply
+    CMD_SET,                // changes state, no reply
+    CMD_SET_ECHO,           // changes state, replies with its payload
+    CMD_SET_LARGE,          // changes state, LARGE_REPLY_SIZE byte reply
+    CMD_REBOOT,             // leaves an action to run after the reply
+    CMD_PASSTHROUGH,        // leaves another action to run after the reply
+};
+
+#define LARGE_REPLY_SIZE 100
+
+static std::vector<int16_t> commandsRun;
+
+static void rebootFn(struct serialPort_s *) { }
+static void passthroughFn(struct serialPort_s *) { }
+
+static bool processOutCommand(mspDescriptor_t, int16_t cmdMSP, sbuf_t *dst)
+{
+    switch (cmdMSP) {
+    case CMD_STATUS:
+        sbufWriteU32(dst, 0x01020304);
+        return true;
+    case CMD_LARGE_STATUS:
+        for (int i = 0; i < LARGE_REPLY_SIZE; i++) {
+            sbufWriteU8(dst, i);
+        }
+        return true;
+    default:
+        return false;
+    }
+}
+
+static mspResult_e processCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    commandsRun.push_back(cmd->cmd);
+    if (processOutCommand(srcDesc, cmd->cmd, &reply->buf)) {
+        return MSP_RESULT_ACK;
+    }
+
+    switch (cmd->cmd) {
+    case CMD_SET:
+        return MSP_RESULT_ACK;
+    case CMD_SET_ECHO:
+        while (sbufBytesRemaining(&cmd->buf)) {
+            sbufWriteU8(&reply->buf, sbufReadU8(&cmd->buf));
+        }
+        return MSP_RESULT_ACK;
+    case CMD_SET_LARGE:
+        for (int i = 0; i < LARGE_REPLY_SIZE; i++) {
+            sbufWriteU8(&reply->buf, i);
+        }
+        return MSP_RESULT_ACK;
+    case CMD_REBOOT:
+        *mspPostProcessFn = rebootFn;
+        return MSP_RESULT_ACK;
+    case CMD_PASSTHROUGH:
+        *mspPostProcessFn = passthroughFn;
+        return MSP_RESULT_ACK;
+    default:
+        return MSP_RESULT_ERROR;
+    }
+}
+
+static void addRequest(std::vector<uint8_t> &request, int16_t cmd, const std::vector<uint8_t> &payload = {})
+{
+    request.push_back(cmd & 0xff);
+    request.push_back(cmd >> 8);
+    request.push_back(payload.size() & 0xff);
+    request.push_back(payload.size() >> 8);
+    request.insert(request.end(), payload.begin(), payload.end());
+}
+
+typedef struct subReply_s {
+    int16_t cmd;
+    int8_t result;
+    std::vector<uint8_t> payload;
+} subReply_t;
+
+static uint8_t replyBuf[1024];
+static mspPostProcessFnPtr postProcessFn;
+
+// processes the request with a reply buffer of replySize bytes and returns the sub-replies
+static std::vector<subReply_t> processMulti(std::vector<uint8_t> request, int replySize)
+{
+    commandsRun.clear();
+    postProcessFn = NULL;
+    memset(replyBuf, 0, sizeof(replyBuf));
+
+    sbuf_t src = { .ptr = request.data(), .end = request.data() + request.size() };
+    sbuf_t dst = { .ptr = replyBuf, .end = replyBuf + replySize };
+    EXPECT_EQ(MSP_RESULT_ACK, mspMultiProcessCommand(0, &dst, &src, &postProcessFn, processCommand, processOutCommand));
+    EXPECT_LE(dst.ptr, replyBuf + replySize);
+
+    sbuf_t reply = { .ptr = replyBuf, .end = dst.ptr };
+    std::vector<subReply_t> subReplies(sbufReadU8(&reply));
+    for (auto &subReply : subReplies) {
+        subReply.cmd = sbufReadU16(&reply);
+        subReply.result = sbufReadU8(&reply);
+        subReply.payload.resize(sbufReadU16(&reply));
+        sbufReadData(&reply, subReply.payload.data(), subReply.payload.size());
+        sbufAdvance(&reply, subReply.payload.size());
+    }
+    EXPECT_EQ(0, sbufBytesRemaining(&reply));
+
+    return subReplies;
+}
+
+TEST(MspMultiTest, TestBatch)
+{
+    std::vector<uint8_t> request;
+    addRequest(request, CMD_STATUS);
+    addRequest(request, CMD_SET, { 7 });
+    addRequest(request, CMD_SET_ECHO, { 1, 2, 3 });
+
+    const auto subReplies = processMulti(request, sizeof(replyBuf));
+
+    ASSERT_EQ(3U, subReplies.size());
+    EXPECT_EQ(CMD_STATUS, subReplies[0].cmd);
+    EXPECT_EQ(MSP_RESULT_ACK, subReplies[0].result);
+    EXPECT_EQ(std::vector<uint8_t>({ 4, 3, 2, 1 }), subReplies[0].payload);
+    EXPECT_EQ(CMD_SET, subReplies[1].cmd);
+    EXPECT_EQ(MSP_RESULT_ACK, subReplies[1].result);
+    EXPECT_TRUE(subReplies[1].payload.empty());
+    EXPECT_EQ(CMD_SET_ECHO, subReplies[2].cmd);
+    EXPECT_EQ(std::vector<uint8_t>({ 1, 2, 3 }), subReplies[2].payload);
+
+    // state is reported without going through the full dispatch
+    EXPECT_EQ(std::vector<int16_t>({ CMD_SET, CMD_SET_ECHO }), commandsRun);
+    EXPECT_EQ(NULL, postProcessFn);
+}
+
+TEST(MspMultiTest, TestStatusTooLargeEndsBatch)
+{
+    std::vector<uint8_t> request;
+    addRequest(request, CMD_STATUS);
+    addRequest(request, CMD_LARGE_STATUS);
+    addRequest(request, CMD_STATUS);
+
+    // room for the first reply and the header of the second
+    const auto subReplies = processMulti(request, 1 + 5 + 4 + 5 + LARGE_REPLY_SIZE - 1);
+
+    ASSERT_EQ(1U, subReplies.size());
+    EXPECT_EQ(CMD_STATUS, subReplies[0].cmd);
+}
+
+TEST(MspMultiTest, TestCommandNotRunWithoutRoom)
+{
+    std::vector<uint8_t> request;
+    addRequest(request, CMD_STATUS);
+    addRequest(request, CMD_SET);
+
+    // the reply of the set command would fit, but it can't be known before it has run
+    const auto subReplies = processMulti(request, 1 + 5 + 4 + 5 + MSP_PORT_OUTBUF_SIZE_MIN - 1);
+
+    ASSERT_EQ(1U, subReplies.size());
+    EXPECT_EQ(CMD_STATUS, subReplies[0].cmd);
+    EXPECT_TRUE(commandsRun.empty());
+
+    // with room for any reply it runs
+    const auto allSubReplies = processMulti(request, 1 + 5 + 4 + 5 + MSP_PORT_OUTBUF_SIZE_MIN);
+
+    ASSERT_EQ(2U, allSubReplies.size());
+    EXPECT_EQ(std::vector<int16_t>({ CMD_SET }), commandsRun);
+}
+
+TEST(MspMultiTest, TestFirstReplyTruncated)
+{
+    std::vector<uint8_t> request;
+    addRequest(request, CMD_SET_LARGE);
+    addRequest(request, CMD_STATUS);
+
+    // the first sub-request runs whatever the space, no envelope can hold its reply
+    const auto subReplies = processMulti(request, 1 + 5 + LARGE_REPLY_SIZE - 1);
+
+    ASSERT_EQ(2U, subReplies.size());
+    EXPECT_EQ(CMD_SET_LARGE, subReplies[0].cmd);
+    EXPECT_EQ(MSP2MULTI_RESULT_TRUNCATED, subReplies[0].result);
+    EXPECT_TRUE(subReplies[0].payload.empty());
+    EXPECT_EQ(CMD_STATUS, subReplies[1].cmd);
+    EXPECT_EQ(MSP_RESULT_ACK, subReplies[1].result);
+    EXPECT_EQ(std::vector<int16_t>({ CMD_SET_LARGE }), commandsRun);
+}
+
+TEST(MspMultiTest, TestNestedMultiRejected)
+{
+    std::vector<uint8_t> nested;
+    addRequest(nested, CMD_SET);
+
+    std::vector<uint8_t> request;
+    addRequest(request, MSP2_MULTI, nested);
+    addRequest(request, CMD_STATUS);
+
+    const auto subReplies = processMulti(request, sizeof(replyBuf));
+
+    ASSERT_EQ(2U, subReplies.size());
+    EXPECT_EQ(MSP2_MULTI, subReplies[0].cmd);
+    EXPECT_EQ(MSP_RESULT_ERROR, subReplies[0].result);
+    EXPECT_TRUE(subReplies[0].payload.empty());
+    EXPECT_EQ(CMD_STATUS, subReplies[1].cmd);
+    EXPECT_EQ(MSP_RESULT_ACK, subReplies[1].result);
+    EXPECT_TRUE(commandsRun.empty());
+}
+
+TEST(MspMultiTest, TestPostProcessNotReplaced)
+{
+    std::vector<uint8_t> request;
+    addRequest(request, CMD_REBOOT);
+    addRequest(request, CMD_PASSTHROUGH);
+    addRequest(request, CMD_STATUS);
+
+    const auto subReplies = processMulti(request, sizeof(replyBuf));
+
+    // nothing runs after a sub-request that leaves an action behind
+    ASSERT_EQ(1U, subReplies.size());
+    EXPECT_EQ(CMD_REBOOT, subReplies[0].cmd);
+    EXPECT_EQ(std::vector<int16_t>({ CMD_REBOOT }), commandsRun);
+    EXPECT_EQ(rebootFn, postProcessFn);
+}
@@ -0,0 +1,342 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <deque>
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/maths.h"
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+
+    #include "drivers/serial.h"
+    #include "drivers/system.h"
+    #include "drivers/time.h"
+
+    #include "io/serial.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_protocol.h"
+    #include "msp/msp_serial.h"
+
+    #include "pg/msp.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    PG_REGISTER(serialConfig_t, serialConfig, PG_SERIAL_CONFIG, 0);
+    PG_REGISTER(mspConfig_t, mspConfig, PG_MSP_CONFIG, 0);
+
+    const uint32_t baudRates[] = { 0, 9600, 19200, 38400, 57600, 115200 };
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define TX_BUFFER_SIZE  256
+#define PUSH_CMD_FAST   MSP_ATTITUDE
+#define PUSH_CMD_SLOW   MSP_ANALOG
+#define REPLY_PAYLOAD_SIZE 40
+
+static serialPort_t testPort;
+static serialPortConfig_t testPortConfig;
+static std::deque<uint8_t> rxBuffer;
+static std::vector<uint8_t> txBuffer;
+static timeMs_t simulationTime;
+static int pushPayloadSize;
+
+static void initPort(void)
+{
+    testPort = {};
+    testPort.identifier = SERIAL_PORT_USART1;
+    testPort.txBufferSize = TX_BUFFER_SIZE;
+    testPortConfig = {};
+    testPortConfig.identifier = SERIAL_PORT_USART1;
+    testPortConfig.functionMask = FUNCTION_MSP;
+
+    rxBuffer.clear();
+    txBuffer.clear();
+    simulationTime = 1000;
+    pushPayloadSize = 10;
+
+    mspSerialInit();
+}
+
+static void subscribe(const std::vector<int16_t> &cmds, const std::vector<uint16_t> &intervalsMs, uint32_t bytesPerSecond)
+{
+    const mspDescriptor_t descriptor = getMspSerialPortDescriptor(SERIAL_PORT_USART1);
+    EXPECT_EQ((int)cmds.size(), mspSerialSetSubscriptions(descriptor, cmds.data(), intervalsMs.data(), cmds.size(), bytesPerSecond));
+}
+
+static mspResult_e processCommand(mspDescriptor_t srcDesc, mspPacket_t *cmd, mspPacket_t *reply, mspPostProcessFnPtr *mspPostProcessFn)
+{
+    UNUSED(srcDesc);
+    UNUSED(mspPostProcessFn);
+
+    reply->cmd = cmd->cmd;
+    for (int i = 0; i < REPLY_PAYLOAD_SIZE; i++) {
+        sbufWriteU8(&reply->buf, i);
+    }
+    return MSP_RESULT_ACK;
+}
+
+static bool processOutCommand(mspDescriptor_t srcDesc, int16_t cmdMSP, sbuf_t *dst)
+{
+    UNUSED(srcDesc);
+
+    for (int i = 0; i < pushPayloadSize; i++) {
+        sbufWriteU8(dst, cmdMSP);
+    }
+    return true;
+}
+
+static void process(void)
+{
+    mspSerialProcess(MSP_SKIP_NON_MSP_DATA, processCommand, NULL, processOutCommand);
+}
+
+static void sendRequest(uint8_t cmd)
+{
+    const uint8_t request[] = { '$', 'M', '<', 0, cmd, cmd };
+    rxBuffer.insert(rxBuffer.end(), request, request + sizeof(request));
+}
+
+// Split the transmitted data into MSPv1 frames and return their commands
+static std::vector<uint8_t> transmittedCommands(void)
+{
+    std::vector<uint8_t> cmds;
+    size_t i = 0;
+    while (i + 5 < txBuffer.size()) {
+        EXPECT_EQ('$', txBuffer[i]);
+        EXPECT_EQ('M', txBuffer[i + 1]);
+        EXPECT_EQ('>', txBuffer[i + 2]);
+        const uint8_t size = txBuffer[i + 3];
+        cmds.push_back(txBuffer[i + 4]);
+        i += 6 + size;
+    }
+    EXPECT_EQ(txBuffer.size(), i);
+    return cmds;
+}
+
+static int countCommand(const std::vector<uint8_t> &cmds, uint8_t cmd)
+{
+    int count = 0;
+    for (const uint8_t c : cmds) {
+        count += (c == cmd);
+    }
+    return count;
+}
+
+TEST(MspSerialTest, TestIntervalScheduling)
+{
+    initPort();
+    subscribe({ PUSH_CMD_FAST, PUSH_CMD_SLOW }, { 100, 250 }, 0);
+
+    std::vector<uint8_t> cmds;
+    for (int t = 0; t <= 1000; t += 10) {
+        simulationTime = 1000 + t;
+        process();
+        const std::vector<uint8_t> sent = transmittedCommands();
+        cmds.insert(cmds.end(), sent.begin(), sent.end());
+        txBuffer.clear();
+    }
+
+    // both due straight away, then at their intervals
+    EXPECT_EQ(11, countCommand(cmds, PUSH_CMD_FAST));
+    EXPECT_EQ(5, countCommand(cmds, PUSH_CMD_SLOW));
+    EXPECT_EQ(PUSH_CMD_FAST, cmds[0]);
+    EXPECT_EQ(PUSH_CMD_SLOW, cmds[1]);
+}
+
+TEST(MspSerialTest, TestTokenBucket)
+{
+    initPort();
+    pushPayloadSize = 44;   // 50 byte frames
+    subscribe({ PUSH_CMD_FAST }, { 1 }, 1000);
+
+    int bytesSent = 0;
+    for (int t = 0; t < 2000; t++) {
+        simulationTime = 1000 + t;
+        process();
+        bytesSent += txBuffer.size();
+        txBuffer.clear();
+    }
+
+    // the bucket starts empty and may overdraw by one frame
+    EXPECT_GE(bytesSent, 2000 - 50);
+    EXPECT_LE(bytesSent, 2000 + 50);
+}
+
+TEST(MspSerialTest, TestReplyPriority)
+{
+    initPort();
+    pushPayloadSize = 44;
+    subscribe({ PUSH_CMD_FAST, PUSH_CMD_SLOW }, { 1, 1 }, 0);
+
+    // the TX buffer is not drained, pushes stop short of the reply reserve
+    for (int t = 0; t < 10; t++) {
+        simulationTime = 1000 + t;
+        process();
+    }
+    EXPECT_FALSE(txBuffer.empty());
+    EXPECT_GE(TX_BUFFER_SIZE - (int)txBuffer.size(), MIN(MSP_PORT_TX_REPLY_RESERVE, TX_BUFFER_SIZE / 2));
+
+    // a request is still answered
+    const size_t pushedBytes = txBuffer.size();
+    sendRequest(MSP_API_VERSION);
+    simulationTime++;
+    process();
+    ASSERT_EQ(pushedBytes + 6 + REPLY_PAYLOAD_SIZE, txBuffer.size());
+    EXPECT_EQ(MSP_API_VERSION, transmittedCommands().back());
+}
+
+TEST(MspSerialTest, TestNoPushWhileRequestArriving)
+{
+    initPort();
+    subscribe({ PUSH_CMD_FAST }, { 1 }, 0);
+
+    // half a request is waiting, pushes hold off until the reply has gone out
+    const uint8_t partialRequest[] = { '$', 'M', '<' };
+    rxBuffer.insert(rxBuffer.end(), partialRequest, partialRequest + sizeof(partialRequest));
+    process();
+    EXPECT_TRUE(txBuffer.empty());
+
+    const uint8_t remainder[] = { 0, MSP_API_VERSION, MSP_API_VERSION };
+    rxBuffer.insert(rxBuffer.end(), remainder, remainder + sizeof(remainder));
+    process();
+    const std::vector<uint8_t> cmds = transmittedCommands();
+    ASSERT_EQ(2, cmds.size());
+    EXPECT_EQ(MSP_API_VERSION, cmds[0]);
+    EXPECT_EQ(PUSH_CMD_FAST, cmds[1]);
+}
+
+// STUBS
+
+extern "C" {
+    uint32_t millis(void)
+    {
+        return simulationTime;
+    }
+
+    mspDescriptor_t mspDescriptorAlloc(void)
+    {
+        return 0;
+    }
+
+    const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e function)
+    {
+        return function == FUNCTION_MSP ? &testPortConfig : NULL;
+    }
+
+    const serialPortConfig_t *findNextSerialPortConfig(serialPortFunction_e function)
+    {
+        UNUSED(function);
+        return NULL;
+    }
+
+    bool isSerialPortShared(const serialPortConfig_t *portConfig, uint16_t functionMask, serialPortFunction_e sharedWithFunction)
+    {
+        UNUSED(portConfig);
+        UNUSED(functionMask);
+        UNUSED(sharedWithFunction);
+        return false;
+    }
+
+    serialPort_t *openSerialPort(serialPortIdentifier_e identifier, serialPortFunction_e function, serialReceiveCallbackPtr rxCallback,
+                                 void *rxCallbackData, uint32_t baudrate, portMode_e mode, portOptions_e options)
+    {
+        UNUSED(identifier);
+        UNUSED(function);
+        UNUSED(rxCallback);
+        UNUSED(rxCallbackData);
+        UNUSED(baudrate);
+        UNUSED(mode);
+        UNUSED(options);
+        return &testPort;
+    }
+
+    void closeSerialPort(serialPort_t *serialPort)
+    {
+        UNUSED(serialPort);
+    }
+
+    void waitForSerialPortToFinishTransmitting(serialPort_t *serialPort)
+    {
+        UNUSED(serialPort);
+    }
+
+    uint32_t serialRxBytesWaiting(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return rxBuffer.size();
+    }
+
+    uint8_t serialRead(serialPort_t *instance)
+    {
+        UNUSED(instance);
+        const uint8_t c = rxBuffer.front();
+        rxBuffer.pop_front();
+        return c;
+    }
+
+    uint32_t serialTxBytesFree(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return TX_BUFFER_SIZE - txBuffer.size();
+    }
+
+    bool isSerialTransmitBufferEmpty(const serialPort_t *instance)
+    {
+        UNUSED(instance);
+        return txBuffer.empty();
+    }
+
+    void serialBeginWrite(serialPort_t *instance)
+    {
+        UNUSED(instance);
+    }
+
+    void serialWriteBufNoFlush(serialPort_t *instance, const uint8_t *data, int count)
+    {
+        UNUSED(instance);
+        txBuffer.insert(txBuffer.end(), data, data + count);
+        EXPECT_LE(txBuffer.size(), (size_t)TX_BUFFER_SIZE);
+    }
+
+    void serialEndWrite(serialPort_t *instance)
+    {
+        UNUSED(instance);
+    }
+
+    void systemResetToBootloader(bootloaderRequestType_e requestType)
+    {
+        UNUSED(requestType);
+    }
+
+    void cliEnter(serialPort_t *serialPort)
+    {
+        UNUSED(serialPort);
+    }
+}
@@ -0,0 +1,325 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "cli/settings.h"
+
+    #include "common/streambuf.h"
+    #include "common/utils.h"
+
+    #include "fc/runtime_config.h"
+
+    #include "flight/pid.h"
+
+    #include "msp/msp.h"
+    #include "msp/msp_protocol_v2_betaflight.h"
+    #include "msp/msp_settings.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    typedef struct testConfig_s {
+        uint8_t level;
+        int16_t offset;
+        uint8_t mode;
+        uint8_t weights[3];
+        int16_t trims[2];
+        uint32_t flags;
+        char name[9];
+        uint8_t pidValue;
+        uint8_t rateValue;
+    } testConfig_t;
+
+    PG_DECLARE(testConfig_t, testConfig);
+    PG_REGISTER_WITH_RESET_TEMPLATE(testConfig_t, testConfig, PG_RESERVED_FOR_TESTING_1, 0);
+    PG_RESET_TEMPLATE(testConfig_t, testConfig,
+        .level = 50,
+        .offset = -10,
+        .mode = 1,
+        .weights = { 100, 100, 100 },
+        .trims = { 0, 0 },
+        .flags = 0,
+        .name = "quad",
+        .pidValue = 0,
+        .rateValue = 0,
+    );
+
+    enum {
+        SETTING_LEVEL,
+        SETTING_OFFSET,
+        SETTING_MODE,
+        SETTING_WEIGHTS,
+        SETTING_TRIMS,
+        SETTING_FLAG,
+        SETTING_NAME,
+        SETTING_PID_VALUE,
+        SETTING_RATE_VALUE,
+        SETTING_COUNT
+    };
+
+    const clivalue_t valueTable[] = {
+        { .name = "level",      .type = VAR_UINT8 | MODE_DIRECT | MASTER_VALUE,       .config = { .minmaxUnsigned = { 10, 100 } },          .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, level) },
+        { .name = "offset",     .type = VAR_INT16 | MODE_DIRECT | MASTER_VALUE,       .config = { .minmax = { -50, 50 } },                  .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, offset) },
+        { .name = "mode",       .type = VAR_UINT8 | MODE_LOOKUP | MASTER_VALUE,       .config = { .lookup = { TABLE_OFF_ON } },             .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, mode) },
+        { .name = "weights",    .type = VAR_UINT8 | MODE_ARRAY | MASTER_VALUE,        .config = { .array = { .max = 100, .length = 3 } },   .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, weights) },
+        { .name = "trims",      .type = VAR_INT16 | MODE_ARRAY | MASTER_VALUE,        .config = { .array = { .length = 2 } },               .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, trims) },
+        { .name = "flag",       .type = VAR_UINT32 | MODE_BITSET | MASTER_VALUE,      .config = { .bitpos = 2 },                            .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, flags) },
+        { .name = "name",       .type = VAR_UINT8 | MODE_STRING | MASTER_VALUE,       .config = { .string = { 2, 8, STRING_FLAGS_NONE } },  .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, name) },
+        { .name = "pid_value",  .type = VAR_UINT8 | MODE_DIRECT | PROFILE_VALUE,      .config = { .minmaxUnsigned = { 0, 200 } },           .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, pidValue) },
+        { .name = "rate_value", .type = VAR_UINT8 | MODE_DIRECT | PROFILE_RATE_VALUE, .config = { .minmaxUnsigned = { 0, 200 } },           .pgn = PG_RESERVED_FOR_TESTING_1, .offset = offsetof(testConfig_t, rateValue) },
+    };
+    const uint16_t valueTableEntryCount = ARRAYLEN(valueTable);
+
+    static const char * const offOn[] = { "OFF", "ON" };
+    const lookupTableEntry_t lookupTables[LOOKUP_TABLE_COUNT] = {
+        [TABLE_OFF_ON] = { offOn, ARRAYLEN(offOn) },
+    };
+
+    uint8_t armingFlags;
+    pidProfile_t *currentPidProfile;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static int pidInitConfigCount;
+static int initRcProcessingCount;
+
+typedef struct settingsReply_s {
+    mspResult_e result;
+    std::vector<uint8_t> data;
+} settingsReply_t;
+
+static settingsReply_t processCommand(int16_t cmd, const std::vector<uint8_t> &request)
+{
+    uint8_t requestBuf[256];
+    uint8_t replyBuf[512];
+    memcpy(requestBuf, request.data(), request.size());
+    sbuf_t src = { .ptr = requestBuf, .end = requestBuf + request.size() };
+    sbuf_t dst = { .ptr = replyBuf, .end = ARRAYEND(replyBuf) };
+
+    settingsReply_t reply;
+    reply.result = mspSettingsProcessCommand(cmd, &src, &dst);
+    reply.data.assign(replyBuf, sbufPtr(&dst));
+    return reply;
+}
+
+static void addRecord(std::vector<uint8_t> &frame, uint16_t index, const std::vector<uint8_t> &value)
+{
+    frame.push_back(index & 0xff);
+    frame.push_back(index >> 8);
+    frame.push_back(value.size());
+    frame.insert(frame.end(), value.begin(), value.end());
+}
+
+static uint16_t readU16(const std::vector<uint8_t> &data, int offset)
+{
+    return data[offset] | (data[offset + 1] << 8);
+}
+
+static void resetSettings(void)
+{
+    pgResetAll();
+    armingFlags = 0;
+    pidInitConfigCount = 0;
+    initRcProcessingCount = 0;
+}
+
+TEST(MspSettingsTest, TestInfoAndSchema)
+{
+    resetSettings();
+
+    settingsReply_t reply = processCommand(MSP2_SETTINGS_INFO, {});
+    EXPECT_EQ(MSP_RESULT_ACK, reply.result);
+    ASSERT_EQ(7, reply.data.size());
+    EXPECT_EQ(SETTING_COUNT, readU16(reply.data, 0));
+    EXPECT_EQ(LOOKUP_TABLE_COUNT, reply.data[2]);
+
+    // schema of the array setting: index, type, name and limits
+    reply = processCommand(MSP2_SETTINGS_SCHEMA, { SETTING_WEIGHTS, 0 });
+    ASSERT_GE(reply.data.size(), 2 + 2 + 2 + strlen("weights") + 2);
+    EXPECT_EQ(SETTING_WEIGHTS, readU16(reply.data, 2));
+    EXPECT_EQ(VAR_UINT8 | MODE_ARRAY | MASTER_VALUE, reply.data[4]);
+    EXPECT_EQ(strlen("weights"), reply.data[5]);
+    EXPECT_EQ(0, memcmp("weights", &reply.data[6], strlen("weights")));
+    EXPECT_EQ(3, reply.data[6 + strlen("weights")]);
+    EXPECT_EQ(100, reply.data[7 + strlen("weights")]);
+}
+
+TEST(MspSettingsTest, TestGet)
+{
+    resetSettings();
+
+    settingsReply_t reply = processCommand(MSP2_SETTINGS_GET, { SETTING_LEVEL, 0, 2, 0 });
+    EXPECT_EQ(MSP_RESULT_ACK, reply.result);
+    EXPECT_EQ(std::vector<uint8_t>({ 0xff, 0xff, SETTING_LEVEL, 0, 1, 50, SETTING_OFFSET, 0, 2, 0xf6, 0xff }), reply.data);
+
+    // only the values that differ from the defaults
+    testConfigMutable()->flags = 1 << 2;
+    strcpy(testConfigMutable()->name, "hex");
+    reply = processCommand(MSP2_SETTINGS_GET, { 0, 0, SETTING_COUNT, 0, 1 });
+    EXPECT_EQ(std::vector<uint8_t>({ 0xff, 0xff, SETTING_FLAG, 0, 1, 1, SETTING_NAME, 0, 3, 'h', 'e', 'x' }), reply.data);
+}
+
+TEST(MspSettingsTest, TestSet)
+{
+    resetSettings();
+
+    std::vector<uint8_t> frame;
+    addRecord(frame, SETTING_LEVEL, { 80 });
+    addRecord(frame, SETTING_OFFSET, { 0xe2, 0xff });
+    addRecord(frame, SETTING_MODE, { 0 });
+    addRecord(frame, SETTING_WEIGHTS, { 0, 50, 100 });
+    addRecord(frame, SETTING_TRIMS, { 0x00, 0x80, 0xff, 0x7f });
+    addRecord(frame, SETTING_FLAG, { 1 });
+    addRecord(frame, SETTING_NAME, { 'w', 'i', 'n', 'g' });
+
+    const settingsReply_t reply = processCommand(MSP2_SETTINGS_SET, frame);
+    EXPECT_EQ(MSP_RESULT_ACK, reply.result);
+    EXPECT_EQ(std::vector<uint8_t>({ 7, 0, 0xff, 0xff }), reply.data);
+
+    EXPECT_EQ(80, testConfig()->level);
+    EXPECT_EQ(-30, testConfig()->offset);
+    EXPECT_EQ(0, testConfig()->mode);
+    EXPECT_EQ(0, testConfig()->weights[0]);
+    EXPECT_EQ(50, testConfig()->weights[1]);
+    EXPECT_EQ(100, testConfig()->weights[2]);
+    EXPECT_EQ(INT16_MIN, testConfig()->trims[0]);
+    EXPECT_EQ(INT16_MAX, testConfig()->trims[1]);
+    EXPECT_EQ(1U << 2, testConfig()->flags);
+    EXPECT_STREQ("wing", testConfig()->name);
+
+    // master values need no further processing
+    EXPECT_EQ(0, pidInitConfigCount);
+    EXPECT_EQ(0, initRcProcessingCount);
+}
+
+TEST(MspSettingsTest, TestSetRejectsWholeFrame)
+{
+    resetSettings();
+
+    const std::vector<std::vector<uint8_t>> invalidRecords[] = {
+        { { SETTING_OFFSET, 0 }, { 0x33, 0x00 } },          // above the maximum
+        { { SETTING_MODE, 0 }, { 2 } },                     // beyond the lookup table
+        { { SETTING_WEIGHTS, 0 }, { 100, 101, 0 } },        // array element above the maximum
+        { { SETTING_TRIMS, 0 }, { 0, 0 } },                 // too few elements
+        { { SETTING_FLAG, 0 }, { 2 } },
+        { { SETTING_NAME, 0 }, { 'x' } },                   // too short
+        { { SETTING_NAME, 0 }, { 'a', 0, 'b' } },
+        { { SETTING_COUNT, 0 }, { 0 } },                    // no such setting
+    };
+
+    for (const auto &invalid : invalidRecords) {
+        const uint16_t index = readU16(invalid[0], 0);
+
+        std::vector<uint8_t> frame;
+        addRecord(frame, SETTING_LEVEL, { 80 });
+        addRecord(frame, index, invalid[1]);
+        addRecord(frame, SETTING_RATE_VALUE, { 10 });
+
+        const settingsReply_t reply = processCommand(MSP2_SETTINGS_SET, frame);
+        EXPECT_EQ(MSP_RESULT_ACK, reply.result);
+        EXPECT_EQ(std::vector<uint8_t>({ 0, 0, (uint8_t)(index & 0xff), (uint8_t)(index >> 8) }), reply.data);
+
+        // the valid records around the rejected one are not applied either
+        EXPECT_EQ(50, testConfig()->level);
+        EXPECT_EQ(0, testConfig()->rateValue);
+    }
+
+    EXPECT_EQ(0, memcmp(testConfig(), pgDefaults(pgFind(PG_RESERVED_FOR_TESTING_1)), sizeof(testConfig_t)));
+    EXPECT_EQ(0, initRcProcessingCount);
+}
+
+TEST(MspSettingsTest, TestSetMalformed)
+{
+    resetSettings();
+
+    std::vector<uint8_t> frame;
+    addRecord(frame, SETTING_LEVEL, { 80 });
+    addRecord(frame, SETTING_OFFSET, { 0x00, 0x00 });
+
+    // record cut short
+    std::vector<uint8_t> truncated(frame.begin(), frame.end() - 1);
+    EXPECT_EQ(MSP_RESULT_ERROR, processCommand(MSP2_SETTINGS_SET, truncated).result);
+
+    // header cut short
+    truncated.assign(frame.begin(), frame.begin() + 6);
+    EXPECT_EQ(MSP_RESULT_ERROR, processCommand(MSP2_SETTINGS_SET, truncated).result);
+
+    EXPECT_EQ(50, testConfig()->level);
+
+    // nothing can be changed while armed
+    armingFlags = ARMED;
+    EXPECT_EQ(MSP_RESULT_ERROR, processCommand(MSP2_SETTINGS_SET, frame).result);
+    EXPECT_EQ(50, testConfig()->level);
+}
+
+TEST(MspSettingsTest, TestSetActivatesProfiles)
+{
+    resetSettings();
+
+    std::vector<uint8_t> frame;
+    addRecord(frame, SETTING_PID_VALUE, { 20 });
+    processCommand(MSP2_SETTINGS_SET, frame);
+    EXPECT_EQ(20, testConfig()->pidValue);
+    EXPECT_EQ(1, pidInitConfigCount);
+    EXPECT_EQ(0, initRcProcessingCount);
+
+    frame.clear();
+    addRecord(frame, SETTING_RATE_VALUE, { 30 });
+    addRecord(frame, SETTING_RATE_VALUE, { 40 });
+    processCommand(MSP2_SETTINGS_SET, frame);
+    EXPECT_EQ(40, testConfig()->rateValue);
+    EXPECT_EQ(1, pidInitConfigCount);
+    EXPECT_EQ(1, initRcProcessingCount);
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t getCurrentPidProfileIndex(void)
+    {
+        return 0;
+    }
+
+    uint8_t getCurrentControlRateProfileIndex(void)
+    {
+        return 0;
+    }
+
+    void pidInitConfig(const pidProfile_t *pidProfile)
+    {
+        UNUSED(pidProfile);
+        pidInitConfigCount++;
+    }
+
+    void initRcProcessing(void)
+    {
+        initRcProcessingCount++;
+    }
+}
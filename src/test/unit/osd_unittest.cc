@@ -856,6 +856,44 @@ TEST_F(OsdTest, TestElementMahDrawn)
     displayPortTestBufferSubstring(1, 11, "1042%c", SYM_MAH);
 }
 
+/*
+ * Tests that an unchanged element is redrawn from its cached text.
+ */
+TEST_F(OsdTest, TestElementCachedText)
+{
+    // given
+    osdElementConfigMutable()->item_pos[OSD_MAH_DRAWN] = OSD_POS(1, 11) | OSD_PROFILE_1_FLAG;
+
+    osdAnalyzeActiveElements();
+
+    // when
+    simulationMahDrawn = 123;
+    displayClearScreen(&testDisplayPort, DISPLAY_CLEAR_WAIT);
+    osdRefresh();
+    displayClearScreen(&testDisplayPort, DISPLAY_CLEAR_WAIT);
+    osdRefresh();
+
+    // then
+    displayPortTestBufferSubstring(1, 11, " 123%c", SYM_MAH);
+
+    // when
+    osdElementConfigMutable()->item_pos[OSD_MAH_DRAWN] = OSD_POS(1, 12) | OSD_PROFILE_1_FLAG;
+    osdAnalyzeActiveElements();
+    displayClearScreen(&testDisplayPort, DISPLAY_CLEAR_WAIT);
+    osdRefresh();
+
+    // then
+    displayPortTestBufferSubstring(1, 12, " 123%c", SYM_MAH);
+
+    // when
+    simulationMahDrawn = 124;
+    displayClearScreen(&testDisplayPort, DISPLAY_CLEAR_WAIT);
+    osdRefresh();
+
+    // then
+    displayPortTestBufferSubstring(1, 12, " 124%c", SYM_MAH);
+}
+
 /*
  * Tests the instantaneous electrical power OSD element.
  */
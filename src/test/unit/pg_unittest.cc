@@ -84,6 +84,53 @@ TEST(ParameterGroupsfTest, Test_pgFind)
     EXPECT_EQ(400, motorConfig3.dev.motorPwmRate);
 }
 
+TEST(ParameterGroupsfTest, Test_pgDefaults)
+{
+    const pgRegistry_t *pgRegistry = pgFind(PG_MOTOR_CONFIG);
+    pgReset(pgRegistry);
+    motorConfigMutable()->minthrottle = 1070;
+
+    const motorConfig_t *defaults = (const motorConfig_t *)pgDefaults(pgRegistry);
+    ASSERT_NE(nullptr, defaults);
+    EXPECT_EQ(1150, defaults->minthrottle);
+    EXPECT_EQ(400, defaults->dev.motorPwmRate);
+    EXPECT_EQ(1070, motorConfig()->minthrottle);
+
+    // generated once, then reused until released
+    EXPECT_EQ(defaults, pgDefaults(pgRegistry));
+    pgDefaultsRelease();
+    defaults = (const motorConfig_t *)pgDefaults(pgRegistry);
+    ASSERT_NE(nullptr, defaults);
+    EXPECT_EQ(1150, defaults->minthrottle);
+}
+
+TEST(ParameterGroupsfTest, Test_pgDefaultsTargetOverrides)
+{
+    // the target configuration changes some of the reset values
+    pgResetAll();
+    motorConfigMutable()->minthrottle = 1070;
+    motorConfigMutable()->dev.motorPwmRate = 480;
+    EXPECT_TRUE(pgDefaultsCaptureOverrides());
+
+    // then the saved config is loaded
+    const pgRegistry_t *pgRegistry = pgFind(PG_MOTOR_CONFIG);
+    pgReset(pgRegistry);
+    motorConfigMutable()->maxthrottle = 1900;
+
+    const motorConfig_t *defaults = (const motorConfig_t *)pgDefaults(pgRegistry);
+    EXPECT_EQ(1070, defaults->minthrottle);
+    EXPECT_EQ(480, defaults->dev.motorPwmRate);
+    EXPECT_EQ(1850, defaults->maxthrottle);
+    EXPECT_EQ(1000, defaults->mincommand);
+
+    // without target configuration the defaults are the reset values
+    pgResetAll();
+    EXPECT_TRUE(pgDefaultsCaptureOverrides());
+    defaults = (const motorConfig_t *)pgDefaults(pgRegistry);
+    EXPECT_EQ(1150, defaults->minthrottle);
+    EXPECT_EQ(400, defaults->dev.motorPwmRate);
+}
+
 // STUBS
 
 extern "C" {
@@ -0,0 +1,181 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "common/axis.h"
+    #include "common/maths.h"
+    #include "common/utils.h"
+
+    #include "build/debug.h"
+
+    #include "fc/controlrate_profile.h"
+    #include "fc/rc.h"
+    #include "fc/rc_controls.h"
+    #include "fc/rc_modes.h"
+
+    #include "flight/imu.h"
+    #include "flight/pid.h"
+
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+    #include "pg/rx.h"
+
+    #include "rx/rx.h"
+
+    #include "sensors/battery.h"
+
+    float applyBetaflightRates(const int axis, float rcCommandf, const float rcCommandfAbs);
+    float applyRaceFlightRates(const int axis, float rcCommandf, const float rcCommandfAbs);
+    float applyKissRates(const int axis, float rcCommandf, const float rcCommandfAbs);
+    float applyActualRates(const int axis, float rcCommandf, const float rcCommandfAbs);
+    float applyQuickRates(const int axis, float rcCommandf, const float rcCommandfAbs);
+    float applyRatesCurve(const int axis, const float rcCommandf, const float rcCommandfAbs);
+
+    static controlRateConfig_t controlRateConfig;
+    controlRateConfig_t *currentControlRateProfile = &controlRateConfig;
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+typedef float (ratesFn)(const int axis, float rcCommandf, const float rcCommandfAbs);
+
+// largest difference between the tabulated and analytic rates curves, and the largest rate
+static void ratesCurveError(ratesFn *analytic, float *maxError, float *maxRate)
+{
+    *maxError = 0.0f;
+    *maxRate = 0.0f;
+
+    initRcProcessing();
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        for (int i = -1000; i <= 1000; i++) {
+            const float rcCommandf = i / 1000.0f;
+            const float expected = analytic(axis, rcCommandf, fabsf(rcCommandf));
+            const float actual = applyRatesCurve(axis, rcCommandf, fabsf(rcCommandf));
+
+            *maxError = fmaxf(*maxError, fabsf(actual - expected));
+            *maxRate = fmaxf(*maxRate, fabsf(expected));
+        }
+    }
+}
+
+static void setRates(ratesType_e ratesType, uint8_t rcRate, uint8_t rate, uint8_t expo)
+{
+    controlRateConfig.rates_type = ratesType;
+    controlRateConfig.thrMid8 = 50;
+    controlRateConfig.thrExpo8 = 0;
+    controlRateConfig.quickRatesRcExpo = 0;
+    // vary the axes so that the per axis curves are exercised
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        controlRateConfig.rcRates[axis] = rcRate + 5 * axis;
+        controlRateConfig.rates[axis] = rate - 5 * axis;
+        controlRateConfig.rcExpo[axis] = expo + 10 * axis;
+    }
+}
+
+static void expectRatesCurveError(ratesFn *analytic, const char *name)
+{
+    float maxError;
+    float maxRate;
+    ratesCurveError(analytic, &maxError, &maxRate);
+
+    // within 1 deg/s, or 0.1% of the full stick rate on the steepest curves
+    EXPECT_LT(maxError, fmaxf(1.0f, 0.001f * maxRate)) << name << " max rate " << maxRate;
+}
+
+TEST(RcUnittest, TestBetaflightRatesCurve)
+{
+    setRates(RATES_TYPE_BETAFLIGHT, 100, 70, 0);
+    expectRatesCurveError(applyBetaflightRates, "betaflight");
+    setRates(RATES_TYPE_BETAFLIGHT, 180, 80, 30);
+    expectRatesCurveError(applyBetaflightRates, "betaflight high");
+}
+
+TEST(RcUnittest, TestRaceFlightRatesCurve)
+{
+    setRates(RATES_TYPE_RACEFLIGHT, 37, 80, 50);
+    expectRatesCurveError(applyRaceFlightRates, "raceflight");
+}
+
+TEST(RcUnittest, TestKissRatesCurve)
+{
+    setRates(RATES_TYPE_KISS, 100, 70, 30);
+    expectRatesCurveError(applyKissRates, "kiss");
+}
+
+TEST(RcUnittest, TestActualRatesCurve)
+{
+    setRates(RATES_TYPE_ACTUAL, 20, 67, 54);
+    expectRatesCurveError(applyActualRates, "actual");
+}
+
+TEST(RcUnittest, TestQuickRatesCurve)
+{
+    setRates(RATES_TYPE_QUICK, 100, 67, 0);
+    expectRatesCurveError(applyQuickRates, "quick");
+    setRates(RATES_TYPE_QUICK, 100, 67, 30);
+    controlRateConfig.quickRatesRcExpo = 1;
+    expectRatesCurveError(applyQuickRates, "quick rc expo");
+}
+
+TEST(RcUnittest, TestRatesCurveEndPoints)
+{
+    setRates(RATES_TYPE_BETAFLIGHT, 100, 70, 0);
+    initRcProcessing();
+
+    for (int axis = FD_ROLL; axis <= FD_YAW; axis++) {
+        EXPECT_FLOAT_EQ(0.0f, applyRatesCurve(axis, 0.0f, 0.0f));
+        EXPECT_FLOAT_EQ(getMaxRcRate(axis), applyRatesCurve(axis, 1.0f, 1.0f));
+        EXPECT_FLOAT_EQ(-getMaxRcRate(axis), applyRatesCurve(axis, -1.0f, 1.0f));
+    }
+}
+
+// STUBS
+
+extern "C" {
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint16_t flightModeFlags;
+    float rcCommand[4];
+    float rcData[MAX_SUPPORTED_RC_CHANNEL_COUNT];
+    pidRuntime_t pidRuntime;
+
+    PG_REGISTER(rcControlsConfig_t, rcControlsConfig, PG_RC_CONTROLS_CONFIG, 0);
+    PG_REGISTER(rxConfig_t, rxConfig, PG_RX_CONFIG, 0);
+    PG_REGISTER(flight3DConfig_t, flight3DConfig, PG_MOTOR_3D_CONFIG, 0);
+
+    bool IS_RC_MODE_ACTIVE(boxId_e) { return false; }
+    bool failsafeIsActive(void) { return false; }
+    bool featureIsEnabled(uint32_t) { return false; }
+    void imuQuaternionHeadfreeTransformVectorEarthToBody(t_fp_vector_def *) {}
+    timeDelta_t rxGetFrameDelta(timeDelta_t *) { return 0; }
+
+    const lowVoltageCutoff_t *getLowVoltageCutoff(void)
+    {
+        static const lowVoltageCutoff_t lowVoltageCutoff = {};
+        return &lowVoltageCutoff;
+    }
+}
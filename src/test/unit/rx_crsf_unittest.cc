@@ -44,6 +44,7 @@ extern "C" {
     rssiSource_e rssiSource;
 
     void crsfDataReceive(uint16_t c);
+    void crsfDataReceiveFrame(const uint8_t *buf, size_t len, void *data);
     uint8_t crsfFrameCRC(void);
     uint8_t crsfFrameCmdCRC(void);
     uint8_t crsfFrameStatus(void);
@@ -345,6 +346,36 @@ TEST(CrossFireTest, TestCrsfDataReceive)
     EXPECT_EQ(crc, crsfFrame.frame.payload[CRSF_FRAME_RC_CHANNELS_PAYLOAD_SIZE]);
 }
 
+TEST(CrossFireTest, TestCrsfDataReceiveFrame)
+{
+    uint8_t frame[sizeof(crsfRcChannelsFrame_t)];
+    memcpy(frame, capturedData, sizeof(frame));
+    frame[0] = CRSF_ADDRESS_FLIGHT_CONTROLLER;
+    frame[sizeof(frame) - 1] = crc8_dvb_s2_buf(&frame[2], sizeof(frame) - 3);
+
+    rxRuntimeState_t rxRuntimeState;
+    rxRuntimeState.lastRcFrameTimeUs = 0;
+    dummyTimeUs = 1000;
+    crsfFrameDone = false;
+
+    // a frame split across the end of the receive buffer is delivered as two spans
+    crsfDataReceiveFrame(frame, 10, &rxRuntimeState);
+    EXPECT_FALSE(crsfFrameDone);
+    crsfDataReceiveFrame(&frame[10], sizeof(frame) - 10, &rxRuntimeState);
+    EXPECT_TRUE(crsfFrameDone);
+    EXPECT_EQ(1000U, rxRuntimeState.lastRcFrameTimeUs);
+    EXPECT_EQ(0, memcmp(frame, crsfChannelDataFrame.bytes, sizeof(frame)));
+
+    // back to back frames in one span
+    uint8_t frames[2 * sizeof(frame)];
+    memcpy(frames, frame, sizeof(frame));
+    memcpy(&frames[sizeof(frame)], frame, sizeof(frame));
+    frames[sizeof(frame) - 1] ^= 0xff;
+    crsfFrameDone = false;
+    crsfDataReceiveFrame(frames, sizeof(frames), &rxRuntimeState);
+    EXPECT_TRUE(crsfFrameDone);
+}
+
 // STUBS
 
 extern "C" {
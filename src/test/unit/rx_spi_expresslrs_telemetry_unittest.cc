@@ -425,6 +425,7 @@ extern "C" {
     const serialPortConfig_t *findSerialPortConfig(serialPortFunction_e) { return NULL;}
     serialPort_t *openSerialPort(serialPortIdentifier_e, serialPortFunction_e, serialReceiveCallbackPtr, void *, uint32_t, portMode_e, portOptions_e) { return NULL; }
     void serialWriteBuf(serialPort_t *, const uint8_t *, int) {}
+    bool serialSetRxFrameCallback(serialPort_t *, serialReceiveFrameCallbackPtr, size_t) { return true; }
 
     int32_t getEstimatedAltitudeCm(void) { return gpsSol.llh.altCm; }
 
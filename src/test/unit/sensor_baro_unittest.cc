@@ -0,0 +1,152 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "build/debug.h"
+
+    #include "common/time.h"
+
+    #include "drivers/barometer/barometer.h"
+    #include "drivers/bus.h"
+
+    #include "pg/detected_hardware.h"
+    #include "pg/pg.h"
+    #include "pg/pg_ids.h"
+
+    #include "sensors/barometer.h"
+    #include "sensors/sensors.h"
+
+    uint8_t debugMode;
+    int16_t debug[DEBUG16_VALUE_COUNT];
+    uint8_t detectedSensors[SENSOR_INDEX_COUNT];
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+static baroSensor_e presentHardware;
+static std::vector<baroSensor_e> probes;
+
+static void initBaro(baroSensor_e present, baroSensor_e previous)
+{
+    pgResetAll();
+    barometerConfigMutable()->baro_busType = BUS_TYPE_I2C;
+    detectedHardwareConfigMutable()->baroHardware = previous;
+
+    presentHardware = present;
+    probes.clear();
+    detectedSensors[SENSOR_INDEX_BARO] = BARO_NONE;
+}
+
+TEST(SensorBaroTest, TestFullDetection)
+{
+    initBaro(BARO_BMP280, BARO_DEFAULT);
+
+    baroInit();
+
+    EXPECT_TRUE(isBaroReady());
+    EXPECT_EQ(BARO_BMP280, detectedSensors[SENSOR_INDEX_BARO]);
+    EXPECT_EQ(std::vector<baroSensor_e>({ BARO_MS5611, BARO_DPS310, BARO_BMP280 }), probes);
+    EXPECT_EQ(BARO_BMP280, detectedHardwareConfig()->baroHardware);
+}
+
+TEST(SensorBaroTest, TestCacheHit)
+{
+    initBaro(BARO_BMP280, BARO_BMP280);
+
+    baroInit();
+
+    // only the sensor found on the previous boot is probed
+    EXPECT_TRUE(isBaroReady());
+    EXPECT_EQ(BARO_BMP280, detectedSensors[SENSOR_INDEX_BARO]);
+    EXPECT_EQ(std::vector<baroSensor_e>({ BARO_BMP280 }), probes);
+    EXPECT_EQ(BARO_BMP280, detectedHardwareConfig()->baroHardware);
+}
+
+TEST(SensorBaroTest, TestCacheMissFallback)
+{
+    initBaro(BARO_BMP280, BARO_DPS310);
+
+    baroInit();
+
+    // the sensor has been replaced, so all of them are probed and the new one is saved
+    EXPECT_TRUE(isBaroReady());
+    EXPECT_EQ(BARO_BMP280, detectedSensors[SENSOR_INDEX_BARO]);
+    EXPECT_EQ(std::vector<baroSensor_e>({ BARO_DPS310, BARO_MS5611, BARO_DPS310, BARO_BMP280 }), probes);
+    EXPECT_EQ(BARO_BMP280, detectedHardwareConfig()->baroHardware);
+}
+
+TEST(SensorBaroTest, TestCacheMissNothingFound)
+{
+    initBaro(BARO_NONE, BARO_BMP280);
+
+    baroInit();
+
+    // the last sensor found is kept, to be verified first once it is back
+    EXPECT_FALSE(isBaroReady());
+    EXPECT_EQ(BARO_NONE, detectedSensors[SENSOR_INDEX_BARO]);
+    EXPECT_EQ(std::vector<baroSensor_e>({ BARO_BMP280, BARO_MS5611, BARO_DPS310, BARO_BMP280 }), probes);
+    EXPECT_EQ(BARO_BMP280, detectedHardwareConfig()->baroHardware);
+}
+
+TEST(SensorBaroTest, TestConfiguredHardware)
+{
+    initBaro(BARO_BMP280, BARO_MS5611);
+    barometerConfigMutable()->baro_hardware = BARO_DPS310;
+
+    baroInit();
+
+    // probing starts at baro_hardware, the saved sensor is neither used nor updated
+    EXPECT_TRUE(isBaroReady());
+    EXPECT_EQ(BARO_BMP280, detectedSensors[SENSOR_INDEX_BARO]);
+    EXPECT_EQ(std::vector<baroSensor_e>({ BARO_DPS310, BARO_BMP280 }), probes);
+    EXPECT_EQ(BARO_MS5611, detectedHardwareConfig()->baroHardware);
+}
+
+// STUBS
+
+extern "C" {
+    static bool probe(baroSensor_e hardware)
+    {
+        probes.push_back(hardware);
+        return hardware == presentHardware;
+    }
+
+    bool ms5611Detect(baroDev_t *) { return probe(BARO_MS5611); }
+    bool baroDPS310Detect(baroDev_t *) { return probe(BARO_DPS310); }
+    bool bmp280Detect(baroDev_t *) { return probe(BARO_BMP280); }
+
+    void i2cBusSetInstance(const extDevice_t *, uint32_t) { }
+    bool busBusy(const extDevice_t *, bool *) { return false; }
+    void sensorsSet(uint32_t) { }
+    timeUs_t micros(void) { return 0; }
+    void schedulerIgnoreTaskExecRate(void) { }
+    void schedulerIgnoreTaskExecTime(void) { }
+    void schedulerIgnoreTaskStateTime(void) { }
+    void schedulerSetNextStateTime(timeDelta_t) { }
+    bool sensors(uint32_t) { return false; }
+}
@@ -0,0 +1,198 @@
+/*
+ * This file is part of Cleanflight and Betaflight.
+ *
+ * Cleanflight and Betaflight are free software. You can redistribute
+ * this software and/or modify this software under the terms of the
+ * GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * Cleanflight and Betaflight are distributed in the hope that they
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software.
+ *
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <vector>
+
+extern "C" {
+    #include "platform.h"
+
+    #include "drivers/serial.h"
+}
+
+#include "unittest_macros.h"
+#include "gtest/gtest.h"
+
+#define MOCK_RX_BUFFER_SIZE 16
+
+typedef std::vector<uint8_t> span_t;
+
+static std::vector<span_t> spans;
+static std::vector<uint8_t> bytes;
+static void *callbackData;
+
+static void mockRxCallback(uint16_t data, void *rxCallbackData)
+{
+    bytes.push_back(data);
+    callbackData = rxCallbackData;
+}
+
+static void mockRxFrameCallback(const uint8_t *data, size_t len, void *rxCallbackData)
+{
+    spans.push_back(span_t(data, data + len));
+    callbackData = rxCallbackData;
+}
+
+// A UART driver as far as the receive path is concerned
+static volatile uint8_t mockRxBuffer[MOCK_RX_BUFFER_SIZE];
+static const struct serialPortVTable mockVTable = { };
+static serialPort_t mockPort;
+
+static void mockUartOpen(serialReceiveCallbackPtr rxCallback)
+{
+    memset(&mockPort, 0, sizeof(mockPort));
+    mockPort.vTable = &mockVTable;
+    mockPort.rxBuffer = mockRxBuffer;
+    mockPort.rxBufferSize = MOCK_RX_BUFFER_SIZE;
+    mockPort.rxCallback = rxCallback;
+    mockPort.rxCallbackData = &mockPort;
+
+    spans.clear();
+    bytes.clear();
+    callbackData = NULL;
+}
+
+// What the DMA controller would do
+static void mockUartReceive(const char *data)
+{
+    while (*data) {
+        mockRxBuffer[mockPort.rxBufferHead] = *data++;
+        mockPort.rxBufferHead = (mockPort.rxBufferHead + 1) % MOCK_RX_BUFFER_SIZE;
+    }
+}
+
+static void mockUartIdle(void)
+{
+    serialRxFlushBuffer(&mockPort, mockPort.rxBufferHead);
+}
+
+static std::string spanText(const span_t &span)
+{
+    return std::string(span.begin(), span.end());
+}
+
+TEST(SerialTest, TestByteCallbackShim)
+{
+    mockUartOpen(mockRxCallback);
+
+    mockUartReceive("ABC");
+    mockUartIdle();
+
+    EXPECT_EQ(3U, bytes.size());
+    EXPECT_EQ("ABC", std::string(bytes.begin(), bytes.end()));
+    EXPECT_EQ(&mockPort, callbackData);
+    EXPECT_EQ(3U, mockPort.rxBufferTail);
+}
+
+TEST(SerialTest, TestFrameCallback)
+{
+    mockUartOpen(mockRxCallback);
+    EXPECT_TRUE(serialSetRxFrameCallback(&mockPort, mockRxFrameCallback, MOCK_RX_BUFFER_SIZE / 2));
+
+    mockUartReceive("HELLO");
+    mockUartIdle();
+
+    EXPECT_TRUE(bytes.empty());
+    ASSERT_EQ(1U, spans.size());
+    EXPECT_EQ("HELLO", spanText(spans[0]));
+    EXPECT_EQ(&mockPort, callbackData);
+
+    // nothing new since the last idle line
+    mockUartIdle();
+    EXPECT_EQ(1U, spans.size());
+}
+
+TEST(SerialTest, TestFrameCallbackWrap)
+{
+    mockUartOpen(mockRxCallback);
+    EXPECT_TRUE(serialSetRxFrameCallback(&mockPort, mockRxFrameCallback, MOCK_RX_BUFFER_SIZE / 2));
+
+    mockUartReceive("0123456789AB");
+    mockUartIdle();
+    spans.clear();
+
+    // wraps the end of the buffer, so arrives as two spans
+    mockUartReceive("CDEFGHIJ");
+    mockUartIdle();
+    ASSERT_EQ(2U, spans.size());
+    EXPECT_EQ("CDEF", spanText(spans[0]));
+    EXPECT_EQ("GHIJ", spanText(spans[1]));
+    EXPECT_EQ(4U, mockPort.rxBufferTail);
+}
+
+TEST(SerialTest, TestFrameCallbackBufferTooSmall)
+{
+    mockUartOpen(mockRxCallback);
+
+    // a frame arriving while the previous one is handled would overwrite it
+    EXPECT_FALSE(serialSetRxFrameCallback(&mockPort, mockRxFrameCallback, MOCK_RX_BUFFER_SIZE / 2 + 1));
+    EXPECT_EQ(NULL, mockPort.rxFrameCallback);
+
+    // the per byte callback stays in place
+    mockUartReceive("ABC");
+    mockUartIdle();
+    EXPECT_TRUE(spans.empty());
+    EXPECT_EQ("ABC", std::string(bytes.begin(), bytes.end()));
+}
+
+// A driver without readBuf, read a byte at a time from the ring buffer
+static uint32_t mockTotalRxWaiting(const serialPort_t *instance)
+{
+    return (instance->rxBufferHead + MOCK_RX_BUFFER_SIZE - instance->rxBufferTail) % MOCK_RX_BUFFER_SIZE;
+}
+
+static uint8_t mockRead(serialPort_t *instance)
+{
+    const uint8_t ch = instance->rxBuffer[instance->rxBufferTail];
+    instance->rxBufferTail = (instance->rxBufferTail + 1) % MOCK_RX_BUFFER_SIZE;
+    return ch;
+}
+
+TEST(SerialTest, TestReadBufFallback)
+{
+    static const struct serialPortVTable byteVTable = { .serialTotalRxWaiting = mockTotalRxWaiting, .serialRead = mockRead };
+
+    mockUartOpen(NULL);
+    mockPort.vTable = &byteVTable;
+
+    mockUartReceive("ABCDE");
+
+    uint8_t buf[8];
+    EXPECT_EQ(3U, serialReadBuf(&mockPort, buf, 3));
+    EXPECT_EQ("ABC", std::string(buf, buf + 3));
+
+    // no more than is waiting
+    EXPECT_EQ(2U, serialReadBuf(&mockPort, buf, sizeof(buf)));
+    EXPECT_EQ("DE", std::string(buf, buf + 2));
+    EXPECT_EQ(0U, serialReadBuf(&mockPort, buf, sizeof(buf)));
+}
+
+TEST(SerialTest, TestNoCallback)
+{
+    mockUartOpen(NULL);
+
+    const uint8_t data[] = { 1, 2, 3 };
+    serialRxFrame(&mockPort, data, sizeof(data));
+    EXPECT_TRUE(bytes.empty());
+    EXPECT_TRUE(spans.empty());
+}
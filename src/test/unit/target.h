@@ -22,6 +22,7 @@
 
 #define DMA_DATA
 #define DMA_DATA_ZERO_INIT
+#define STATIC_DMA_DATA_AUTO static
 
 #define USE_ACC
 #define USE_CMS
@@ -79,3 +80,9 @@
 #define TARGET_IO_PORTB         0xffff
 #define TARGET_IO_PORTC         0xffff
 
+#ifdef CONFIG_IN_FLASH
+// the config area is an array provided by the test, there is no linker script
+extern uint8_t eepromData[EEPROM_SIZE];
+#define __config_start (*eepromData)
+#define __config_end (eepromData[EEPROM_SIZE])
+#endif
@@ -36,11 +36,15 @@ extern "C" {
     void updateLEDDMABuffer(ledStripFormatRGB_e ledFormat, rgbColor24bpp_t *color, unsigned ledIndex);
     void schedulerIgnoreTaskExecTime(void) {}
     void schedulerIgnoreTaskStateTime(void) {}
+
+    static int hsvToRgb24Calls = 0;
 }
 
 TEST(WS2812, updateDMABuffer)
 {
     // given
+    BIT_COMPARE_1 = 20;
+    BIT_COMPARE_0 = 10;
     rgbColor24bpp_t color1 = { .raw = {0xFF,0xAA,0x55} };
 
     // when
@@ -80,11 +84,67 @@ TEST(WS2812, updateDMABuffer)
     byteIndex++;
 }
 
+TEST(WS2812, updateStripOnlyEncodesChangedLeds)
+{
+    // given
+    const hsvColor_t red = { 0, 255, 255 };
+    const hsvColor_t blue = { 240, 255, 255 };
+    BIT_COMPARE_1 = 20;
+    BIT_COMPARE_0 = 10;
+    ws2811LedStripEnable();
+    setUsedLedCount(4);
+    setStripColor(&red);
+
+    // when
+    hsvToRgb24Calls = 0;
+    ws2811LedDataTransferInProgress = false;
+    EXPECT_TRUE(ws2811UpdateStrip(LED_GRB, 100));
+
+    // then
+    EXPECT_EQ(WS2811_DATA_BUFFER_SIZE, hsvToRgb24Calls);
+
+    // when
+    hsvToRgb24Calls = 0;
+    ws2811LedDataTransferInProgress = false;
+    EXPECT_TRUE(ws2811UpdateStrip(LED_GRB, 100));
+
+    // then
+    EXPECT_EQ(0, hsvToRgb24Calls);
+
+    // when
+    setLedHsv(2, &blue);
+    hsvToRgb24Calls = 0;
+    ws2811LedDataTransferInProgress = false;
+    EXPECT_TRUE(ws2811UpdateStrip(LED_GRB, 100));
+
+    // then
+    EXPECT_EQ(1, hsvToRgb24Calls);
+    // the stub puts the hue in the red channel, which is the second byte for GRB
+    const uint8_t blueRed = 240;
+    for (int bit = 0; bit < 8; bit++) {
+        EXPECT_EQ((blueRed & (0x80 >> bit)) ? BIT_COMPARE_1 : BIT_COMPARE_0, ledStripDMABuffer[2 * 24 + 8 + bit]);
+    }
+
+    // when
+    hsvToRgb24Calls = 0;
+    ws2811LedDataTransferInProgress = false;
+    EXPECT_TRUE(ws2811UpdateStrip(LED_GRB, 50));
+
+    // then
+    EXPECT_EQ(WS2811_DATA_BUFFER_SIZE, hsvToRgb24Calls);
+}
+
 extern "C" {
 rgbColor24bpp_t* hsvToRgb24(const hsvColor_t *c)
 {
-    UNUSED(c);
-    return NULL;
+    static rgbColor24bpp_t rgb;
+
+    hsvToRgb24Calls++;
+    rgb.rgb.r = c->h;
+    rgb.rgb.g = c->s;
+    rgb.rgb.b = c->v;
+
+    return &rgb;
 }
 
 bool ws2811LedStripHardwareInit(ioTag_t ioTag)
@@ -0,0 +1,57 @@
+#!/bin/sh
+
+# Generate the name ordered index of the CLI valueTable, so settings can be found with a binary search
+#
+# The input is cli/settings.c after preprocessing with the flags of the target, so only the settings
+# built into the target are indexed. The order is the one of strcasecmp(), names are compared in lower case.
+#
+# Usage: make_settings_index.sh <preprocessed settings.c> <output file>
+
+INPUT_FILE=$1
+OUTPUT_FILE=$2
+
+# print "<lower case name> <table index>" for every valueTable entry, the name is the first initialiser of the entry
+awk '
+/^#/ { next }
+!inTable && /clivalue_t[ \t]+valueTable[ \t]*\[[ \t]*\][ \t]*=/ { inTable = 1 }
+inTable {
+    for (i = 1; i <= length($0); i++) {
+        c = substr($0, i, 1)
+        if (inString) {
+            if (c == "\\") {
+                i++
+            } else if (c == "\"") {
+                inString = 0
+            } else if (inName) {
+                name = name c
+            }
+        } else if (c == "\"") {
+            inString = 1
+        } else if (c == "{") {
+            depth++
+            if (depth == 2) {
+                inName = 1
+                name = ""
+            }
+        } else if (c == "}") {
+            depth--
+            if (depth == 0) {
+                exit
+            }
+        } else if (c == "," && inName) {
+            print tolower(name), count++
+            inName = 0
+        }
+    }
+}
+' "${INPUT_FILE}" | LC_ALL=C sort -k1,1 | awk '
+BEGIN {
+    print "/* Generated by make_settings_index.sh, do not edit */"
+    print ""
+    print "#include <stdint.h>"
+    print ""
+    print "const uint16_t valueTableNameIndex[] = {"
+}
+{ print "    " $2 ", // " $1 }
+END { print "};" }
+' > "${OUTPUT_FILE}"